@@ -232,6 +232,222 @@ static inline bool simdDecodeAscii(ushort *, const uchar *, const uchar *, const
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(SSE4_1)
+static inline bool hasSimdUtf8()
+{
+    return qCpuHasFeature(SSE4_1);
+}
+
+// PSHUFB masks that pack the selected 16-bit lanes of the low half of a register:
+// entry n keeps lane j if bit j of n is set
+static const char utf16PackLanes[16][8] = {
+    { -1, -1, -1, -1, -1, -1, -1, -1 },
+    {  0,  1, -1, -1, -1, -1, -1, -1 },
+    {  2,  3, -1, -1, -1, -1, -1, -1 },
+    {  0,  1,  2,  3, -1, -1, -1, -1 },
+    {  4,  5, -1, -1, -1, -1, -1, -1 },
+    {  0,  1,  4,  5, -1, -1, -1, -1 },
+    {  2,  3,  4,  5, -1, -1, -1, -1 },
+    {  0,  1,  2,  3,  4,  5, -1, -1 },
+    {  6,  7, -1, -1, -1, -1, -1, -1 },
+    {  0,  1,  6,  7, -1, -1, -1, -1 },
+    {  2,  3,  6,  7, -1, -1, -1, -1 },
+    {  0,  1,  2,  3,  6,  7, -1, -1 },
+    {  4,  5,  6,  7, -1, -1, -1, -1 },
+    {  0,  1,  4,  5,  6,  7, -1, -1 },
+    {  2,  3,  4,  5,  6,  7, -1, -1 },
+    {  0,  1,  2,  3,  4,  5,  6,  7 }
+};
+
+// PSHUFB masks that pack one- and two-byte UTF-8 sequences stored in 16-bit lanes:
+// the first byte of lane j is always kept, the second only if bit j of n is set
+static const char utf8PackPairs[16][8] = {
+    {  0,  2,  4,  6, -1, -1, -1, -1 },
+    {  0,  1,  2,  4,  6, -1, -1, -1 },
+    {  0,  2,  3,  4,  6, -1, -1, -1 },
+    {  0,  1,  2,  3,  4,  6, -1, -1 },
+    {  0,  2,  4,  5,  6, -1, -1, -1 },
+    {  0,  1,  2,  4,  5,  6, -1, -1 },
+    {  0,  2,  3,  4,  5,  6, -1, -1 },
+    {  0,  1,  2,  3,  4,  5,  6, -1 },
+    {  0,  2,  4,  6,  7, -1, -1, -1 },
+    {  0,  1,  2,  4,  6,  7, -1, -1 },
+    {  0,  2,  3,  4,  6,  7, -1, -1 },
+    {  0,  1,  2,  3,  4,  6,  7, -1 },
+    {  0,  2,  4,  5,  6,  7, -1, -1 },
+    {  0,  1,  2,  4,  5,  6,  7, -1 },
+    {  0,  2,  3,  4,  5,  6,  7, -1 },
+    {  0,  1,  2,  3,  4,  5,  6,  7 }
+};
+
+// population count of a nibble, without requiring the POPCNT instruction
+static inline uint nibbleCount(uint n)
+{
+    return (Q_UINT64_C(0x4332322132212110) >> (4 * n)) & 0xf;
+}
+
+// Encodes runs of U+0080 to U+FFFF (except surrogates) eight characters at a time:
+// blocks with only one- and two-byte sequences (e.g. Greek, Cyrillic, Arabic text
+// with ASCII spaces and punctuation) and blocks with only three-byte sequences (e.g.
+// CJK text). Returns as soon as it finds anything else, leaving it to the caller,
+// with the position before which it's not worth calling this function again.
+QT_FUNCTION_TARGET(SSE4_1)
+static const ushort *simdEncodeNonAscii(uchar *&dst, const ushort *&src, const ushort *end)
+{
+    // the output buffer is three times as big as the input, so the 28 bytes
+    // we may store are always available if there are 16 characters left
+    for ( ; end - src >= 16; src += 8) {
+        const __m128i data = _mm_loadu_si128((const __m128i*)src);
+        const __m128i isAscii = _mm_cmpeq_epi16(_mm_min_epu16(data, _mm_set1_epi16(0x7f)), data);
+        const __m128i isTwoBytes = _mm_cmpeq_epi16(_mm_min_epu16(data, _mm_set1_epi16(0x7ff)), data);
+        const uint ascii = _mm_movemask_epi8(isAscii);
+        const uint twoBytes = _mm_movemask_epi8(isTwoBytes);
+        if (ascii == 0xffff)
+            return src + 8;     // let simdEncodeAscii deal with it
+
+        const __m128i low6 = _mm_or_si128(_mm_and_si128(data, _mm_set1_epi16(0x3f)), _mm_set1_epi16(0x80));
+        if (twoBytes == 0xffff) {
+            // 110yyyyy 10xxxxxx, or the ASCII character and a byte we drop
+            __m128i lead = _mm_or_si128(_mm_srli_epi16(data, 6), _mm_set1_epi16(0xc0));
+            __m128i pairs = _mm_or_si128(lead, _mm_slli_epi16(low6, 8));
+            pairs = _mm_blendv_epi8(pairs, data, isAscii);
+
+            // one bit per character that needs two bytes
+            uint n = _mm_movemask_epi8(_mm_packs_epi16(isAscii, _mm_setzero_si128())) ^ 0xff;
+            __m128i packed = _mm_shuffle_epi8(pairs, _mm_loadl_epi64((const __m128i *)utf8PackPairs[n & 0xf]));
+            _mm_storel_epi64((__m128i *)dst, packed);
+            dst += 4 + nibbleCount(n & 0xf);
+            packed = _mm_shuffle_epi8(_mm_srli_si128(pairs, 8), _mm_loadl_epi64((const __m128i *)utf8PackPairs[n >> 4]));
+            _mm_storel_epi64((__m128i *)dst, packed);
+            dst += 4 + nibbleCount(n >> 4);
+            continue;
+        }
+
+        const __m128i isSurrogate = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(short(0xf800))),
+                                                    _mm_set1_epi16(short(0xd800)));
+        if (twoBytes || _mm_movemask_epi8(isSurrogate))
+            return src + 8;
+
+        // 1110zzzz 10yyyyyy 10xxxxxx
+        const __m128i lead = _mm_or_si128(_mm_srli_epi16(data, 12), _mm_set1_epi16(0xe0));
+        const __m128i mid = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(data, 6), _mm_set1_epi16(0x3f)),
+                                         _mm_set1_epi16(0x80));
+        const __m128i leadMid = _mm_or_si128(lead, _mm_slli_epi16(mid, 8));
+        __m128i packed = _mm_or_si128(
+                    _mm_shuffle_epi8(leadMid, _mm_setr_epi8(0, 1, -1, 2, 3, -1, 4, 5, -1, 6, 7, -1, -1, -1, -1, -1)),
+                    _mm_shuffle_epi8(low6, _mm_setr_epi8(-1, -1, 0, -1, -1, 2, -1, -1, 4, -1, -1, 6, -1, -1, -1, -1)));
+        _mm_storeu_si128((__m128i *)dst, packed);
+        packed = _mm_or_si128(
+                    _mm_shuffle_epi8(leadMid, _mm_setr_epi8(8, 9, -1, 10, 11, -1, 12, 13, -1, 14, 15, -1, -1, -1, -1, -1)),
+                    _mm_shuffle_epi8(low6, _mm_setr_epi8(-1, -1, 8, -1, -1, 10, -1, -1, 12, -1, -1, 14, -1, -1, -1, -1)));
+        _mm_storeu_si128((__m128i *)(dst + 12), packed);
+        dst += 24;
+    }
+    return end;
+}
+
+// Decodes runs of one-, two- and three-byte UTF-8 sequences, consuming up to
+// fifteen bytes at a time. The input is validated the same way fromUtf8() does:
+// continuation bytes must match the lead bytes, and overlong forms and encoded
+// surrogates are rejected. On anything else (four-byte sequences, errors or the
+// end of the input) it returns, leaving the slow path to deal with it. The return
+// value is the position before which it's not worth calling this function again.
+QT_FUNCTION_TARGET(SSE4_1)
+static const uchar *simdDecodeNonAscii(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    // we consume at most fifteen bytes, but need to look ahead for continuations
+    while (end - src >= 16) {
+        const __m128i data = _mm_loadu_si128((const __m128i*)src);
+        const uint nonAscii = _mm_movemask_epi8(data);
+
+        // if there are at most two non-ASCII bytes (e.g. Western European text),
+        // the ASCII fast path and the scalar decoder do better
+        const uint rest = nonAscii & (nonAscii - 1);
+        if ((rest & (rest - 1)) == 0)
+            return src + 64;
+
+        // classify the bytes
+        const __m128i c0 = _mm_set1_epi8(char(0xc0));
+        const uint cont = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, c0), _mm_set1_epi8(char(0x80))));
+        const __m128i lead2 = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(data, _mm_set1_epi8(char(0xc2))), data),
+                                            _mm_cmpeq_epi8(_mm_min_epu8(data, _mm_set1_epi8(char(0xdf))), data));
+        const uint lead2Bytes = _mm_movemask_epi8(lead2);
+        const uint lead3Bytes = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xf0))),
+                                                                 _mm_set1_epi8(char(0xe0))));
+
+        // a byte ends a character if the next one isn't a continuation;
+        // consume up to and including the last character ending in the first fifteen bytes
+        const uint ends = ~(cont >> 1) & 0x7fff;
+        if (!ends)
+            return src + 16;
+        const uint consumed = 32 - qCountLeadingZeroBits(ends);
+        const uint valid = (1U << consumed) - 1;
+
+        // C0, C1 and four-byte sequences
+        uint errors = nonAscii & ~(cont | lead2Bytes | lead3Bytes);
+
+        // E0 must be followed by A0-BF (else it's overlong) and ED by 80-9F (else it's a surrogate)
+        // (shift bit 5 into bit 7 of each byte, which is what movemask extracts)
+        const uint bit5 = _mm_movemask_epi8(_mm_slli_epi16(data, 2));
+        const uint e0 = _mm_movemask_epi8(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xe0))));
+        const uint ed = _mm_movemask_epi8(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xed))));
+        errors |= ((e0 << 1) & ~bit5) | ((ed << 1) & bit5);
+
+        // the continuation bytes must be exactly the ones the lead bytes ask for
+        // (this also catches sequences that are cut short by the end of the window)
+        const uint leads = (lead2Bytes | lead3Bytes) & valid;
+        const uint expected = (leads << 1) | ((lead3Bytes & valid) << 2);
+        if ((errors & valid) | (expected ^ (cont & valid)))
+            return src + 16;
+
+        // calculate the code point that each character ends in, depending on
+        // whether the byte and the one before it are continuations:
+        //   0xxxxxxx                    00000000 0xxxxxxx
+        //   110yyyyy 10xxxxxx           00000yyy yyxxxxxx
+        //   1110zzzz 10yyyyyy 10xxxxxx  zzzzyyyy yyxxxxxx
+        const __m128i prev1 = _mm_slli_si128(data, 1);
+        const __m128i prev2 = _mm_slli_si128(data, 2);
+        const __m128i isCont = _mm_cmpeq_epi8(_mm_and_si128(data, c0), _mm_set1_epi8(char(0x80)));
+        const __m128i prevBits = _mm_srli_epi16(prev1, 2);
+        __m128i lo = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(prev1, _mm_set1_epi8(3)), 6),
+                                  _mm_and_si128(data, _mm_set1_epi8(0x3f)));
+        lo = _mm_blendv_epi8(data, lo, isCont);
+        __m128i hi = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(prev2, _mm_set1_epi8(0xf)), 4),
+                                  _mm_and_si128(prevBits, _mm_set1_epi8(0xf)));
+        hi = _mm_blendv_epi8(_mm_and_si128(prevBits, _mm_set1_epi8(7)), hi, _mm_slli_si128(isCont, 1));
+        hi = _mm_and_si128(hi, isCont);
+
+        // keep only the lanes ending a character
+        const __m128i chars[2] = { _mm_unpacklo_epi8(lo, hi), _mm_unpackhi_epi8(lo, hi) };
+        for (int i = 0; i < 4; ++i) {
+            const uint n = (ends >> (4 * i)) & 0xf;
+            const __m128i half = (i & 1) ? _mm_srli_si128(chars[i / 2], 8) : chars[i / 2];
+            _mm_storel_epi64((__m128i *)dst, _mm_shuffle_epi8(half, _mm_loadl_epi64((const __m128i *)utf16PackLanes[n])));
+            dst += nibbleCount(n);
+        }
+        src += consumed;
+    }
+    return end;
+}
+#else
+static inline bool hasSimdUtf8()
+{
+    return false;
+}
+
+static const ushort *simdEncodeNonAscii(uchar *&, const ushort *&, const ushort *end)
+{
+    Q_UNREACHABLE();
+    return end;
+}
+
+static const uchar *simdDecodeNonAscii(ushort *&, const uchar *&, const uchar *end)
+{
+    Q_UNREACHABLE();
+    return end;
+}
+#endif
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -240,12 +456,16 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
     const ushort *src = reinterpret_cast<const ushort *>(uc);
     const ushort *const end = src + len;
 
+    const ushort *nextMultiByte = src;
     while (src != end) {
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
 
         do {
+            if (src >= nextMultiByte && hasSimdUtf8())
+                nextMultiByte = simdEncodeNonAscii(dst, src, end);
+
             ushort uc = *src++;
             int res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, dst, src, end);
             if (res < 0) {
@@ -288,6 +508,7 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
     }
 
     const ushort *nextAscii = src;
+    const ushort *nextMultiByte = src;
     while (src != end) {
         int res;
         ushort uc;
@@ -298,6 +519,8 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
         } else {
             if (src >= nextAscii && simdEncodeAscii(cursor, nextAscii, src, end))
                 break;
+            if (src >= nextMultiByte && hasSimdUtf8())
+                nextMultiByte = simdEncodeNonAscii(cursor, src, end);
 
             uc = *src++;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
@@ -383,12 +606,16 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) Q_DECL
             src += 3;
         }
 
+        const uchar *nextMultiByte = src;
         while (src < end) {
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
 
             do {
+                if (src >= nextMultiByte && hasSimdUtf8())
+                    nextMultiByte = simdDecodeNonAscii(dst, src, end);
+
                 uchar b = *src++;
                 int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, src, end);
                 if (res < 0) {
@@ -473,10 +700,13 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     // main body, stateless decoding
     res = 0;
     const uchar *nextAscii = src;
+    const uchar *nextMultiByte = src;
     const uchar *start = src;
     while (res >= 0 && src < end) {
         if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
             break;
+        if (headerdone && src >= nextMultiByte && hasSimdUtf8())
+            nextMultiByte = simdDecodeNonAscii(dst, src, end);
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -102,6 +102,10 @@
 #define QT_FEATURE_topleveldomain -1
 #define QT_NO_TRANSLATION
 #define QT_FEATURE_translation -1
+#ifndef QT_FEATURE_zstd
+// rcc defines this when Qt was configured with Zstandard support
+# define QT_FEATURE_zstd -1
+#endif
 
 #ifdef QT_BUILD_QMAKE
 #define QT_FEATURE_commandlineparser -1
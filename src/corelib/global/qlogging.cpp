@@ -53,6 +53,8 @@
 #include "qdatetime.h"
 #include "qcoreapplication.h"
 #include "qthread.h"
+#include "qwaitcondition.h"
+#include "qmath.h"
 #include "private/qloggingregistry_p.h"
 #include "private/qcoreapplication_p.h"
 #include "private/qsimd_p.h"
@@ -94,6 +96,13 @@
 #  endif
 #endif
 
+#ifndef QT_NO_THREAD
+#  define QLOGGING_HAVE_ASYNC_WRITER
+#  ifdef Q_OS_UNIX
+#    include <pthread.h>
+#  endif
+#endif
+
 #if QT_CONFIG(slog2)
 extern char *__progname;
 #endif
@@ -1586,6 +1595,442 @@ static void android_default_message_handler(QtMsgType type,
 }
 #endif //Q_OS_ANDROID
 
+/*!
+    \internal
+    Writes the formatted \a logMessage to the system log, unless we log to
+    the console. Returns \c false if the message must go to stderr.
+*/
+static bool qt_message_to_system_log(QtMsgType type, const QMessageLogContext &context,
+                                     QString &logMessage)
+{
+    if (qt_logging_to_console())
+        return false;
+#if defined(Q_OS_WIN)
+    Q_UNUSED(type);
+    Q_UNUSED(context);
+    logMessage.append(QLatin1Char('\n'));
+    OutputDebugString(reinterpret_cast<const wchar_t *>(logMessage.utf16()));
+    return true;
+#elif QT_CONFIG(slog2)
+    Q_UNUSED(context);
+    logMessage.append(QLatin1Char('\n'));
+    slog2_default_handler(type, logMessage.toLocal8Bit().constData());
+    return true;
+#elif QT_CONFIG(journald)
+    systemd_default_message_handler(type, context, logMessage);
+    return true;
+#elif QT_CONFIG(syslog)
+    Q_UNUSED(context);
+    syslog_default_message_handler(type, logMessage.toUtf8().constData());
+    return true;
+#elif defined(Q_OS_ANDROID)
+    android_default_message_handler(type, context, logMessage);
+    return true;
+#else
+    Q_UNUSED(type);
+    Q_UNUSED(context);
+    Q_UNUSED(logMessage);
+    return false;
+#endif
+}
+
+#ifdef QLOGGING_HAVE_ASYNC_WRITER
+/*
+    Asynchronous output of the default message handler, enabled by setting
+    QT_LOGGING_ASYNC to "block" or "drop" (or "1", which means "block").
+
+    The calling thread only formats the message and moves it into a bounded
+    ring of QAsyncLogWriter::Message, claiming a slot with a single atomic
+    operation (Vyukov's bounded queue, with one consumer). The writer thread
+    takes the messages in order and writes them in batches: one write and
+    one flush of stderr per batch, or one call per message for the system
+    logs. When the ring is full, the "block" policy waits for the writer and
+    the "drop" policy discards the message; the number of dropped messages
+    is reported in the output.
+
+    The capacity can be set with QT_LOGGING_ASYNC_CAPACITY (1024 messages by
+    default). Pending messages are written before a fatal message aborts the
+    application, and when the application exits.
+
+    The child of a fork() doesn't get the writer thread, so it writes all its
+    messages synchronously; the messages pending at the time of the fork()
+    are the parent's to write.
+*/
+class QAsyncLogWriter : public QThread
+{
+public:
+    enum OverflowPolicy {
+        Block,
+        Drop
+    };
+
+    QAsyncLogWriter(OverflowPolicy policy, int capacity);
+    ~QAsyncLogWriter();
+
+    bool post(QtMsgType type, const QMessageLogContext &context, QString &text);
+    void flush();
+    void stop();
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    struct Message {
+        QAtomicInteger<quint32> sequence;
+        QtMsgType type;
+        int line;
+        QString text;
+        QByteArray file;
+        QByteArray function;
+        QByteArray category;
+    };
+
+    bool tryPost(QtMsgType type, const QMessageLogContext &context, QString &text);
+    bool writePending();
+    void write(Message *message);
+    bool writeDropCount();
+    void flushConsole();
+
+    const OverflowPolicy policy;
+    const bool copyContext;
+    const quint32 mask;
+    Message *ring;
+    QAtomicInteger<quint32> head;       // next slot to be claimed by a producer
+    quint32 tail;                       // next slot to be written, writer thread only
+    QAtomicInteger<quint32> written;    // for flush()
+    QAtomicInt dropped;
+    QAtomicInt writerSleeping;
+    QAtomicInt waitingThreads;          // blocked producers, and flush()
+    QAtomicInt quit;
+    QAtomicPointer<void> writerThreadId;
+    QByteArray consoleBuffer;
+
+    QMutex mutex;
+    QWaitCondition wakeWriter;
+    QWaitCondition wakeProducers;       // on space available, or for flush()
+};
+
+// set in the child of a fork() of a process that started the writer thread
+static QBasicAtomicInt asyncLogWriterLost = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+#ifdef Q_OS_UNIX
+static void markAsyncLogWriterLost()
+{
+    asyncLogWriterLost.store(1);
+}
+#endif
+
+static bool messageSinkUsesContext()
+{
+#if QT_CONFIG(journald) || defined(Q_OS_ANDROID)
+    return !qt_logging_to_console();
+#else
+    return false;
+#endif
+}
+
+QAsyncLogWriter::QAsyncLogWriter(OverflowPolicy policy, int capacity)
+    : policy(policy), copyContext(messageSinkUsesContext()),
+      mask(qNextPowerOfTwo(quint32(qMax(capacity, 2)) - 1) - 1),
+      ring(new Message[mask + 1]), head(0), tail(0), written(0)
+{
+    for (quint32 i = 0; i <= mask; ++i)
+        ring[i].sequence.store(i);
+    consoleBuffer.reserve(16384);
+#ifdef Q_OS_UNIX
+    pthread_atfork(nullptr, nullptr, markAsyncLogWriterLost);
+#endif
+}
+
+QAsyncLogWriter::~QAsyncLogWriter()
+{
+    delete [] ring;
+}
+
+/*!
+    \internal
+    Queues the formatted \a text for the writer thread, taking it over.
+    Returns \c false if the message must be written synchronously.
+*/
+bool QAsyncLogWriter::post(QtMsgType type, const QMessageLogContext &context, QString &text)
+{
+    // a message generated while writing would wait for itself
+    if (quit.load() || QThread::currentThreadId() == writerThreadId.load() || asyncLogWriterLost.load())
+        return false;
+
+    // never dropped: written after all pending messages, before aborting
+    if (type == QtFatalMsg) {
+        flush();
+        return false;
+    }
+
+    if (tryPost(type, context, text)) {
+        if (writerSleeping.fetchAndAddOrdered(0)) {
+            QMutexLocker locker(&mutex);
+            wakeWriter.wakeOne();
+        }
+        return true;
+    }
+
+    if (policy == Drop) {
+        dropped.ref();
+        return true;
+    }
+
+    waitingThreads.ref();
+    QMutexLocker locker(&mutex);
+    while (!tryPost(type, context, text)) {
+        if (quit.load()) {
+            waitingThreads.deref();
+            return false;
+        }
+        wakeWriter.wakeOne();
+        wakeProducers.wait(&mutex, 100);
+    }
+    waitingThreads.deref();
+    wakeWriter.wakeOne();
+    return true;
+}
+
+bool QAsyncLogWriter::tryPost(QtMsgType type, const QMessageLogContext &context, QString &text)
+{
+    quint32 pos = head.loadAcquire();
+    Message *message;
+    forever {
+        message = &ring[pos & mask];
+        const qint32 diff = qint32(message->sequence.loadAcquire() - pos);
+        if (diff == 0) {
+            if (head.testAndSetRelaxed(pos, pos + 1, pos))
+                break;
+        } else if (diff < 0) {
+            return false; // full
+        } else {
+            pos = head.loadAcquire();
+        }
+    }
+
+    message->type = type;
+    message->line = context.line;
+    message->text.swap(text);
+    if (copyContext) {
+        message->file = context.file;
+        message->function = context.function;
+        message->category = context.category;
+    }
+    message->sequence.storeRelease(pos + 1);
+    return true;
+}
+
+/*!
+    \internal
+    Waits until the messages posted so far have been written.
+*/
+void QAsyncLogWriter::flush()
+{
+    if (QThread::currentThreadId() == writerThreadId.load() || !isRunning() || asyncLogWriterLost.load())
+        return;
+
+    const quint32 target = head.loadAcquire();
+    waitingThreads.ref();
+    QMutexLocker locker(&mutex);
+    while (qint32(written.loadAcquire() - target) < 0 || dropped.load()) {
+        const quint32 before = written.load();
+        wakeWriter.wakeOne();
+        // don't hang if a producer died before publishing its message
+        if (!wakeProducers.wait(&mutex, 1000) && written.load() == before)
+            break;
+    }
+    waitingThreads.deref();
+}
+
+/*!
+    \internal
+    Writes the pending messages and stops the writer thread. Messages posted
+    afterwards are written synchronously.
+*/
+void QAsyncLogWriter::stop()
+{
+    {
+        QMutexLocker locker(&mutex);
+        quit.store(1);
+        wakeWriter.wakeOne();
+        wakeProducers.wakeAll();
+    }
+    wait();
+    // messages posted while the writer was exiting
+    writePending();
+    writeDropCount();
+    flushConsole();
+}
+
+void QAsyncLogWriter::run()
+{
+    writerThreadId.store(QThread::currentThreadId());
+    forever {
+        bool wroteAny = writeDropCount();
+        wroteAny |= writePending();
+        flushConsole();
+        if (wroteAny) {
+            written.storeRelease(tail);
+            if (waitingThreads.fetchAndAddOrdered(0)) {
+                QMutexLocker locker(&mutex);
+                wakeProducers.wakeAll();
+            }
+        }
+
+        QMutexLocker locker(&mutex);
+        writerSleeping.fetchAndStoreOrdered(1);
+        if (qint32(ring[tail & mask].sequence.loadAcquire() - (tail + 1)) == 0
+                || dropped.load()) {
+            writerSleeping.store(0);
+            continue;
+        }
+        // for flush()
+        wakeProducers.wakeAll();
+        if (quit.load())
+            break;
+        wakeWriter.wait(&mutex);
+        writerSleeping.store(0);
+    }
+}
+
+// returns true if there was any message
+bool QAsyncLogWriter::writePending()
+{
+    bool wroteAny = false;
+    forever {
+        Message *message = &ring[tail & mask];
+        if (qint32(message->sequence.loadAcquire() - (tail + 1)) != 0)
+            break;
+        write(message);
+        message->text = QString();
+        message->sequence.storeRelease(tail + mask + 1);
+        ++tail;
+        wroteAny = true;
+
+        // let blocked producers proceed before the end of a long batch
+        if ((tail & 255) == 0 && waitingThreads.load()) {
+            QMutexLocker locker(&mutex);
+            wakeProducers.wakeAll();
+        }
+    }
+    return wroteAny;
+}
+
+void QAsyncLogWriter::write(Message *message)
+{
+    QMessageLogContext context(message->file.isNull() ? 0 : message->file.constData(),
+                               message->line,
+                               message->function.isNull() ? 0 : message->function.constData(),
+                               message->category.isNull() ? 0 : message->category.constData());
+    if (qt_message_to_system_log(message->type, context, message->text))
+        return;
+
+    consoleBuffer += message->text.toLocal8Bit();
+    consoleBuffer += '\n';
+    if (consoleBuffer.size() >= 16384)
+        flushConsole();
+}
+
+bool QAsyncLogWriter::writeDropCount()
+{
+    const int count = dropped.fetchAndStoreRelaxed(0);
+    if (!count)
+        return false;
+    QString text = QString::fromLatin1("QAsyncLogWriter: %1 messages dropped").arg(count);
+    QMessageLogContext context;
+    if (!qt_message_to_system_log(QtWarningMsg, context, text)) {
+        consoleBuffer += text.toLocal8Bit();
+        consoleBuffer += '\n';
+    }
+    return true;
+}
+
+void QAsyncLogWriter::flushConsole()
+{
+    if (consoleBuffer.isEmpty())
+        return;
+    fwrite(consoleBuffer.constData(), 1, consoleBuffer.size(), stderr);
+    fflush(stderr);
+    consoleBuffer.resize(0);
+}
+
+static QAsyncLogWriter *createAsyncLogWriter()
+{
+    const QByteArray mode = qgetenv("QT_LOGGING_ASYNC");
+    QAsyncLogWriter::OverflowPolicy policy = QAsyncLogWriter::Block;
+    if (mode == "drop")
+        policy = QAsyncLogWriter::Drop;
+
+    bool ok;
+    int capacity = qEnvironmentVariableIntValue("QT_LOGGING_ASYNC_CAPACITY", &ok);
+    if (!ok || capacity <= 0)
+        capacity = 1024;
+
+    QAsyncLogWriter *writer = new QAsyncLogWriter(policy, capacity);
+    writer->start();
+    return writer;
+}
+
+namespace {
+struct AsyncLogWriterHolder
+{
+    QAsyncLogWriter *writer;
+
+    AsyncLogWriterHolder() : writer(createAsyncLogWriter()) {}
+    ~AsyncLogWriterHolder()
+    {
+        // the writer thread can be neither waited for nor destroyed in the
+        // child of a fork()
+        if (asyncLogWriterLost.load())
+            return;
+        writer->stop();
+        delete writer;
+    }
+};
+}
+
+Q_GLOBAL_STATIC(AsyncLogWriterHolder, asyncLogWriterHolder)
+
+// -1 until QT_LOGGING_ASYNC is read
+static QBasicAtomicInt asyncLoggingEnabled = Q_BASIC_ATOMIC_INITIALIZER(-1);
+
+// returns the writer if asynchronous output is enabled, starting it if needed
+static QAsyncLogWriter *asyncLogWriter()
+{
+    int enabled = asyncLoggingEnabled.loadAcquire();
+    if (Q_UNLIKELY(enabled < 0)) {
+        const QByteArray mode = qgetenv("QT_LOGGING_ASYNC");
+        asyncLoggingEnabled.testAndSetRelease(-1, !mode.isEmpty() && mode != "0");
+        enabled = asyncLoggingEnabled.loadAcquire();
+    }
+    if (!enabled)
+        return 0;
+    AsyncLogWriterHolder *holder = asyncLogWriterHolder();
+    return holder ? holder->writer : 0;
+}
+
+/*!
+    \internal
+    Enables or disables the asynchronous output of the default message
+    handler, overriding QT_LOGGING_ASYNC. The pending messages are written
+    before returning.
+*/
+Q_CORE_EXPORT void qt_logging_set_async(bool enable)
+{
+    asyncLoggingEnabled.storeRelease(enable);
+    if (asyncLogWriterHolder.exists() && !asyncLogWriterHolder.isDestroyed())
+        asyncLogWriterHolder()->writer->flush();
+}
+
+// called before aborting on a fatal message
+static void flushAsyncLogWriter()
+{
+    if (asyncLogWriterHolder.exists() && !asyncLogWriterHolder.isDestroyed())
+        asyncLogWriterHolder()->writer->flush();
+}
+#endif // QLOGGING_HAVE_ASYNC_WRITER
+
 /*!
     \internal
 */
@@ -1599,26 +2044,15 @@ static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &con
     if (logMessage.isNull())
         return;
 
-    if (!qt_logging_to_console()) {
-#if defined(Q_OS_WIN)
-        logMessage.append(QLatin1Char('\n'));
-        OutputDebugString(reinterpret_cast<const wchar_t *>(logMessage.utf16()));
-        return;
-#elif QT_CONFIG(slog2)
-        logMessage.append(QLatin1Char('\n'));
-        slog2_default_handler(type, logMessage.toLocal8Bit().constData());
-        return;
-#elif QT_CONFIG(journald)
-        systemd_default_message_handler(type, context, logMessage);
-        return;
-#elif QT_CONFIG(syslog)
-        syslog_default_message_handler(type, logMessage.toUtf8().constData());
-        return;
-#elif defined(Q_OS_ANDROID)
-        android_default_message_handler(type, context, logMessage);
-        return;
-#endif
+#ifdef QLOGGING_HAVE_ASYNC_WRITER
+    if (QAsyncLogWriter *writer = asyncLogWriter()) {
+        if (writer->post(type, context, logMessage))
+            return;
     }
+#endif
+
+    if (qt_message_to_system_log(type, context, logMessage))
+        return;
     fprintf(stderr, "%s\n", logMessage.toLocal8Bit().constData());
     fflush(stderr);
 }
@@ -1685,6 +2119,9 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
 
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message)
 {
+#ifdef QLOGGING_HAVE_ASYNC_WRITER
+    flushAsyncLogWriter();
+#endif
 #if defined(Q_CC_MSVC) && defined(QT_DEBUG) && defined(_DEBUG) && defined(_CRT_ERROR)
     wchar_t contextFileL[256];
     // we probably should let the compiler do this for us, by declaring QMessageLogContext::file to
@@ -1797,6 +2234,15 @@ void qErrnoWarning(int code, const char *msg, ...)
     output under X11 or to the debugger under Windows. If it is a
     fatal message, the application aborts immediately.
 
+    Since Qt 5.10, the default message handler can write the messages from a
+    background thread, so that the threads that log do not wait for the
+    output. This is enabled by setting the environment variable
+    \c QT_LOGGING_ASYNC to \c block or \c drop, which selects what happens
+    when more than \c QT_LOGGING_ASYNC_CAPACITY (1024 by default) messages are
+    waiting to be written: the logging thread waits, or the message is
+    discarded. The pending messages are written before the application aborts
+    on a fatal message.
+
     Only one message handler can be defined, since this is usually
     done on an application-wide basis to control debug output.
 
@@ -1259,7 +1259,9 @@ public:
         DirectConnection,
         QueuedConnection,
         BlockingQueuedConnection,
-        UniqueConnection =  0x80
+        UniqueConnection =  0x80,
+        BatchedConnection = 0x100,
+        CoalescedConnection = 0x200
     };
 
     enum ShortcutContext {
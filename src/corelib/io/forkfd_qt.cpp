@@ -73,3 +73,156 @@ QT_END_NAMESPACE
 extern "C" {
 #include "../../3rdparty/forkfd/forkfd.c"
 }
+
+#if defined(__linux__) && !defined(__hppa__)
+#  include <sched.h>
+#  include <sys/mman.h>
+#  define QT_HAVE_CLONE_VFORK
+#endif
+
+QT_BEGIN_NAMESPACE
+
+#ifdef QT_HAVE_CLONE_VFORK
+static const size_t vforkStackSize = 256 * 1024;
+
+namespace {
+struct VforkChildData
+{
+    int (*childFn)(void *);
+    void *token;
+    int *deathPipe;
+    const sigset_t *oldMask;
+};
+} // unnamed namespace
+
+static int vforkChildEntry(void *arg)
+{
+    const VforkChildData *data = static_cast<const VforkChildData *>(arg);
+    struct sigaction sa;
+    int ret;
+
+    // We're running on the parent's memory until we exec or exit, so no
+    // handler installed by the parent may run here. Reset every caught signal
+    // to the default disposition (ignored signals remain ignored across exec
+    // anyway), then restore the signal mask the caller had.
+    for (int sig = 1; sig < NSIG; ++sig) {
+        if (sigaction(sig, nullptr, &sa) == -1)
+            continue;
+        if (sa.sa_handler == SIG_IGN || sa.sa_handler == SIG_DFL)
+            continue;
+        sa.sa_handler = SIG_DFL;
+        sa.sa_flags = 0;
+        sigemptyset(&sa.sa_mask);
+        sigaction(sig, &sa, nullptr);
+    }
+    sigprocmask(SIG_SETMASK, data->oldMask, nullptr);
+
+    EINTR_LOOP(ret, close(data->deathPipe[0]));
+    EINTR_LOOP(ret, close(data->deathPipe[1]));
+
+    _exit(data->childFn(data->token));
+}
+#endif
+
+/*
+    Works like forkfd(), but instead of returning in the child process, calls
+    \a childFn with \a token as its argument and exits with the value that
+    function returns (normally, \a childFn calls one of the exec functions and
+    only returns on failure). The child process is reaped and reported the
+    same way as for forkfd(), and FFD_CHILD_PROCESS is never returned.
+
+    On Linux, the child is created with clone(CLONE_VM | CLONE_VFORK), so it
+    shares the memory of the calling process, and the calling thread is
+    suspended until the child execs or exits. That avoids copying the page
+    tables of the parent, but \a childFn may then only call async-signal-safe
+    functions and must not modify any state of the parent. Elsewhere, this
+    function uses forkfd().
+
+    This lives here rather than in forkfd.c so that the latter stays in sync
+    with upstream; it uses forkfd's internals to register the child.
+*/
+int qt_vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token)
+{
+#ifdef QT_HAVE_CLONE_VFORK
+    Header *header;
+    ProcessInfo *info;
+    struct pipe_payload payload;
+    VforkChildData data;
+    sigset_t allSignals, oldMask;
+    char *stack;
+    size_t pageSize;
+    pid_t pid;
+    int deathPipe[2];
+    int savedErrno;
+    int ret;
+
+    (void) pthread_once(&forkfd_initialization, forkfd_initialize);
+
+    info = allocateInfo(&header);
+    if (info == nullptr) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    // create the pipe before we clone
+    if (create_pipe(deathPipe, flags) == -1)
+        goto err_free; // failed to create the pipes, pass errno
+
+    // the child needs a stack of its own, with a guard page below it
+    pageSize = size_t(sysconf(_SC_PAGESIZE));
+    stack = static_cast<char *>(mmap(nullptr, vforkStackSize + pageSize, PROT_READ | PROT_WRITE,
+                                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK | MAP_NORESERVE, -1, 0));
+    if (stack == MAP_FAILED)
+        goto err_close;
+    mprotect(stack, pageSize, PROT_NONE);
+
+    // block all signals so no handler runs in the child before it resets them
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &oldMask);
+
+    data.childFn = childFn;
+    data.token = token;
+    data.deathPipe = deathPipe;
+    data.oldMask = &oldMask;
+    pid = clone(vforkChildEntry, stack + vforkStackSize + pageSize,
+                CLONE_VM | CLONE_VFORK | SIGCHLD, &data);
+    savedErrno = errno;
+
+    pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
+    munmap(stack, vforkStackSize + pageSize);
+
+    if (pid == -1) {
+        errno = savedErrno;
+        goto err_close; // failed to clone, pass errno
+    }
+    if (ppid)
+        *ppid = pid;
+
+    // Store the child's PID in the info structure. Unlike forkfd(), we can't
+    // make the child wait for us, since we were suspended until it exec'ed,
+    // so check if it has already exited.
+    info->deathPipe = deathPipe[1];
+    ffd_atomic_store(&info->pid, pid, FFD_ATOMIC_RELEASE);
+    if (tryReaping(pid, &payload))
+        notifyAndFreeInfo(header, info, &payload);
+
+    return deathPipe[0];
+
+err_close:
+    savedErrno = errno;
+    EINTR_LOOP(ret, close(deathPipe[0]));
+    EINTR_LOOP(ret, close(deathPipe[1]));
+    errno = savedErrno;
+err_free:
+    // free the info pointer
+    freeInfo(header, info);
+    return -1;
+#else
+    int fd = forkfd(flags, ppid);
+    if (fd == FFD_CHILD_PROCESS)
+        _exit(childFn(token));
+    return fd;
+#endif
+}
+
+QT_END_NAMESPACE
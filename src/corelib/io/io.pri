@@ -49,6 +49,7 @@ HEADERS +=  \
         io/qfilesystemengine_p.h \
         io/qfilesystemmetadata_p.h \
         io/qfilesystemiterator_p.h \
+        io/qfilesystemwalker_p.h \
         io/qfileselector.h \
         io/qfileselector_p.h \
         io/qloggingcategory.h \
@@ -89,10 +90,13 @@ SOURCES += \
         io/qfilesystemwatcher_polling.cpp \
         io/qfilesystementry.cpp \
         io/qfilesystemengine.cpp \
+        io/qfilesystemwalker.cpp \
         io/qfileselector.cpp \
         io/qloggingcategory.cpp \
         io/qloggingregistry.cpp
 
+qtConfig(zstd): QMAKE_USE_PRIVATE += zstd
+
 qtConfig(processenvironment) {
     SOURCES += \
         io/qprocess.cpp
@@ -142,7 +146,8 @@ win32 {
                 io/qfsfileengine_unix.cpp \
                 io/qfilesystemengine_unix.cpp \
                 io/qlockfile_unix.cpp \
-                io/qfilesystemiterator_unix.cpp
+                io/qfilesystemiterator_unix.cpp \
+                io/qfilesystemwalker_unix.cpp
 
         !integrity:!uikit {
             SOURCES += io/forkfd_qt.cpp
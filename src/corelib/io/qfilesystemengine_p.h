@@ -93,6 +93,8 @@ public:
 #if defined(Q_OS_UNIX)
     static bool cloneFile(int srcfd, int dstfd, const QFileSystemMetaData &knownData);
     static bool fillMetaData(int fd, QFileSystemMetaData &data); // what = PosixStatFlags
+    static bool fillMetaDataAt(int dirfd, const char *name, QFileSystemMetaData &data,
+                               QFileSystemMetaData::MetaDataFlags what);
     static QByteArray id(int fd);
     static bool setFileTime(int fd, const QDateTime &newDate,
                             QAbstractFileEngine::FileTime whatTime, QSystemError &error);
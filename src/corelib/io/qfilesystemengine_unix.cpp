@@ -102,6 +102,14 @@ static int statx(int dirfd, const char *pathname, int flag, unsigned mask, struc
 #  endif
 #endif
 
+#ifndef QT_FSTATAT
+#  if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#    define QT_FSTATAT ::fstatat64
+#  else
+#    define QT_FSTATAT ::fstatat
+#  endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #define emptyFileEntryWarning() emptyFileEntryWarning_(QT_MESSAGELOG_FILE, QT_MESSAGELOG_LINE, QT_MESSAGELOG_FUNC)
@@ -292,7 +300,8 @@ mtime(const T &statBuffer, int)
 }
 
 #ifdef STATX_BASIC_STATS
-static int qt_real_statx(int fd, const char *pathname, int flags, struct statx *statxBuffer)
+static int qt_real_statx(int fd, const char *pathname, int flags, struct statx *statxBuffer,
+                         unsigned mask = STATX_BASIC_STATS | STATX_BTIME)
 {
 #ifdef Q_ATOMIC_INT8_IS_SUPPORTED
     static QBasicAtomicInteger<qint8> statxTested  = Q_BASIC_ATOMIC_INITIALIZER(0);
@@ -303,7 +312,6 @@ static int qt_real_statx(int fd, const char *pathname, int flags, struct statx *
     if (statxTested.load() == -1)
         return -ENOSYS;
 
-    unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
     int ret = statx(fd, pathname, flags, mask, statxBuffer);
     if (ret == -1 && errno == ENOSYS) {
         statxTested.store(-1);
@@ -328,6 +336,12 @@ static int qt_fstatx(int fd, struct statx *statxBuffer)
     return qt_real_statx(fd, "", AT_EMPTY_PATH, statxBuffer);
 }
 
+static int qt_lstatx_type(int dirfd, const char *name, struct statx *statxBuffer)
+{
+    // only ask for the file type, which spares network file systems a round trip
+    return qt_real_statx(dirfd, name, AT_SYMLINK_NOFOLLOW, statxBuffer, STATX_TYPE);
+}
+
 inline void QFileSystemMetaData::fillFromStatxBuf(const struct statx &statxBuffer)
 {
     // Permissions
@@ -395,6 +409,12 @@ static int qt_lstatx(const char *, struct statx *)
 static int qt_fstatx(int, struct statx *)
 { return -ENOSYS; }
 
+static int qt_real_statx(int, const char *, int, struct statx *)
+{ return -ENOSYS; }
+
+static int qt_lstatx_type(int, const char *, struct statx *)
+{ return -ENOSYS; }
+
 inline void QFileSystemMetaData::fillFromStatxBuf(const struct statx &)
 { }
 #endif
@@ -427,6 +447,82 @@ bool QFileSystemEngine::fillMetaData(int fd, QFileSystemMetaData &data)
     return false;
 }
 
+/*!
+    \internal
+
+    Fills \a data with the meta data of the entry \a name in the directory
+    open as \a dirfd. If \a what only asks for the entry type, the entry is
+    inspected without following symbolic links and only its type is
+    requested from the kernel. Otherwise, the PosixStatFlags of the entry are
+    filled in, following symbolic links as stat() does.
+*/
+//static
+bool QFileSystemEngine::fillMetaDataAt(int dirfd, const char *name, QFileSystemMetaData &data,
+                                       QFileSystemMetaData::MetaDataFlags what)
+{
+    union {
+        struct statx statxBuffer;
+        QT_STATBUF statBuffer;
+    };
+
+    if (!(what & ~QFileSystemMetaData::Type)) {
+        mode_t mode;
+        int ret = qt_lstatx_type(dirfd, name, &statxBuffer);
+        if (ret == -ENOSYS) {
+            if (QT_FSTATAT(dirfd, name, &statBuffer, AT_SYMLINK_NOFOLLOW) != 0)
+                return false;
+            mode = statBuffer.st_mode;
+        } else if (ret == 0) {
+            mode = statxBuffer.stx_mode;
+        } else {
+            return false;
+        }
+
+        const QFileSystemMetaData::MetaDataFlags typeFlags = QFileSystemMetaData::LinkType
+                | QFileSystemMetaData::FileType
+                | QFileSystemMetaData::DirectoryType
+                | QFileSystemMetaData::SequentialType;
+        data.knownFlagsMask |= typeFlags;
+        data.entryFlags &= ~typeFlags;
+        if (S_ISLNK(mode))
+            data.entryFlags |= QFileSystemMetaData::LinkType;
+        else if (S_ISREG(mode))
+            data.entryFlags |= QFileSystemMetaData::FileType;
+        else if (S_ISDIR(mode))
+            data.entryFlags |= QFileSystemMetaData::DirectoryType;
+        else if (!S_ISBLK(mode))
+            data.entryFlags |= QFileSystemMetaData::SequentialType;
+        return true;
+    }
+
+    data.entryFlags &= ~(QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::ExistsAttribute);
+    data.knownFlagsMask |= QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::ExistsAttribute;
+
+    bool ok;
+    int ret = qt_real_statx(dirfd, name, 0, &statxBuffer);
+    if (ret == -ENOSYS) {
+        ok = QT_FSTATAT(dirfd, name, &statBuffer, 0) == 0;
+        if (ok)
+            data.fillFromStatBuf(statBuffer);
+    } else {
+        ok = ret == 0;
+        if (ok)
+            data.fillFromStatxBuf(statxBuffer);
+    }
+
+    if (!ok) {
+        // a dangling symbolic link, or the entry was removed meanwhile
+        data.birthTime_ = 0;
+        data.metadataChangeTime_ = 0;
+        data.modificationTime_ = 0;
+        data.accessTime_ = 0;
+        data.size_ = 0;
+        data.userId_ = (uint) -2;
+        data.groupId_ = (uint) -2;
+    }
+    return ok;
+}
+
 #if defined(_DEXTRA_FIRST)
 static void fillStat64fromStat32(struct stat64 *statBuf64, const struct stat &statBuf32)
 {
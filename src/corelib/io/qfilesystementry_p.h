@@ -61,7 +61,7 @@
 
 QT_BEGIN_NAMESPACE
 
-class QFileSystemEntry
+class Q_AUTOTEST_EXPORT QFileSystemEntry
 {
 public:
 
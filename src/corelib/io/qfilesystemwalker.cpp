@@ -0,0 +1,342 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qfilesystemwalker_p.h"
+
+#ifndef QT_NO_FILESYSTEMITERATOR
+
+#include "qfilesystemengine_p.h"
+#include "qfilesystemiterator_p.h"
+#include "qfileinfo_p.h"
+#ifndef QT_NO_THREAD
+#include <qrunnable.h>
+#include <qthreadpool.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QFileSystemWalker
+    \inmodule QtCore
+    \internal
+
+    \brief The QFileSystemWalker class lists all entries of a directory tree.
+
+    Unlike QDirIterator, QFileSystemWalker is meant for scanning very large
+    trees. It hands the entries it finds to a handler function in batches,
+    and does not stat() them unless FetchMetaData is set: the entry type is
+    taken from the directory listing wherever the file system reports it. On
+    Linux, directories are read with getdents64() into a large buffer, so a
+    directory with many entries needs few system calls.
+
+    If a thread pool is set, subdirectories are read in parallel by as many
+    of the pool's threads as are idle when walk() is called, in addition to
+    the calling thread. Batches are then delivered in no particular order,
+    but the handler is never called concurrently.
+
+    The entries "." and ".." are never reported. Symbolic links to
+    directories are reported, and only descended into if FollowSymlinks is
+    set. Like QDirIterator, the walker then descends into each link target at
+    most once, which is enough to break link loops.
+*/
+
+/*!
+    \enum QFileSystemWalker::WalkerFlag
+
+    \value NoWalkerFlags Report all entries, using only the information that
+           the directory listing provides.
+    \value FollowSymlinks Descend into symbolic links to directories.
+    \value FetchMetaData Fill in the PosixStatFlags of every entry, following
+           symbolic links like QFileInfo does.
+*/
+
+/*!
+    Returns a QFileInfo for this entry that reuses the meta data collected
+    while walking, so that no further system calls are needed to query it.
+*/
+QFileInfo QFileSystemWalker::Entry::fileInfo() const
+{
+    return QFileInfo(new QFileInfoPrivate(entry, metaData));
+}
+
+QFileSystemWalkerPrivate::QFileSystemWalkerPrivate(const QString &path,
+                                                   QFileSystemWalker::WalkerFlags flags)
+    : root(path),
+      flags(flags),
+      pool(nullptr),
+      batchSize(1024),
+      busy(0),
+      helpers(0),
+      failed(false)
+{
+}
+
+/*!
+    Creates a walker for the directory tree rooted at \a path.
+*/
+QFileSystemWalker::QFileSystemWalker(const QString &path, WalkerFlags flags)
+    : d(new QFileSystemWalkerPrivate(path, flags))
+{
+}
+
+QFileSystemWalker::~QFileSystemWalker()
+{
+}
+
+/*!
+    Makes walk() read directories in parallel on idle threads of \a pool.
+    The default, a null pointer, walks the tree in the calling thread only.
+*/
+void QFileSystemWalker::setThreadPool(QThreadPool *pool)
+{
+    d->pool = pool;
+}
+
+QThreadPool *QFileSystemWalker::threadPool() const
+{
+    return d->pool;
+}
+
+/*!
+    Sets the number of entries collected before they are handed to the
+    handler to \a size. The default is 1024.
+*/
+void QFileSystemWalker::setBatchSize(int size)
+{
+    d->batchSize = qMax(1, size);
+}
+
+int QFileSystemWalker::batchSize() const
+{
+    return d->batchSize;
+}
+
+#ifndef QT_NO_THREAD
+class QFileSystemWalkerRunnable : public QRunnable
+{
+public:
+    explicit QFileSystemWalkerRunnable(QFileSystemWalkerPrivate *d) : d(d) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        d->run();
+
+        QMutexLocker locker(&d->mutex);
+        if (--d->helpers == 0)
+            d->condition.wakeAll();
+    }
+
+private:
+    QFileSystemWalkerPrivate *d;
+};
+#endif
+
+/*!
+    Walks the whole tree, calling \a handler with batches of entries, and
+    returns once all entries have been delivered.
+
+    Returns \c false if the root or any of its subdirectories could not be
+    read; the entries that could be read are delivered regardless.
+*/
+bool QFileSystemWalker::walk(const BatchHandler &handler)
+{
+    d->handler = handler;
+    d->pending.append(d->root);
+    d->failed = false;
+    d->visitedLinks.clear();
+    if (d->flags & FollowSymlinks)
+        d->isNewDirectory(d->root); // links back to the root are not followed
+
+#ifndef QT_NO_THREAD
+    if (d->pool) {
+        // Only borrow threads that are free right now; a runnable that was
+        // merely queued could start after this walker is gone.
+        const int wanted = d->pool->maxThreadCount() - 1;
+        for (int i = 0; i < wanted; ++i) {
+            QFileSystemWalkerRunnable *runnable = new QFileSystemWalkerRunnable(d.data());
+            {
+                QMutexLocker locker(&d->mutex);
+                ++d->helpers;
+            }
+            if (!d->pool->tryStart(runnable)) {
+                delete runnable;
+                QMutexLocker locker(&d->mutex);
+                --d->helpers;
+                break;
+            }
+        }
+    }
+#endif
+
+    d->run();
+
+#ifndef QT_NO_THREAD
+    QMutexLocker locker(&d->mutex);
+    while (d->helpers > 0)
+        d->condition.wait(&d->mutex);
+#endif
+
+    d->handler = BatchHandler();
+    return !d->failed;
+}
+
+/*!
+    \internal
+
+    The loop executed by every thread taking part in the walk: take the most
+    recently found directory, read it, and queue its subdirectories, until no
+    directory is left and no other thread can find new ones.
+*/
+void QFileSystemWalkerPrivate::run()
+{
+    QFileSystemWalker::Batch batch;
+    batch.reserve(batchSize);
+    QVector<QFileSystemEntry> subdirectories;
+    QByteArray buffer;
+
+    QMutexLocker locker(&mutex);
+    for (;;) {
+#ifndef QT_NO_THREAD
+        while (pending.isEmpty() && busy > 0)
+            condition.wait(&mutex);
+#endif
+        if (pending.isEmpty())
+            break;
+
+        const QFileSystemEntry directory = pending.takeLast();
+        ++busy;
+        locker.unlock();
+
+        const bool ok = readDirectory(directory, batch, subdirectories, buffer);
+
+        locker.relock();
+        --busy;
+        if (!ok)
+            failed = true;
+        if (!subdirectories.isEmpty()) {
+            pending += subdirectories;
+            subdirectories.clear();
+#ifndef QT_NO_THREAD
+            condition.wakeAll();
+#endif
+        } else if (busy == 0 && pending.isEmpty()) {
+#ifndef QT_NO_THREAD
+            condition.wakeAll();
+#endif
+        }
+    }
+    locker.unlock();
+
+    if (!batch.isEmpty())
+        deliver(batch);
+}
+
+/*!
+    \internal
+
+    Returns \c true if \a link resolves to a directory that no other link
+    followed during this walk resolved to.
+*/
+bool QFileSystemWalkerPrivate::isNewDirectory(const QFileSystemEntry &link)
+{
+    QFileSystemMetaData metaData;
+    const QString target = QFileSystemEngine::canonicalName(link, metaData).filePath();
+    if (target.isEmpty())
+        return false;
+
+    QMutexLocker locker(&mutex);
+    if (visitedLinks.contains(target))
+        return false;
+    visitedLinks.insert(target);
+    return true;
+}
+
+void QFileSystemWalkerPrivate::deliver(QFileSystemWalker::Batch &batch)
+{
+    {
+        QMutexLocker locker(&handlerMutex);
+        handler(batch);
+    }
+    batch.clear();
+}
+
+#ifndef Q_OS_UNIX
+bool QFileSystemWalkerPrivate::readDirectory(const QFileSystemEntry &directory,
+                                             QFileSystemWalker::Batch &batch,
+                                             QVector<QFileSystemEntry> &subdirectories,
+                                             QByteArray &buffer)
+{
+    Q_UNUSED(buffer)
+
+    QFileSystemIterator iterator(directory, QDir::NoFilter, QStringList());
+    QFileSystemWalker::Entry entry;
+    while (iterator.advance(entry.entry, entry.metaData)) {
+        const QString fileName = entry.entry.fileName();
+        if (fileName == QLatin1String(".") || fileName == QLatin1String(".."))
+            continue;
+
+        if (flags & QFileSystemWalker::FetchMetaData)
+            QFileSystemEngine::fillMetaData(entry.entry, entry.metaData,
+                                            QFileSystemMetaData::PosixStatFlags);
+
+        if (entry.metaData.isLink()) {
+            if (flags & QFileSystemWalker::FollowSymlinks) {
+                QFileSystemMetaData target = entry.metaData;
+                QFileSystemEngine::fillMetaData(entry.entry, target,
+                                                QFileSystemMetaData::DirectoryType);
+                if (target.isDirectory() && isNewDirectory(entry.entry))
+                    subdirectories.append(entry.entry);
+            }
+        } else if (entry.metaData.isDirectory()) {
+            subdirectories.append(entry.entry);
+        }
+
+        batch.append(entry);
+        if (batch.size() >= batchSize)
+            deliver(batch);
+        entry.metaData.clear();
+    }
+    // QFileSystemIterator does not tell an unreadable directory from an empty one
+    return true;
+}
+#endif // Q_OS_UNIX
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_FILESYSTEMITERATOR
@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFILESYSTEMWALKER_P_H
+#define QFILESYSTEMWALKER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+
+#ifndef QT_NO_FILESYSTEMITERATOR
+
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qset.h>
+#include <QtCore/qvector.h>
+#ifndef QT_NO_THREAD
+#include <QtCore/qwaitcondition.h>
+#endif
+
+#include <QtCore/private/qfilesystementry_p.h>
+#include <QtCore/private/qfilesystemmetadata_p.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+class QThreadPool;
+class QFileSystemWalkerPrivate;
+
+class Q_AUTOTEST_EXPORT QFileSystemWalker
+{
+public:
+    enum WalkerFlag {
+        NoWalkerFlags = 0x0,
+        FollowSymlinks = 0x1,
+        FetchMetaData = 0x2
+    };
+    Q_DECLARE_FLAGS(WalkerFlags, WalkerFlag)
+
+    struct Entry
+    {
+        QFileSystemEntry entry;
+        QFileSystemMetaData metaData;
+
+        QFileInfo fileInfo() const;
+    };
+    typedef QVector<Entry> Batch;
+    typedef std::function<void(const Batch &)> BatchHandler;
+
+    explicit QFileSystemWalker(const QString &path, WalkerFlags flags = NoWalkerFlags);
+    ~QFileSystemWalker();
+
+    void setThreadPool(QThreadPool *pool);
+    QThreadPool *threadPool() const;
+
+    void setBatchSize(int size);
+    int batchSize() const;
+
+    bool walk(const BatchHandler &handler);
+
+private:
+    Q_DISABLE_COPY(QFileSystemWalker)
+    QScopedPointer<QFileSystemWalkerPrivate> d;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(QFileSystemWalker::WalkerFlags)
+
+class QFileSystemWalkerPrivate
+{
+public:
+    QFileSystemWalkerPrivate(const QString &path, QFileSystemWalker::WalkerFlags flags);
+
+    void run();
+    bool readDirectory(const QFileSystemEntry &directory, QFileSystemWalker::Batch &batch,
+                       QVector<QFileSystemEntry> &subdirectories, QByteArray &buffer);
+    bool isNewDirectory(const QFileSystemEntry &link);
+    void deliver(QFileSystemWalker::Batch &batch);
+
+    QFileSystemEntry root;
+    QFileSystemWalker::WalkerFlags flags;
+    QThreadPool *pool;
+    int batchSize;
+    QFileSystemWalker::BatchHandler handler;
+
+    QMutex mutex;               // protects everything below
+#ifndef QT_NO_THREAD
+    QWaitCondition condition;
+#endif
+    QVector<QFileSystemEntry> pending;
+    int busy;                   // threads currently reading a directory
+    int helpers;                // pool threads taking part in the walk
+    bool failed;
+    QSet<QString> visitedLinks;
+
+    QMutex handlerMutex;        // serializes calls to the handler
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_FILESYSTEMITERATOR
+
+#endif // QFILESYSTEMWALKER_P_H
@@ -0,0 +1,206 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+#include "qfilesystemwalker_p.h"
+
+#ifndef QT_NO_FILESYSTEMITERATOR
+
+#include "qfilesystemengine_p.h"
+#include <private/qcore_unix_p.h>
+
+#include <dirent.h>
+#include <errno.h>
+
+#if defined(Q_OS_LINUX)
+#  include <sys/syscall.h>
+#  if defined(SYS_getdents64)
+#    define QT_USE_GETDENTS64
+#  endif
+#endif
+
+#if !defined(_DEXTRA_FIRST) && (defined(_DIRENT_HAVE_D_TYPE) || defined(Q_OS_BSD4))
+#  define QT_HAVE_DIRENT_TYPE
+#endif
+
+QT_BEGIN_NAMESPACE
+
+#ifdef QT_USE_GETDENTS64
+// The record layout of getdents64(), which glibc only declares in recent versions
+struct qt_linux_dirent64
+{
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+enum { DirentBufferSize = 256 * 1024 };
+#endif
+
+namespace {
+class DirectoryReader
+{
+public:
+    DirectoryReader(QFileSystemWalkerPrivate *d, const QFileSystemEntry &directory,
+                    QFileSystemWalker::Batch &batch, QVector<QFileSystemEntry> &subdirectories)
+        : d(d), batch(batch), subdirectories(subdirectories),
+          directoryPath(directory.nativeFilePath())
+    {
+        if (!directoryPath.endsWith('/'))
+            directoryPath.append('/');
+    }
+
+    void addEntry(int dirfd, const char *name, unsigned char type);
+
+private:
+    QFileSystemWalkerPrivate *d;
+    QFileSystemWalker::Batch &batch;
+    QVector<QFileSystemEntry> &subdirectories;
+    QFileSystemEntry::NativePath directoryPath;
+};
+}
+
+void DirectoryReader::addEntry(int dirfd, const char *name, unsigned char type)
+{
+    if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+        return;
+
+    QFileSystemWalker::Entry entry;
+    entry.entry = QFileSystemEntry(directoryPath + name, QFileSystemEntry::FromNativePath());
+
+#ifdef QT_HAVE_DIRENT_TYPE
+    // Only the type is used from the directory entry, so a minimal one will do
+    QT_DIRENT dirEntry;
+    dirEntry.d_type = type;
+    entry.metaData.fillFromDirEnt(dirEntry);
+#endif
+
+    if (type == 0) // DT_UNKNOWN
+        QFileSystemEngine::fillMetaDataAt(dirfd, name, entry.metaData, QFileSystemMetaData::Type);
+    if (d->flags & QFileSystemWalker::FetchMetaData)
+        QFileSystemEngine::fillMetaDataAt(dirfd, name, entry.metaData,
+                                          QFileSystemMetaData::PosixStatFlags);
+
+    if (entry.metaData.isLink()) {
+        if (d->flags & QFileSystemWalker::FollowSymlinks) {
+            QFileSystemMetaData target = entry.metaData;
+            if (!target.hasFlags(QFileSystemMetaData::PosixStatFlags))
+                QFileSystemEngine::fillMetaDataAt(dirfd, name, target,
+                                                  QFileSystemMetaData::PosixStatFlags);
+            if (target.isDirectory() && d->isNewDirectory(entry.entry))
+                subdirectories.append(entry.entry);
+        }
+    } else if (entry.metaData.isDirectory()) {
+        subdirectories.append(entry.entry);
+    }
+
+    batch.append(entry);
+    if (batch.size() >= d->batchSize)
+        d->deliver(batch);
+}
+
+bool QFileSystemWalkerPrivate::readDirectory(const QFileSystemEntry &directory,
+                                             QFileSystemWalker::Batch &batch,
+                                             QVector<QFileSystemEntry> &subdirectories,
+                                             QByteArray &buffer)
+{
+    const int dirfd = qt_safe_open(directory.nativeFilePath().constData(),
+                                   QT_OPEN_RDONLY | O_DIRECTORY);
+    if (dirfd == -1)
+        return false;
+
+    DirectoryReader reader(this, directory, batch, subdirectories);
+    bool ok = true;
+
+#ifdef QT_USE_GETDENTS64
+    if (buffer.size() < DirentBufferSize)
+        buffer.resize(DirentBufferSize);
+
+    for (;;) {
+        const long n = syscall(SYS_getdents64, dirfd, buffer.data(), buffer.size());
+        if (n == 0)
+            break;
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            ok = false;
+            break;
+        }
+
+        for (long offset = 0; offset < n; ) {
+            const qt_linux_dirent64 *record =
+                    reinterpret_cast<const qt_linux_dirent64 *>(buffer.constData() + offset);
+            reader.addEntry(dirfd, record->d_name, record->d_type);
+            offset += record->d_reclen;
+        }
+    }
+    qt_safe_close(dirfd);
+#else
+    Q_UNUSED(buffer)
+
+    QT_DIR *dir = ::fdopendir(dirfd);
+    if (!dir) {
+        qt_safe_close(dirfd);
+        return false;
+    }
+
+    for (;;) {
+        errno = 0;
+        const QT_DIRENT *dirEntry = QT_READDIR(dir);
+        if (!dirEntry) {
+            ok = (errno == 0);
+            break;
+        }
+#ifdef QT_HAVE_DIRENT_TYPE
+        reader.addEntry(dirfd, dirEntry->d_name, dirEntry->d_type);
+#else
+        reader.addEntry(dirfd, dirEntry->d_name, 0);
+#endif
+    }
+    QT_CLOSEDIR(dir); // also closes dirfd
+#endif
+
+    return ok;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_FILESYSTEMITERATOR
@@ -596,6 +596,18 @@ void QProcessPrivate::Channel::clear()
     interpreter itself (\c{cmd.exe} on some Windows systems), and ask
     the interpreter to execute the desired command.
 
+    \section1 Notes for Unix Users
+
+    QProcess starts the child process with \c fork(). The cost of that
+    grows with the size of the parent's address space. On Linux, since
+    Qt 5.10, setting the environment variable \c QT_PROCESS_USE_VFORK to
+    a non-empty value makes QProcess start children with \c vfork()
+    semantics instead: the child shares the memory of the parent until the
+    program is executed, and the thread that called start() is suspended
+    meanwhile. This is considerably faster when the parent is large. Only
+    opt in if every reimplementation of setupChildProcess() in the
+    application is safe to run that way.
+
     \sa QBuffer, QFile, QTcpSocket
 */
 
@@ -1943,6 +1955,12 @@ void QProcess::setProcessState(ProcessState state)
     execution, your workaround is to emit finished() and then call
     exit().
 
+    Only async-signal-safe functions should be called from a
+    reimplementation. If \c QT_PROCESS_USE_VFORK is set (see
+    \l{Notes for Unix Users}), the reimplementation runs on the memory of
+    the parent process, so it must not modify any data of the QProcess or
+    of the application either.
+
     \warning This function is called by QProcess on Unix and \macos
     only. On Windows and QNX, it is not called.
 */
@@ -360,6 +360,33 @@ static char **_q_dupEnvironment(const QProcessEnvironmentPrivate::Map &environme
     return envp;
 }
 
+namespace {
+struct QChildProcessStartInfo
+{
+    QProcessPrivate *d;
+    const char *workingDir;
+    char **argv;
+    char **envp;
+
+    static int execChild(void *token)
+    {
+        const QChildProcessStartInfo *info = static_cast<QChildProcessStartInfo *>(token);
+        info->d->execChild(info->workingDir, info->argv, info->envp);
+        return -1;
+    }
+};
+} // unnamed namespace
+
+// in forkfd_qt.cpp
+int qt_vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token);
+
+// Starting the child with vfork() semantics is opt-in, since user code in
+// setupChildProcess() would then run on our memory.
+static bool useVfork()
+{
+    return !qEnvironmentVariableIsEmpty("QT_PROCESS_USE_VFORK");
+}
+
 void QProcessPrivate::startProcess()
 {
     Q_Q(QProcess);
@@ -454,18 +481,27 @@ void QProcessPrivate::startProcess()
 
     // Start the process manager, and fork off the child process.
     pid_t childPid;
-    forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
-    int lastForkErrno = errno;
-    if (forkfd != FFD_CHILD_PROCESS) {
-        // Parent process.
-        // Clean up duplicated memory.
-        for (int i = 0; i <= arguments.count(); ++i)
-            free(argv[i]);
-        for (int i = 0; i < envc; ++i)
-            free(envp[i]);
-        delete [] argv;
-        delete [] envp;
+    if (useVfork()) {
+        // qt_vforkfd() doesn't return in the child: it runs execChild() there, on
+        // our memory (where supported), and only comes back once it has exec'ed.
+        QChildProcessStartInfo startInfo = { this, workingDirPtr, argv, envp };
+        forkfd = qt_vforkfd(FFD_CLOEXEC, &childPid, &QChildProcessStartInfo::execChild, &startInfo);
+    } else {
+        forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
+        if (forkfd == FFD_CHILD_PROCESS) {
+            execChild(workingDirPtr, argv, envp);
+            ::_exit(-1);
+        }
     }
+    int lastForkErrno = errno;
+
+    // Clean up duplicated memory.
+    for (int i = 0; i <= arguments.count(); ++i)
+        free(argv[i]);
+    for (int i = 0; i < envc; ++i)
+        free(envp[i]);
+    delete [] argv;
+    delete [] envp;
 
     // On QNX, if spawnChild failed, childPid will be -1 but forkfd is still 0.
     // This is intentional because we only want to handle failure to fork()
@@ -483,12 +519,6 @@ void QProcessPrivate::startProcess()
         return;
     }
 
-    // Start the child.
-    if (forkfd == FFD_CHILD_PROCESS) {
-        execChild(workingDirPtr, argv, envp);
-        ::_exit(-1);
-    }
-
     pid = Q_PID(childPid);
 
     // parent
@@ -587,7 +617,6 @@ void QProcessPrivate::execChild(const char *workingDir, char **argv, char **envp
 report_errno:
     error.code = errno;
     qt_safe_write(childStartedPipe[1], &error, sizeof(error));
-    childStartedPipe[1] = -1;
 }
 
 bool QProcessPrivate::processStarted(QString *errorMessage)
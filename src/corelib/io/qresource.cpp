@@ -59,10 +59,108 @@
 # include "private/qcore_unix_p.h"
 #endif
 
+#if QT_CONFIG(zstd)
+# include <zstd.h>
+#endif
+
+#include <algorithm>
+
 //#define DEBUG_RESOURCE_MATCH
 
 QT_BEGIN_NAMESPACE
 
+#if QT_CONFIG(zstd)
+// The frames of a Zstandard compressed resource. rcc writes such resources as
+// a sequence of independent frames followed by a seek table in the Zstandard
+// seekable format, so any range of the data can be decompressed on its own.
+class QResourceZstdFrames
+{
+public:
+    bool read(const uchar *data, qint64 size);
+
+    int frameCount() const { return qMax(0, compressedOffsets.size() - 1); }
+    int frameAt(qint64 pos) const;
+    qint64 uncompressedOffset(int frame) const { return uncompressedOffsets.at(frame); }
+    qint64 uncompressedFrameSize(int frame) const
+    { return uncompressedOffsets.at(frame + 1) - uncompressedOffsets.at(frame); }
+    qint64 uncompressedSize() const
+    { return uncompressedOffsets.isEmpty() ? 0 : uncompressedOffsets.last(); }
+
+    bool decompressFrame(ZSTD_DCtx *context, const uchar *data, int frame, char *out) const;
+
+private:
+    // Start of each frame; both have an extra entry holding the total size.
+    QVector<qint64> compressedOffsets;
+    QVector<qint64> uncompressedOffsets;
+};
+
+bool QResourceZstdFrames::read(const uchar *data, qint64 size)
+{
+    static const quint32 skippableMagic = 0x184D2A5E;
+    static const quint32 seekableMagic = 0x8F92EAB1;
+    static const int footerSize = 9;
+
+    compressedOffsets.clear();
+    uncompressedOffsets.clear();
+
+    if (size >= 8 + footerSize && qFromLittleEndian<quint32>(data + size - 4) == seekableMagic) {
+        const quint32 count = qFromLittleEndian<quint32>(data + size - footerSize);
+        const int entrySize = (data[size - 5] & 0x80) ? 12 : 8; // with checksums or not
+        const qint64 tableSize = qint64(count) * entrySize + footerSize;
+        const qint64 tableStart = size - tableSize - 8;
+        if (tableStart < 0 || qFromLittleEndian<quint32>(data + tableStart) != skippableMagic
+                || qFromLittleEndian<quint32>(data + tableStart + 4) != tableSize) {
+            return false;
+        }
+
+        compressedOffsets.reserve(count + 1);
+        uncompressedOffsets.reserve(count + 1);
+        qint64 compressed = 0;
+        qint64 uncompressed = 0;
+        const uchar *entry = data + tableStart + 8;
+        for (quint32 i = 0; i < count; ++i, entry += entrySize) {
+            compressedOffsets.append(compressed);
+            uncompressedOffsets.append(uncompressed);
+            compressed += qFromLittleEndian<quint32>(entry);
+            uncompressed += qFromLittleEndian<quint32>(entry + 4);
+        }
+        compressedOffsets.append(compressed);
+        uncompressedOffsets.append(uncompressed);
+        if (compressed != tableStart) {
+            compressedOffsets.clear();
+            uncompressedOffsets.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // no seek table: a single frame that records its content size
+    const unsigned long long contentSize = ZSTD_getFrameContentSize(data, size_t(size));
+    if (contentSize == ZSTD_CONTENTSIZE_UNKNOWN || contentSize == ZSTD_CONTENTSIZE_ERROR)
+        return false;
+    compressedOffsets << 0 << size;
+    uncompressedOffsets << 0 << qint64(contentSize);
+    return true;
+}
+
+int QResourceZstdFrames::frameAt(qint64 pos) const
+{
+    const auto it = std::upper_bound(uncompressedOffsets.constBegin(),
+                                     uncompressedOffsets.constEnd() - 1, pos);
+    return int(it - uncompressedOffsets.constBegin()) - 1;
+}
+
+bool QResourceZstdFrames::decompressFrame(ZSTD_DCtx *context, const uchar *data, int frame,
+                                          char *out) const
+{
+    const qint64 start = compressedOffsets.at(frame);
+    const size_t outSize = size_t(uncompressedFrameSize(frame));
+    const size_t n = ZSTD_decompressDCtx(context, out, outSize, data + start,
+                                         size_t(compressedOffsets.at(frame + 1) - start));
+    return !ZSTD_isError(n) && n == outSize;
+}
+#endif // QT_CONFIG(zstd)
+
 
 class QStringSplitter
 {
@@ -95,11 +193,14 @@ public:
 //resource glue
 class QResourceRoot
 {
+protected:
     enum Flags
     {
         Compressed = 0x01,
-        Directory = 0x02
+        Directory = 0x02,
+        CompressedZstd = 0x04
     };
+private:
     const uchar *tree, *names, *payloads;
     int version;
     inline int findOffset(int node) const { return node * (14 + (version >= 0x02 ? 8 : 0)); } //sizeof each tree element
@@ -114,7 +215,15 @@ public:
     virtual ~QResourceRoot() { }
     int findNode(const QString &path, const QLocale &locale=QLocale()) const;
     inline bool isContainer(int node) const { return flags(node) & Directory; }
-    inline bool isCompressed(int node) const { return flags(node) & Compressed; }
+    inline QResource::Compression compressionAlgorithm(int node) const
+    {
+        const short f = flags(node);
+        if (f & Compressed)
+            return QResource::ZlibCompression;
+        if (f & CompressedZstd)
+            return QResource::ZstdCompression;
+        return QResource::NoCompression;
+    }
     const uchar *data(int node, qint64 *size) const;
     QDateTime lastModified(int node) const;
     QStringList children(int node) const;
@@ -193,8 +302,8 @@ static inline QStringList *resourceSearchPaths()
     which will be found in the list of paths returned by QDir::searchPaths().
 
     A QResource that is representing a file will have data backing it, this
-    data can possibly be compressed, in which case qUncompress() must be
-    used to access the real data; this happens implicitly when accessed
+    data can possibly be compressed, in which case uncompressedData() must
+    be used to access the real data; this happens implicitly when accessed
     through a QFile. A QResource that is representing a directory will have
     only children and no data.
 
@@ -241,7 +350,7 @@ public:
     QString fileName, absoluteFilePath;
     QList<QResourceRoot*> related;
     uint container : 1;
-    mutable uint compressed : 1;
+    mutable uint compressionAlgo : 2;
     mutable qint64 size;
     mutable const uchar *data;
     mutable QStringList children;
@@ -255,7 +364,7 @@ void
 QResourcePrivate::clear()
 {
     absoluteFilePath.clear();
-    compressed = 0;
+    compressionAlgo = QResource::NoCompression;
     data = 0;
     size = 0;
     children.clear();
@@ -284,11 +393,11 @@ QResourcePrivate::load(const QString &file)
                 container = res->isContainer(node);
                 if(!container) {
                     data = res->data(node, &size);
-                    compressed = res->isCompressed(node);
+                    compressionAlgo = res->compressionAlgorithm(node);
                 } else {
                     data = 0;
                     size = 0;
-                    compressed = 0;
+                    compressionAlgo = QResource::NoCompression;
                 }
                 lastModified = res->lastModified(node);
             } else if(res->isContainer(node) != container) {
@@ -300,7 +409,7 @@ QResourcePrivate::load(const QString &file)
             container = true;
             data = 0;
             size = 0;
-            compressed = 0;
+            compressionAlgo = QResource::NoCompression;
             lastModified = QDateTime();
             res->ref.ref();
             related.append(res);
@@ -492,14 +601,46 @@ bool QResource::isValid() const
     Returns \c true if the resource represents a file and the data backing it
     is in a compressed format, false otherwise.
 
-    \sa data(), isFile()
+    \sa data(), compressionAlgorithm(), isFile()
 */
 
 bool QResource::isCompressed() const
+{
+    return compressionAlgorithm() != NoCompression;
+}
+
+/*!
+    \enum QResource::Compression
+    \since 5.10
+
+    This enum describes how the data backing a resource file is stored.
+
+    \value NoCompression The data is not compressed.
+    \value ZlibCompression The data is compressed with zlib, in the format
+    produced by qCompress().
+    \value ZstdCompression The data is compressed with Zstandard, as a
+    sequence of independent frames followed by a seek table in the Zstandard
+    seekable format. rcc only produces such resources when asked to with
+    \c{--compress-algo zstd}, and Qt can only read them when it was built
+    with Zstandard support.
+
+    \sa compressionAlgorithm()
+*/
+
+/*!
+    \since 5.10
+
+    Returns the algorithm used to compress the data backing the resource, or
+    NoCompression if the data is stored as is or the resource is a directory.
+
+    \sa isCompressed(), uncompressedData()
+*/
+
+QResource::Compression QResource::compressionAlgorithm() const
 {
     Q_D(const QResource);
     d->ensureInitialized();
-    return d->compressed;
+    return Compression(d->compressionAlgo);
 }
 
 /*!
@@ -517,11 +658,11 @@ qint64 QResource::size() const
 
 /*!
     Returns direct access to a read only segment of data that this resource
-    represents. If the resource is compressed the data returns is
-    compressed and qUncompress() must be used to access the data. If the
-    resource is a directory 0 is returned.
+    represents. If the resource is compressed the data returned is
+    compressed and uncompressedData() must be used to access the data. If
+    the resource is a directory 0 is returned.
 
-    \sa size(), isCompressed(), isFile()
+    \sa size(), compressionAlgorithm(), isFile()
 */
 
 const uchar *QResource::data() const
@@ -531,6 +672,91 @@ const uchar *QResource::data() const
     return d->data;
 }
 
+/*!
+    \since 5.10
+
+    Returns the size of the data backing the resource once it is
+    uncompressed, which is the same as size() for uncompressed resources.
+    Returns -1 if the size cannot be determined, for instance because Qt was
+    built without support for the compression algorithm.
+
+    \sa size(), uncompressedData()
+*/
+
+qint64 QResource::uncompressedSize() const
+{
+    Q_D(const QResource);
+    d->ensureInitialized();
+    switch (Compression(d->compressionAlgo)) {
+    case NoCompression:
+        return d->size;
+    case ZlibCompression:
+        // qCompress() prefixes the data with its size in big endian
+        if (d->size >= 4)
+            return qFromBigEndian<quint32>(d->data);
+        return -1;
+    case ZstdCompression: {
+#if QT_CONFIG(zstd)
+        QResourceZstdFrames frames;
+        if (frames.read(d->data, d->size))
+            return frames.uncompressedSize();
+#endif
+        return -1;
+    }
+    }
+    return -1;
+}
+
+/*!
+    \since 5.10
+
+    Returns the data backing the resource, uncompressed if necessary. For
+    uncompressed resources this does not copy the data; the returned
+    QByteArray references the memory returned by data(). Returns an empty
+    QByteArray if the data cannot be uncompressed or the resource is a
+    directory.
+
+    \sa data(), uncompressedSize(), compressionAlgorithm()
+*/
+
+QByteArray QResource::uncompressedData() const
+{
+    Q_D(const QResource);
+    d->ensureInitialized();
+    if (!d->data || d->size <= 0)
+        return QByteArray();
+    switch (Compression(d->compressionAlgo)) {
+    case NoCompression:
+        return QByteArray::fromRawData(reinterpret_cast<const char *>(d->data), int(d->size));
+    case ZlibCompression:
+#ifndef QT_NO_COMPRESS
+        return qUncompress(d->data, int(d->size));
+#else
+        break;
+#endif
+    case ZstdCompression: {
+#if QT_CONFIG(zstd)
+        QResourceZstdFrames frames;
+        if (!frames.read(d->data, d->size) || frames.uncompressedSize() > INT_MAX)
+            break;
+        ZSTD_DCtx *context = ZSTD_createDCtx();
+        if (!context)
+            break;
+        QByteArray result(int(frames.uncompressedSize()), Qt::Uninitialized);
+        bool ok = true;
+        for (int i = 0; ok && i < frames.frameCount(); ++i)
+            ok = frames.decompressFrame(context, d->data, i, result.data() + frames.uncompressedOffset(i));
+        ZSTD_freeDCtx(context);
+        if (ok)
+            return result;
+#endif
+        break;
+    }
+    }
+    qWarning("QResource: Unable to uncompress %s", qPrintable(d->fileName));
+    return QByteArray();
+}
+
 /*!
     Returns the date and time when the file was last modified before
     packaging into a resource.
@@ -858,7 +1084,7 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
                                          const unsigned char *name, const unsigned char *data)
 {
     QMutexLocker lock(resourceMutex());
-    if ((version == 0x01 || version == 0x2) && resourceList()) {
+    if (version >= 0x01 && version <= 0x03 && resourceList()) {
         bool found = false;
         QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ++i) {
@@ -884,7 +1110,7 @@ Q_CORE_EXPORT bool qUnregisterResourceData(int version, const unsigned char *tre
         return false;
 
     QMutexLocker lock(resourceMutex());
-    if ((version == 0x01 || version == 0x02) && resourceList()) {
+    if (version >= 0x01 && version <= 0x03 && resourceList()) {
         QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ) {
             if(*resourceList()->at(i) == res) {
@@ -900,6 +1126,15 @@ Q_CORE_EXPORT bool qUnregisterResourceData(int version, const unsigned char *tre
     return false;
 }
 
+#if QT_CONFIG(zstd)
+// Called from code generated by rcc for resources that contain Zstandard
+// compressed files, so that they fail to link against a Qt that cannot read them.
+Q_CORE_EXPORT bool qResourceFeatureZstd()
+{
+    return true;
+}
+#endif
+
 //run time resource creation
 
 class QDynamicBufferResourceRoot: public QResourceRoot
@@ -947,7 +1182,24 @@ public:
         if (size >= 0 && (tree_offset >= size || data_offset >= size || name_offset >= size))
             return false;
 
-        if (version == 0x01 || version == 0x02) {
+        // Version 3 adds the combined flags of all files to the header
+        if (version >= 0x03) {
+            if (size >= 0 && size < 24)
+                return false;
+            const quint32 file_flags = qFromBigEndian<quint32>(b + offset);
+            offset += 4;
+#if !QT_CONFIG(zstd)
+            if (file_flags & CompressedZstd) {
+                qWarning("QResource: Cannot load a resource compressed with Zstandard: "
+                         "Qt was built without Zstandard support");
+                return false;
+            }
+#else
+            Q_UNUSED(file_flags);
+#endif
+        }
+
+        if (version >= 0x01 && version <= 0x03) {
             buffer = b;
             setSource(version, b+tree_offset, b+name_offset, b+data_offset);
             return true;
@@ -1223,11 +1475,35 @@ private:
     uchar *map(qint64 offset, qint64 size, QFile::MemoryMapFlags flags);
     bool unmap(uchar *ptr);
     void uncompress() const;
+    qint64 uncompressedSize() const;
+#if QT_CONFIG(zstd)
+    bool readZstdFrames() const;
+    qint64 readZstd(char *data, qint64 len) const;
+#endif
     qint64 offset;
     QResource resource;
     mutable QByteArray uncompressed;
+#if QT_CONFIG(zstd)
+    // Zstandard compressed resources are decompressed a frame at a time, as
+    // they are read; only the last frame read is kept.
+    mutable QResourceZstdFrames zstdFrames;
+    mutable QByteArray frameBuffer;
+    mutable int bufferedFrame;
+    mutable ZSTD_DCtx *zstdContext;
+#endif
 protected:
-    QResourceFileEnginePrivate() : offset(0) { }
+    QResourceFileEnginePrivate()
+        : offset(0)
+#if QT_CONFIG(zstd)
+        , bufferedFrame(-1), zstdContext(0)
+#endif
+    { }
+#if QT_CONFIG(zstd)
+    ~QResourceFileEnginePrivate()
+    {
+        ZSTD_freeDCtx(zstdContext);
+    }
+#endif
 };
 
 bool QResourceFileEngine::mkdir(const QString &, bool) const
@@ -1281,7 +1557,8 @@ bool QResourceFileEngine::open(QIODevice::OpenMode flags)
     }
     if(flags & QIODevice::WriteOnly)
         return false;
-    d->uncompress();
+    if (d->resource.compressionAlgorithm() == QResource::ZlibCompression)
+        d->uncompress();
     if (!d->resource.isValid()) {
         d->errorString = QSystemError::stdString(ENOENT);
         return false;
@@ -1294,6 +1571,10 @@ bool QResourceFileEngine::close()
     Q_D(QResourceFileEngine);
     d->offset = 0;
     d->uncompressed.clear();
+#if QT_CONFIG(zstd)
+    d->frameBuffer.clear();
+    d->bufferedFrame = -1;
+#endif
     return true;
 }
 
@@ -1309,10 +1590,20 @@ qint64 QResourceFileEngine::read(char *data, qint64 len)
         len = size()-d->offset;
     if(len <= 0)
         return 0;
-    if(d->resource.isCompressed())
-        memcpy(data, d->uncompressed.constData()+d->offset, len);
-    else
+    if (d->resource.compressionAlgorithm() == QResource::NoCompression) {
         memcpy(data, d->resource.data()+d->offset, len);
+    } else if (!d->uncompressed.isEmpty()) {
+        memcpy(data, d->uncompressed.constData()+d->offset, len);
+    } else {
+#if QT_CONFIG(zstd)
+        if (d->resource.compressionAlgorithm() != QResource::ZstdCompression
+                || d->readZstd(data, len) != len) {
+            return -1;
+        }
+#else
+        return -1;
+#endif
+    }
     d->offset += len;
     return len;
 }
@@ -1347,11 +1638,7 @@ qint64 QResourceFileEngine::size() const
     Q_D(const QResourceFileEngine);
     if(!d->resource.isValid())
         return 0;
-    if (d->resource.isCompressed()) {
-        d->uncompress();
-        return d->uncompressed.size();
-    }
-    return d->resource.size();
+    return d->uncompressedSize();
 }
 
 qint64 QResourceFileEngine::pos() const
@@ -1508,12 +1795,18 @@ uchar *QResourceFileEnginePrivate::map(qint64 offset, qint64 size, QFile::Memory
 {
     Q_Q(QResourceFileEngine);
     Q_UNUSED(flags);
-    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > resource.size()) {
+    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > uncompressedSize()) {
         q->setError(QFile::UnspecifiedError, QString());
         return 0;
     }
-    uchar *address = const_cast<uchar *>(resource.data());
-    return (address + offset);
+    const uchar *address = resource.data();
+    if (resource.compressionAlgorithm() != QResource::NoCompression) {
+        uncompress();
+        if (uncompressed.isEmpty())
+            return 0;
+        address = reinterpret_cast<const uchar *>(uncompressed.constData());
+    }
+    return const_cast<uchar *>(address) + offset;
 }
 
 bool QResourceFileEnginePrivate::unmap(uchar *ptr)
@@ -1525,13 +1818,77 @@ bool QResourceFileEnginePrivate::unmap(uchar *ptr)
 void QResourceFileEnginePrivate::uncompress() const
 {
     if (resource.isCompressed() && uncompressed.isEmpty() && resource.size()) {
-#ifndef QT_NO_COMPRESS
-        uncompressed = qUncompress(resource.data(), resource.size());
-#else
-        Q_ASSERT(!"QResourceFileEngine::open: Qt built without support for compression");
+#ifdef QT_NO_COMPRESS
+        if (resource.compressionAlgorithm() == QResource::ZlibCompression)
+            Q_ASSERT(!"QResourceFileEngine::open: Qt built without support for compression");
 #endif
+        uncompressed = resource.uncompressedData();
+    }
+}
+
+qint64 QResourceFileEnginePrivate::uncompressedSize() const
+{
+    switch (resource.compressionAlgorithm()) {
+    case QResource::NoCompression:
+        break;
+    case QResource::ZlibCompression:
+        uncompress();
+        return uncompressed.size();
+    case QResource::ZstdCompression:
+        if (!uncompressed.isEmpty())
+            return uncompressed.size();
+#if QT_CONFIG(zstd)
+        if (readZstdFrames())
+            return zstdFrames.uncompressedSize();
+#endif
+        return 0;
+    }
+    return resource.size();
+}
+
+#if QT_CONFIG(zstd)
+bool QResourceFileEnginePrivate::readZstdFrames() const
+{
+    if (zstdFrames.frameCount())
+        return true;
+    return zstdFrames.read(resource.data(), resource.size());
+}
+
+qint64 QResourceFileEnginePrivate::readZstd(char *data, qint64 len) const
+{
+    if (!readZstdFrames())
+        return -1;
+    if (!zstdContext && !(zstdContext = ZSTD_createDCtx()))
+        return -1;
+
+    const uchar *compressed = resource.data();
+    qint64 done = 0;
+    while (done < len) {
+        const qint64 pos = offset + done;
+        const int frame = zstdFrames.frameAt(pos);
+        const qint64 frameStart = zstdFrames.uncompressedOffset(frame);
+        const qint64 frameSize = zstdFrames.uncompressedFrameSize(frame);
+        const qint64 chunk = qMin(len - done, frameStart + frameSize - pos);
+
+        if (frame != bufferedFrame && chunk == frameSize) {
+            // the whole frame is wanted: decompress it straight into the caller's buffer
+            if (!zstdFrames.decompressFrame(zstdContext, compressed, frame, data + done))
+                return -1;
+        } else {
+            if (frame != bufferedFrame) {
+                frameBuffer.resize(int(frameSize));
+                bufferedFrame = -1;
+                if (!zstdFrames.decompressFrame(zstdContext, compressed, frame, frameBuffer.data()))
+                    return -1;
+                bufferedFrame = frame;
+            }
+            memcpy(data + done, frameBuffer.constData() + (pos - frameStart), chunk);
+        }
+        done += chunk;
     }
+    return done;
 }
+#endif // QT_CONFIG(zstd)
 
 #endif // !defined(QT_BOOTSTRAPPED)
 
@@ -49,6 +49,7 @@
 #include "qdir.h"
 #include "qfileinfo.h"
 #include "qmutex.h"
+#include "qset.h"
 #include "qlibraryinfo.h"
 #include "qtemporaryfile.h"
 #include "qstandardpaths.h"
@@ -152,7 +153,8 @@ static QBasicMutex settingsGlobalMutex;
 static QSettings::Format globalDefaultFormat = QSettings::NativeFormat;
 
 QConfFile::QConfFile(const QString &fileName, bool _userPerms)
-    : name(fileName), size(0), ref(1), userPerms(_userPerms)
+    : name(fileName), size(0), unparsedIniKeys(0), liveIniKeys(0), staleIniLines(0),
+      ref(1), userPerms(_userPerms)
 {
     usedHashFunc()->insert(name, this);
 }
@@ -574,10 +576,17 @@ bool QSettingsPrivate::iniUnescapedKey(const QByteArray &key, int from, int to,
         }
 
         if (ch != '%' || i == to - 1) {
-            if (uint(ch - 'A') <= 'Z' - 'A') // only for ASCII
-                lowercaseOnly = false;
-            result += QLatin1Char(ch);
-            ++i;
+            // append the run of plain characters at once
+            int runEnd = i;
+            do {
+                if (uint(ch - 'A') <= 'Z' - 'A') // only for ASCII
+                    lowercaseOnly = false;
+                if (++runEnd == to)
+                    break;
+                ch = (uchar)key.at(runEnd);
+            } while (ch != '\\' && ch != '%');
+            result += QLatin1String(key.constData() + i, runEnd - i);
+            i = runEnd;
             continue;
         }
 
@@ -1227,6 +1236,37 @@ QConfFileSettingsPrivate::~QConfFileSettingsPrivate()
     }
 }
 
+namespace {
+struct IniIndexLess
+{
+    explicit IniIndexLess(const QString &keys) : keys(keys) {}
+
+    bool operator()(const QSettingsIniIndexEntry &e1, const QSettingsIniIndexEntry &e2) const
+    {
+        return QStringRef(&keys, e1.key, e1.keyLength) < QStringRef(&keys, e2.key, e2.keyLength);
+    }
+    bool operator()(const QSettingsIniIndexEntry &e, const QString &key) const
+    {
+        return QStringRef(&keys, e.key, e.keyLength) < QStringRef(&key);
+    }
+
+    const QString &keys;
+};
+} // unnamed namespace
+
+static void markIniKeyParsed(QConfFile *confFile, QSettingsIniIndexEntry *entry)
+{
+    entry->valueStart = -1;
+
+    // everything is in originalKeys now; let go of the file contents
+    if (--confFile->unparsedIniKeys == 0) {
+        confFile->iniData.clear();
+        confFile->iniKeys.clear();
+        confFile->iniIndex.clear();
+        confFile->mappedFile.reset();
+    }
+}
+
 void QConfFileSettingsPrivate::remove(const QString &key)
 {
     if (confFiles.isEmpty())
@@ -1239,8 +1279,8 @@ void QConfFileSettingsPrivate::remove(const QString &key)
     QSettingsKey prefix(key + QLatin1Char('/'), caseSensitivity);
     QMutexLocker locker(&confFile->mutex);
 
-    ensureSectionParsed(confFile, theKey);
-    ensureSectionParsed(confFile, prefix);
+    ensureKeyParsed(confFile, theKey);
+    ensureGroupParsed(confFile, prefix);
 
     ParsedSettingsMap::iterator i = confFile->addedKeys.lowerBound(prefix);
     while (i != confFile->addedKeys.end() && i.key().startsWith(prefix))
@@ -1284,7 +1324,7 @@ bool QConfFileSettingsPrivate::get(const QString &key, QVariant *value) const
             found = (j != confFile->addedKeys.constEnd());
         }
         if (!found) {
-            ensureSectionParsed(confFile, theKey);
+            ensureKeyParsed(confFile, theKey);
             j = confFile->originalKeys.constFind(theKey);
             found = (j != confFile->originalKeys.constEnd()
                      && !confFile->removedKeys.contains(theKey));
@@ -1312,10 +1352,23 @@ QStringList QConfFileSettingsPrivate::children(const QString &prefix, ChildSpec
     for (auto confFile : qAsConst(confFiles)) {
         QMutexLocker locker(&confFile->mutex);
 
-        if (thePrefix.isEmpty())
-            ensureAllSectionsParsed(confFile);
-        else
-            ensureSectionParsed(confFile, thePrefix);
+        /*
+            Keys whose values haven't been parsed yet are listed
+            straight from the index; there's no need to parse them.
+        */
+        if (confFile->unparsedIniKeys != 0) {
+            const QSettingsIniIndex &index = confFile->iniIndex;
+            QSettingsIniIndex::const_iterator e = std::lower_bound(index.constBegin(), index.constEnd(),
+                                                                   thePrefix, IniIndexLess(confFile->iniKeys));
+            for (; e != index.constEnd(); ++e) {
+                const QStringRef key(&confFile->iniKeys, e->key, e->keyLength);
+                if (!key.startsWith(thePrefix))
+                    break;
+                if (e->valueStart != -1)
+                    processChild(QStringRef(&confFile->iniKeys, e->originalKey + startPos,
+                                            e->originalKeyLength - startPos), spec, result);
+            }
+        }
 
         j = const_cast<const ParsedSettingsMap *>(
                 &confFile->originalKeys)->lowerBound( thePrefix);
@@ -1350,7 +1403,7 @@ void QConfFileSettingsPrivate::clear()
     QConfFile *confFile = confFiles.at(0);
 
     QMutexLocker locker(&confFile->mutex);
-    ensureAllSectionsParsed(confFile);
+    ensureAllKeysParsed(confFile);
     confFile->addedKeys.clear();
     confFile->removedKeys = confFile->originalKeys;
 }
@@ -1438,7 +1491,13 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
                         || (confFile->size != 0 && confFile->timeStamp != fileInfo.lastModified()));
 
     if (mustReadFile) {
-        confFile->unparsedIniSections.clear();
+        confFile->iniData.clear();
+        confFile->iniKeys.clear();
+        confFile->iniIndex.clear();
+        confFile->unparsedIniKeys = 0;
+        confFile->liveIniKeys = 0;
+        confFile->staleIniLines = 0;
+        confFile->mappedFile.reset();
         confFile->originalKeys.clear();
 
         QFile file(confFile->name);
@@ -1460,8 +1519,34 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
             } else
 #endif
             if (format <= QSettings::IniFormat) {
-                QByteArray data = file.readAll();
-                ok = readIniFile(data, &confFile->unparsedIniSections);
+                QByteArray data;
+#ifndef QT_BOOTSTRAPPED
+                /*
+                    In mapping mode, the index refers to the mapped file
+                    directly, and the mapping is kept until every value
+                    has been parsed.
+                */
+                if (iniMapping) {
+                    QScopedPointer<QFile> mappedFile(new QFile(confFile->name));
+                    if (mappedFile->open(QFile::ReadOnly)) {
+                        const qint64 mappedSize = mappedFile->size();
+                        if (mappedSize > 0 && mappedSize < INT_MAX) {
+                            if (uchar *map = mappedFile->map(0, mappedSize)) {
+                                data = QByteArray::fromRawData(reinterpret_cast<const char *>(map),
+                                                               int(mappedSize));
+                                confFile->mappedFile.swap(mappedFile);
+                            }
+                        }
+                    }
+                }
+#endif
+                if (data.isNull())
+                    data = file.readAll();
+                ok = readIniFile(data, &confFile->iniKeys, &confFile->iniIndex,
+                                 &confFile->staleIniLines);
+                confFile->iniData = data;
+                confFile->unparsedIniKeys = confFile->iniIndex.size();
+                confFile->liveIniKeys = confFile->iniIndex.size();
             } else if (readFunc) {
                 QSettings::SettingsMap tempNewKeys;
                 ok = readFunc(file, tempNewKeys);
@@ -1490,7 +1575,21 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
     */
     if (!readOnly) {
         bool ok = false;
-        ensureAllSectionsParsed(confFile);
+
+        /*
+            In mapping mode, changes are appended to the file as long as
+            no keys were removed and the stale lines left behind by
+            earlier appends don't outnumber the live keys. Otherwise the
+            file is compacted by rewriting it below.
+        */
+        if (iniMapping && format <= QSettings::IniFormat && !createFile
+                && confFile->removedKeys.isEmpty()
+                && confFile->staleIniLines <= confFile->liveIniKeys) {
+            if (appendIniFile(confFile))
+                return;
+        }
+
+        ensureAllKeysParsed(confFile);
         ParsedSettingsMap mergedKeys = confFile->mergedKeyMap();
 
 #if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(temporaryfile)
@@ -1528,8 +1627,9 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
 #endif
 
         if (ok) {
-            confFile->unparsedIniSections.clear();
             confFile->originalKeys = mergedKeys;
+            confFile->liveIniKeys = mergedKeys.size();
+            confFile->staleIniLines = 0;
             confFile->addedKeys.clear();
             confFile->removedKeys.clear();
 
@@ -1640,34 +1740,33 @@ break_out_of_outer_loop:
 }
 
 /*
+    Builds the index of \a data: the full keys are unescaped into \a keys,
+    and \a index receives one entry per distinct key, sorted, referring to
+    the raw value in \a data. If a key occurs several times, the last value
+    wins, as the key was overridden by a later section of the file; such
+    lines, and repeated section headers, are counted in \a staleLines.
+
     Returns \c false on parse error. However, as many keys are read as
     possible, so if the user doesn't check the status he will get the
     most out of the file anyway.
 */
-bool QConfFileSettingsPrivate::readIniFile(const QByteArray &data,
-                                           UnparsedSettingsMap *unparsedIniSections)
+bool QConfFileSettingsPrivate::readIniFile(const QByteArray &data, QString *keys,
+                                           QSettingsIniIndex *index, int *staleLines)
 {
-#define FLUSH_CURRENT_SECTION() \
-    { \
-        QByteArray &sectionData = (*unparsedIniSections)[QSettingsKey(currentSection, \
-                                                                      IniCaseSensitivity, \
-                                                                      sectionPosition)]; \
-        if (!sectionData.isEmpty()) \
-            sectionData.append('\n'); \
-        sectionData += data.mid(currentSectionStart, lineStart - currentSectionStart); \
-        sectionPosition = ++position; \
-    }
-
     QString currentSection;
-    int currentSectionStart = 0;
+    QString key;
+    bool sectionIsLowercase = true;
+    QSet<QString> sections;
+    QVector<int> sectionStarts(1, 0);
     int dataPos = 0;
     int lineStart;
     int lineLen;
     int equalsPos;
     int position = 0;
-    int sectionPosition = 0;
     bool ok = true;
 
+    *staleLines = 0;
+
 #ifndef QT_NO_TEXTCODEC
     // detect utf8 BOM
     const uchar *dd = (const uchar *)data.constData();
@@ -1680,8 +1779,6 @@ bool QConfFileSettingsPrivate::readIniFile(const QByteArray &data,
     while (readIniLine(data, dataPos, lineStart, lineLen, equalsPos)) {
         char ch = data.at(lineStart);
         if (ch == '[') {
-            FLUSH_CURRENT_SECTION();
-
             // this is a section
             QByteArray iniSection;
             int idx = data.indexOf(']', lineStart);
@@ -1696,80 +1793,105 @@ bool QConfFileSettingsPrivate::readIniFile(const QByteArray &data,
 
             if (qstricmp(iniSection.constData(), "general") == 0) {
                 currentSection.clear();
+                sectionIsLowercase = true;
             } else {
                 if (qstricmp(iniSection.constData(), "%general") == 0) {
                     currentSection = QLatin1String(iniSection.constData() + 1);
+                    sectionIsLowercase = false;
                 } else {
                     currentSection.clear();
-                    iniUnescapedKey(iniSection, 0, iniSection.size(), currentSection);
+                    sectionIsLowercase = iniUnescapedKey(iniSection, 0, iniSection.size(),
+                                                         currentSection);
                 }
                 currentSection += QLatin1Char('/');
             }
-            currentSectionStart = dataPos;
+            if (sections.contains(currentSection))
+                ++*staleLines;
+            else
+                sections.insert(currentSection);
+            if (sectionStarts.constLast() != index->size())
+                sectionStarts.append(index->size());
+        } else if (equalsPos == -1) {
+            if (ch != ';')
+                ok = false;
+        } else {
+            int keyEnd = equalsPos;
+            while (keyEnd > lineStart && ((ch = data.at(keyEnd - 1)) == ' ' || ch == '\t'))
+                --keyEnd;
+
+            key.resize(0);
+            key += currentSection;
+            bool keyIsLowercase = (iniUnescapedKey(data, lineStart, keyEnd, key)
+                                   && sectionIsLowercase);
+
+            QSettingsIniIndexEntry entry;
+            entry.originalKey = keys->size();
+            entry.originalKeyLength = key.size();
+            *keys += key;
+
+            /*
+                We try to avoid the expensive toLower() call by
+                comparing the key as is when it's already in lowercase.
+            */
+            if (IniCaseSensitivity == Qt::CaseInsensitive && !keyIsLowercase) {
+                const QString lower = key.toLower();
+                entry.key = keys->size();
+                entry.keyLength = lower.size();
+                *keys += lower;
+            } else {
+                entry.key = entry.originalKey;
+                entry.keyLength = entry.originalKeyLength;
+            }
+            entry.position = position;
+            entry.valueStart = equalsPos + 1;
+            entry.valueEnd = lineStart + lineLen;
+            index->append(entry);
         }
         ++position;
     }
 
     Q_ASSERT(lineStart == data.length());
-    FLUSH_CURRENT_SECTION();
-
-    return ok;
-
-#undef FLUSH_CURRENT_SECTION
-}
-
-bool QConfFileSettingsPrivate::readIniSection(const QSettingsKey &section, const QByteArray &data,
-                                              ParsedSettingsMap *settingsMap, QTextCodec *codec)
-{
-    QStringList strListValue;
-    bool sectionIsLowercase = (section == section.originalCaseKey());
-    int equalsPos;
-
-    bool ok = true;
-    int dataPos = 0;
-    int lineStart;
-    int lineLen;
-    int position = section.originalKeyPosition();
-
-    while (readIniLine(data, dataPos, lineStart, lineLen, equalsPos)) {
-        char ch = data.at(lineStart);
-        Q_ASSERT(ch != '[');
 
-        if (equalsPos == -1) {
-            if (ch != ';')
-                ok = false;
-            continue;
+    /*
+        Sort the keys of each section, then merge the sections. Both are
+        usually in order already, at least in files written by QSettings.
+        The sort is stable, so that of equal keys, the first has the
+        original position and the last has the current value.
+    */
+    if (sectionStarts.constLast() != index->size())
+        sectionStarts.append(index->size());
+    const IniIndexLess lessThan(*keys);
+    const QSettingsIniIndex::iterator begin = index->begin();
+    const int sectionCount = sectionStarts.size() - 1;
+    for (int i = 0; i < sectionCount; ++i) {
+        QSettingsIniIndex::iterator first = begin + sectionStarts.at(i);
+        QSettingsIniIndex::iterator last = begin + sectionStarts.at(i + 1);
+        if (!std::is_sorted(first, last, lessThan))
+            std::stable_sort(first, last, lessThan);
+    }
+    for (int width = 1; width < sectionCount; width *= 2) {
+        for (int i = 0; i + width < sectionCount; i += 2 * width) {
+            QSettingsIniIndex::iterator middle = begin + sectionStarts.at(i + width);
+            if (lessThan(*middle, *(middle - 1))) {
+                std::inplace_merge(begin + sectionStarts.at(i), middle,
+                                   begin + sectionStarts.at(qMin(i + 2 * width, sectionCount)),
+                                   lessThan);
+            }
         }
+    }
 
-        int keyEnd = equalsPos;
-        while (keyEnd > lineStart && ((ch = data.at(keyEnd - 1)) == ' ' || ch == '\t'))
-            --keyEnd;
-        int valueStart = equalsPos + 1;
-
-        QString key = section.originalCaseKey();
-        bool keyIsLowercase = (iniUnescapedKey(data, lineStart, keyEnd, key) && sectionIsLowercase);
-
-        QString strValue;
-        strValue.reserve(lineLen - (valueStart - lineStart));
-        bool isStringList = iniUnescapedStringList(data, valueStart, lineStart + lineLen,
-                                                   strValue, strListValue, codec);
-        QVariant variant;
-        if (isStringList) {
-            variant = stringListToVariantList(strListValue);
-        } else {
-            variant = stringToVariant(strValue);
+    if (!index->isEmpty()) {
+        QSettingsIniIndex::iterator out = index->begin();
+        for (QSettingsIniIndex::const_iterator in = out + 1; in != index->constEnd(); ++in) {
+            if (lessThan(*out, *in)) {
+                *++out = *in;
+            } else {
+                out->valueStart = in->valueStart;
+                out->valueEnd = in->valueEnd;
+                ++*staleLines;
+            }
         }
-
-        /*
-            We try to avoid the expensive toLower() call in
-            QSettingsKey by passing Qt::CaseSensitive when the
-            key is already in lowercase.
-        */
-        settingsMap->insert(QSettingsKey(key, keyIsLowercase ? Qt::CaseSensitive
-                                                             : IniCaseSensitivity,
-                                         position),
-                            variant);
-        ++position;
+        index->erase(out + 1, index->end());
     }
 
     return ok;
@@ -1899,43 +2021,123 @@ bool QConfFileSettingsPrivate::writeIniFile(QIODevice &device, const ParsedSetti
     return !writeError;
 }
 
-void QConfFileSettingsPrivate::ensureAllSectionsParsed(QConfFile *confFile) const
+/*
+    Appends the added keys of \a confFile to the file, as new sections.
+    Since keys read later override the ones read earlier, this has the
+    same effect as rewriting the file, at a cost that doesn't depend on
+    the size of the file. Returns \c false if the keys couldn't be
+    appended, in which case the file must be rewritten.
+*/
+bool QConfFileSettingsPrivate::appendIniFile(QConfFile *confFile)
 {
-    UnparsedSettingsMap::const_iterator i = confFile->unparsedIniSections.constBegin();
-    const UnparsedSettingsMap::const_iterator end = confFile->unparsedIniSections.constEnd();
+#ifdef Q_OS_WIN
+    const char * const eol = "\r\n";
+#else
+    const char eol = '\n';
+#endif
+
+    QFile file(confFile->name);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+    if (file.write(QByteArray() + eol) == -1 || !writeIniFile(file, confFile->addedKeys))
+        return false;
+    file.close();
+    if (file.error() != QFile::NoError)
+        return false;
 
-    for (; i != end; ++i) {
-        if (!QConfFileSettingsPrivate::readIniSection(i.key(), i.value(), &confFile->originalKeys, iniCodec))
-            setStatus(QSettings::FormatError);
+    ParsedSettingsMap::const_iterator i;
+    for (i = confFile->addedKeys.constBegin(); i != confFile->addedKeys.constEnd(); ++i) {
+        bool overridden = confFile->originalKeys.contains(i.key());
+        if (!overridden && confFile->unparsedIniKeys != 0) {
+            QSettingsIniIndex &index = confFile->iniIndex;
+            QSettingsIniIndex::iterator e = std::lower_bound(index.begin(), index.end(), i.key(),
+                                                             IniIndexLess(confFile->iniKeys));
+            if (e != index.end() && e->valueStart != -1
+                    && QStringRef(&confFile->iniKeys, e->key, e->keyLength) == i.key()) {
+                overridden = true;
+                markIniKeyParsed(confFile, e);
+            }
+        }
+        if (overridden)
+            ++confFile->staleIniLines;
+        else
+            ++confFile->liveIniKeys;
+        confFile->originalKeys.insert(i.key(), i.value());
     }
-    confFile->unparsedIniSections.clear();
+    // roughly account for the section headers
+    ++confFile->staleIniLines;
+    confFile->addedKeys.clear();
+
+    QFileInfo fileInfo(confFile->name);
+    confFile->size = fileInfo.size();
+    confFile->timeStamp = fileInfo.lastModified();
+    return true;
 }
 
-void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
-                                                   const QSettingsKey &key) const
+void QConfFileSettingsPrivate::parseIniKey(QConfFile *confFile, QSettingsIniIndexEntry *entry) const
 {
-    if (confFile->unparsedIniSections.isEmpty())
-        return;
+    Q_ASSERT(entry->valueStart != -1);
 
-    UnparsedSettingsMap::iterator i;
-
-    int indexOfSlash = key.indexOf(QLatin1Char('/'));
-    if (indexOfSlash != -1) {
-        i = confFile->unparsedIniSections.upperBound(key);
-        if (i == confFile->unparsedIniSections.begin())
-            return;
-        --i;
-        if (i.key().isEmpty() || !key.startsWith(i.key()))
-            return;
+    QString strValue;
+    QStringList strListValue;
+    strValue.reserve(entry->valueEnd - entry->valueStart);
+    bool isStringList = iniUnescapedStringList(confFile->iniData, entry->valueStart, entry->valueEnd,
+                                               strValue, strListValue, iniCodec);
+    QVariant variant;
+    if (isStringList) {
+        variant = stringListToVariantList(strListValue);
     } else {
-        i = confFile->unparsedIniSections.begin();
-        if (i == confFile->unparsedIniSections.end() || !i.key().isEmpty())
-            return;
+        variant = stringToVariant(strValue);
     }
 
-    if (!QConfFileSettingsPrivate::readIniSection(i.key(), i.value(), &confFile->originalKeys, iniCodec))
-        setStatus(QSettings::FormatError);
-    confFile->unparsedIniSections.erase(i);
+    const QString key = confFile->iniKeys.mid(entry->originalKey, entry->originalKeyLength);
+    confFile->originalKeys.insert(QSettingsKey(key, entry->key == entry->originalKey
+                                                    ? Qt::CaseSensitive : IniCaseSensitivity,
+                                               entry->position),
+                                  variant);
+    markIniKeyParsed(confFile, entry);
+}
+
+void QConfFileSettingsPrivate::ensureAllKeysParsed(QConfFile *confFile) const
+{
+    QSettingsIniIndex &index = confFile->iniIndex;
+    for (int i = 0; confFile->unparsedIniKeys != 0 && i < index.size(); ++i) {
+        if (index.at(i).valueStart != -1)
+            parseIniKey(confFile, &index[i]);
+    }
+}
+
+void QConfFileSettingsPrivate::ensureKeyParsed(QConfFile *confFile,
+                                               const QSettingsKey &key) const
+{
+    if (confFile->unparsedIniKeys == 0)
+        return;
+
+    QSettingsIniIndex &index = confFile->iniIndex;
+    QSettingsIniIndex::iterator e = std::lower_bound(index.begin(), index.end(), key,
+                                                     IniIndexLess(confFile->iniKeys));
+    if (e != index.end() && e->valueStart != -1
+            && QStringRef(&confFile->iniKeys, e->key, e->keyLength) == key) {
+        parseIniKey(confFile, e);
+    }
+}
+
+void QConfFileSettingsPrivate::ensureGroupParsed(QConfFile *confFile,
+                                                 const QSettingsKey &prefix) const
+{
+    if (confFile->unparsedIniKeys == 0)
+        return;
+
+    QSettingsIniIndex &index = confFile->iniIndex;
+    int i = std::lower_bound(index.constBegin(), index.constEnd(), prefix,
+                             IniIndexLess(confFile->iniKeys)) - index.constBegin();
+    for (; confFile->unparsedIniKeys != 0 && i < index.size(); ++i) {
+        QSettingsIniIndexEntry &entry = index[i];
+        if (!QStringRef(&confFile->iniKeys, entry.key, entry.keyLength).startsWith(prefix))
+            break;
+        if (entry.valueStart != -1)
+            parseIniKey(confFile, &entry);
+    }
 }
 
 /*!
@@ -2934,6 +3136,54 @@ void QSettings::setAtomicSyncRequired(bool enable)
     d->atomicSyncOnly = enable;
 }
 
+/*!
+    \since 5.10
+
+    Returns \c true if INI files are memory-mapped and changes are
+    appended to them; otherwise returns \c false.
+
+    The default is \c false.
+
+    \sa setIniMappingEnabled()
+*/
+bool QSettings::isIniMappingEnabled() const
+{
+    Q_D(const QSettings);
+    return d->iniMapping;
+}
+
+/*!
+    \since 5.10
+
+    Configures how QSettings accesses a file in \l IniFormat. If the
+    \a enable argument is \c true, the file is mapped into memory
+    instead of being read, and sync() appends the changed keys to the
+    end of the file instead of rewriting it. The file is rewritten in
+    full when keys have been removed, or when the overridden entries
+    have accumulated; other INI readers, including older versions of
+    QSettings, see the same settings either way.
+
+    Independently of this setting, QSettings only parses the value of a
+    key in an INI file when it is first read.
+
+    The mode applies to the next time the file is read or written; a
+    file is read when the QSettings object is constructed, and again by
+    sync() when it has been changed by another process.
+
+    Appending is not atomic, regardless of isAtomicSyncRequired(): a
+    process reading the file concurrently can see a partially written
+    key. The mapping also requires that the file is only ever replaced,
+    never truncated in place, while it is in use. Use this mode for
+    large files that are read often and changed a few keys at a time.
+
+    \sa isIniMappingEnabled(), sync()
+*/
+void QSettings::setIniMappingEnabled(bool enable)
+{
+    Q_D(QSettings);
+    d->iniMapping = enable;
+}
+
 /*!
     Appends \a prefix to the current group.
 
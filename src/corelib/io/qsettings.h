@@ -148,6 +148,8 @@ public:
     Status status() const;
     bool isAtomicSyncRequired() const;
     void setAtomicSyncRequired(bool enable);
+    bool isIniMappingEnabled() const;
+    void setIniMappingEnabled(bool enable);
 
     void beginGroup(const QString &prefix);
     void endGroup();
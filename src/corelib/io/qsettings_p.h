@@ -57,6 +57,7 @@
 #include "QtCore/qiodevice.h"
 #include "QtCore/qstack.h"
 #include "QtCore/qstringlist.h"
+#include "QtCore/qvector.h"
 #ifndef QT_NO_QOBJECT
 #include "private/qobject_p.h"
 #endif
@@ -64,6 +65,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QFile;
+
 #ifndef Q_OS_WIN
 #define QT_QSETTINGS_ALWAYS_CASE_SENSITIVE_AND_FORGET_ORIGINAL_KEY_ORDER
 #endif
@@ -111,9 +114,29 @@ private:
 
 Q_DECLARE_TYPEINFO(QSettingsKey, Q_MOVABLE_TYPE);
 
-typedef QMap<QSettingsKey, QByteArray> UnparsedSettingsMap;
 typedef QMap<QSettingsKey, QVariant> ParsedSettingsMap;
 
+/*
+    One key of an INI file whose value has not been parsed yet. The
+    key strings live in QConfFile::iniKeys and the raw value in
+    QConfFile::iniData; both are referred to by offset, so that the
+    index of a large file is a single allocation.
+*/
+struct QSettingsIniIndexEntry
+{
+    int key;                // key as compared by QSettingsKey
+    int keyLength;
+    int originalKey;        // key as written in the file
+    int originalKeyLength;
+    int position;
+    int valueStart;         // -1 once the value has been parsed
+    int valueEnd;
+};
+Q_DECLARE_TYPEINFO(QSettingsIniIndexEntry, Q_PRIMITIVE_TYPE);
+
+// sorted by QSettingsIniIndexEntry::key
+typedef QVector<QSettingsIniIndexEntry> QSettingsIniIndex;
+
 class QSettingsGroup
 {
 public:
@@ -162,7 +185,13 @@ public:
     QString name;
     QDateTime timeStamp;
     qint64 size;
-    UnparsedSettingsMap unparsedIniSections;
+    QByteArray iniData;
+    QString iniKeys;
+    QSettingsIniIndex iniIndex;
+    int unparsedIniKeys;
+    int liveIniKeys;
+    int staleIniLines;
+    QScopedPointer<QFile> mappedFile;
     ParsedSettingsMap originalKeys;
     ParsedSettingsMap addedKeys;
     ParsedSettingsMap removedKeys;
@@ -250,6 +279,7 @@ protected:
     bool fallbacks;
     bool pendingChanges;
     bool atomicSyncOnly = true;
+    bool iniMapping = false;
     mutable QSettings::Status status;
 };
 
@@ -273,9 +303,8 @@ public:
     bool isWritable() const Q_DECL_OVERRIDE;
     QString fileName() const Q_DECL_OVERRIDE;
 
-    bool readIniFile(const QByteArray &data, UnparsedSettingsMap *unparsedIniSections);
-    static bool readIniSection(const QSettingsKey &section, const QByteArray &data,
-                               ParsedSettingsMap *settingsMap, QTextCodec *codec);
+    bool readIniFile(const QByteArray &data, QString *keys, QSettingsIniIndex *index,
+                     int *staleLines);
     static bool readIniLine(const QByteArray &data, int &dataPos, int &lineStart, int &lineLen,
                             int &equalsPos);
 
@@ -284,12 +313,15 @@ private:
     void initAccess();
     void syncConfFile(QConfFile *confFile);
     bool writeIniFile(QIODevice &device, const ParsedSettingsMap &map);
+    bool appendIniFile(QConfFile *confFile);
 #ifdef Q_OS_MAC
     bool readPlistFile(const QByteArray &data, ParsedSettingsMap *map) const;
     bool writePlistFile(QIODevice &file, const ParsedSettingsMap &map) const;
 #endif
-    void ensureAllSectionsParsed(QConfFile *confFile) const;
-    void ensureSectionParsed(QConfFile *confFile, const QSettingsKey &key) const;
+    void ensureAllKeysParsed(QConfFile *confFile) const;
+    void ensureKeyParsed(QConfFile *confFile, const QSettingsKey &key) const;
+    void ensureGroupParsed(QConfFile *confFile, const QSettingsKey &prefix) const;
+    void parseIniKey(QConfFile *confFile, QSettingsIniIndexEntry *entry) const;
 
     QVector<QConfFile *> confFiles;
     QSettings::ReadFunc readFunc;
@@ -57,7 +57,10 @@
 #include <qjsondocument.h>
 #include <qjsonarray.h>
 #include <qatomic.h>
+#include <qhash.h>
+#include <qmutex.h>
 #include <qstring.h>
+#include <qvector.h>
 #include <qendian.h>
 #include <qnumeric.h>
 
@@ -689,6 +692,42 @@ inline Base *Value::base(const Base *b) const
     return reinterpret_cast<Base *>(data(b));
 }
 
+/*
+    Backs a document created by QJsonDocument::fromJson() with
+    QJsonDocument::ParseLazily. Instead of the binary tree, it keeps the text
+    and the offsets of its structural characters. Single members of the
+    top-level object or array can be looked up from these directly; anything
+    else parses the whole document into the binary format first.
+*/
+class LazyDocument
+{
+public:
+    struct Token {
+        int offset;     // of the structural character in json
+        int match;      // for '{' and '[': the index of the closing token
+    };
+
+    explicit LazyDocument(const QByteArray &text)
+        : json(text), isObject(false)
+    {}
+
+    bool index(QJsonParseError *error);
+    bool value(const QString &key, QJsonValue *value);
+    bool value(int i, QJsonValue *value);
+
+    QByteArray json;
+    QVector<Token> tokens;
+    QHash<int, QJsonValue> values; // parsed so far, by the index of the token before them
+    QMutex mutex;
+    QAtomicInt parsed;
+    bool isObject;
+
+private:
+    bool validate(QJsonParseError::ParseError *error, const char **where) const;
+    bool parseValue(const char *begin, const char *end, QJsonValue *value) const;
+    bool cachedValue(int token, const char *begin, const char *end, QJsonValue *value);
+};
+
 class Data {
 public:
     enum Validation {
@@ -705,13 +744,18 @@ public:
     };
     uint compactionCounter : 31;
     uint ownsData : 1;
+    LazyDocument *lazy;
 
     inline Data(char *raw, int a)
-        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true)
+        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true), lazy(0)
+    {
+    }
+    explicit inline Data(LazyDocument *l)
+        : alloc(0), rawData(0), compactionCounter(0), ownsData(true), lazy(l)
     {
     }
     inline Data(int reserved, QJsonValue::Type valueType)
-        : rawData(0), compactionCounter(0), ownsData(true)
+        : rawData(0), compactionCounter(0), ownsData(true), lazy(0)
     {
         Q_ASSERT(valueType == QJsonValue::Array || valueType == QJsonValue::Object);
 
@@ -727,7 +771,13 @@ public:
         b->length = 0;
     }
     inline ~Data()
-    { if (ownsData) free(rawData); }
+    { if (ownsData) free(rawData); delete lazy; }
+
+    inline bool isLazy() const { return lazy && !lazy->parsed.loadAcquire(); }
+    inline void ensureParsed() { if (Q_UNLIKELY(isLazy())) parseLazyDocument(); }
+    void parseLazyDocument();
+    bool lazyValue(const QString &key, QJsonValue *value);
+    bool lazyValue(int i, QJsonValue *value);
 
     uint offsetOf(const void *ptr) const { return (uint)(((char *)ptr - rawData)); }
 
@@ -771,6 +821,8 @@ public:
     bool valid() const;
 
 private:
+    void parseLazyDocumentLocked();
+
     Q_DISABLE_COPY(Data)
 };
 
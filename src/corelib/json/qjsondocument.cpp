@@ -234,6 +234,7 @@ const char *QJsonDocument::rawData(int *size) const
         *size = 0;
         return 0;
     }
+    d->ensureParsed();
     *size = d->alloc;
     return d->rawData;
 }
@@ -321,6 +322,8 @@ QVariant QJsonDocument::toVariant() const
     if (!d)
         return QVariant();
 
+    d->ensureParsed();
+
     if (d->header->root()->isArray())
         return QJsonArray(d, static_cast<QJsonPrivate::Array *>(d->header->root())).toVariantList();
     else
@@ -376,6 +379,7 @@ QByteArray QJsonDocument::toJson(JsonFormat format) const
     if (!d)
         return json;
 
+    d->ensureParsed();
     if (d->header->root()->isArray())
         QJsonPrivate::Writer::arrayToJson(static_cast<QJsonPrivate::Array *>(d->header->root()), json, 0, (format == Compact));
     else
@@ -401,6 +405,57 @@ QJsonDocument QJsonDocument::fromJson(const QByteArray &json, QJsonParseError *e
     return parser.parse(error);
 }
 
+/*!
+    \enum QJsonDocument::ParseMode
+    \since 5.10
+
+    This value defines how much of the document fromJson() parses up front.
+
+    \value ParseEagerly The whole document is parsed and validated right
+           away. This is the default.
+    \value ParseLazily The document is validated and its structure is
+           indexed. Members of the top-level object or array looked up with
+           operator[]() are parsed on demand, and the whole document is
+           parsed the first time it is accessed in any other way, including
+           object() and array().
+*/
+
+/*!
+    \overload
+    \since 5.10
+
+    Parses \a json as a UTF-8 encoded JSON document in the given \a mode.
+
+    With ParseLazily, fromJson() locates the brackets, commas and colons
+    outside of strings and validates the document without building it,
+    which is faster than a full parse, and is worthwhile when only a few
+    members of a large document are read with operator[](). A member or
+    element is parsed the first time operator[]() returns it and kept for
+    later lookups, each of which still walks over the index of the
+    top-level object or array.
+
+    Only the document's own operator[]() is lazy: object(), array() and any
+    other access parse the whole document, after which it behaves like one
+    parsed with ParseEagerly.
+
+    The same errors as with ParseEagerly are reported in \a error, so a
+    document that is not null can be parsed.
+
+    \sa toJson(), QJsonParseError, isNull()
+*/
+QJsonDocument QJsonDocument::fromJson(const QByteArray &json, QJsonParseError *error, ParseMode mode)
+{
+    if (mode == ParseEagerly)
+        return fromJson(json, error);
+
+    QJsonPrivate::LazyDocument *lazy = new QJsonPrivate::LazyDocument(json);
+    if (!lazy->index(error)) {
+        delete lazy;
+        return QJsonDocument();
+    }
+    return QJsonDocument(new QJsonPrivate::Data(lazy));
+}
+
 /*!
     Returns \c true if the document doesn't contain any data.
  */
@@ -426,6 +481,8 @@ bool QJsonDocument::isEmpty() const
  */
 QByteArray QJsonDocument::toBinaryData() const
 {
+    if (d)
+        d->ensureParsed();
     if (!d || !d->rawData)
         return QByteArray();
 
@@ -441,6 +498,8 @@ bool QJsonDocument::isArray() const
 {
     if (!d)
         return false;
+    if (d->lazy)
+        return !d->lazy->isObject;
 
     QJsonPrivate::Header *h = (QJsonPrivate::Header *)d->rawData;
     return h->root()->isArray();
@@ -455,6 +514,8 @@ bool QJsonDocument::isObject() const
 {
     if (!d)
         return false;
+    if (d->lazy)
+        return d->lazy->isObject;
 
     QJsonPrivate::Header *h = (QJsonPrivate::Header *)d->rawData;
     return h->root()->isObject();
@@ -471,6 +532,7 @@ bool QJsonDocument::isObject() const
 QJsonObject QJsonDocument::object() const
 {
     if (d) {
+        d->ensureParsed();
         QJsonPrivate::Base *b = d->header->root();
         if (b->isObject())
             return QJsonObject(d, static_cast<QJsonPrivate::Object *>(b));
@@ -489,6 +551,7 @@ QJsonObject QJsonDocument::object() const
 QJsonArray QJsonDocument::array() const
 {
     if (d) {
+        d->ensureParsed();
         QJsonPrivate::Base *b = d->header->root();
         if (b->isArray())
             return QJsonArray(d, static_cast<QJsonPrivate::Array *>(b));
@@ -567,6 +630,9 @@ const QJsonValue QJsonDocument::operator[](const QString &key) const
     if (!isObject())
         return QJsonValue(QJsonValue::Undefined);
 
+    QJsonValue value;
+    if (d->lazy && d->lazyValue(key, &value))
+        return value;
     return object().value(key);
 }
 
@@ -579,6 +645,9 @@ const QJsonValue QJsonDocument::operator[](QLatin1String key) const
     if (!isObject())
         return QJsonValue(QJsonValue::Undefined);
 
+    QJsonValue value;
+    if (d->lazy && d->lazyValue(key, &value))
+        return value;
     return object().value(key);
 }
 
@@ -599,6 +668,9 @@ const QJsonValue QJsonDocument::operator[](int i) const
     if (!isArray())
         return QJsonValue(QJsonValue::Undefined);
 
+    QJsonValue value;
+    if (d->lazy && d->lazyValue(i, &value))
+        return value;
     return array().at(i);
 }
 
@@ -613,6 +685,8 @@ bool QJsonDocument::operator==(const QJsonDocument &other) const
     if (!d || !other.d)
         return false;
 
+    d->ensureParsed();
+    other.d->ensureParsed();
     if (d->header->root()->isArray() != other.d->header->root()->isArray())
         return false;
 
@@ -652,6 +726,7 @@ QDebug operator<<(QDebug dbg, const QJsonDocument &o)
         dbg << "QJsonDocument()";
         return dbg;
     }
+    o.d->ensureParsed();
     QByteArray json;
     if (o.d->header->root()->isArray())
         QJsonPrivate::Writer::arrayToJson(static_cast<QJsonPrivate::Array *>(o.d->header->root()), json, 0, true);
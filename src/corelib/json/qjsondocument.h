@@ -67,7 +67,8 @@ struct Q_CORE_EXPORT QJsonParseError
         MissingObject,
         DeepNesting,
         DocumentTooLarge,
-        GarbageAtEnd
+        GarbageAtEnd,
+        PrematureEndOfDocument
     };
 
     QString    errorString() const;
@@ -129,7 +130,13 @@ public:
         Compact
     };
 
+    enum ParseMode {
+        ParseEagerly,
+        ParseLazily
+    };
+
     static QJsonDocument fromJson(const QByteArray &json, QJsonParseError *error = Q_NULLPTR);
+    static QJsonDocument fromJson(const QByteArray &json, QJsonParseError *error, ParseMode mode); // ### Qt 6: merge
 
 #ifdef Q_QDOC
     QByteArray toJson(JsonFormat format = Indented) const;
@@ -58,8 +58,6 @@ static int indent = 0;
 #define DEBUG if (1) ; else qDebug()
 #endif
 
-static const int nestingLimit = 1024;
-
 QT_BEGIN_NAMESPACE
 
 // error strings for the JSON parser
@@ -78,6 +76,7 @@ QT_BEGIN_NAMESPACE
 #define JSONERR_DEEP_NEST   QT_TRANSLATE_NOOP("QJsonParseError", "too deeply nested document")
 #define JSONERR_DOC_LARGE   QT_TRANSLATE_NOOP("QJsonParseError", "too large document")
 #define JSONERR_GARBAGEEND  QT_TRANSLATE_NOOP("QJsonParseError", "garbage at the end of the document")
+#define JSONERR_PREMATURE   QT_TRANSLATE_NOOP("QJsonParseError", "premature end of document")
 
 /*!
     \class QJsonParseError
@@ -112,6 +111,10 @@ QT_BEGIN_NAMESPACE
     \value DeepNesting              The JSON document is too deeply nested for the parser to parse it
     \value DocumentTooLarge         The JSON document is too large for the parser to parse it
     \value GarbageAtEnd             The parsed document contains additional garbage characters at the end
+    \value PrematureEndOfDocument   The input ended before the document was complete. This
+                                    error is only reported by QJsonStreamReader, which can
+                                    recover from it once more data is available. This value
+                                    was added in Qt 5.10.
 
 */
 
@@ -187,6 +190,9 @@ QString QJsonParseError::errorString() const
     case GarbageAtEnd:
         sz = JSONERR_GARBAGEEND;
         break;
+    case PrematureEndOfDocument:
+        sz = JSONERR_PREMATURE;
+        break;
     }
 #ifndef QT_BOOTSTRAPPED
     return QCoreApplication::translate("QJsonParseError", sz);
@@ -732,13 +738,9 @@ bool Parser::parseValue(QJsonPrivate::Value *val, int baseOffset)
 
 */
 
-bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
+const char *QJsonPrivate::scanNumber(const char *json, const char *end, bool *isInt)
 {
-    BEGIN << "parseNumber" << json;
-    val->type = QJsonValue::Double;
-
-    const char *start = json;
-    bool isInt = true;
+    *isInt = true;
 
     // minus
     if (json < end && *json == '-')
@@ -754,7 +756,7 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
     // frac = decimal-point 1*DIGIT
     if (json < end && *json == '.') {
-        isInt = false;
+        *isInt = false;
         ++json;
         while (json < end && *json >= '0' && *json <= '9')
             ++json;
@@ -762,7 +764,7 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
     // exp = e [ minus / plus ] 1*DIGIT
     if (json < end && (*json == 'e' || *json == 'E')) {
-        isInt = false;
+        *isInt = false;
         ++json;
         if (json < end && (*json == '-' || *json == '+'))
             ++json;
@@ -770,6 +772,18 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
             ++json;
     }
 
+    return json;
+}
+
+bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
+{
+    BEGIN << "parseNumber" << json;
+    val->type = QJsonValue::Double;
+
+    const char *start = json;
+    bool isInt;
+    json = scanNumber(json, end, &isInt);
+
     if (json >= end) {
         lastError = QJsonParseError::TerminationByNumber;
         return false;
@@ -852,13 +866,12 @@ static inline bool addHexDigit(char digit, uint *result)
     return true;
 }
 
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
+bool QJsonPrivate::scanEscapeSequence(const char *&json, const char *end, uint *ch)
 {
     ++json;
     if (json >= end)
         return false;
 
-    DEBUG << "scan escape" << (char)*json;
     uint escaped = *json++;
     switch (escaped) {
     case '"':
@@ -897,7 +910,7 @@ static inline bool scanEscapeSequence(const char *&json, const char *end, uint *
     return true;
 }
 
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
+bool QJsonPrivate::scanUtf8Char(const char *&json, const char *end, uint *result)
 {
     const uchar *&src = reinterpret_cast<const uchar *&>(json);
     const uchar *uend = reinterpret_cast<const uchar *>(end);
@@ -1024,4 +1037,617 @@ bool Parser::parseString(bool *latin1)
     return true;
 }
 
+/*
+    Lazy parsing
+*/
+
+static inline bool isJsonSpace(char c)
+{
+    return c == Space || c == Tab || c == LineFeed || c == Return;
+}
+
+static inline void trimSpace(const char *&begin, const char *&end)
+{
+    while (begin < end && isJsonSpace(*begin))
+        ++begin;
+    while (end > begin && isJsonSpace(end[-1]))
+        --end;
+}
+
+static inline bool isOnlySpace(const char *begin, const char *end)
+{
+    trimSpace(begin, end);
+    return begin == end;
+}
+
+/*
+    Finds the structural characters of the document outside of strings,
+    pairs up the brackets and checks that they are balanced. Sixteen bytes
+    at a time where SSE2 is available: bytes within strings are masked out
+    with a prefix XOR of the quote positions. Blocks with backslashes are
+    left to the scalar loop, which tracks escapes. Then validate() checks
+    what lies between the structural characters.
+*/
+bool LazyDocument::index(QJsonParseError *error)
+{
+    const char *begin = json.constData();
+    const char *end = begin + json.size();
+    const char *p = begin;
+    QVarLengthArray<int, 64> open;
+    QJsonParseError::ParseError e = QJsonParseError::NoError;
+    const char *where = p;
+    bool inString = false;
+    bool escaped = false;
+
+    if (end - p > 3 && uchar(p[0]) == 0xef && uchar(p[1]) == 0xbb && uchar(p[2]) == 0xbf)
+        p += 3;
+    while (p < end && isJsonSpace(*p))
+        ++p;
+    if (p == end || (*p != BeginObject && *p != BeginArray)) {
+        e = QJsonParseError::IllegalValue;
+        where = p;
+        goto error;
+    }
+    isObject = (*p == BeginObject);
+    tokens.reserve(json.size() / 16);
+
+    {
+        auto addToken = [&](const char *c) {
+            Token t = { int(c - begin), -1 };
+            switch (*c) {
+            case BeginObject:
+            case BeginArray:
+                if (open.isEmpty() && !tokens.isEmpty()) {
+                    e = QJsonParseError::GarbageAtEnd;
+                    return false;
+                }
+                if (open.size() >= nestingLimit) {
+                    e = QJsonParseError::DeepNesting;
+                    return false;
+                }
+                open.append(tokens.size());
+                break;
+            case EndObject:
+            case EndArray:
+                if (open.isEmpty()) {
+                    e = QJsonParseError::GarbageAtEnd;
+                    return false;
+                }
+                if (begin[tokens.at(open.last()).offset] != (*c == EndObject ? BeginObject : BeginArray)) {
+                    e = *c == EndObject ? QJsonParseError::UnterminatedArray : QJsonParseError::UnterminatedObject;
+                    return false;
+                }
+                tokens[open.last()].match = tokens.size();
+                open.removeLast();
+                break;
+            default:
+                if (open.isEmpty()) {
+                    e = QJsonParseError::GarbageAtEnd;
+                    return false;
+                }
+                break;
+            }
+            tokens.append(t);
+            return true;
+        };
+
+        auto scanScalar = [&](const char *c, const char *stop) {
+            for ( ; c < stop; ++c) {
+                if (inString) {
+                    if (escaped)
+                        escaped = false;
+                    else if (*c == '\\')
+                        escaped = true;
+                    else if (*c == Quote)
+                        inString = false;
+                    continue;
+                }
+                switch (*c) {
+                case Quote:
+                    inString = true;
+                    break;
+                case BeginObject:
+                case BeginArray:
+                case EndObject:
+                case EndArray:
+                case NameSeparator:
+                case ValueSeparator:
+                    if (!addToken(c)) {
+                        where = c;
+                        return false;
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+            return true;
+        };
+
+#ifdef __SSE2__
+        const __m128i quote = _mm_set1_epi8(Quote);
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+        const __m128i beginBracket = _mm_set1_epi8(BeginObject);    // '[' | 0x20 == '{'
+        const __m128i endBracket = _mm_set1_epi8(EndObject);        // ']' | 0x20 == '}'
+        const __m128i nameSeparator = _mm_set1_epi8(NameSeparator);
+        const __m128i valueSeparator = _mm_set1_epi8(ValueSeparator);
+        for ( ; end - p >= 16; p += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            if (escaped || _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash))) {
+                if (!scanScalar(p, p + 16))
+                    goto error;
+                continue;
+            }
+
+            // bit i of inside is set if p[i] is within a string (counting
+            // the opening quote, but not the closing one)
+            uint inside = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote));
+            inside ^= inside << 1;
+            inside ^= inside << 2;
+            inside ^= inside << 4;
+            inside ^= inside << 8;
+            if (inString)
+                inside = ~inside;
+            inside &= 0xffff;
+            inString = inside & 0x8000;
+
+            const __m128i lower = _mm_or_si128(chunk, caseBit);
+            const __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(lower, beginBracket),
+                                                  _mm_cmpeq_epi8(lower, endBracket));
+            const __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(chunk, nameSeparator),
+                                                    _mm_cmpeq_epi8(chunk, valueSeparator));
+            uint structural = _mm_movemask_epi8(_mm_or_si128(brackets, separators)) & ~inside;
+            while (structural) {
+                const char *c = p + qCountTrailingZeroBits(structural);
+                if (!addToken(c)) {
+                    where = c;
+                    goto error;
+                }
+                structural &= structural - 1;
+            }
+        }
+#endif
+        if (!scanScalar(p, end))
+            goto error;
+    }
+
+    where = end;
+    if (!open.isEmpty()) {
+        if (inString)
+            e = QJsonParseError::UnterminatedString;
+        else
+            e = begin[tokens.at(open.last()).offset] == BeginObject ? QJsonParseError::UnterminatedObject
+                                                                    : QJsonParseError::UnterminatedArray;
+        goto error;
+    }
+    where = begin + tokens.last().offset + 1;
+    while (where < end && isJsonSpace(*where))
+        ++where;
+    if (where < end) {
+        e = QJsonParseError::GarbageAtEnd;
+        goto error;
+    }
+    if (!validate(&e, &where))
+        goto error;
+
+    if (error) {
+        error->offset = 0;
+        error->error = QJsonParseError::NoError;
+    }
+    return true;
+
+error:
+    if (error) {
+        error->offset = int(where - begin);
+        error->error = e;
+    }
+    tokens.clear();
+    return false;
+}
+
+// returns the end of the string starting at the quote at c, or 0 if it is
+// malformed
+static const char *scanString(const char *c, const char *end, QJsonParseError::ParseError *error)
+{
+    uint ch;
+    ++c;
+    while (c < end) {
+        if (*c == Quote)
+            return c + 1;
+        if (*c == '\\') {
+            if (!scanEscapeSequence(c, end, &ch)) {
+                *error = QJsonParseError::IllegalEscapeSequence;
+                return 0;
+            }
+        } else if (uchar(*c) < 0x80) {
+            ++c;
+        } else if (!scanUtf8Char(c, end, &ch)) {
+            *error = QJsonParseError::IllegalUTF8String;
+            return 0;
+        }
+    }
+    *error = QJsonParseError::UnterminatedString;
+    return 0;
+}
+
+// accepts the same numbers as Parser::parseNumber()
+static bool isValidNumber(const char *begin, const char *end)
+{
+    const char *c = begin;
+    if (c < end && *c == '-')
+        ++c;
+    if (c == end)
+        return false;
+    if (end - c < 10) {
+        const char *digit = c;
+        while (digit < end && *digit >= '0' && *digit <= '9')
+            ++digit;
+        if (digit == end)
+            return true;
+    }
+    bool ok;
+    QByteArray(begin, int(end - begin)).toDouble(&ok);
+    return ok;
+}
+
+/*
+    Checks the literal, number or string in [begin, end), which has no space
+    around it, and that nothing follows it up to the next structural
+    character.
+*/
+static const char *validateScalar(const char *begin, const char *end, bool inObject,
+                                  QJsonParseError::ParseError *error)
+{
+    const char *c = begin;
+    switch (*c) {
+    case Quote:
+        c = scanString(c, end, error);
+        if (!c)
+            return begin;
+        break;
+    case 'n':
+    case 't':
+        if (end - c < 4 || memcmp(c, *c == 'n' ? "null" : "true", 4) != 0) {
+            *error = QJsonParseError::IllegalValue;
+            return begin;
+        }
+        c += 4;
+        break;
+    case 'f':
+        if (end - c < 5 || memcmp(c, "false", 5) != 0) {
+            *error = QJsonParseError::IllegalValue;
+            return begin;
+        }
+        c += 5;
+        break;
+    default: {
+        bool isInt;
+        c = scanNumber(begin, end, &isInt);
+        if (!isValidNumber(begin, c)) {
+            *error = QJsonParseError::IllegalNumber;
+            return begin;
+        }
+        break;
+    }
+    }
+    if (c < end) {
+        *error = inObject ? QJsonParseError::UnterminatedObject : QJsonParseError::MissingValueSeparator;
+        return c;
+    }
+    return 0;
+}
+
+/*
+    Checks that member names, values and separators appear between the
+    structural characters where the grammar allows them, and that the
+    literals, numbers and strings are well-formed, so that a document
+    accepted by index() parses without errors. The brackets are known to be
+    balanced already. The errors are those the parser would report.
+*/
+bool LazyDocument::validate(QJsonParseError::ParseError *error, const char **where) const
+{
+    const char *text = json.constData();
+    QVarLengthArray<bool, 64> inObject;
+    for (int i = 0; i < tokens.size() - 1; ++i) {
+        const char token = text[tokens.at(i).offset];
+        if (token == BeginObject || token == BeginArray)
+            inObject.append(token == BeginObject);
+        else if (token == EndObject || token == EndArray)
+            inObject.removeLast();
+        const bool object = inObject.last();
+
+        const char *begin = text + tokens.at(i).offset + 1;
+        const char *end = text + tokens.at(i + 1).offset;
+        trimSpace(begin, end);
+        const char next = text[tokens.at(i + 1).offset];
+        const char close = object ? EndObject : EndArray;
+        *where = begin;
+
+        if (object && (token == BeginObject || token == ValueSeparator)) {
+            // a member name, unless the object is empty
+            if (begin == end) {
+                if (next == EndObject && token == BeginObject)
+                    continue;
+                *error = next == EndObject ? QJsonParseError::MissingObject
+                                           : QJsonParseError::UnterminatedObject;
+                return false;
+            }
+            if (*begin != Quote) {
+                *error = QJsonParseError::UnterminatedObject;
+                return false;
+            }
+            const char *nameEnd = scanString(begin, end, error);
+            if (!nameEnd)
+                return false;
+            if (nameEnd != end || next != NameSeparator) {
+                *where = nameEnd;
+                *error = QJsonParseError::MissingNameSeparator;
+                return false;
+            }
+        } else if (token == EndObject || token == EndArray) {
+            // after a nested object or array
+            if (begin != end || (next != ValueSeparator && next != close)) {
+                *error = object ? QJsonParseError::UnterminatedObject
+                                : QJsonParseError::MissingValueSeparator;
+                return false;
+            }
+        } else {
+            // a value: after a name separator, or in an array
+            if (begin == end) {
+                if (next == BeginObject || next == BeginArray)
+                    continue;
+                if (next == EndArray && token == BeginArray)
+                    continue;
+                *error = next == ValueSeparator ? QJsonParseError::IllegalValue
+                                                : QJsonParseError::MissingObject;
+                return false;
+            }
+            if (const char *invalid = validateScalar(begin, end, object, error)) {
+                *where = invalid;
+                return false;
+            }
+            if (next != ValueSeparator && next != close) {
+                *where = end;
+                *error = object ? QJsonParseError::UnterminatedObject
+                                : QJsonParseError::MissingValueSeparator;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+    Parses the value in [begin, end) on its own.
+*/
+bool LazyDocument::parseValue(const char *begin, const char *end, QJsonValue *value) const
+{
+    trimSpace(begin, end);
+    if (begin == end)
+        return false;
+
+    QJsonParseError error;
+    if (*begin == BeginObject || *begin == BeginArray) {
+        Parser parser(begin, int(end - begin));
+        const QJsonDocument doc = parser.parse(&error);
+        if (error.error != QJsonParseError::NoError)
+            return false;
+        *value = doc.isObject() ? QJsonValue(doc.object()) : QJsonValue(doc.array());
+        return true;
+    }
+
+    // the parser only accepts objects and arrays at the top level
+    QByteArray wrapped;
+    wrapped.reserve(int(end - begin) + 2);
+    wrapped += BeginArray;
+    wrapped.append(begin, int(end - begin));
+    wrapped += EndArray;
+    Parser parser(wrapped.constData(), wrapped.size());
+    const QJsonArray array = parser.parse(&error).array();
+    if (error.error != QJsonParseError::NoError || array.size() != 1)
+        return false;
+    *value = array.at(0);
+    return true;
+}
+
+/*
+    Returns the value in [begin, end) that follows the token with the index
+    \a token, parsing it only the first time it is asked for.
+*/
+bool LazyDocument::cachedValue(int token, const char *begin, const char *end, QJsonValue *value)
+{
+    const auto it = values.constFind(token);
+    if (it != values.cend()) {
+        *value = it.value();
+        return true;
+    }
+    if (!parseValue(begin, end, value))
+        return false;
+    values.insert(token, *value);
+    return true;
+}
+
+// returns 1 if the member name in [begin, end) is key, 0 if it is not,
+// and -1 if it is not a valid string
+static int memberNameMatches(const char *begin, const char *end, const QString &key)
+{
+    trimSpace(begin, end);
+    if (end - begin < 2 || *begin != Quote || end[-1] != Quote)
+        return -1;
+    ++begin;
+    --end;
+
+    const char *c = begin;
+    while (c < end && uchar(*c) < 0x80 && *c != '\\' && *c != Quote)
+        ++c;
+    if (c == end)
+        return QLatin1String(begin, int(end - begin)) == key;
+
+    QString name;
+    name.reserve(int(end - begin));
+    for (c = begin; c < end; ) {
+        uint ch;
+        if (*c == Quote)
+            return -1;
+        if (*c == '\\') {
+            if (!scanEscapeSequence(c, end, &ch))
+                return -1;
+        } else if (!scanUtf8Char(c, end, &ch)) {
+            return -1;
+        }
+        if (QChar::requiresSurrogates(ch)) {
+            name += QChar(QChar::highSurrogate(ch));
+            name += QChar(QChar::lowSurrogate(ch));
+        } else {
+            name += QChar(ushort(ch));
+        }
+    }
+    return name == key;
+}
+
+/*
+    Looks up \a key in the top-level object. Returns false if the document
+    turns out to be malformed.
+*/
+bool LazyDocument::value(const QString &key, QJsonValue *value)
+{
+    Q_ASSERT(isObject);
+    const char *text = json.constData();
+    const int close = tokens.at(0).match;
+    *value = QJsonValue(QJsonValue::Undefined);
+    if (close == 1)
+        return isOnlySpace(text + tokens.at(0).offset + 1, text + tokens.at(1).offset);
+
+    // like the parser, the last of several members with the same name wins
+    const char *valueBegin = 0;
+    const char *valueEnd = 0;
+    int valueToken = 0;
+    int separator = 0;
+    for (;;) {
+        const int colon = separator + 1;
+        if (text[tokens.at(colon).offset] != NameSeparator)
+            return false;
+        const Token &first = tokens.at(colon + 1);
+        const bool isContainer = first.match >= 0;
+        const int next = isContainer ? first.match + 1 : colon + 1;
+        if (next != close && text[tokens.at(next).offset] != ValueSeparator)
+            return false;
+
+        const int matches = memberNameMatches(text + tokens.at(separator).offset + 1,
+                                              text + tokens.at(colon).offset, key);
+        if (matches < 0)
+            return false;
+        if (matches) {
+            valueBegin = text + tokens.at(colon).offset + 1;
+            valueToken = colon;
+            valueEnd = text + (isContainer ? tokens.at(first.match).offset + 1 : tokens.at(next).offset);
+        }
+        if (next == close)
+            break;
+        separator = next;
+    }
+
+    return !valueBegin || cachedValue(valueToken, valueBegin, valueEnd, value);
+}
+
+/*
+    Looks up index \a i in the top-level array. Returns false if the
+    document turns out to be malformed.
+*/
+bool LazyDocument::value(int i, QJsonValue *value)
+{
+    Q_ASSERT(!isObject);
+    const char *text = json.constData();
+    const int close = tokens.at(0).match;
+    *value = QJsonValue(QJsonValue::Undefined);
+    if (close == 1)
+        return isOnlySpace(text + tokens.at(0).offset + 1, text + tokens.at(1).offset);
+
+    int separator = 0;
+    for (int n = 0; ; ++n) {
+        const Token &first = tokens.at(separator + 1);
+        const bool isContainer = first.match >= 0;
+        const int next = isContainer ? first.match + 1 : separator + 1;
+        if (next != close && text[tokens.at(next).offset] != ValueSeparator)
+            return false;
+        if (n == i) {
+            const char *valueEnd = text + (isContainer ? tokens.at(first.match).offset + 1 : tokens.at(next).offset);
+            return cachedValue(separator, text + tokens.at(separator).offset + 1, valueEnd, value);
+        }
+        if (next == close)
+            return true;
+        separator = next;
+    }
+}
+
+/*
+    Replaces the index of a lazily parsed document with the binary tree.
+    index() has validated the document, but the parser can still fail, for
+    instance with DocumentTooLarge. The document then becomes an empty
+    object or array, with a warning since nobody is around to be handed the
+    parse error.
+*/
+void Data::parseLazyDocument()
+{
+    QMutexLocker locker(&lazy->mutex);
+    if (!lazy->parsed.load())
+        parseLazyDocumentLocked();
+}
+
+void Data::parseLazyDocumentLocked()
+{
+    Parser parser(lazy->json.constData(), lazy->json.size());
+    QJsonParseError error;
+    QJsonDocument doc = parser.parse(&error);
+    if (doc.isNull()) {
+        qWarning("QJsonDocument: Lazily parsed document is malformed: %s at offset %d",
+                 qPrintable(error.errorString()), error.offset);
+        if (lazy->isObject)
+            doc.setObject(QJsonObject());
+        else
+            doc.setArray(QJsonArray());
+    }
+
+    Data *parsedData = doc.d;
+    Q_ASSERT(parsedData->ref.load() == 1 && parsedData->ownsData);
+    qSwap(rawData, parsedData->rawData);
+    qSwap(alloc, parsedData->alloc);
+    compactionCounter = parsedData->compactionCounter;
+
+    // only the binary tree is used from now on
+    lazy->json.clear();
+    lazy->tokens = QVector<LazyDocument::Token>();
+    lazy->values = QHash<int, QJsonValue>();
+    lazy->parsed.storeRelease(1);
+}
+
+bool Data::lazyValue(const QString &key, QJsonValue *value)
+{
+    QMutexLocker locker(&lazy->mutex);
+    if (lazy->parsed.load())
+        return false;
+    if (lazy->value(key, value))
+        return true;
+    parseLazyDocumentLocked();
+    *value = QJsonValue(QJsonValue::Undefined);
+    return true;
+}
+
+bool Data::lazyValue(int i, QJsonValue *value)
+{
+    QMutexLocker locker(&lazy->mutex);
+    if (lazy->parsed.load())
+        return false;
+    if (i < 0) {
+        *value = QJsonValue(QJsonValue::Undefined);
+        return true;
+    }
+    if (lazy->value(i, value))
+        return true;
+    parseLazyDocumentLocked();
+    *value = QJsonValue(QJsonValue::Undefined);
+    return true;
+}
+
 QT_END_NAMESPACE
@@ -59,6 +59,13 @@ QT_BEGIN_NAMESPACE
 
 namespace QJsonPrivate {
 
+static const int nestingLimit = 1024;
+
+// shared with QJsonStreamReader
+bool scanEscapeSequence(const char *&json, const char *end, uint *ch);
+bool scanUtf8Char(const char *&json, const char *end, uint *result);
+const char *scanNumber(const char *json, const char *end, bool *isInt);
+
 class Parser
 {
 public:
@@ -0,0 +1,1342 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstream.h"
+#include "qjsonobject.h"
+#include "qjsonarray.h"
+#include "qjsonparser_p.h"
+#include "qjsonwriter_p.h"
+#include "private/qlocale_tools_p.h"
+
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+// how much input QJsonStreamReader asks its device for at a time
+static const int ReadChunkSize = 16384;
+// how much output QJsonStreamWriter collects before writing it to its device
+static const int WriteChunkSize = 16384;
+
+enum {
+    Space = 0x20,
+    Tab = 0x09,
+    LineFeed = 0x0a,
+    Return = 0x0d,
+    BeginArray = 0x5b,
+    BeginObject = 0x7b,
+    EndArray = 0x5d,
+    EndObject = 0x7d,
+    NameSeparator = 0x3a,
+    ValueSeparator = 0x2c,
+    Quote = 0x22
+};
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State {
+        DocumentStart,
+        ObjectStart,        // after '{': a name or '}'
+        ObjectName,         // after ',' in an object: a name
+        MemberSeparator,    // after a name: ':'
+        MemberValue,        // after ':': a value
+        ArrayStart,         // after '[': a value or ']'
+        ArrayValue,         // after ',' in an array: a value
+        AfterValue,         // ',' or the end of the enclosing container
+        DocumentEnd,        // only whitespace may follow
+        Finished
+    };
+
+    enum Result {
+        TokenRead,
+        NeedMoreData,
+        ParseFailed
+    };
+
+    QJsonStreamReaderPrivate() : device(nullptr) { reset(); }
+
+    void reset();
+    bool fetchData();
+    QJsonStreamReader::TokenType next();
+
+    Result parseToken();
+    Result parseValue(const char *json, const char *end);
+    Result parseString(const char *json, const char *end, QString *out);
+    Result parseLiteral(const char *json, const char *end, const char *literal, int length);
+    Result parseNumber(const char *json, const char *end);
+    Result startContainer(char c);
+    Result endContainer(char c);
+    Result raiseError(QJsonParseError::ParseError e, const char *where);
+
+    QIODevice *device;
+    QByteArray buffer;
+    int pos;                // first unconsumed byte in buffer
+    qint64 bufferOffset;    // offset of buffer[0] in the input
+    State state;
+    QVarLengthArray<char, 16> containers;
+    QJsonStreamReader::TokenType type;
+    QJsonParseError::ParseError error;
+    qint64 errorOffset;
+    QString name;
+    QJsonValue value;
+};
+
+void QJsonStreamReaderPrivate::reset()
+{
+    buffer.clear();
+    pos = 0;
+    bufferOffset = 0;
+    state = DocumentStart;
+    containers.clear();
+    type = QJsonStreamReader::NoToken;
+    error = QJsonParseError::NoError;
+    errorOffset = 0;
+    name.clear();
+    value = QJsonValue();
+}
+
+/*
+    Reads the next chunk from the device, after dropping the input that has
+    already been consumed. Returns \c false if no more data is available.
+*/
+bool QJsonStreamReaderPrivate::fetchData()
+{
+    if (!device)
+        return false;
+
+    if (pos) {
+        buffer.remove(0, pos);
+        bufferOffset += pos;
+        pos = 0;
+    }
+
+    // grow the chunk with the pending token, so that scanning a very long
+    // string does not become quadratic
+    const int chunk = qMax(ReadChunkSize, buffer.size());
+    const int oldSize = buffer.size();
+    buffer.resize(oldSize + chunk);
+    const qint64 read = device->read(buffer.data() + oldSize, chunk);
+    buffer.resize(oldSize + int(qMax<qint64>(read, 0)));
+    return read > 0;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::next()
+{
+    if (type == QJsonStreamReader::Invalid) {
+        if (error != QJsonParseError::PrematureEndOfDocument)
+            return type;
+        error = QJsonParseError::NoError;
+    }
+    if (state == Finished)
+        return type = QJsonStreamReader::EndDocument;
+
+    name.clear();
+    value = QJsonValue();
+    for (;;) {
+        switch (parseToken()) {
+        case TokenRead:
+        case ParseFailed:
+            return type;
+        case NeedMoreData:
+            if (fetchData())
+                continue;
+            if (state == DocumentEnd) {
+                state = Finished;
+                return type = QJsonStreamReader::EndDocument;
+            }
+            error = QJsonParseError::PrematureEndOfDocument;
+            errorOffset = bufferOffset + pos;
+            return type = QJsonStreamReader::Invalid;
+        }
+    }
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::raiseError(QJsonParseError::ParseError e, const char *where)
+{
+    error = e;
+    errorOffset = bufferOffset + (where - buffer.constData());
+    type = QJsonStreamReader::Invalid;
+    return ParseFailed;
+}
+
+/*
+    Parses the next token from the buffered input. pos is only advanced past
+    complete tokens and separators, so parsing can resume at the same spot
+    once more data has arrived.
+*/
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::parseToken()
+{
+    for (;;) {
+        const char *begin = buffer.constData();
+        const char *json = begin + pos;
+        const char *end = begin + buffer.size();
+
+        while (json < end && (*json == Space || *json == Tab || *json == LineFeed || *json == Return))
+            ++json;
+        pos = json - begin;
+        if (json == end)
+            return NeedMoreData;
+
+        switch (state) {
+        case DocumentStart:
+            if (bufferOffset + pos == 0 && uchar(*json) == 0xef) {
+                // UTF-8 byte order mark
+                if (end - json < 3)
+                    return NeedMoreData;
+                if (uchar(json[1]) == 0xbb && uchar(json[2]) == 0xbf) {
+                    pos += 3;
+                    continue;
+                }
+            }
+            if (*json == BeginObject || *json == BeginArray)
+                return startContainer(*json);
+            return raiseError(QJsonParseError::IllegalValue, json);
+
+        case ObjectStart:
+        case ObjectName:
+            if (*json == Quote) {
+                const Result r = parseString(json, end, &name);
+                if (r == TokenRead) {
+                    state = MemberSeparator;
+                    type = QJsonStreamReader::Name;
+                }
+                return r;
+            }
+            if (*json == EndObject) {
+                if (state == ObjectName)
+                    return raiseError(QJsonParseError::MissingObject, json);
+                return endContainer(*json);
+            }
+            return raiseError(QJsonParseError::UnterminatedObject, json);
+
+        case MemberSeparator:
+            if (*json != NameSeparator)
+                return raiseError(QJsonParseError::MissingNameSeparator, json);
+            ++pos;
+            state = MemberValue;
+            continue;
+
+        case MemberValue:
+        case ArrayStart:
+        case ArrayValue:
+            return parseValue(json, end);
+
+        case AfterValue:
+            if (containers.last() == BeginObject) {
+                if (*json == EndObject)
+                    return endContainer(*json);
+                if (*json != ValueSeparator)
+                    return raiseError(QJsonParseError::UnterminatedObject, json);
+                state = ObjectName;
+            } else {
+                if (*json == EndArray)
+                    return endContainer(*json);
+                if (*json != ValueSeparator)
+                    return raiseError(QJsonParseError::MissingValueSeparator, json);
+                state = ArrayValue;
+            }
+            ++pos;
+            continue;
+
+        case DocumentEnd:
+            return raiseError(QJsonParseError::GarbageAtEnd, json);
+
+        case Finished:
+            Q_UNREACHABLE();
+        }
+    }
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::parseValue(const char *json, const char *end)
+{
+    switch (*json) {
+    case BeginObject:
+    case BeginArray:
+        return startContainer(*json);
+    case EndArray:
+        if (state == ArrayStart)
+            return endContainer(*json);
+        return raiseError(QJsonParseError::MissingObject, json);
+    case EndObject:
+        return raiseError(QJsonParseError::MissingObject, json);
+    case ValueSeparator:
+        return raiseError(QJsonParseError::IllegalValue, json);
+    case Quote: {
+        QString str;
+        const Result r = parseString(json, end, &str);
+        if (r == TokenRead) {
+            value = str;
+            type = QJsonStreamReader::String;
+            state = AfterValue;
+        }
+        return r;
+    }
+    case 't': {
+        const Result r = parseLiteral(json, end, "true", 4);
+        if (r == TokenRead) {
+            value = true;
+            type = QJsonStreamReader::Bool;
+        }
+        return r;
+    }
+    case 'f': {
+        const Result r = parseLiteral(json, end, "false", 5);
+        if (r == TokenRead) {
+            value = false;
+            type = QJsonStreamReader::Bool;
+        }
+        return r;
+    }
+    case 'n': {
+        const Result r = parseLiteral(json, end, "null", 4);
+        if (r == TokenRead) {
+            value = QJsonValue(QJsonValue::Null);
+            type = QJsonStreamReader::Null;
+        }
+        return r;
+    }
+    default:
+        return parseNumber(json, end);
+    }
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::parseLiteral(const char *json, const char *end,
+                                                                      const char *literal, int length)
+{
+    const int available = int(qMin<qptrdiff>(end - json, length));
+    if (memcmp(json, literal, available) != 0)
+        return raiseError(QJsonParseError::IllegalValue, json);
+    if (available < length)
+        return NeedMoreData;
+    pos += length;
+    state = AfterValue;
+    return TokenRead;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::parseNumber(const char *json, const char *end)
+{
+    bool isInt;
+    const char *numberEnd = QJsonPrivate::scanNumber(json, end, &isInt);
+    // the number might continue in the next chunk
+    if (numberEnd == end)
+        return NeedMoreData;
+
+    const int length = int(numberEnd - json);
+    double d;
+    if (isInt && length < 16) {
+        // fits into the mantissa of a double
+        const char *c = json;
+        const bool negative = (*c == '-');
+        if (negative)
+            ++c;
+        if (c == numberEnd)
+            return raiseError(QJsonParseError::IllegalNumber, json);
+        qint64 n = 0;
+        while (c < numberEnd)
+            n = n * 10 + (*c++ - '0');
+        d = negative ? -double(n) : double(n);
+    } else {
+        // asciiToDouble() may need a terminated string
+        QVarLengthArray<char, 64> number(length + 1);
+        memcpy(number.data(), json, length);
+        number[length] = '\0';
+        bool ok;
+        int processed;
+        d = asciiToDouble(number.constData(), length, ok, processed);
+        if (!ok || processed != length)
+            return raiseError(QJsonParseError::IllegalNumber, json);
+    }
+
+    value = d;
+    type = QJsonStreamReader::Number;
+    pos += length;
+    state = AfterValue;
+    return TokenRead;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::parseString(const char *json, const char *end, QString *out)
+{
+    // find the closing quote first, so that nothing is decoded twice when
+    // the string is not complete yet
+    const char *s = json + 1;
+    bool isLatin1 = true;
+    while (s < end) {
+        if (*s == Quote)
+            break;
+        if (*s == '\\') {
+            isLatin1 = false;
+            s += 2;
+            continue;
+        }
+        if (uchar(*s) >= 0x80)
+            isLatin1 = false;
+        ++s;
+    }
+    if (s >= end)
+        return NeedMoreData;
+
+    const char *stringEnd = s;
+    if (isLatin1) {
+        *out = QString::fromLatin1(json + 1, int(stringEnd - json - 1));
+    } else {
+        QString str;
+        str.reserve(int(stringEnd - json));
+        s = json + 1;
+        while (s < stringEnd) {
+            const char *where = s;
+            uint ch;
+            if (*s == '\\') {
+                if (!QJsonPrivate::scanEscapeSequence(s, stringEnd, &ch))
+                    return raiseError(QJsonParseError::IllegalEscapeSequence, where);
+            } else {
+                if (!QJsonPrivate::scanUtf8Char(s, stringEnd, &ch))
+                    return raiseError(QJsonParseError::IllegalUTF8String, where);
+            }
+            if (QChar::requiresSurrogates(ch)) {
+                str += QChar(QChar::highSurrogate(ch));
+                str += QChar(QChar::lowSurrogate(ch));
+            } else {
+                str += QChar(ushort(ch));
+            }
+        }
+        *out = str;
+    }
+
+    pos = int(stringEnd + 1 - buffer.constData());
+    return TokenRead;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::startContainer(char c)
+{
+    if (containers.size() >= QJsonPrivate::nestingLimit)
+        return raiseError(QJsonParseError::DeepNesting, buffer.constData() + pos);
+    containers.append(c);
+    ++pos;
+    if (c == BeginObject) {
+        state = ObjectStart;
+        type = QJsonStreamReader::StartObject;
+    } else {
+        state = ArrayStart;
+        type = QJsonStreamReader::StartArray;
+    }
+    return TokenRead;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::endContainer(char c)
+{
+    containers.removeLast();
+    ++pos;
+    state = containers.isEmpty() ? DocumentEnd : AfterValue;
+    type = c == EndObject ? QJsonStreamReader::EndObject : QJsonStreamReader::EndArray;
+    return TokenRead;
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \ingroup shared
+    \reentrant
+    \since 5.10
+
+    \brief The QJsonStreamReader class provides a fast parser for reading
+    JSON documents token by token.
+
+    QJsonStreamReader is an alternative to QJsonDocument::fromJson() for
+    documents that are too large to be held in memory as a whole, that
+    arrive in pieces, or of which only a small part is of interest. Like
+    QXmlStreamReader, it is a pull parser: the application calls readNext()
+    to advance to the next token, and then inspects it with tokenType(),
+    name() and value().
+
+    \code
+    QJsonStreamReader reader(&file);
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QJsonStreamReader::Name && reader.name() == QLatin1String("id"))
+            ids.append(reader.readValue().toInt());
+    }
+    if (reader.hasError())
+        qWarning() << reader.errorString() << "at offset" << reader.offset();
+    \endcode
+
+    Input can come from a QIODevice, which is read in chunks, or be passed
+    in incrementally with addData(). If the reader runs out of input in the
+    middle of the document, readNext() returns \l Invalid and error()
+    returns QJsonParseError::PrematureEndOfDocument. This error is
+    recoverable: once more data is available (for a device) or has been
+    added with addData(), calling readNext() again continues where the
+    reader left off. All other errors are final.
+
+    The reader accepts exactly the documents QJsonDocument::fromJson()
+    accepts, and reports the same errors for malformed input.
+
+    readValue() reads a complete object or array into a QJsonValue, and
+    skipCurrentValue() skips over one without building it, which makes it
+    easy to mix token-level and document-level processing.
+
+    \sa QJsonStreamWriter, QJsonDocument, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken The reader has not yet read anything.
+    \value Invalid An error has occurred, reported in error() and
+           errorString().
+    \value EndDocument The reader has reached the end of the document.
+    \value StartObject The reader reports the start of an object.
+    \value EndObject The reader reports the end of an object.
+    \value StartArray The reader reports the start of an array.
+    \value EndArray The reader reports the end of an array.
+    \value Name The reader reports the name of an object member in name().
+           The token for the member's value follows.
+    \value String The reader reports a string in value().
+    \value Number The reader reports a number in value().
+    \value Bool The reader reports \c true or \c false in value().
+    \value Null The reader reports \c null.
+*/
+
+/*!
+    Constructs a stream reader without any input.
+
+    \sa setDevice(), addData()
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Creates a new stream reader that reads from \a device.
+
+    \sa setDevice(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Creates a new stream reader that reads from \a data.
+
+    \sa addData(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    Q_D(QJsonStreamReader);
+    d->buffer = data;
+}
+
+/*!
+    Destructs the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device and resets the reader to its
+    initial state. Setting the device to \nullptr removes any device or
+    data from the reader.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamReader);
+    d->reset();
+    d->device = device;
+}
+
+/*!
+    Returns the current device associated with the reader, or \nullptr if
+    no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->device;
+}
+
+/*!
+    Adds more \a data for the reader to read. This function does nothing if
+    the reader has a device().
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    if (d->pos) {
+        d->buffer.remove(0, d->pos);
+        d->bufferOffset += d->pos;
+        d->pos = 0;
+    }
+    d->buffer += data;
+}
+
+/*!
+    Removes any device() or data from the reader and resets its internal
+    state to the initial state.
+
+    \sa addData()
+*/
+void QJsonStreamReader::clear()
+{
+    Q_D(QJsonStreamReader);
+    d->reset();
+    d->device = nullptr;
+}
+
+/*!
+    Returns \c true if the reader has read until the end of the document,
+    or if an error() has occurred and reading has been aborted. Otherwise
+    returns \c false.
+
+    When atEnd() and hasError() return \c true and error() returns
+    QJsonParseError::PrematureEndOfDocument, the input has been well-formed
+    so far, but a complete document has not been read yet. Reading
+    continues with the next call to readNext() once more data is available.
+
+    \sa hasError(), error(), device()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == EndDocument || d->type == Invalid;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    With one exception, once an error() is reported, readNext() does not
+    read any further input. The exception is
+    QJsonParseError::PrematureEndOfDocument, which is reported when the end
+    of the available input was reached before the document was complete; in
+    this case readNext() tries again.
+
+    \sa tokenType(), tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    Q_D(QJsonStreamReader);
+    return d->next();
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type;
+}
+
+static const char QJsonStreamReader_tokenTypeString_string[] =
+    "NoToken\0"
+    "Invalid\0"
+    "EndDocument\0"
+    "StartObject\0"
+    "EndObject\0"
+    "StartArray\0"
+    "EndArray\0"
+    "Name\0"
+    "String\0"
+    "Number\0"
+    "Bool\0"
+    "Null\0"
+    "\0";
+
+static const short QJsonStreamReader_tokenTypeString_indices[] = {
+    0, 8, 16, 28, 40, 50, 61, 70, 75, 82, 89, 94, 0
+};
+
+/*!
+    Returns the reader's current token as string.
+
+    \sa tokenType()
+*/
+QString QJsonStreamReader::tokenString() const
+{
+    Q_D(const QJsonStreamReader);
+    return QLatin1String(QJsonStreamReader_tokenTypeString_string +
+                         QJsonStreamReader_tokenTypeString_indices[d->type]);
+}
+
+/*!
+    Returns \c true if the reader reports a value: a String, Number, Bool or
+    Null token, or the start of an object or array.
+
+    \sa value(), readValue()
+*/
+bool QJsonStreamReader::isValue() const
+{
+    switch (tokenType()) {
+    case StartObject:
+    case StartArray:
+    case String:
+    case Number:
+    case Bool:
+    case Null:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*!
+    Returns the number of objects and arrays the current token is nested
+    in. The StartObject and StartArray tokens already count their own
+    container, the EndObject and EndArray tokens no longer do.
+*/
+int QJsonStreamReader::depth() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->containers.size();
+}
+
+/*!
+    Returns the number of bytes of input the reader has consumed. If an
+    error has occurred, returns the offset at which it was detected.
+*/
+qint64 QJsonStreamReader::offset() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Invalid ? d->errorOffset : d->bufferOffset + d->pos;
+}
+
+/*!
+    Returns the member name if the current token is a \l Name; otherwise
+    returns an empty string.
+*/
+QString QJsonStreamReader::name() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->name;
+}
+
+/*!
+    Returns the value of a String, Number, Bool or Null token. For all
+    other tokens, returns a null QJsonValue.
+
+    \sa readValue()
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->value;
+}
+
+/*!
+    Reads the value starting at the current token and returns it. If the
+    current token is a \l Name, the member's value is read.
+
+    For StartObject and StartArray, the whole object or array is read, and
+    the reader is left on the matching EndObject or EndArray token. For all
+    other values, this is the same as value(). Returns an undefined
+    QJsonValue if the current token does not start a value or an error
+    occurs.
+
+    \sa skipCurrentValue()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type == Name)
+        readNext();
+
+    switch (d->type) {
+    case String:
+    case Number:
+    case Bool:
+    case Null:
+        return d->value;
+    case StartObject: {
+        QJsonObject object;
+        while (readNext() == Name) {
+            const QString key = d->name;
+            readNext();
+            const QJsonValue v = readValue();
+            if (d->type == Invalid)
+                break;
+            object.insert(key, v);
+        }
+        if (d->type != EndObject)
+            break;
+        return object;
+    }
+    case StartArray: {
+        QJsonArray array;
+        while (readNext() != EndArray) {
+            const QJsonValue v = readValue();
+            if (d->type == Invalid)
+                break;
+            array.append(v);
+        }
+        if (d->type != EndArray)
+            break;
+        return array;
+    }
+    default:
+        break;
+    }
+    return QJsonValue(QJsonValue::Undefined);
+}
+
+/*!
+    Skips the value starting at the current token. If the current token is
+    a \l Name, the member's value is skipped.
+
+    For StartObject and StartArray, the reader is left on the matching
+    EndObject or EndArray token, without building the object or array in
+    memory.
+
+    \sa readValue()
+*/
+void QJsonStreamReader::skipCurrentValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type == Name)
+        readNext();
+    if (d->type != StartObject && d->type != StartArray)
+        return;
+
+    int level = 1;
+    while (level) {
+        switch (readNext()) {
+        case StartObject:
+        case StartArray:
+            ++level;
+            break;
+        case EndObject:
+        case EndArray:
+            --level;
+            break;
+        case Invalid:
+            return;
+        default:
+            break;
+        }
+    }
+}
+
+/*!
+    Returns the type of the current error, or QJsonParseError::NoError if
+    no error occurred.
+
+    \sa errorString(), hasError()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->error;
+}
+
+/*!
+    Returns the error message that was set with error().
+
+    \sa error(), offset()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    Q_D(const QJsonStreamReader);
+    QJsonParseError e;
+    e.offset = int(d->errorOffset);
+    e.error = d->error;
+    return e.errorString();
+}
+
+/*!
+    \fn bool QJsonStreamReader::hasError() const
+
+    Returns \c true if an error has occurred, otherwise \c false.
+
+    \sa errorString(), error()
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartObject() const
+
+    Returns \c true if tokenType() equals \l StartObject; otherwise returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndObject() const
+
+    Returns \c true if tokenType() equals \l EndObject; otherwise returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartArray() const
+
+    Returns \c true if tokenType() equals \l StartArray; otherwise returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndArray() const
+
+    Returns \c true if tokenType() equals \l EndArray; otherwise returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isName() const
+
+    Returns \c true if tokenType() equals \l Name; otherwise returns \c false.
+*/
+
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container {
+        char close;
+        bool hasEntries;
+    };
+
+    QJsonStreamWriterPrivate()
+        : device(nullptr), array(nullptr), autoFormatting(false), afterName(false), hasError(false)
+    {}
+
+    QByteArray &output() { return array ? *array : buffer; }
+    void beginEntry();
+    void startContainer(char open, char close);
+    void endContainer(char close);
+    void writeBuffer();
+
+    QIODevice *device;
+    QByteArray *array;
+    QByteArray buffer;
+    QVarLengthArray<Container, 16> containers;
+    bool autoFormatting;
+    bool afterName;
+    bool hasError;
+};
+
+/*
+    Writes what precedes a new name or value: the separator from the
+    previous entry and, when auto-formatting, the line break and
+    indentation. Values following a name go right after it.
+*/
+void QJsonStreamWriterPrivate::beginEntry()
+{
+    if (afterName) {
+        afterName = false;
+        return;
+    }
+    if (containers.isEmpty())
+        return;
+
+    QByteArray &json = output();
+    Container &c = containers.last();
+    if (c.hasEntries)
+        json += autoFormatting ? ",\n" : ",";
+    c.hasEntries = true;
+    if (autoFormatting)
+        json.append(4 * containers.size(), ' ');
+}
+
+void QJsonStreamWriterPrivate::startContainer(char open, char close)
+{
+    beginEntry();
+    QByteArray &json = output();
+    json += open;
+    if (autoFormatting)
+        json += '\n';
+    const Container c = { close, false };
+    containers.append(c);
+}
+
+void QJsonStreamWriterPrivate::endContainer(char close)
+{
+    if (containers.isEmpty() || containers.last().close != close || afterName) {
+        qWarning("QJsonStreamWriter: mismatched end of %s", close == EndObject ? "object" : "array");
+        return;
+    }
+
+    QByteArray &json = output();
+    const bool hadEntries = containers.last().hasEntries;
+    containers.removeLast();
+    if (autoFormatting) {
+        if (hadEntries)
+            json += '\n';
+        json.append(4 * containers.size(), ' ');
+    }
+    json += close;
+
+    if (containers.isEmpty()) {
+        if (autoFormatting)
+            json += '\n';
+        writeBuffer();
+    } else if (buffer.size() >= WriteChunkSize) {
+        writeBuffer();
+    }
+}
+
+void QJsonStreamWriterPrivate::writeBuffer()
+{
+    if (!device || buffer.isEmpty())
+        return;
+    if (device->write(buffer) != buffer.size())
+        hasError = true;
+    buffer.resize(0);
+}
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.10
+
+    \brief The QJsonStreamWriter class provides a JSON writer with a simple
+    streaming API.
+
+    QJsonStreamWriter is the counterpart to QJsonStreamReader. It writes a
+    JSON document piece by piece to a QIODevice or a QByteArray, without
+    building it in memory as a QJsonDocument first.
+
+    \code
+    QJsonStreamWriter writer(&file);
+    writer.setAutoFormatting(true);
+    writer.writeStartArray();
+    for (const Record &record : records) {
+        writer.writeStartObject();
+        writer.writeMember(QStringLiteral("id"), record.id);
+        writer.writeMember(QStringLiteral("name"), record.name);
+        writer.writeEndObject();
+    }
+    writer.writeEndArray();
+    \endcode
+
+    Output for a device is collected in an internal buffer and written in
+    chunks, at the latest when the top-level object or array is closed or
+    flush() is called.
+
+    The writer produces the same text as QJsonDocument::toJson():
+    compact by default, and in the QJsonDocument::Indented format if
+    autoFormatting() is enabled. Member names are written in the order
+    they are passed, and nothing checks for duplicates.
+
+    \sa QJsonStreamReader, QJsonDocument, QXmlStreamWriter
+*/
+
+/*!
+    Constructs a stream writer without a device.
+
+    \sa setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter()
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+}
+
+/*!
+    Constructs a stream writer that writes into \a device.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Constructs a stream writer that writes into \a array. The data is
+    appended to the array directly, without buffering.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *array)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    Q_D(QJsonStreamWriter);
+    d->array = array;
+}
+
+/*!
+    Destructor. Writes any buffered output to the device.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeBuffer();
+}
+
+/*!
+    Sets the current device to \a device, after writing any buffered output
+    to the previous one.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeBuffer();
+    d->device = device;
+    d->array = nullptr;
+    if (device)
+        d->buffer.reserve(WriteChunkSize + WriteChunkSize / 2);
+}
+
+/*!
+    Returns the current device associated with the writer, or \nullptr if
+    no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->device;
+}
+
+/*!
+    \property QJsonStreamWriter::autoFormatting
+*/
+
+/*!
+    Enables auto-formatting if \a enable is \c true, otherwise disables it.
+
+    With auto-formatting, the output is indented the same way as by
+    QJsonDocument::toJson() with QJsonDocument::Indented. The default value
+    is \c false.
+*/
+void QJsonStreamWriter::setAutoFormatting(bool enable)
+{
+    Q_D(QJsonStreamWriter);
+    d->autoFormatting = enable;
+}
+
+/*!
+    Returns \c true if auto-formatting is enabled, otherwise \c false.
+
+    \sa setAutoFormatting()
+*/
+bool QJsonStreamWriter::autoFormatting() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->autoFormatting;
+}
+
+/*!
+    Writes the start of an object. Its members are written with writeName()
+    and writeValue(), or writeMember(), and it is closed with
+    writeEndObject().
+*/
+void QJsonStreamWriter::writeStartObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(BeginObject, EndObject);
+}
+
+/*!
+    Closes the object opened last with writeStartObject().
+*/
+void QJsonStreamWriter::writeEndObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->endContainer(EndObject);
+}
+
+/*!
+    Writes the start of an array. Its elements are written with
+    writeValue(), and it is closed with writeEndArray().
+*/
+void QJsonStreamWriter::writeStartArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->startContainer(BeginArray, EndArray);
+}
+
+/*!
+    Closes the array opened last with writeStartArray().
+*/
+void QJsonStreamWriter::writeEndArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->endContainer(EndArray);
+}
+
+/*!
+    Writes \a name as the name of the next object member. The next call
+    must write the member's value.
+
+    \sa writeMember()
+*/
+void QJsonStreamWriter::writeName(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->beginEntry();
+    QByteArray &json = d->output();
+    json += '"';
+    json += QJsonPrivate::Writer::escapedString(name);
+    json += d->autoFormatting ? "\": " : "\":";
+    d->afterName = true;
+}
+
+/*!
+    Writes \a value. Objects and arrays are written recursively.
+
+    \sa writeMember()
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    switch (value.type()) {
+    case QJsonValue::Object: {
+        writeStartObject();
+        const QJsonObject object = value.toObject();
+        for (QJsonObject::const_iterator it = object.begin(), end = object.end(); it != end; ++it)
+            writeMember(it.key(), it.value());
+        writeEndObject();
+        return;
+    }
+    case QJsonValue::Array: {
+        writeStartArray();
+        const QJsonArray array = value.toArray();
+        for (const QJsonValue &v : array)
+            writeValue(v);
+        writeEndArray();
+        return;
+    }
+    default:
+        break;
+    }
+
+    d->beginEntry();
+    QByteArray &json = d->output();
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        json += value.toBool() ? "true" : "false";
+        break;
+    case QJsonValue::Double:
+        QJsonPrivate::Writer::doubleToJson(value.toDouble(), json);
+        break;
+    case QJsonValue::String:
+        json += '"';
+        json += QJsonPrivate::Writer::escapedString(value.toString());
+        json += '"';
+        break;
+    default:
+        json += "null";
+        break;
+    }
+    if (d->containers.isEmpty() || d->buffer.size() >= WriteChunkSize)
+        d->writeBuffer();
+}
+
+/*!
+    Writes an object member with the name \a name and the value \a value.
+    This is a convenience function equivalent to:
+    \code
+    writeName(name);
+    writeValue(value);
+    \endcode
+*/
+void QJsonStreamWriter::writeMember(const QString &name, const QJsonValue &value)
+{
+    writeName(name);
+    writeValue(value);
+}
+
+/*!
+    Writes the current token of \a reader. This makes it possible to copy,
+    filter or reformat a document while it is being read.
+
+    \sa QJsonStreamReader::tokenType()
+*/
+void QJsonStreamWriter::writeCurrentToken(const QJsonStreamReader &reader)
+{
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartObject:
+        writeStartObject();
+        break;
+    case QJsonStreamReader::EndObject:
+        writeEndObject();
+        break;
+    case QJsonStreamReader::StartArray:
+        writeStartArray();
+        break;
+    case QJsonStreamReader::EndArray:
+        writeEndArray();
+        break;
+    case QJsonStreamReader::Name:
+        writeName(reader.name());
+        break;
+    case QJsonStreamReader::String:
+    case QJsonStreamReader::Number:
+    case QJsonStreamReader::Bool:
+    case QJsonStreamReader::Null:
+        writeValue(reader.value());
+        break;
+    default:
+        break;
+    }
+}
+
+/*!
+    Writes any buffered output to the device.
+*/
+void QJsonStreamWriter::flush()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeBuffer();
+}
+
+/*!
+    Returns \c true if writing to the device failed, otherwise \c false.
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->hasError;
+}
+
+QT_END_NAMESPACE
@@ -64,6 +64,10 @@ class Writer
 public:
     static void objectToJson(const QJsonPrivate::Object *o, QByteArray &json, int indent, bool compact = false);
     static void arrayToJson(const QJsonPrivate::Array *a, QByteArray &json, int indent, bool compact = false);
+
+    // shared with QJsonStreamWriter
+    static QByteArray escapedString(const QString &s);
+    static void doubleToJson(double d, QByteArray &json);
 };
 
 }
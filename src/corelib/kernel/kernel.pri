@@ -32,6 +32,7 @@ HEADERS += \
         kernel/qmetaobject_p.h \
         kernel/qmetaobject_moc_p.h \
         kernel/qmetaobjectbuilder_p.h \
+        kernel/qmetacallbatch_p.h \
         kernel/qobject_p.h \
         kernel/qcoreglobaldata_p.h \
         kernel/qsharedmemory.h \
@@ -56,6 +57,7 @@ SOURCES += \
         kernel/qmetaobject.cpp \
         kernel/qmetatype.cpp \
         kernel/qmetaobjectbuilder.cpp \
+        kernel/qmetacallbatch.cpp \
         kernel/qmimedata.cpp \
         kernel/qobject.cpp \
         kernel/qobjectcleanuphandler.cpp \
@@ -69,6 +69,7 @@
 #include <private/qfunctions_p.h>
 #include <private/qlocale_p.h>
 #include <private/qhooks_p.h>
+#include <private/qmetacallbatch_p.h>
 
 #ifndef QT_NO_QOBJECT
 #if defined(Q_OS_UNIX)
@@ -1587,6 +1588,10 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
         return;
     }
 
+    // the calls of Qt::BatchedConnection are delivered all at once
+    if (!receiver && (!event_type || event_type == QEvent::MetaCall))
+        QMetaCallBatch::sendPendingCalls(data);
+
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
@@ -1594,14 +1599,14 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
     // events, canWait will be set to false.
-    data->canWait = (data->postEventList.size() == 0);
+    data->canWait = (data->postEventList.size() == 0 && !QMetaCallBatch::hasPendingCalls(data));
 
     if (data->postEventList.size() == 0 || (receiver && !receiver->d_func()->postedEvents)) {
         --data->postEventList.recursion;
         return;
     }
 
-    data->canWait = true;
+    data->canWait = !QMetaCallBatch::hasPendingCalls(data);
 
     // okay. here is the tricky loop. be careful about optimizing
     // this, it looks the way it does for good reasons.
@@ -55,6 +55,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <limits>
+
 #ifndef QT_NO_EVENTFD
 #  include <sys/eventfd.h>
 #endif
@@ -222,18 +224,165 @@ int QThreadPipe::check(const pollfd &pfd)
     return readyread;
 }
 
+#if QT_CONFIG(epoll)
+static inline uint32_t epollEventsFromPoll(short events)
+{
+    uint32_t result = 0;
+    if (events & POLLIN)
+        result |= EPOLLIN;
+    if (events & POLLOUT)
+        result |= EPOLLOUT;
+    if (events & POLLPRI)
+        result |= EPOLLPRI;
+    return result;
+}
+
+static inline short pollEventsFromEpoll(uint32_t events)
+{
+    short result = 0;
+    if (events & EPOLLIN)
+        result |= POLLIN;
+    if (events & EPOLLOUT)
+        result |= POLLOUT;
+    if (events & EPOLLPRI)
+        result |= POLLPRI;
+    if (events & EPOLLERR)
+        result |= POLLERR;
+    if (events & EPOLLHUP)
+        result |= POLLHUP;
+    return result;
+}
+#endif
+
 QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Can not continue without a thread pipe");
+
+#if QT_CONFIG(epoll)
+    epollFd = -1;
+    epollEdgeTriggered = false;
+    initEpoll();
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#if QT_CONFIG(epoll)
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
+
     // cleanup timers
     qDeleteAll(timerList);
 }
 
+#if QT_CONFIG(epoll)
+/*
+    The epoll(7) backend is opt-in: set QT_EVENT_DISPATCHER_EPOLL to a non-empty value
+    other than "0" to enable it with level-triggered notifications, or to "edge" to
+    request edge-triggered ones. Unlike the poll(2) backend, which rebuilds and scans
+    the whole descriptor set on every iteration, descriptors are (un)registered with
+    the kernel when socket notifiers are enabled or disabled and processEvents() only
+    visits the ones that are ready, which pays off with thousands of notifiers.
+
+    With "edge", a notifier is only activated when new data arrives (or buffer space
+    frees up), not while some is left: a slot that reads only part of the available
+    data is not activated again for the rest until more arrives. Only use it when all
+    the slots read until the descriptor would block, as QAbstractSocket does.
+*/
+bool QEventDispatcherUNIXPrivate::initEpoll()
+{
+    const QByteArray mode = qgetenv("QT_EVENT_DISPATCHER_EPOLL");
+    if (mode.isEmpty() || mode == "0")
+        return false;
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        qErrnoWarning("QEventDispatcherUNIX: epoll_create1 failed, falling back to poll");
+        return false;
+    }
+
+    // the thread pipe is always level-triggered, QThreadPipe::check() drains it
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = 0;
+    ev.data.fd = threadPipe.fds[0];
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, threadPipe.fds[0], &ev) == -1) {
+        qErrnoWarning("QEventDispatcherUNIX: cannot watch the thread pipe with epoll, falling back to poll");
+        qt_safe_close(epollFd);
+        epollFd = -1;
+        return false;
+    }
+
+    epollEdgeTriggered = (mode == "edge");
+    epollReady.resize(64);
+    return true;
+}
+#endif
+
+void QEventDispatcherUNIXPrivate::socketNotifierEventsChanged(int sockfd, QSocketNotifier::Type type,
+                                                              short oldEvents, short newEvents)
+{
+#if QT_CONFIG(epoll)
+    if (epollFd < 0 || oldEvents == newEvents)
+        return;
+
+    if (epollUnsupportedFds.contains(sockfd) || epollInvalidFds.contains(sockfd)) {
+        if (!newEvents) {
+            epollUnsupportedFds.remove(sockfd);
+            epollInvalidFds.remove(sockfd);
+        }
+        return;
+    }
+
+    epoll_event ev;
+    ev.events = epollEventsFromPoll(newEvents) | (epollEdgeTriggered ? uint32_t(EPOLLET) : 0);
+    ev.data.u64 = 0;
+    ev.data.fd = sockfd;
+
+    int op = !oldEvents ? EPOLL_CTL_ADD : (!newEvents ? EPOLL_CTL_DEL : EPOLL_CTL_MOD);
+    int ret = epoll_ctl(epollFd, op, sockfd, &ev);
+
+    // The descriptor may have been closed (and possibly reused) while notifiers
+    // were still enabled on it, so the kernel's interest list can disagree with ours.
+    if (ret == -1 && op == EPOLL_CTL_MOD && errno == ENOENT) {
+        op = EPOLL_CTL_ADD;
+        ret = epoll_ctl(epollFd, op, sockfd, &ev);
+    } else if (ret == -1 && op == EPOLL_CTL_ADD && errno == EEXIST) {
+        op = EPOLL_CTL_MOD;
+        ret = epoll_ctl(epollFd, op, sockfd, &ev);
+    }
+
+    if (ret == 0)
+        return;
+
+    // The descriptor was closed while notifiers were enabled on it, which the
+    // kernel forgets about silently. Warn like the poll(2) backend does.
+    if (op == EPOLL_CTL_DEL && (errno == ENOENT || errno == EBADF)) {
+        qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                 sockfd, socketType(type));
+        return;
+    }
+    if (errno == EBADF) {
+        epollInvalidFds.insert(sockfd);
+        return;
+    }
+
+    if (op == EPOLL_CTL_ADD && errno == EPERM) {
+        epollUnsupportedFds.insert(sockfd);
+        return;
+    }
+
+    qErrnoWarning("QEventDispatcherUNIX: epoll_ctl failed for socket %d", sockfd);
+#else
+    Q_UNUSED(sockfd);
+    Q_UNUSED(type);
+    Q_UNUSED(oldEvents);
+    Q_UNUSED(newEvents);
+#endif
+}
+
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
@@ -289,6 +438,92 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
     pollfds.clear();
 }
 
+int QEventDispatcherUNIXPrivate::pollEvents(timespec *tm, bool include_notifiers)
+{
+    pollfds.clear();
+    pollfds.reserve(1 + (include_notifiers ? socketNotifiers.size() : 0));
+
+    if (include_notifiers)
+        for (auto it = socketNotifiers.cbegin(); it != socketNotifiers.cend(); ++it)
+            pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+
+    // This must be last, as it's popped off the end below
+    pollfds.append(threadPipe.prepare());
+
+    int nevents = 0;
+
+    switch (qt_safe_poll(pollfds.data(), pollfds.size(), tm)) {
+    case -1:
+        perror("qt_safe_poll");
+        break;
+    case 0:
+        break;
+    default:
+        nevents += threadPipe.check(pollfds.takeLast());
+        if (include_notifiers)
+            nevents += activateSocketNotifiers();
+        break;
+    }
+
+    return nevents;
+}
+
+#if QT_CONFIG(epoll)
+int QEventDispatcherUNIXPrivate::epollEvents(timespec *tm)
+{
+    int timeout = -1;
+    if (!epollUnsupportedFds.isEmpty() || !epollInvalidFds.isEmpty()) {
+        timeout = 0;
+    } else if (tm) {
+        // round up, so that we don't wake up just before a timer is due
+        const qint64 msecs = qint64(tm->tv_sec) * 1000 + (tm->tv_nsec + 999999) / 1000000;
+        timeout = int(qMin(msecs, qint64(std::numeric_limits<int>::max())));
+    }
+
+    const int nready = epoll_wait(epollFd, epollReady.data(), epollReady.size(), timeout);
+    if (nready == -1) {
+        if (errno != EINTR)
+            perror("epoll_wait");
+        return 0;
+    }
+
+    int nevents = 0;
+    pollfds.clear();
+
+    for (int i = 0; i < nready; ++i) {
+        const epoll_event &ev = epollReady.at(i);
+        pollfd pfd = qt_make_pollfd(ev.data.fd, 0);
+        pfd.revents = pollEventsFromEpoll(ev.events);
+
+        if (pfd.fd == threadPipe.fds[0])
+            nevents += threadPipe.check(pfd);
+        else if (socketNotifiers.contains(pfd.fd))
+            pollfds.append(pfd);
+    }
+
+    for (int fd : qAsConst(epollUnsupportedFds)) {
+        pollfd pfd = qt_make_pollfd(fd, 0);
+        pfd.revents = socketNotifiers.value(fd).events() & (POLLIN | POLLOUT);
+        if (pfd.revents)
+            pollfds.append(pfd);
+    }
+
+    // markPendingSocketNotifiers() disables their notifiers, which removes them from the set
+    for (int fd : qAsConst(epollInvalidFds)) {
+        pollfd pfd = qt_make_pollfd(fd, 0);
+        pfd.revents = POLLNVAL;
+        pollfds.append(pfd);
+    }
+
+    // let the next wait collect more events at once if this one was saturated
+    if (nready == epollReady.size() && epollReady.size() < 4096)
+        epollReady.resize(epollReady.size() * 2);
+
+    nevents += activateSocketNotifiers();
+    return nevents;
+}
+#endif
+
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
 {
     markPendingSocketNotifiers();
@@ -411,7 +646,9 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
+    const short oldEvents = sn_set.events();
     sn_set.notifiers[type] = notifier;
+    d->socketNotifierEventsChanged(sockfd, type, oldEvents, sn_set.events());
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -450,7 +687,9 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
     }
 
+    const short oldEvents = sn_set.events();
     sn_set.notifiers[type] = nullptr;
+    d->socketNotifierEventsChanged(sockfd, type, oldEvents, sn_set.events());
 
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
@@ -485,30 +724,16 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
-    d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
-
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
-
-    // This must be last, as it's popped off the end below
-    d->pollfds.append(d->threadPipe.prepare());
-
     int nevents = 0;
 
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
-    case -1:
-        perror("qt_safe_poll");
-        break;
-    case 0:
-        break;
-    default:
-        nevents += d->threadPipe.check(d->pollfds.takeLast());
-        if (include_notifiers)
-            nevents += d->activateSocketNotifiers();
-        break;
-    }
+#if QT_CONFIG(epoll)
+    // socket notifiers stay registered with epoll; when they are excluded,
+    // fall back to polling just the thread pipe
+    if (d->epollFd >= 0 && include_notifiers)
+        nevents += d->epollEvents(tm);
+    else
+#endif
+        nevents += d->pollEvents(tm, include_notifiers);
 
     if (include_timers)
         nevents += d->activateTimers();
@@ -53,11 +53,17 @@
 
 #include "QtCore/qabstracteventdispatcher.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qset.h"
+#include "QtCore/qsocketnotifier.h"
 #include "private/qabstracteventdispatcher_p.h"
 #include "private/qcore_unix_p.h"
 #include "QtCore/qvarlengtharray.h"
 #include "private/qtimerinfo_unix_p.h"
 
+#if QT_CONFIG(epoll)
+#  include <sys/epoll.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
@@ -139,10 +145,27 @@ public:
     void markPendingSocketNotifiers();
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
+    void socketNotifierEventsChanged(int sockfd, QSocketNotifier::Type type, short oldEvents, short newEvents);
+
+    int pollEvents(timespec *tm, bool include_notifiers);
 
     QThreadPipe threadPipe;
     QVector<pollfd> pollfds;
 
+#if QT_CONFIG(epoll)
+    bool initEpoll();
+    int epollEvents(timespec *tm);
+
+    // -1 if the poll(2) backend is in use
+    int epollFd;
+    bool epollEdgeTriggered;
+    QVector<epoll_event> epollReady;
+    // descriptors epoll(7) refuses (e.g. regular files); always reported ready, like poll(2) does
+    QSet<int> epollUnsupportedFds;
+    // descriptors closed while notifiers were enabled on them; reported with POLLNVAL, like poll(2) does
+    QSet<int> epollInvalidFds;
+#endif
+
     QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
     QVector<QSocketNotifier *> pendingNotifiers;
 
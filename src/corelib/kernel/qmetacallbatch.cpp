@@ -0,0 +1,322 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmetacallbatch_p.h"
+
+#include "qabstracteventdispatcher.h"
+#include "qcoreapplication.h"
+#include "qmetatype.h"
+
+#include <private/qthread_p.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QMetaCallBatch
+
+    Delivers the queued calls of connections made with Qt::BatchedConnection.
+
+    Instead of allocating a QMetaCallEvent and posting it with
+    QCoreApplication::postEvent() (which locks the receiver thread's event
+    list), QMetaObject::activate() allocates a single entry, copies the
+    arguments into it (in place if they are small enough) and pushes it onto
+    a lock-free stack of the receiver's QThreadData. Only the emission that
+    finds the stack empty wakes up the receiver's event loop;
+    QCoreApplicationPrivate::sendPostedEvents() then delivers all the calls
+    at once, in the order they were posted. If a slot runs a nested event
+    loop, the calls that the outer delivery has not reached yet go first.
+
+    When MaxPendingCalls calls are waiting, the receiver is not keeping up,
+    and further calls are posted as QMetaCallEvents until it catches up.
+
+    For Qt::CoalescedConnection, the pending call is stored in the
+    connection itself and a token is pushed on the stack; further emissions
+    replace the pending call until the token is processed, so the slot is
+    invoked once with the latest arguments.
+
+    Each entry references the connection, and the slot object if any, so
+    they stay valid until the call is delivered. A call is dropped if the
+    connection was broken in the meantime, and forwarded to the receiver's
+    new thread if it was moved.
+*/
+
+namespace {
+enum {
+    MaxPendingCalls = 65536
+};
+}
+
+static QBasicAtomicInt pendingCallCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+// returns 0 if too many calls are pending, the call must then be posted as an event
+static QMetaCallBatchEntry *allocateEntry()
+{
+    if (pendingCallCount.fetchAndAddRelaxed(1) >= MaxPendingCalls) {
+        pendingCallCount.deref();
+        return 0;
+    }
+    QMetaCallBatchEntry *entry = new QMetaCallBatchEntry;
+    Q_CHECK_PTR(entry);
+    entry->token = false;
+    return entry;
+}
+
+// Tokens don't count towards MaxPendingCalls: there is at most one for each
+// call waiting in a Connection::pendingCall (give or take one being delivered).
+static QMetaCallBatchEntry *allocateToken()
+{
+    QMetaCallBatchEntry *token = new QMetaCallBatchEntry;
+    Q_CHECK_PTR(token);
+    token->token = true;
+    return token;
+}
+
+static void freeEntry(QMetaCallBatchEntry *entry)
+{
+    if (!entry->token)
+        pendingCallCount.deref();
+    delete entry;
+}
+
+static void push(QThreadData *data, QMetaCallBatchEntry *entry)
+{
+    QMetaCallBatchEntry *head = data->metaCallBatch.loadAcquire();
+    do {
+        entry->next = head;
+    } while (!data->metaCallBatch.testAndSetOrdered(head, entry, head));
+
+    if (head)
+        return; // the event loop has been woken up for the calls already pending
+
+    QMutexLocker locker(&data->postEventList.mutex);
+    data->canWait = false;
+    locker.unlock();
+
+    QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+    if (dispatcher)
+        dispatcher->wakeUp();
+}
+
+/*!
+    \internal
+    Queues the call of connection \a c for \a signal of \a sender, with the
+    arguments \a argv of types \a argumentTypes. \a slotObj is the slot
+    object of \a c, if any.
+
+    Returns \c false if the call could not be batched, in which case it must
+    be posted as a QMetaCallEvent.
+*/
+bool QMetaCallBatch::post(QObjectPrivate::Connection *c, QtPrivate::QSlotObjectBase *slotObj,
+                          const QObject *sender, int signal, const int *argumentTypes, void **argv)
+{
+    QMetaCallBatchEntry *entry = allocateEntry();
+    if (!entry)
+        return false;
+
+    int nargs = 1; // include return type
+    while (argumentTypes[nargs-1])
+        ++nargs;
+
+    c->ref();
+    if (slotObj)
+        slotObj->ref();
+    entry->signalId = signal;
+    entry->nargs = nargs;
+    entry->connection = c;
+    entry->slotObj = slotObj;
+    entry->sender = sender;
+    entry->types = argumentTypes;
+    if (nargs <= QMetaCallBatchEntry::InlineArgumentCount + 1) {
+        entry->args = entry->inlineArgs;
+    } else {
+        entry->args = static_cast<void **>(malloc(nargs * sizeof(void *)));
+        Q_CHECK_PTR(entry->args);
+    }
+    entry->args[0] = 0; // return value
+    for (int n = 1; n < nargs; ++n) {
+        const int type = argumentTypes[n-1];
+        if (n <= QMetaCallBatchEntry::InlineArgumentCount
+                && QMetaType::sizeOf(type) <= QMetaCallBatchEntry::InlineStorageSize) {
+            void *where = entry->storage.data + (n - 1) * QMetaCallBatchEntry::InlineStorageSize;
+            entry->args[n] = QMetaType::construct(type, where, argv[n]);
+        } else {
+            entry->args[n] = QMetaType::create(type, argv[n]);
+        }
+    }
+
+    if (c->isCoalesced) {
+        if (QMetaCallBatchEntry *previous = c->pendingCall.fetchAndStoreOrdered(entry)) {
+            // not delivered yet, and the token for it is already queued
+            release(previous);
+            return true;
+        }
+        // the call must not be lost once it is in pendingCall, so the token
+        // can't fail
+        QMetaCallBatchEntry *token = allocateToken();
+        c->ref();
+        token->nargs = 0;
+        token->connection = c;
+        token->slotObj = 0;
+        token->args = 0;
+        entry = token;
+    }
+
+    push(c->receiverThreadData.loadAcquire(), entry);
+    return true;
+}
+
+/*!
+    \internal
+    Returns \c true if calls are waiting to be delivered in the thread of
+    \a data, which must be the current thread.
+*/
+bool QMetaCallBatch::hasPendingCalls(const QThreadData *data)
+{
+    return data->metaCallBatch.load() != 0 || data->metaCallBatchInDelivery;
+}
+
+/*!
+    \internal
+    Delivers the calls that are pending in the thread of \a data, which must
+    be the current thread.
+*/
+void QMetaCallBatch::sendPendingCalls(QThreadData *data)
+{
+    // the stack is in the reverse order of posting
+    QMetaCallBatchEntry *calls = 0;
+    QMetaCallBatchEntry *entry = data->metaCallBatch.fetchAndStoreAcquire(0);
+    while (entry) {
+        QMetaCallBatchEntry *next = entry->next;
+        entry->next = calls;
+        calls = entry;
+        entry = next;
+    }
+
+    // A slot may run a nested event loop, which comes back here. The calls
+    // that the outer level has not delivered yet are older, so they go first.
+    QMetaCallBatchEntry **tail = &data->metaCallBatchInDelivery;
+    while (*tail)
+        tail = &(*tail)->next;
+    *tail = calls;
+
+    while ((entry = data->metaCallBatchInDelivery)) {
+        data->metaCallBatchInDelivery = entry->next;
+
+        if (entry->token) {
+            QMetaCallBatchEntry *token = entry;
+            entry = token->connection->pendingCall.fetchAndStoreAcquire(0);
+            release(token);
+            if (!entry)
+                continue;
+        }
+
+        QObjectPrivate::Connection *c = entry->connection;
+        if (QObject *receiver = c->receiver.loadAcquire()) {
+            QThreadData *receiverData = c->receiverThreadData.loadAcquire();
+            if (receiverData != data) {
+                // the receiver was moved to another thread after the call was posted
+                push(receiverData, entry);
+                continue;
+            }
+
+            if (entry->slotObj) {
+                QMetaCallEvent ev(entry->slotObj, entry->sender, entry->signalId,
+                                  entry->nargs, 0, entry->args);
+                QCoreApplication::sendEvent(receiver, &ev);
+            } else {
+                QMetaCallEvent ev(c->method_offset, c->method_relative, c->callFunction,
+                                  entry->sender, entry->signalId, entry->nargs, 0, entry->args);
+                QCoreApplication::sendEvent(receiver, &ev);
+            }
+        }
+        release(entry);
+    }
+}
+
+/*!
+    \internal
+    Drops the calls that are pending in the thread of \a data, when the thread
+    finishes or its data is destroyed.
+*/
+static void discardCalls(QMetaCallBatchEntry *entry)
+{
+    while (entry) {
+        QMetaCallBatchEntry *next = entry->next;
+        if (entry->token) {
+            if (QMetaCallBatchEntry *call = entry->connection->pendingCall.fetchAndStoreAcquire(0))
+                QMetaCallBatch::release(call);
+        }
+        QMetaCallBatch::release(entry);
+        entry = next;
+    }
+}
+
+void QMetaCallBatch::discardPendingCalls(QThreadData *data)
+{
+    discardCalls(data->metaCallBatchInDelivery);
+    data->metaCallBatchInDelivery = 0;
+    discardCalls(data->metaCallBatch.fetchAndStoreAcquire(0));
+}
+
+/*!
+    \internal
+    Destroys the arguments of \a entry, drops its references and returns it to the pool.
+*/
+void QMetaCallBatch::release(QMetaCallBatchEntry *entry)
+{
+    for (int n = 1; n < entry->nargs; ++n) {
+        const int type = entry->types[n-1];
+        void *inlineArgument = entry->storage.data + (n - 1) * QMetaCallBatchEntry::InlineStorageSize;
+        if (n <= QMetaCallBatchEntry::InlineArgumentCount && entry->args[n] == inlineArgument)
+            QMetaType::destruct(type, entry->args[n]);
+        else
+            QMetaType::destroy(type, entry->args[n]);
+    }
+    if (entry->args != entry->inlineArgs)
+        free(entry->args);
+    if (entry->slotObj)
+        entry->slotObj->destroyIfLastRef();
+
+    QObjectPrivate::Connection *c = entry->connection;
+    freeEntry(entry);
+    c->deref();
+}
+
+QT_END_NAMESPACE
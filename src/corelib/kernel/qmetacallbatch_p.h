@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMETACALLBATCH_P_H
+#define QMETACALLBATCH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of qobject.cpp and qcoreapplication.cpp.  This header file may change
+// from version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/private/qobject_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QThreadData;
+
+/*
+    A queued call of a Qt::BatchedConnection. Entries are allocated on the
+    heap and linked into the QThreadData::metaCallBatch stack of the
+    receiver's thread.
+*/
+struct QMetaCallBatchEntry
+{
+    enum {
+        InlineArgumentCount = 4,
+        InlineStorageSize = 8   // per argument
+    };
+
+    bool token;                           // the call is in connection->pendingCall (Qt::CoalescedConnection)
+    int signalId;
+    int nargs;
+    QMetaCallBatchEntry *next;
+    QObjectPrivate::Connection *connection; // referenced
+    QtPrivate::QSlotObjectBase *slotObj;  // referenced, or 0
+    const QObject *sender;
+    const int *types;                     // owned by the connection, see Connection::argumentTypes
+    void **args;
+    void *inlineArgs[InlineArgumentCount + 1];
+    union {
+        double alignment;
+        char data[InlineArgumentCount * InlineStorageSize];
+    } storage;
+};
+
+class QMetaCallBatch
+{
+public:
+    static bool post(QObjectPrivate::Connection *c, QtPrivate::QSlotObjectBase *slotObj,
+                     const QObject *sender, int signal, const int *argumentTypes, void **argv);
+    static bool hasPendingCalls(const QThreadData *data);
+    static void sendPendingCalls(QThreadData *data);
+    static void discardPendingCalls(QThreadData *data);
+    static void release(QMetaCallBatchEntry *entry);
+};
+
+QT_END_NAMESPACE
+
+#endif // QMETACALLBATCH_P_H
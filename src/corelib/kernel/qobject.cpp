@@ -62,7 +62,9 @@
 
 #include <private/qorderedmutexlocker_p.h>
 #include <private/qhooks_p.h>
+#include <private/qmetacallbatch_p.h>
 
+#include <algorithm>
 #include <new>
 
 #include <ctype.h>
@@ -279,6 +281,112 @@ static void computeOffsets(const QMetaObject *metaobject, int *signalOffset, int
     }
 }
 
+/*
+    A QConnectionSnapshot is an immutable copy of the connections that are
+    activated when a signal is emitted: the ones in the signal's own
+    connection list, followed by the ones connected to all signals.
+
+    QMetaObject::activate() iterates over a snapshot without locking the
+    sender's mutex. Connecting or disconnecting never modifies a snapshot;
+    it removes it from the QObjectConnectionListVector (which rebuilds it on
+    the next emission) and retires it. A retired snapshot is freed once no
+    activation can still be reading it.
+
+    Each entry holds a reference to its Connection and, for functor based
+    connections, to the slot object, so that neither of them can be destroyed
+    while an emission is using them. Dropping the last reference of a slot
+    object may run arbitrary code, so snapshots are always freed with the
+    mutex unlocked.
+*/
+struct QConnectionSnapshot
+{
+    struct Entry {
+        QObjectPrivate::Connection *connection;
+        QtPrivate::QSlotObjectBase *slotObj;
+    };
+
+    QConnectionSnapshot *nextRetired;
+    int count;
+    Entry entries[1];
+
+    static QConnectionSnapshot *create(const QObjectPrivate::ConnectionList *list,
+                                       const QObjectPrivate::ConnectionList &allsignals);
+    static void free(QConnectionSnapshot *snapshot);
+};
+
+/*
+    The snapshots of one object: entry 0 is used for signals without their own
+    connection list, entry signal + 1 for the others. The table is replaced
+    (and the old one retired) when the connection list vector grows.
+*/
+struct QConnectionSnapshotTable
+{
+    QConnectionSnapshotTable *nextRetired;
+    int size;
+    QBasicAtomicPointer<QConnectionSnapshot> snapshots[1];
+};
+
+static void appendToSnapshot(QConnectionSnapshot::Entry *&entry, const QObjectPrivate::ConnectionList &list)
+{
+    for (QObjectPrivate::Connection *c = list.first; c; c = c->nextConnectionList) {
+        if (!c->receiver)
+            continue;
+        c->ref();
+        entry->connection = c;
+        entry->slotObj = 0;
+        if (c->isSlotObject) {
+            c->slotObj->ref();
+            entry->slotObj = c->slotObj;
+        }
+        ++entry;
+    }
+}
+
+/*
+    Must be called with the mutex of the owner of \a list and \a allsignals locked.
+ */
+QConnectionSnapshot *QConnectionSnapshot::create(const QObjectPrivate::ConnectionList *list,
+                                                 const QObjectPrivate::ConnectionList &allsignals)
+{
+    int count = 0;
+    for (const QObjectPrivate::Connection *c = list ? list->first : 0; c; c = c->nextConnectionList)
+        count += c->receiver ? 1 : 0;
+    for (const QObjectPrivate::Connection *c = allsignals.first; c; c = c->nextConnectionList)
+        count += c->receiver ? 1 : 0;
+
+    QConnectionSnapshot *snapshot = static_cast<QConnectionSnapshot *>(
+                malloc(sizeof(QConnectionSnapshot) + qMax(count - 1, 0) * sizeof(Entry)));
+    Q_CHECK_PTR(snapshot);
+    snapshot->nextRetired = 0;
+    snapshot->count = count;
+
+    Entry *entry = snapshot->entries;
+    if (list)
+        appendToSnapshot(entry, *list);
+    appendToSnapshot(entry, allsignals);
+    Q_ASSERT(entry == snapshot->entries + count);
+    return snapshot;
+}
+
+/*
+    Frees \a snapshot and all the snapshots retired before it. Must not be
+    called with a signal slot mutex locked.
+ */
+void QConnectionSnapshot::free(QConnectionSnapshot *snapshot)
+{
+    while (snapshot) {
+        QConnectionSnapshot *next = snapshot->nextRetired;
+        for (int i = 0; i < snapshot->count; ++i) {
+            const Entry &entry = snapshot->entries[i];
+            if (entry.slotObj)
+                entry.slotObj->destroyIfLastRef();
+            entry.connection->deref();
+        }
+        ::free(snapshot);
+        snapshot = next;
+    }
+}
+
 /*
     This vector contains the all connections from an object.
 
@@ -288,7 +396,9 @@ static void computeOffsets(const QMetaObject *metaobject, int *signalOffset, int
     QObjectPrivate::signalIndex (not QMetaObject::indexOfSignal).
     Negative index means connections to all signals.
 
-    This vector is protected by the object mutex (signalSlotMutexes())
+    This vector is protected by the object mutex (signalSlotMutexes()),
+    except for the snapshots and the emitting counter, which
+    QMetaObject::activate() uses without locking (see QConnectionSnapshot).
 
     Each Connection is also part of a 'senders' linked list. The mutex
     of the receiver must be locked when touching the pointers of this
@@ -302,18 +412,145 @@ public:
     int inUse; //number of functions that are currently accessing this object or its connections
     QObjectPrivate::ConnectionList allsignals;
 
+    // number of QMetaObject::activate() calls reading the snapshots, shifted left by one;
+    // bit 0 is set when snapshots were retired while they were running
+    QAtomicInt emitting;
+    QAtomicPointer<QConnectionSnapshotTable> snapshots;
+    QConnectionSnapshot *retiredSnapshots;
+    QConnectionSnapshotTable *retiredTables;
+
     QObjectConnectionListVector()
-        : QVector<QObjectPrivate::ConnectionList>(), orphaned(false), dirty(false), inUse(0)
+        : QVector<QObjectPrivate::ConnectionList>(), orphaned(false), dirty(false), inUse(0),
+          emitting(0), snapshots(0), retiredSnapshots(0), retiredTables(0)
     { }
 
+    ~QObjectConnectionListVector()
+    {
+        // the snapshots must have been collected, see deleteConnectionLists()
+        Q_ASSERT(!retiredSnapshots && !retiredTables);
+        ::free(snapshots.load());
+    }
+
     QObjectPrivate::ConnectionList &operator[](int at)
     {
         if (at < 0)
             return allsignals;
         return QVector<QObjectPrivate::ConnectionList>::operator[](at);
     }
+
+    bool isEmitting() const { return emitting.load() >> 1; }
+
+    // Does not lock; returns 0 if the snapshot needs to be created first
+    QConnectionSnapshot *snapshot(int signal) const
+    {
+        const QConnectionSnapshotTable *table = snapshots.loadAcquire();
+        if (!table)
+            return 0;
+        return table->snapshots[signal + 1 < table->size ? signal + 1 : 0].loadAcquire();
+    }
+
+    QConnectionSnapshot *createSnapshot(int signal);
+    void invalidateSnapshots(int signal);
+    QConnectionSnapshot *collectGarbage();
+
+private:
+    void retire(QConnectionSnapshotTable *table, int entry)
+    {
+        if (QConnectionSnapshot *snapshot = table->snapshots[entry].fetchAndStoreRelaxed(0)) {
+            snapshot->nextRetired = retiredSnapshots;
+            retiredSnapshots = snapshot;
+        }
+    }
 };
 
+/*
+    Returns the snapshot used to activate \a signal, creating it if needed.
+    Must be called with the mutex locked.
+ */
+QConnectionSnapshot *QObjectConnectionListVector::createSnapshot(int signal)
+{
+    QConnectionSnapshotTable *table = snapshots.load();
+    if (!table) {
+        const int size = count() + 1;
+        table = static_cast<QConnectionSnapshotTable *>(
+                    calloc(1, sizeof(QConnectionSnapshotTable)
+                              + (size - 1) * sizeof(QBasicAtomicPointer<QConnectionSnapshot>)));
+        Q_CHECK_PTR(table);
+        table->size = size;
+        snapshots.storeRelease(table);
+    }
+
+    const int entry = signal + 1 < table->size ? signal + 1 : 0;
+    QConnectionSnapshot *snapshot = table->snapshots[entry].load();
+    if (!snapshot) {
+        snapshot = QConnectionSnapshot::create(entry ? &at(signal) : 0, allsignals);
+        table->snapshots[entry].storeRelease(snapshot);
+    }
+    return snapshot;
+}
+
+/*
+    Retires the snapshots that contain the connection list of \a signal (all
+    of them if \a signal is negative or out of range). Must be called with the
+    mutex locked, and followed by collectGarbage().
+ */
+void QObjectConnectionListVector::invalidateSnapshots(int signal)
+{
+    QConnectionSnapshotTable *table = snapshots.load();
+    if (!table)
+        return;
+
+    if (table->size != count() + 1) {
+        // the vector grew, a new table will be created on the next emission
+        for (int i = 0; i < table->size; ++i)
+            retire(table, i);
+        snapshots.store(0);
+        table->nextRetired = retiredTables;
+        retiredTables = table;
+    } else if (signal < 0 || signal + 1 >= table->size) {
+        for (int i = 0; i < table->size; ++i)
+            retire(table, i);
+    } else {
+        retire(table, signal + 1);
+    }
+}
+
+/*
+    Must be called with the mutex locked. Returns the retired snapshots if no
+    activation can still be reading them; the caller must pass them to
+    QConnectionSnapshot::free() after unlocking the mutex. Otherwise, the last
+    running activation will collect them.
+ */
+QConnectionSnapshot *QObjectConnectionListVector::collectGarbage()
+{
+    if (!retiredSnapshots && !retiredTables)
+        return 0;
+    if (emitting.fetchAndOrOrdered(1) >> 1)
+        return 0;
+    emitting.fetchAndAndOrdered(~1);
+
+    while (QConnectionSnapshotTable *table = retiredTables) {
+        retiredTables = table->nextRetired;
+        ::free(table);
+    }
+    QConnectionSnapshot *garbage = retiredSnapshots;
+    retiredSnapshots = 0;
+    return garbage;
+}
+
+/*
+    Deletes \a connectionLists, which must not be in use anymore. Returns its
+    snapshots, to be freed once the mutex is unlocked.
+ */
+static QConnectionSnapshot *deleteConnectionLists(QObjectConnectionListVector *connectionLists)
+{
+    Q_ASSERT(!connectionLists->inUse && !connectionLists->isEmitting());
+    connectionLists->invalidateSnapshots(-1);
+    QConnectionSnapshot *garbage = connectionLists->collectGarbage();
+    delete connectionLists;
+    return garbage;
+}
+
 // Used by QAccessibleWidget
 bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
 {
@@ -322,7 +559,7 @@ bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
     if (signal_index < 0)
         return false;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (const QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
             const QObjectPrivate::Connection *c =
                 connectionLists->at(signal_index).first;
@@ -346,7 +583,7 @@ QObjectList QObjectPrivate::receiverList(const char *signal) const
     if (signal_index < 0)
         return returnValue;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (const QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
             const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first;
 
@@ -376,15 +613,19 @@ QObjectList QObjectPrivate::senderList() const
   for the specified \a signal
 
   The signalSlotLock() of the sender and receiver must be locked while calling
-  this function
+  this function. The snapshots this retires must be collected by the caller
+  (see QObjectConnectionListVector::collectGarbage()).
 
   Will also add the connection in the sender's list of the receiver.
  */
 void QObjectPrivate::addConnection(int signal, Connection *c)
 {
     Q_ASSERT(c->sender == q_ptr);
-    if (!connectionLists)
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
+    if (!connectionLists) {
         connectionLists = new QObjectConnectionListVector();
+        this->connectionLists.storeRelease(connectionLists);
+    }
     if (signal >= connectionLists->count())
         connectionLists->resize(signal + 1);
 
@@ -395,6 +636,7 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
         connectionList.first = c;
     }
     connectionList.last = c;
+    connectionLists->invalidateSnapshots(signal);
 
     cleanConnectionLists();
 
@@ -413,6 +655,7 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
 
 void QObjectPrivate::cleanConnectionLists()
 {
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
     if (connectionLists->dirty && !connectionLists->inUse) {
         // remove broken connections
         for (int signal = -1; signal < connectionLists->count(); ++signal) {
@@ -916,17 +1159,18 @@ QObject::~QObject()
         d->currentSender->ref = 0;
     d->currentSender = 0;
 
-    if (d->connectionLists || d->senders) {
+    QConnectionSnapshot *garbage = 0;
+    if (d->connectionLists.load() || d->senders) {
         QMutex *signalSlotMutex = signalSlotLock(this);
         QMutexLocker locker(signalSlotMutex);
 
         // disconnect all receivers
-        if (d->connectionLists) {
-            ++d->connectionLists->inUse;
-            int connectionListsCount = d->connectionLists->count();
+        if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            ++connectionLists->inUse;
+            int connectionListsCount = connectionLists->count();
             for (int signal = -1; signal < connectionListsCount; ++signal) {
                 QObjectPrivate::ConnectionList &connectionList =
-                    (*d->connectionLists)[signal];
+                    (*connectionLists)[signal];
 
                 while (QObjectPrivate::Connection *c = connectionList.first) {
                     if (!c->receiver) {
@@ -959,12 +1203,14 @@ QObject::~QObject()
                 }
             }
 
-            if (!--d->connectionLists->inUse) {
-                delete d->connectionLists;
+            if (!--connectionLists->inUse && !connectionLists->isEmitting()) {
+                garbage = deleteConnectionLists(connectionLists);
             } else {
-                d->connectionLists->orphaned = true;
+                connectionLists->orphaned = true;
+                connectionLists->invalidateSnapshots(-1);
+                garbage = connectionLists->collectGarbage();
             }
-            d->connectionLists = 0;
+            d->connectionLists.store(0);
         }
 
         /* Disconnect all senders:
@@ -994,9 +1240,13 @@ QObject::~QObject()
                 continue;
             }
             node->receiver = 0;
-            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists;
-            if (senderLists)
+            QConnectionSnapshot *senderGarbage = 0;
+            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists.load();
+            if (senderLists) {
                 senderLists->dirty = true;
+                senderLists->invalidateSnapshots(node->signal_index);
+                senderGarbage = senderLists->collectGarbage();
+            }
 
             QtPrivate::QSlotObjectBase *slotObj = Q_NULLPTR;
             if (node->isSlotObject) {
@@ -1008,15 +1258,18 @@ QObject::~QObject()
             if (needToUnlock)
                 m->unlock();
 
-            if (slotObj) {
+            if (slotObj || senderGarbage) {
                 if (node)
                     node->prev = &node;
                 locker.unlock();
-                slotObj->destroyIfLastRef();
+                if (slotObj)
+                    slotObj->destroyIfLastRef();
+                QConnectionSnapshot::free(senderGarbage);
                 locker.relock();
             }
         }
     }
+    QConnectionSnapshot::free(garbage);
 
     if (!d->children.isEmpty())
         d->deleteChildren();
@@ -1038,8 +1291,25 @@ QObjectPrivate::Connection::~Connection()
         if (v != &DIRECT_CONNECTION_ONLY)
             delete [] v;
     }
+    Q_ASSERT(!pendingCall.load());
     if (isSlotObject)
         slotObj->destroyIfLastRef();
+    if (QThreadData *threadData = receiverThreadData.load())
+        threadData->deref();
+}
+
+/*!
+    \internal
+    Stores the thread data of the receiver, so that QMetaObject::activate()
+    can decide how to invoke the slot without accessing a receiver that might
+    be getting destroyed in another thread. Must be called with the receiver's
+    mutex locked.
+*/
+void QObjectPrivate::Connection::setReceiverThreadData(QThreadData *threadData)
+{
+    threadData->ref();
+    if (QThreadData *old = receiverThreadData.fetchAndStoreRelease(threadData))
+        old->deref();
 }
 
 
@@ -1415,6 +1685,14 @@ QThread *QObject::thread() const
     return d_func()->threadData->thread;
 }
 
+static void collectSignalSlotLocks(const QObject *o, QVarLengthArray<QMutex *, 16> *locks)
+{
+    locks->append(signalSlotLock(o));
+    const QObjectList &children = QObjectPrivate::get(o)->children;
+    for (int i = 0; i < children.size(); ++i)
+        collectSignalSlotLocks(children.at(i), locks);
+}
+
 /*!
     Changes the thread affinity for this object and its children. The
     object cannot be moved if it has a parent. Event processing will
@@ -1492,6 +1770,17 @@ void QObject::moveToThread(QThread *targetThread)
     if (!targetData)
         targetData = new QThreadData(0);
 
+    // make sure nobody adds/removes connections to this object or its children
+    // while we're moving them; their locks have to be taken before the post
+    // event list mutexes and in the same order as QOrderedMutexLocker does
+    QVarLengthArray<QMutex *, 16> signalSlotLocks;
+    collectSignalSlotLocks(this, &signalSlotLocks);
+    std::sort(signalSlotLocks.begin(), signalSlotLocks.end(), std::less<QMutex *>());
+    signalSlotLocks.erase(std::unique(signalSlotLocks.begin(), signalSlotLocks.end()),
+                          signalSlotLocks.end());
+    for (QMutex *mutex : qAsConst(signalSlotLocks))
+        mutex->lock();
+
     QOrderedMutexLocker locker(&currentData->postEventList.mutex,
                                &targetData->postEventList.mutex);
 
@@ -1502,6 +1791,8 @@ void QObject::moveToThread(QThread *targetThread)
     d_func()->setThreadData_helper(currentData, targetData);
 
     locker.unlock();
+    for (int i = signalSlotLocks.size() - 1; i >= 0; --i)
+        signalSlotLocks.at(i)->unlock();
 
     // now currentData can commit suicide if it wants to
     currentData->deref();
@@ -1550,6 +1841,11 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     threadData->deref();
     threadData = targetData;
 
+    // the senders list is protected by our signal/slot lock, which
+    // moveToThread() holds for this object and all of its children
+    for (Connection *c = senders; c; c = c->next)
+        c->setReceiverThreadData(targetData);
+
     for (int i = 0; i < children.size(); ++i) {
         QObject *child = children.at(i);
         child->d_func()->setThreadData_helper(currentData, targetData);
@@ -2451,10 +2747,10 @@ int QObject::receivers(const char *signal) const
         }
 
         QMutexLocker locker(signalSlotLock(this));
-        if (d->connectionLists) {
-            if (signal_index < d->connectionLists->count()) {
+        if (const QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            if (signal_index < connectionLists->count()) {
                 const QObjectPrivate::Connection *c =
-                    d->connectionLists->at(signal_index).first;
+                    connectionLists->at(signal_index).first;
                 while (c) {
                     receivers += c->receiver ? 1 : 0;
                     c = c->nextConnectionList;
@@ -2502,10 +2798,10 @@ bool QObject::isSignalConnected(const QMetaMethod &signal) const
         return d->isSignalConnected(signalIndex);
 
     QMutexLocker locker(signalSlotLock(this));
-    if (d->connectionLists) {
-        if (signalIndex < uint(d->connectionLists->count())) {
+    if (const QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        if (signalIndex < uint(connectionLists->count())) {
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signalIndex).first;
+                connectionLists->at(signalIndex).first;
             while (c) {
                 if (c->receiver)
                     return true;
@@ -2759,7 +3055,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const char *sign
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if ((type & ~(Qt::BatchedConnection | Qt::CoalescedConnection)) == Qt::QueuedConnection
             && !(types = queuedConnectionTypes(signalTypes.constData(), signalTypes.size()))) {
         return QMetaObject::Connection(0);
     }
@@ -2840,7 +3136,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const QMetaMetho
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if ((type & ~(Qt::BatchedConnection | Qt::CoalescedConnection)) == Qt::QueuedConnection
             && !(types = queuedConnectionTypes(signal.parameterTypes())))
         return QMetaObject::Connection(0);
 
@@ -3279,6 +3575,10 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     QObjectPrivate::StaticMetaCallFunction callFunction =
         rmeta ? rmeta->d.static_metacall : 0;
 
+    const bool batched = type & (Qt::BatchedConnection | Qt::CoalescedConnection);
+    const bool coalesced = type & Qt::CoalescedConnection;
+    type &= ~(Qt::BatchedConnection | Qt::CoalescedConnection);
+
     QOrderedMutexLocker locker(signalSlotLock(sender),
                                signalSlotLock(receiver));
 
@@ -3307,13 +3607,18 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     c->method_offset = method_offset;
     c->connectionType = type;
     c->isSlotObject = false;
+    c->isBatched = batched;
+    c->isCoalesced = coalesced;
     c->argumentTypes.store(types);
     c->nextConnectionList = 0;
     c->callFunction = callFunction;
+    c->setReceiverThreadData(QObjectPrivate::get(r)->threadData);
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.data());
+    QConnectionSnapshot *garbage = QObjectPrivate::get(s)->connectionLists.load()->collectGarbage();
 
     locker.unlock();
+    QConnectionSnapshot::free(garbage);
     QMetaMethod smethod = QMetaObjectPrivate::signal(smeta, signal_index);
     if (smethod.isValid())
         s->connectNotify(smethod);
@@ -3432,6 +3737,7 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
             if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
                 success = true;
                 connectionLists->dirty = true;
+                connectionLists->invalidateSnapshots(sig_index);
             }
         }
     } else if (signal_index < connectionLists->count()) {
@@ -3440,15 +3746,20 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
         if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
             success = true;
             connectionLists->dirty = true;
+            connectionLists->invalidateSnapshots(signal_index);
         }
     }
 
     --connectionLists->inUse;
     Q_ASSERT(connectionLists->inUse >= 0);
-    if (connectionLists->orphaned && !connectionLists->inUse)
-        delete connectionLists;
+    QConnectionSnapshot *garbage;
+    if (connectionLists->orphaned && !connectionLists->inUse && !connectionLists->isEmitting())
+        garbage = deleteConnectionLists(connectionLists);
+    else
+        garbage = connectionLists->collectGarbage();
 
     locker.unlock();
+    QConnectionSnapshot::free(garbage);
     if (success) {
         QMetaMethod smethod = QMetaObjectPrivate::signal(smeta, signal_index);
         if (smethod.isValid())
@@ -3565,8 +3876,8 @@ void QMetaObject::connectSlotsByName(QObject *o)
 
     \a signal must be in the signal index range (see QObjectPrivate::signalIndex()).
 */
-static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv,
-                            QMutexLocker &locker)
+// returns 0 if the arguments of \a signal cannot be queued
+static const int *queuedArgumentTypes(QObject *sender, int signal, QObjectPrivate::Connection *c)
 {
     const int *argumentTypes = c->argumentTypes.load();
     if (!argumentTypes) {
@@ -3581,6 +3892,14 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
         }
     }
     if (argumentTypes == &DIRECT_CONNECTION_ONLY) // cannot activate
+        return 0;
+    return argumentTypes;
+}
+
+static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv)
+{
+    const int *argumentTypes = queuedArgumentTypes(sender, signal, c);
+    if (!argumentTypes)
         return;
     int nargs = 1; // include return type
     while (argumentTypes[nargs-1])
@@ -3592,25 +3911,20 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     types[0] = 0; // return type
     args[0] = 0; // return value
 
-    if (nargs > 1) {
-        for (int n = 1; n < nargs; ++n)
-            types[n] = argumentTypes[n-1];
+    for (int n = 1; n < nargs; ++n) {
+        types[n] = argumentTypes[n-1];
+        args[n] = QMetaType::create(types[n], argv[n]);
+    }
 
+    QMutexLocker locker(signalSlotLock(sender));
+    if (!c->receiver) {
         locker.unlock();
+        // we have been disconnected since the emission started
         for (int n = 1; n < nargs; ++n)
-            args[n] = QMetaType::create(types[n], argv[n]);
-        locker.relock();
-
-        if (!c->receiver) {
-            locker.unlock();
-            // we have been disconnected while the mutex was unlocked
-            for (int n = 1; n < nargs; ++n)
-                QMetaType::destroy(types[n], args[n]);
-            free(types);
-            free(args);
-            locker.relock();
-            return;
-        }
+            QMetaType::destroy(types[n], args[n]);
+        free(types);
+        free(args);
+        return;
     }
 
     QMetaCallEvent *ev = c->isSlotObject ?
@@ -3658,143 +3972,145 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
     }
 
     {
-    QMutexLocker locker(signalSlotLock(sender));
     struct ConnectionListsRef {
+        QObject *sender;
         QObjectConnectionListVector *connectionLists;
-        ConnectionListsRef(QObjectConnectionListVector *connectionLists) : connectionLists(connectionLists)
+        ConnectionListsRef(QObject *sender, QObjectConnectionListVector *connectionLists)
+            : sender(sender), connectionLists(connectionLists)
         {
             if (connectionLists)
-                ++connectionLists->inUse;
+                connectionLists->emitting.fetchAndAddOrdered(2);
         }
         ~ConnectionListsRef()
         {
             if (!connectionLists)
                 return;
 
-            --connectionLists->inUse;
-            Q_ASSERT(connectionLists->inUse >= 0);
-            if (connectionLists->orphaned) {
-                if (!connectionLists->inUse)
-                    delete connectionLists;
+            // the vector is only orphaned from this thread, when the sender is
+            // destroyed during the emission; deleting it requires the mutex
+            const bool orphaned = connectionLists->orphaned;
+            if (!orphaned && connectionLists->emitting.fetchAndAddOrdered(-2) != 3)
+                return; // nothing was retired while we were the last one emitting
+
+            QConnectionSnapshot *garbage;
+            {
+                QMutexLocker locker(signalSlotLock(sender));
+                if (orphaned)
+                    connectionLists->emitting.fetchAndAddOrdered(-2);
+                if (orphaned && !connectionLists->inUse && !connectionLists->isEmitting())
+                    garbage = deleteConnectionLists(connectionLists);
+                else
+                    garbage = connectionLists->collectGarbage();
             }
+            QConnectionSnapshot::free(garbage);
         }
 
         QObjectConnectionListVector *operator->() const { return connectionLists; }
     };
-    ConnectionListsRef connectionLists = sender->d_func()->connectionLists;
+    ConnectionListsRef connectionLists(sender, sender->d_func()->connectionLists.loadAcquire());
     if (!connectionLists.connectionLists) {
-        locker.unlock();
         if (qt_signal_spy_callback_set.signal_end_callback != 0)
             qt_signal_spy_callback_set.signal_end_callback(sender, signal_index);
         return;
     }
 
-    const QObjectPrivate::ConnectionList *list;
-    if (signal_index < connectionLists->count())
-        list = &connectionLists->at(signal_index);
-    else
-        list = &connectionLists->allsignals;
+    // The snapshot is not modified by connections made or broken during the
+    // emission, so the slots connected by the slots are not activated by this
+    // emission. The ones disconnected are skipped because their receiver is 0.
+    QConnectionSnapshot *snapshot = connectionLists->snapshot(signal_index);
+    if (!snapshot) {
+        QMutexLocker locker(signalSlotLock(sender));
+        snapshot = connectionLists->createSnapshot(signal_index);
+    }
 
     Qt::HANDLE currentThreadId = QThread::currentThreadId();
 
-    do {
-        QObjectPrivate::Connection *c = list->first;
-        if (!c) continue;
-        // We need to check against last here to ensure that signals added
-        // during the signal emission are not emitted in this emission.
-        QObjectPrivate::Connection *last = list->last;
-
-        do {
-            if (!c->receiver)
-                continue;
-
-            QObject * const receiver = c->receiver;
-            const bool receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId.load();
+    for (int i = 0; i < snapshot->count; ++i) {
+        const QConnectionSnapshot::Entry &entry = snapshot->entries[i];
+        QObjectPrivate::Connection *c = entry.connection;
+        QObject * const receiver = c->receiver;
+        if (!receiver)
+            continue;
 
-            // determine if this connection should be sent immediately or
-            // put into the event queue
-            if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
-                || (c->connectionType == Qt::QueuedConnection)) {
-                queued_activate(sender, signal_index, c, argv ? argv : empty_argv, locker);
-                continue;
+        // don't use receiver->d_func()->threadData, the receiver might be
+        // getting destroyed in its own thread
+        const bool receiverInSameThread =
+                currentThreadId == c->receiverThreadData.loadAcquire()->threadId.load();
+
+        // determine if this connection should be sent immediately or
+        // put into the event queue
+        if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
+            || (c->connectionType == Qt::QueuedConnection)) {
+            if (c->isBatched) {
+                const int *argumentTypes = queuedArgumentTypes(sender, signal_index, c);
+                if (!argumentTypes)
+                    continue;
+                if (QMetaCallBatch::post(c, entry.slotObj, sender, signal_index,
+                                         argumentTypes, argv ? argv : empty_argv))
+                    continue;
+                // the pool is exhausted, fall back to a QMetaCallEvent
+            }
+            queued_activate(sender, signal_index, c, argv ? argv : empty_argv);
+            continue;
 #ifndef QT_NO_THREAD
-            } else if (c->connectionType == Qt::BlockingQueuedConnection) {
-                if (receiverInSameThread) {
-                    qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
-                    "Sender is %s(%p), receiver is %s(%p)",
-                    sender->metaObject()->className(), sender,
-                    receiver->metaObject()->className(), receiver);
-                }
-                QSemaphore semaphore;
-                QMetaCallEvent *ev = c->isSlotObject ?
-                    new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
+        } else if (c->connectionType == Qt::BlockingQueuedConnection) {
+            if (receiverInSameThread) {
+                qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
+                "Sender is %s(%p), receiver is %s(%p)",
+                sender->metaObject()->className(), sender,
+                receiver->metaObject()->className(), receiver);
+            }
+            QSemaphore semaphore;
+            {
+                QMutexLocker locker(signalSlotLock(sender));
+                if (!c->receiver)
+                    continue;
+                QMetaCallEvent *ev = entry.slotObj ?
+                    new QMetaCallEvent(entry.slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
                     new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
                 QCoreApplication::postEvent(receiver, ev);
-                locker.unlock();
-                semaphore.acquire();
-                locker.relock();
-                continue;
-#endif
-            }
-
-            QConnectionSenderSwitcher sw;
-
-            if (receiverInSameThread) {
-                sw.switchSender(receiver, sender, signal_index);
             }
-            if (c->isSlotObject) {
-                c->slotObj->ref();
-                QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
-                locker.unlock();
-                obj->call(receiver, argv ? argv : empty_argv);
-
-                // Make sure the slot object gets destroyed before the mutex is locked again, as the
-                // destructor of the slot object might also lock a mutex from the signalSlotLock() mutex pool,
-                // and that would deadlock if the pool happens to return the same mutex.
-                obj.reset();
-
-                locker.relock();
-            } else if (c->callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
-                //we compare the vtable to make sure we are not in the destructor of the object.
-                const int methodIndex = c->method();
-                const int method_relative = c->method_relative;
-                const auto callFunction = c->callFunction;
-                locker.unlock();
-                if (qt_signal_spy_callback_set.slot_begin_callback != 0)
-                    qt_signal_spy_callback_set.slot_begin_callback(receiver, methodIndex, argv ? argv : empty_argv);
-
-                callFunction(receiver, QMetaObject::InvokeMetaMethod, method_relative, argv ? argv : empty_argv);
-
-                if (qt_signal_spy_callback_set.slot_end_callback != 0)
-                    qt_signal_spy_callback_set.slot_end_callback(receiver, methodIndex);
-                locker.relock();
-            } else {
-                const int method = c->method_relative + c->method_offset;
-                locker.unlock();
-
-                if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
-                    qt_signal_spy_callback_set.slot_begin_callback(receiver,
-                                                                method,
-                                                                argv ? argv : empty_argv);
-                }
+            semaphore.acquire();
+            continue;
+#endif
+        }
 
-                metacall(receiver, QMetaObject::InvokeMetaMethod, method, argv ? argv : empty_argv);
+        QConnectionSenderSwitcher sw;
 
-                if (qt_signal_spy_callback_set.slot_end_callback != 0)
-                    qt_signal_spy_callback_set.slot_end_callback(receiver, method);
+        if (receiverInSameThread) {
+            sw.switchSender(receiver, sender, signal_index);
+        }
+        if (entry.slotObj) {
+            // the snapshot holds a reference to the slot object
+            entry.slotObj->call(receiver, argv ? argv : empty_argv);
+        } else if (c->callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
+            //we compare the vtable to make sure we are not in the destructor of the object.
+            const int methodIndex = c->method();
+            if (qt_signal_spy_callback_set.slot_begin_callback != 0)
+                qt_signal_spy_callback_set.slot_begin_callback(receiver, methodIndex, argv ? argv : empty_argv);
+
+            c->callFunction(receiver, QMetaObject::InvokeMetaMethod, c->method_relative, argv ? argv : empty_argv);
+
+            if (qt_signal_spy_callback_set.slot_end_callback != 0)
+                qt_signal_spy_callback_set.slot_end_callback(receiver, methodIndex);
+        } else {
+            const int method = c->method_relative + c->method_offset;
 
-                locker.relock();
+            if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
+                qt_signal_spy_callback_set.slot_begin_callback(receiver,
+                                                            method,
+                                                            argv ? argv : empty_argv);
             }
 
-            if (connectionLists->orphaned)
-                break;
-        } while (c != last && (c = c->nextConnectionList) != 0);
+            metacall(receiver, QMetaObject::InvokeMetaMethod, method, argv ? argv : empty_argv);
+
+            if (qt_signal_spy_callback_set.slot_end_callback != 0)
+                qt_signal_spy_callback_set.slot_end_callback(receiver, method);
+        }
 
         if (connectionLists->orphaned)
             break;
-    } while (list != &connectionLists->allsignals &&
-        //start over for all signals;
-        ((list = &connectionLists->allsignals), true));
+    }
 
     }
 
@@ -4061,14 +4377,14 @@ void QObject::dumpObjectInfo() const
     // first, look for connections where this object is the sender
     qDebug("  SIGNALS OUT");
 
-    if (d->connectionLists) {
-        for (int signal_index = 0; signal_index < d->connectionLists->count(); ++signal_index) {
+    if (const QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        for (int signal_index = 0; signal_index < connectionLists->count(); ++signal_index) {
             const QMetaMethod signal = QMetaObjectPrivate::signal(metaObject(), signal_index);
             qDebug("        signal: %s", signal.methodSignature().constData());
 
             // receivers
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first;
             while (c) {
                 if (!c->receiver) {
                     qDebug("          <Disconnected receiver>");
@@ -4080,11 +4396,11 @@ void QObject::dumpObjectInfo() const
                     c = c->nextConnectionList;
                     continue;
                 }
-                const QMetaObject *receiverMetaObject = c->receiver->metaObject();
+                const QMetaObject *receiverMetaObject = c->receiver.load()->metaObject();
                 const QMetaMethod method = receiverMetaObject->method(c->method());
                 qDebug("          --> %s::%s %s",
                        receiverMetaObject->className(),
-                       c->receiver->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver->objectName()),
+                       c->receiver.load()->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver.load()->objectName()),
                        method.methodSignature().constData());
                 c = c->nextConnectionList;
             }
@@ -4806,6 +5122,10 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     QObject *s = const_cast<QObject *>(sender);
     QObject *r = const_cast<QObject *>(receiver);
 
+    const bool batched = type & (Qt::BatchedConnection | Qt::CoalescedConnection);
+    const bool coalesced = type & Qt::CoalescedConnection;
+    type = static_cast<Qt::ConnectionType>(type & ~(Qt::BatchedConnection | Qt::CoalescedConnection));
+
     QOrderedMutexLocker locker(signalSlotLock(sender),
                                signalSlotLock(receiver));
 
@@ -4833,14 +5153,19 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     c->slotObj = slotObj;
     c->connectionType = type;
     c->isSlotObject = true;
+    c->isBatched = batched;
+    c->isCoalesced = coalesced;
     if (types) {
         c->argumentTypes.store(types);
         c->ownArgumentTypes = false;
     }
+    c->setReceiverThreadData(QObjectPrivate::get(r)->threadData);
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.data());
+    QConnectionSnapshot *garbage = QObjectPrivate::get(s)->connectionLists.load()->collectGarbage();
     QMetaObject::Connection ret(c.take());
     locker.unlock();
+    QConnectionSnapshot::free(garbage);
 
     QMetaMethod method = QMetaObjectPrivate::signal(senderMetaObject, signal_index);
     Q_ASSERT(method.isValid());
@@ -4867,6 +5192,7 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
     QMutex *senderMutex = signalSlotLock(c->sender);
     QMutex *receiverMutex = signalSlotLock(c->receiver);
 
+    QConnectionSnapshot *garbage;
     {
         QOrderedMutexLocker locker(senderMutex, receiverMutex);
 
@@ -4878,7 +5204,11 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
         if (c->next)
             c->next->prev = c->prev;
         c->receiver = 0;
+
+        connectionLists->invalidateSnapshots(c->signal_index);
+        garbage = connectionLists->collectGarbage();
     }
+    QConnectionSnapshot::free(garbage);
 
     // destroy the QSlotObject, if possible
     if (c->isSlotObject) {
@@ -249,7 +249,8 @@ public:
                           "Return type of the slot is not compatible with the return type of the signal.");
 
         const int *types = Q_NULLPTR;
-        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+        const int dispatch = type & ~(Qt::BatchedConnection | Qt::CoalescedConnection);
+        if (dispatch == Qt::QueuedConnection || dispatch == Qt::BlockingQueuedConnection)
             types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
         return connectImpl(sender, reinterpret_cast<void **>(&signal),
@@ -289,7 +290,8 @@ public:
                           "Return type of the slot is not compatible with the return type of the signal.");
 
         const int *types = Q_NULLPTR;
-        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+        const int dispatch = type & ~(Qt::BatchedConnection | Qt::CoalescedConnection);
+        if (dispatch == Qt::QueuedConnection || dispatch == Qt::BlockingQueuedConnection)
             types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
         return connectImpl(sender, reinterpret_cast<void **>(&signal), context, Q_NULLPTR,
@@ -328,7 +330,8 @@ public:
                           "No Q_OBJECT in the class with the signal");
 
         const int *types = Q_NULLPTR;
-        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+        const int dispatch = type & ~(Qt::BatchedConnection | Qt::CoalescedConnection);
+        if (dispatch == Qt::QueuedConnection || dispatch == Qt::BlockingQueuedConnection)
             types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
         return connectImpl(sender, reinterpret_cast<void **>(&signal), context, Q_NULLPTR,
@@ -67,6 +67,7 @@ QT_BEGIN_NAMESPACE
 class QVariant;
 class QThreadData;
 class QObjectConnectionListVector;
+struct QMetaCallBatchEntry;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
 /* for Qt Test */
@@ -127,7 +128,8 @@ public:
     struct Connection
     {
         QObject *sender;
-        QObject *receiver;
+        QAtomicPointer<QObject> receiver;
+        QAtomicPointer<QThreadData> receiverThreadData; // referenced; kept in sync by moveToThread()
         union {
             StaticMetaCallFunction callFunction;
             QtPrivate::QSlotObjectBase *slotObj;
@@ -138,6 +140,7 @@ public:
         Connection *next;
         Connection **prev;
         QAtomicPointer<const int> argumentTypes;
+        QAtomicPointer<QMetaCallBatchEntry> pendingCall; // Qt::CoalescedConnection, see QMetaCallBatch
         QAtomicInt ref_;
         ushort method_offset;
         ushort method_relative;
@@ -145,10 +148,14 @@ public:
         ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 4 == blocking
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
-        Connection() : nextConnectionList(0), ref_(2), ownArgumentTypes(true) {
+        ushort isBatched : 1;
+        ushort isCoalesced : 1;
+        Connection() : receiverThreadData(0), nextConnectionList(0), ref_(2), ownArgumentTypes(true),
+                       isBatched(false), isCoalesced(false) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
         ~Connection();
+        void setReceiverThreadData(QThreadData *threadData);
         int method() const { Q_ASSERT(!isSlotObject); return method_offset + method_relative; }
         void ref() { ref_.ref(); }
         void deref() {
@@ -228,7 +235,8 @@ public:
     ExtraData *extraData;    // extra data set by the user
     QThreadData *threadData; // id of the thread that owns the object
 
-    QObjectConnectionListVector *connectionLists;
+    // read without locking by QMetaObject::activate(), see QConnectionSnapshot
+    QAtomicPointer<QObjectConnectionListVector> connectionLists;
 
     Connection *senders;     // linked list of connections connected to this object
     Sender *currentSender;   // object currently activating the object
@@ -40,6 +40,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvarlengtharray.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -84,6 +85,7 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = 0;
+    insertionCount = 0;
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -174,18 +176,141 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+static inline bool timerLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout < t2->timeout)
+        return true;
+    if (t2->timeout < t1->timeout)
+        return false;
+    return t1->sequence < t2->sequence;
+}
+
+void QTimerInfoList::heapSiftUp(int index)
+{
+    QTimerInfo *ti = at(index);
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        QTimerInfo *t = at(parent);
+        if (!timerLessThan(ti, t))
+            break;
+        (*this)[index] = t;
+        t->heapIndex = index;
+        index = parent;
+    }
+    (*this)[index] = ti;
+    ti->heapIndex = index;
+}
+
+void QTimerInfoList::heapSiftDown(int index)
+{
+    QTimerInfo *ti = at(index);
+    const int count = size();
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && timerLessThan(at(child + 1), at(child)))
+            ++child;
+        QTimerInfo *t = at(child);
+        if (!timerLessThan(t, ti))
+            break;
+        (*this)[index] = t;
+        t->heapIndex = index;
+        index = child;
+    }
+    (*this)[index] = ti;
+    ti->heapIndex = index;
+}
+
+/*
+  remove timer info from the heap (but not from the id lookup)
+*/
+void QTimerInfoList::heapRemove(QTimerInfo *ti)
+{
+    const int index = ti->heapIndex;
+    Q_ASSERT(at(index) == ti);
+
+    QTimerInfo *last = takeLast();
+    if (last == ti)
+        return;
+
+    // move the last entry into the hole, then restore the heap property
+    (*this)[index] = last;
+    last->heapIndex = index;
+    if (index > 0 && timerLessThan(last, at((index - 1) / 2)))
+        heapSiftUp(index);
+    else
+        heapSiftDown(index);
+}
+
+void QTimerInfoList::heapRebuild()
+{
+    for (int i = 0; i < size(); ++i)
+        at(i)->heapIndex = i;
+    for (int i = size() / 2 - 1; i >= 0; --i)
+        heapSiftDown(i);
+}
+
+/*
+  Returns the number of timers whose timeout has passed. They form a subtree
+  at the top of the heap, so only those and their direct children are visited.
+*/
+int QTimerInfoList::expiredTimerCount() const
+{
+    int count = 0;
+    QVarLengthArray<int, 64> stack;
+    if (!isEmpty())
+        stack.append(0);
+    while (!stack.isEmpty()) {
+        const int index = stack.last();
+        stack.removeLast();
+        if (currentTime < at(index)->timeout)
+            continue;
+        ++count;
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            stack.append(child);
+    }
+    return count;
+}
+
+/*
+  Returns the next timer to fire that is not being activated right now. Timers
+  being activated are few (activateTimers() only recurses through nested event
+  loops), so a best-first walk from the top of the heap finds it quickly.
+*/
+QTimerInfo *QTimerInfoList::firstWaitingTimer() const
+{
+    QVarLengthArray<int, 16> candidates;
+    if (!isEmpty())
+        candidates.append(0);
+    while (!candidates.isEmpty()) {
+        int best = 0;
+        for (int i = 1; i < candidates.size(); ++i) {
+            if (timerLessThan(at(candidates.at(i)), at(candidates.at(best))))
+                best = i;
+        }
+        const int index = candidates.at(best);
+        candidates.remove(best);
+
+        QTimerInfo *t = at(index);
+        if (!t->activateRef)
+            return t;
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            candidates.append(child);
+    }
+    return 0;
+}
+
 /*
   insert timer info into list
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
-    }
-    insert(index+1, ti);
+    // timers with the same timeout fire in the order they were inserted
+    ti->sequence = ++insertionCount;
+    ti->heapIndex = size();
+    append(ti);
+    heapSiftUp(ti->heapIndex);
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -389,13 +514,7 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
+    QTimerInfo *t = firstWaitingTimer();
 
     if (!t)
       return false;
@@ -423,16 +542,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -493,6 +609,7 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
             ++t->timeout.tv_sec;
     }
 
+    timersById.insert(timerId, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -508,41 +625,46 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timersById.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+
+    heapRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = 0;
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
+
+    // compact the list in one pass, then restore the heap property
+    int kept = 0;
     for (int i = 0; i < count(); ++i) {
         QTimerInfo *t = at(i);
         if (t->obj == object) {
             // object found
-            removeAt(i);
+            timersById.remove(t->id);
             if (t == firstTimerInfo)
                 firstTimerInfo = 0;
             if (t->activateRef)
                 *(t->activateRef) = 0;
             delete t;
-            // move back one so that we don't skip the new current item
-            --i;
+        } else {
+            (*this)[kept++] = t;
         }
     }
+    if (kept < count()) {
+        erase(begin() + kept, end());
+        heapRebuild();
+    }
     return true;
 }
 
@@ -579,11 +701,7 @@ int QTimerInfoList::activateTimers()
 
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    maxCount = expiredTimerCount();
 
     //fire the timers.
     while (maxCount--) {
@@ -604,8 +722,6 @@ int QTimerInfoList::activateTimers()
             firstTimerInfo = currentTimerInfo;
         }
 
-        // remove from list
-        removeFirst();
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -630,8 +746,9 @@ int QTimerInfoList::activateTimers()
         // determine next timeout time
         calculateNextTimeout(currentTimerInfo, currentTime);
 
-        // reinsert timer
-        timerInsert(currentTimerInfo);
+        // reinsert timer, behind the ones with the same timeout
+        currentTimerInfo->sequence = ++insertionCount;
+        heapSiftDown(0);
         if (currentTimerInfo->interval > 0)
             n_act++;
 
@@ -56,6 +56,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -69,6 +70,8 @@ struct QTimerInfo {
     timespec timeout;  // - when to actually fire
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
+    int heapIndex;    // - position in QTimerInfoList
+    quint64 sequence; // - insertion order, breaks ties between equal timeouts
 
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
@@ -77,6 +80,9 @@ struct QTimerInfo {
 #endif
 };
 
+// The list is kept as a binary min-heap ordered by timeout (and by insertion
+// order for equal timeouts), so constFirst() is always the next timer to fire.
+// Use timerInsert() and the unregister functions to modify it.
 class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
@@ -92,6 +98,16 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo;
 
+    QHash<int, QTimerInfo *> timersById;
+    quint64 insertionCount;
+
+    void heapSiftUp(int index);
+    void heapSiftDown(int index);
+    void heapRemove(QTimerInfo *t);
+    void heapRebuild();
+    int expiredTimerCount() const;
+    QTimerInfo *firstWaitingTimer() const;
+
 public:
     QTimerInfoList();
 
@@ -53,6 +53,9 @@
 #include "qjsonvalue.h"
 #include "qjsonobject.h"
 #include "qjsonarray.h"
+#if QT_CONFIG(library)
+#include "private/qpluginmetadatacache_p.h"
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -114,6 +117,7 @@ void QFactoryLoader::update()
 #endif
                     QDir::Files);
         QLibraryPrivate *library = 0;
+        QPluginMetaDataCache cache(path);
 
 #ifdef Q_OS_MAC
         // Loading both the debug and release version of the cocoa plugins causes the objective-c runtime
@@ -142,8 +146,19 @@ void QFactoryLoader::update()
             if (qt_debug_component()) {
                 qDebug() << "QFactoryLoader::QFactoryLoader() looking at" << fileName;
             }
-            library = QLibraryPrivate::findOrCreate(QFileInfo(fileName).canonicalFilePath());
-            if (!library->isPlugin()) {
+            const QFileInfo fileInfo(fileName);
+            library = QLibraryPrivate::findOrCreate(fileInfo.canonicalFilePath());
+            if (cache.isEnabled()) {
+                const QJsonObject cached = cache.find(plugins.at(j), fileInfo);
+                if (!cached.isEmpty()) {
+                    if (qt_debug_component())
+                        qDebug() << "QFactoryLoader::QFactoryLoader() using cached meta data for" << fileName;
+                    library->setCachedMetaData(cached);
+                }
+            }
+            const bool isPlugin = library->isPlugin();
+            cache.insert(plugins.at(j), fileInfo, library->metaData);
+            if (!isPlugin) {
                 if (qt_debug_component()) {
                     qDebug() << library->errorString << endl
                              << "         not a plugin";
@@ -737,6 +737,30 @@ void QLibraryPrivate::updatePluginState()
         return;
     }
 
+    checkPluginMetaData();
+}
+
+/*!
+    \internal
+
+    Uses \a cachedMetaData, which was extracted from this same file earlier,
+    as the plugin's meta data instead of scanning the file for it. Does
+    nothing if the plugin state has already been determined.
+
+    \sa QPluginMetaDataCache
+*/
+void QLibraryPrivate::setCachedMetaData(const QJsonObject &cachedMetaData)
+{
+    if (pluginState != MightBeAPlugin || pHnd)
+        return;
+
+    errorString.clear();
+    metaData = cachedMetaData;
+    checkPluginMetaData();
+}
+
+void QLibraryPrivate::checkPluginMetaData()
+{
     pluginState = IsNotAPlugin; // be pessimistic
 
     uint qt_version = (uint)metaData.value(QLatin1String("version")).toDouble();
@@ -107,6 +107,7 @@ public:
     QString errorString;
 
     void updatePluginState();
+    void setCachedMetaData(const QJsonObject &cachedMetaData);
     bool isPlugin();
 
 private:
@@ -117,6 +118,7 @@ private:
     bool load_sys();
     bool unload_sys();
     QFunctionPointer resolve_sys(const char *);
+    void checkPluginMetaData();
 
     QAtomicInt loadHintsInt;
 
@@ -0,0 +1,261 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qpluginmetadatacache_p.h"
+
+#include <qcryptographichash.h>
+#include <qdatastream.h>
+#include <qdatetime.h>
+#include <qdir.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qjsondocument.h>
+#if QT_CONFIG(temporaryfile)
+#include <qsavefile.h>
+#endif
+#include <qstandardpaths.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QPluginMetaDataCache
+    \inmodule QtCore
+    \internal
+
+    \brief The QPluginMetaDataCache class keeps the meta data of the plugins
+    found in one directory across application runs.
+
+    Extracting the meta data from a plugin means mapping the file and walking
+    its ELF or Mach-O headers. QFactoryLoader does that for every file in every
+    plugin directory it scans, which adds up at start-up. This class stores the
+    extracted meta data in binary JSON form in a per-directory cache file,
+    together with the size and modification time of each plugin. An entry is
+    only used if the plugin file still has the same size and modification time,
+    which costs a single \c stat() call.
+
+    The cache files are kept in the \c qtplugincache subdirectory of
+    QStandardPaths::GenericCacheLocation. The location can be overridden with
+    the \c QT_PLUGIN_CACHE_PATH environment variable, and caching can be turned
+    off altogether by setting \c QT_NO_PLUGIN_CACHE.
+*/
+
+enum : quint32 {
+    CacheMagic = 0x51504d43,    // 'QPMC'
+    CacheVersion = 1
+};
+
+static inline qint64 modificationTime(const QFileInfo &info)
+{
+    return info.lastModified().toMSecsSinceEpoch();
+}
+
+/*!
+    Creates a cache for the plugins in \a directory and reads the entries that
+    were stored for it, if any.
+*/
+QPluginMetaDataCache::QPluginMetaDataCache(const QString &directory)
+    : directory(directory), dirty(false)
+{
+    const QString cacheDir = cacheDirectory();
+    if (cacheDir.isEmpty())
+        return;
+
+    const QByteArray hash = QCryptographicHash::hash(directory.toUtf8(), QCryptographicHash::Sha1);
+    cacheFile = cacheDir + QLatin1String("/metadata-") + QLatin1String(hash.toHex())
+            + QLatin1String(".cache");
+    load();
+}
+
+/*!
+    Writes back any changes made to the cache.
+*/
+QPluginMetaDataCache::~QPluginMetaDataCache()
+{
+    save();
+}
+
+/*!
+    Returns the directory the cache files are kept in, or an empty string if
+    plugin meta data caching is disabled.
+*/
+QString QPluginMetaDataCache::cacheDirectory()
+{
+    if (qEnvironmentVariableIsSet("QT_NO_PLUGIN_CACHE"))
+        return QString();
+
+    QString dir = QFile::decodeName(qgetenv("QT_PLUGIN_CACHE_PATH"));
+#ifndef QT_NO_STANDARDPATHS
+    if (dir.isEmpty()) {
+        dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+        if (!dir.isEmpty())
+            dir += QLatin1String("/qtplugincache");
+    }
+#endif
+    return dir;
+}
+
+void QPluginMetaDataCache::load()
+{
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != CacheMagic || version != CacheVersion)
+        return;
+
+    QString storedDirectory;
+    quint32 count;
+    in >> storedDirectory >> count;
+    if (storedDirectory != directory)
+        return;
+
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString fileName;
+        Entry entry;
+        in >> fileName >> entry.size >> entry.lastModified >> entry.binaryMetaData;
+        stored.insert(fileName, entry);
+    }
+
+    // a truncated or otherwise damaged file is thrown away as a whole
+    if (in.status() != QDataStream::Ok)
+        stored.clear();
+}
+
+/*!
+    Returns the cached meta data of the plugin \a fileName, which must be a file
+    name relative to the cache's directory. \a info must refer to that file and
+    is used to check that the plugin has not changed since it was cached.
+
+    Returns an empty object if there is no valid entry for the plugin.
+*/
+QJsonObject QPluginMetaDataCache::find(const QString &fileName, const QFileInfo &info)
+{
+    const auto it = stored.constFind(fileName);
+    if (it == stored.constEnd() || it->size != info.size()
+            || it->lastModified != modificationTime(info)) {
+        return QJsonObject();
+    }
+
+    const QJsonDocument doc = QJsonDocument::fromBinaryData(it->binaryMetaData);
+    if (!doc.isObject())
+        return QJsonObject();
+
+    current.insert(fileName, *it);
+    return doc.object();
+}
+
+/*!
+    Records \a metaData as the meta data of the plugin \a fileName, described by
+    \a info. Does nothing if an up-to-date entry for the plugin has already
+    been looked up or inserted.
+*/
+void QPluginMetaDataCache::insert(const QString &fileName, const QFileInfo &info,
+                                  const QJsonObject &metaData)
+{
+    if (!isEnabled() || metaData.isEmpty())
+        return;
+
+    Entry entry;
+    entry.size = info.size();
+    entry.lastModified = modificationTime(info);
+
+    const auto it = current.constFind(fileName);
+    if (it != current.constEnd() && it->size == entry.size && it->lastModified == entry.lastModified)
+        return;
+
+    entry.binaryMetaData = QJsonDocument(metaData).toBinaryData();
+    current.insert(fileName, entry);
+
+    const auto old = stored.constFind(fileName);
+    if (old == stored.constEnd() || old->size != entry.size
+            || old->lastModified != entry.lastModified
+            || old->binaryMetaData != entry.binaryMetaData) {
+        dirty = true;
+    }
+}
+
+/*!
+    Writes the cache file if any entry was added or changed, or if plugins
+    that were cached before have not been seen again. The entries written are
+    those that were looked up or inserted since the cache was created.
+
+    Returns \c true if the cache file is up to date.
+*/
+bool QPluginMetaDataCache::save()
+{
+    if (!isEnabled())
+        return false;
+    if (!dirty && current.size() == stored.size())
+        return true;
+
+    if (!QDir().mkpath(QFileInfo(cacheFile).absolutePath()))
+        return false;
+
+#if QT_CONFIG(temporaryfile)
+    QSaveFile file(cacheFile);
+#else
+    QFile file(cacheFile);
+#endif
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << quint32(CacheMagic) << quint32(CacheVersion) << directory << quint32(current.size());
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it)
+        out << it.key() << it->size << it->lastModified << it->binaryMetaData;
+
+    if (out.status() != QDataStream::Ok)
+        return false;
+#if QT_CONFIG(temporaryfile)
+    if (!file.commit())
+        return false;
+#endif
+
+    stored = current;
+    dirty = false;
+    return true;
+}
+
+QT_END_NAMESPACE
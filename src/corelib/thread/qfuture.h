@@ -46,6 +46,12 @@
 
 #include <QtCore/qfutureinterface.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qthreadpool.h>
+
+#include <iterator>
+#include <type_traits>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,6 +61,61 @@ class QFutureWatcher;
 template <>
 class QFutureWatcher<void>;
 
+namespace QtFuture {
+enum class Launch {
+    Sync,
+    Async
+};
+}
+
+namespace QtPrivate {
+
+struct FutureAccess;
+
+template <typename Function, typename Arg, typename = void>
+struct IsCallableWith : std::false_type {};
+template <typename Function, typename Arg>
+struct IsCallableWith<Function, Arg, decltype(void(std::declval<Function &>()(std::declval<Arg>())))>
+    : std::true_type {};
+
+template <typename Function, typename = void>
+struct IsCallableWithoutArguments : std::false_type {};
+template <typename Function>
+struct IsCallableWithoutArguments<Function, decltype(void(std::declval<Function &>()()))>
+    : std::true_type {};
+
+// A continuation either takes the result of the parent future (nothing, for
+// QFuture<void>), in which case it is only called if the parent succeeded, or
+// the parent future itself, in which case it is always called.
+template <typename Function, typename T>
+struct TakesParentResult : IsCallableWith<Function, T> {};
+template <typename Function>
+struct TakesParentResult<Function, void> : IsCallableWithoutArguments<Function> {};
+
+template <typename Function, typename T, bool = TakesParentResult<Function, T>::value>
+struct ContinuationTraits
+{
+    enum { TakesFuture = false };
+    typedef decltype(std::declval<Function &>()(std::declval<T>())) ResultType;
+};
+template <typename Function>
+struct ContinuationTraits<Function, void, true>
+{
+    enum { TakesFuture = false };
+    typedef decltype(std::declval<Function &>()()) ResultType;
+};
+template <typename Function, typename T>
+struct ContinuationTraits<Function, T, false>
+{
+    enum { TakesFuture = true };
+    typedef decltype(std::declval<Function &>()(std::declval<QFuture<T> >())) ResultType;
+};
+
+template <typename Function, typename T>
+using ContinuationResult = QFuture<typename ContinuationTraits<typename std::decay<Function>::type, T>::ResultType>;
+
+} // namespace QtPrivate
+
 template <typename T>
 class QFuture
 {
@@ -96,6 +157,22 @@ public:
     operator T() const { return result(); }
     QList<T> results() const { return d.results(); }
 
+    template <typename Function>
+    QtPrivate::ContinuationResult<Function, T> then(Function &&function);
+    template <typename Function>
+    QtPrivate::ContinuationResult<Function, T> then(QtFuture::Launch policy, Function &&function);
+    template <typename Function>
+    QtPrivate::ContinuationResult<Function, T> then(QThreadPool *pool, Function &&function);
+    template <typename Function>
+    QtPrivate::ContinuationResult<Function, T> then(QObject *context, Function &&function);
+
+#ifndef QT_NO_EXCEPTIONS
+    template <typename Function>
+    QFuture<T> onFailed(Function &&handler);
+    template <typename Function>
+    QFuture<T> onFailed(QObject *context, Function &&handler);
+#endif
+
     class const_iterator
     {
     public:
@@ -145,6 +222,7 @@ public:
 
 private:
     friend class QFutureWatcher<T>;
+    friend struct QtPrivate::FutureAccess;
 
 public: // Warning: the d pointer is not documented and is considered private.
     mutable QFutureInterface<T> d;
@@ -220,8 +298,25 @@ public:
     QString progressText() const { return d.progressText(); }
     void waitForFinished() { d.waitForFinished(); }
 
+    template <typename Function>
+    QtPrivate::ContinuationResult<Function, void> then(Function &&function);
+    template <typename Function>
+    QtPrivate::ContinuationResult<Function, void> then(QtFuture::Launch policy, Function &&function);
+    template <typename Function>
+    QtPrivate::ContinuationResult<Function, void> then(QThreadPool *pool, Function &&function);
+    template <typename Function>
+    QtPrivate::ContinuationResult<Function, void> then(QObject *context, Function &&function);
+
+#ifndef QT_NO_EXCEPTIONS
+    template <typename Function>
+    QFuture<void> onFailed(Function &&handler);
+    template <typename Function>
+    QFuture<void> onFailed(QObject *context, Function &&handler);
+#endif
+
 private:
     friend class QFutureWatcher<void>;
+    friend struct QtPrivate::FutureAccess;
 
 #ifdef QFUTURE_TEST
 public:
@@ -234,6 +329,471 @@ inline QFuture<void> QFutureInterface<void>::future()
     return QFuture<void>(this);
 }
 
+namespace QtPrivate {
+
+struct FutureAccess
+{
+    template <typename T>
+    static QFutureInterfaceBase &interface(QFuture<T> &future) { return future.d; }
+
+    static void addContinuation(QFutureInterfaceBase &iface,
+                                std::function<void(const QFutureInterfaceBase &)> continuation)
+    { iface.addContinuation(std::move(continuation)); }
+};
+
+template <typename T>
+inline QFuture<T> futureFromInterface(const QFutureInterfaceBase &data)
+{
+    QFutureInterface<T> iface(data);
+    return iface.future();
+}
+
+// Finishes a promise that will never get a result, so that nobody waits
+// for it forever.
+inline void cancelIfUnfinished(QFutureInterfaceBase &promise)
+{
+    if (!promise.isFinished()) {
+        promise.reportCanceled();
+        promise.reportFinished();
+    }
+}
+
+// Forwards a failed or canceled parent to the promise of its continuation.
+inline bool forwardFailure(QFutureInterfaceBase &parent, QFutureInterfaceBase &promise)
+{
+#ifndef QT_NO_EXCEPTIONS
+    if (parent.exceptionStore().hasException()) {
+        promise.reportException(*parent.exceptionStore().exception().exception());
+        promise.reportFinished();
+        return true;
+    }
+#endif
+    if (parent.isCanceled()) {
+        promise.reportCanceled();
+        promise.reportFinished();
+        return true;
+    }
+    return false;
+}
+
+template <typename Result, typename Callable>
+inline void reportCallResult(QFutureInterface<Result> &promise, Callable &&callable)
+{
+    promise.reportResult(callable());
+}
+
+template <typename Callable>
+inline void reportCallResult(QFutureInterface<void> &, Callable &&callable)
+{
+    callable();
+}
+
+template <typename Callable>
+inline void reportCallResultCatchingExceptions(QFutureInterfaceBase &promise, Callable &&callable)
+{
+#ifndef QT_NO_EXCEPTIONS
+    try {
+#endif
+        callable();
+#ifndef QT_NO_EXCEPTIONS
+    } catch (QException &e) {
+        promise.reportException(e);
+    } catch (...) {
+        promise.reportException(QUnhandledException());
+    }
+#endif
+}
+
+template <typename Function, typename ParentResult, typename Result>
+class Continuation
+{
+public:
+    typedef ContinuationTraits<Function, ParentResult> Traits;
+
+    Continuation(Function &&function, const QFutureInterface<Result> &promise)
+        : m_function(std::move(function)), m_promise(promise)
+    { }
+    ~Continuation() { cancelIfUnfinished(m_promise); }
+
+    void run(const QFutureInterface<ParentResult> &parentData)
+    {
+        QFutureInterface<ParentResult> parent(parentData);
+        const std::integral_constant<bool, Traits::TakesFuture> takesFuture = {};
+        if (!Traits::TakesFuture && forwardFailure(parent, m_promise))
+            return;
+        reportCallResultCatchingExceptions(m_promise, [this, &parent, takesFuture]() {
+            reportCallResult(m_promise, [this, &parent, takesFuture]() {
+                return call(parent, takesFuture);
+            });
+        });
+        m_promise.reportFinished();
+    }
+
+private:
+    template <typename T>
+    Result call(QFutureInterface<T> &parent, std::true_type)
+    { return m_function(parent.future()); }
+    template <typename T>
+    Result call(QFutureInterface<T> &parent, std::false_type)
+    { return m_function(parent.future().result()); }
+    Result call(QFutureInterface<void> &, std::false_type)
+    { return m_function(); }
+
+    Function m_function;
+    QFutureInterface<Result> m_promise;
+};
+
+#ifndef QT_NO_EXCEPTIONS
+// The exception type a failure handler accepts, if any.
+template <typename Function, typename = void>
+struct FailureHandlerArguments : FunctionPointer<decltype(&Function::operator())> {};
+template <typename Function>
+struct FailureHandlerArguments<Function, typename std::enable_if<std::is_pointer<Function>::value>::type>
+    : FunctionPointer<Function> {};
+
+template <typename Function, typename T>
+class FailureHandler
+{
+public:
+    typedef FailureHandlerArguments<Function> Arguments;
+
+    FailureHandler(Function &&handler, const QFutureInterface<T> &promise)
+        : m_handler(std::move(handler)), m_promise(promise)
+    { }
+    ~FailureHandler() { cancelIfUnfinished(m_promise); }
+
+    void run(const QFutureInterface<T> &parentData)
+    {
+        QFutureInterface<T> parent(parentData);
+        if (!parent.exceptionStore().hasException()) {
+            forwardResults(parent);
+        } else {
+            const std::integral_constant<bool, Arguments::ArgumentCount == 0> catchesAll = {};
+            reportCallResultCatchingExceptions(m_promise, [this, &parent, catchesAll]() {
+                handle(parent, catchesAll);
+            });
+        }
+        m_promise.reportFinished();
+    }
+
+private:
+    void handle(QFutureInterface<T> &, std::true_type)
+    {
+        reportCallResult(m_promise, m_handler);
+    }
+    void handle(QFutureInterface<T> &parent, std::false_type)
+    {
+        typedef typename std::decay<typename Arguments::Arguments::Car>::type Exception;
+        // Exceptions of other types propagate to the promise.
+        try {
+            parent.exceptionStore().throwPossibleException();
+        } catch (const Exception &e) {
+            reportCallResult(m_promise, [this, &e]() { return m_handler(e); });
+        }
+    }
+
+    template <typename U>
+    void forwardResults(QFutureInterface<U> &parent)
+    {
+        if (parent.isCanceled())
+            m_promise.reportCanceled();
+        else
+            m_promise.reportResults(parent.results().toVector());
+    }
+    void forwardResults(QFutureInterface<void> &parent)
+    {
+        if (parent.isCanceled())
+            m_promise.reportCanceled();
+    }
+
+    Function m_handler;
+    QFutureInterface<T> m_promise;
+};
+#endif // QT_NO_EXCEPTIONS
+
+template <typename State, typename ParentResult>
+class ContinuationRunnable : public QRunnable
+{
+public:
+    ContinuationRunnable(const QSharedPointer<State> &state, const QFutureInterface<ParentResult> &parent)
+        : m_state(state), m_parent(parent)
+    { }
+    void run() Q_DECL_OVERRIDE { m_state->run(m_parent); }
+
+private:
+    QSharedPointer<State> m_state;
+    QFutureInterface<ParentResult> m_parent;
+};
+
+// Runs the continuation in the thread that finishes the parent (no pool and
+// no context), on \a pool, or in the thread of \a context by way of a queued
+// call. If the context is destroyed first, the continuation is dropped and
+// its future canceled.
+template <typename ParentResult, typename State>
+void scheduleContinuation(QFutureInterfaceBase &parent, const QSharedPointer<State> &state,
+                          QThreadPool *pool, QObject *context, bool hasContext)
+{
+    const QPointer<QObject> guard(context);
+    FutureAccess::addContinuation(parent, [state, pool, guard, hasContext](const QFutureInterfaceBase &parentData) {
+        const QFutureInterface<ParentResult> finished(parentData);
+        if (pool) {
+            pool->start(new ContinuationRunnable<State, ParentResult>(state, finished));
+        } else if (hasContext) {
+            if (QObject *receiver = guard.data())
+                QMetaObject::invokeMethod(receiver, [state, finished]() { state->run(finished); });
+        } else {
+            state->run(finished);
+        }
+    });
+}
+
+template <typename ParentResult, typename Function>
+ContinuationResult<Function, ParentResult>
+addContinuation(QFutureInterfaceBase &parent, Function &&function,
+                QThreadPool *pool, QObject *context, bool hasContext)
+{
+    typedef typename std::decay<Function>::type Callable;
+    typedef typename ContinuationTraits<Callable, ParentResult>::ResultType Result;
+    typedef Continuation<Callable, ParentResult, Result> State;
+
+    QFutureInterface<Result> promise;
+    promise.reportStarted();
+    QSharedPointer<State> state(new State(Callable(std::forward<Function>(function)), promise));
+    scheduleContinuation<ParentResult>(parent, state, pool, context, hasContext);
+    return promise.future();
+}
+
+#ifndef QT_NO_EXCEPTIONS
+template <typename T, typename Function>
+QFuture<T> addFailureHandler(QFutureInterfaceBase &parent, Function &&handler,
+                             QObject *context, bool hasContext)
+{
+    typedef typename std::decay<Function>::type Callable;
+    typedef FailureHandler<Callable, T> State;
+
+    QFutureInterface<T> promise;
+    promise.reportStarted();
+    QSharedPointer<State> state(new State(Callable(std::forward<Function>(handler)), promise));
+    scheduleContinuation<T>(parent, state, nullptr, context, hasContext);
+    return promise.future();
+}
+#endif
+
+} // namespace QtPrivate
+
+template <typename T>
+template <typename Function>
+QtPrivate::ContinuationResult<Function, T> QFuture<T>::then(Function &&function)
+{
+    return QtPrivate::addContinuation<T>(d, std::forward<Function>(function), nullptr, nullptr, false);
+}
+
+template <typename T>
+template <typename Function>
+QtPrivate::ContinuationResult<Function, T> QFuture<T>::then(QtFuture::Launch policy, Function &&function)
+{
+    QThreadPool *pool = policy == QtFuture::Launch::Async ? QThreadPool::globalInstance() : nullptr;
+    return QtPrivate::addContinuation<T>(d, std::forward<Function>(function), pool, nullptr, false);
+}
+
+template <typename T>
+template <typename Function>
+QtPrivate::ContinuationResult<Function, T> QFuture<T>::then(QThreadPool *pool, Function &&function)
+{
+    return QtPrivate::addContinuation<T>(d, std::forward<Function>(function), pool, nullptr, false);
+}
+
+template <typename T>
+template <typename Function>
+QtPrivate::ContinuationResult<Function, T> QFuture<T>::then(QObject *context, Function &&function)
+{
+    return QtPrivate::addContinuation<T>(d, std::forward<Function>(function), nullptr, context, true);
+}
+
+#ifndef QT_NO_EXCEPTIONS
+template <typename T>
+template <typename Function>
+QFuture<T> QFuture<T>::onFailed(Function &&handler)
+{
+    return QtPrivate::addFailureHandler<T>(d, std::forward<Function>(handler), nullptr, false);
+}
+
+template <typename T>
+template <typename Function>
+QFuture<T> QFuture<T>::onFailed(QObject *context, Function &&handler)
+{
+    return QtPrivate::addFailureHandler<T>(d, std::forward<Function>(handler), context, true);
+}
+#endif
+
+template <typename Function>
+QtPrivate::ContinuationResult<Function, void> QFuture<void>::then(Function &&function)
+{
+    return QtPrivate::addContinuation<void>(d, std::forward<Function>(function), nullptr, nullptr, false);
+}
+
+template <typename Function>
+QtPrivate::ContinuationResult<Function, void> QFuture<void>::then(QtFuture::Launch policy, Function &&function)
+{
+    QThreadPool *pool = policy == QtFuture::Launch::Async ? QThreadPool::globalInstance() : nullptr;
+    return QtPrivate::addContinuation<void>(d, std::forward<Function>(function), pool, nullptr, false);
+}
+
+template <typename Function>
+QtPrivate::ContinuationResult<Function, void> QFuture<void>::then(QThreadPool *pool, Function &&function)
+{
+    return QtPrivate::addContinuation<void>(d, std::forward<Function>(function), pool, nullptr, false);
+}
+
+template <typename Function>
+QtPrivate::ContinuationResult<Function, void> QFuture<void>::then(QObject *context, Function &&function)
+{
+    return QtPrivate::addContinuation<void>(d, std::forward<Function>(function), nullptr, context, true);
+}
+
+#ifndef QT_NO_EXCEPTIONS
+template <typename Function>
+QFuture<void> QFuture<void>::onFailed(Function &&handler)
+{
+    return QtPrivate::addFailureHandler<void>(d, std::forward<Function>(handler), nullptr, false);
+}
+
+template <typename Function>
+QFuture<void> QFuture<void>::onFailed(QObject *context, Function &&handler)
+{
+    return QtPrivate::addFailureHandler<void>(d, std::forward<Function>(handler), context, true);
+}
+#endif
+
+namespace QtFuture {
+
+template <typename T>
+struct WhenAnyResult
+{
+    WhenAnyResult() : index(-1) { }
+    WhenAnyResult(int i, const QFuture<T> &f) : index(i), future(f) { }
+
+    int index;
+    QFuture<T> future;
+};
+
+} // namespace QtFuture
+
+namespace QtPrivate {
+
+template <typename Future>
+struct FutureResultType;
+template <typename T>
+struct FutureResultType<QFuture<T> > { typedef T Type; };
+
+template <typename T>
+class WhenAllContext
+{
+public:
+    explicit WhenAllContext(int count)
+        : futures(count), remaining(count)
+    { promise.reportStarted(); }
+    ~WhenAllContext() { cancelIfUnfinished(promise); }
+
+    void setFinished(int index, const QFuture<T> &future)
+    {
+        // Each future writes its own slot; the last one to finish publishes them.
+        futures[index] = future;
+        if (!remaining.deref()) {
+            promise.reportResult(futures.toList());
+            promise.reportFinished();
+        }
+    }
+
+    QFutureInterface<QList<QFuture<T> > > promise;
+
+private:
+    QVector<QFuture<T> > futures;
+    QAtomicInt remaining;
+};
+
+template <typename T>
+class WhenAnyContext
+{
+public:
+    WhenAnyContext()
+        : done(0)
+    { promise.reportStarted(); }
+    ~WhenAnyContext() { cancelIfUnfinished(promise); }
+
+    void setFinished(int index, const QFuture<T> &future)
+    {
+        if (done.testAndSetOrdered(0, 1)) {
+            promise.reportResult(QtFuture::WhenAnyResult<T>(index, future));
+            promise.reportFinished();
+        }
+    }
+
+    QFutureInterface<QtFuture::WhenAnyResult<T> > promise;
+
+private:
+    QAtomicInt done;
+};
+
+// The contexts only hold the futures that have finished, so an input future
+// that never finishes does not keep the others (or itself) alive.
+template <typename Context, typename InputIt>
+void watchFutures(const QSharedPointer<Context> &context, InputIt first, InputIt last)
+{
+    typedef typename std::iterator_traits<InputIt>::value_type Future;
+    typedef typename FutureResultType<Future>::Type T;
+
+    for (int index = 0; first != last; ++first, ++index) {
+        Future future = *first;
+        FutureAccess::addContinuation(FutureAccess::interface(future),
+                                      [context, index](const QFutureInterfaceBase &data) {
+            context->setFinished(index, futureFromInterface<T>(data));
+        });
+    }
+}
+
+} // namespace QtPrivate
+
+namespace QtFuture {
+
+template <typename InputIt>
+QFuture<QList<typename std::iterator_traits<InputIt>::value_type> > whenAll(InputIt first, InputIt last)
+{
+    typedef typename std::iterator_traits<InputIt>::value_type Future;
+    typedef typename QtPrivate::FutureResultType<Future>::Type T;
+
+    const int count = int(std::distance(first, last));
+    QSharedPointer<QtPrivate::WhenAllContext<T> > context(new QtPrivate::WhenAllContext<T>(count));
+    QFuture<QList<Future> > result = context->promise.future();
+    if (count == 0) {
+        context->promise.reportResult(QList<Future>());
+        context->promise.reportFinished();
+        return result;
+    }
+    QtPrivate::watchFutures(context, first, last);
+    return result;
+}
+
+template <typename InputIt>
+QFuture<WhenAnyResult<typename QtPrivate::FutureResultType<typename std::iterator_traits<InputIt>::value_type>::Type> >
+whenAny(InputIt first, InputIt last)
+{
+    typedef typename std::iterator_traits<InputIt>::value_type Future;
+    typedef typename QtPrivate::FutureResultType<Future>::Type T;
+
+    QSharedPointer<QtPrivate::WhenAnyContext<T> > context(new QtPrivate::WhenAnyContext<T>);
+    QFuture<WhenAnyResult<T> > result = context->promise.future();
+    if (first == last) {
+        context->promise.reportResult(WhenAnyResult<T>());
+        context->promise.reportFinished();
+        return result;
+    }
+    QtPrivate::watchFutures(context, first, last);
+    return result;
+}
+
+} // namespace QtFuture
+
 template <typename T>
 QFuture<void> qToVoidFuture(const QFuture<T> &future)
 {
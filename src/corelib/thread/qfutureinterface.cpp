@@ -93,6 +93,19 @@ static inline int switch_off(QAtomicInt &a, int which)
     return a.fetchAndAndRelaxed(~which) & ~which;
 }
 
+// Runs the continuations of a future that has just finished or been
+// canceled. They run without the lock held (\a locker must hold it), so that
+// they can query the future (or attach further continuations to it).
+static void runContinuations(const QFutureInterfaceBase &iface, QFutureInterfaceBasePrivate *d,
+                             QMutexLocker &locker)
+{
+    QVector<std::function<void(const QFutureInterfaceBase &)> > continuations;
+    continuations.swap(d->continuations);
+    locker.unlock();
+    for (const auto &continuation : qAsConst(continuations))
+        continuation(iface);
+}
+
 static inline int switch_from_to(QAtomicInt &a, int from, int to)
 {
     int newValue;
@@ -113,6 +126,7 @@ void QFutureInterfaceBase::cancel()
     d->waitCondition.wakeAll();
     d->pausedWaitCondition.wakeAll();
     d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::Canceled));
+    runContinuations(*this, d, locker);
 }
 
 void QFutureInterfaceBase::setPaused(bool paused)
@@ -279,6 +293,7 @@ void QFutureInterfaceBase::reportException(const QException &exception)
     d->waitCondition.wakeAll();
     d->pausedWaitCondition.wakeAll();
     d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::Canceled));
+    runContinuations(*this, d, locker);
 }
 #endif
 
@@ -289,6 +304,7 @@ void QFutureInterfaceBase::reportFinished()
         switch_from_to(d->state, Running, Finished);
         d->waitCondition.wakeAll();
         d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::Finished));
+        runContinuations(*this, d, locker);
     }
 }
 
@@ -349,6 +365,21 @@ void QFutureInterfaceBase::waitForFinished()
     d->m_exceptionStore.throwPossibleException();
 }
 
+// Registers \a continuation to be called, with this future as argument, from
+// the thread that reports the future as finished or canceled (which includes
+// reporting an exception). If that has already happened, the continuation is
+// called right away from the calling thread.
+void QFutureInterfaceBase::addContinuation(std::function<void(const QFutureInterfaceBase &)> continuation)
+{
+    QMutexLocker locker(&d->m_mutex);
+    if (!(d->state.load() & (Finished | Canceled))) {
+        d->continuations.append(std::move(continuation));
+        return;
+    }
+    locker.unlock();
+    continuation(*this);
+}
+
 void QFutureInterfaceBase::reportResultsReady(int beginIndex, int endIndex)
 {
     if (beginIndex == endIndex || (d->state.load() & (Canceled|Finished)))
@@ -48,6 +48,8 @@
 #include <QtCore/qexception.h>
 #include <QtCore/qresultstore.h>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 
 
@@ -56,6 +58,9 @@ class QThreadPool;
 class QFutureInterfaceBasePrivate;
 class QFutureWatcherBase;
 class QFutureWatcherBasePrivate;
+namespace QtPrivate {
+struct FutureAccess;
+}
 
 class Q_CORE_EXPORT QFutureInterfaceBase
 {
@@ -140,6 +145,9 @@ private:
 private:
     friend class QFutureWatcherBase;
     friend class QFutureWatcherBasePrivate;
+    friend struct QtPrivate::FutureAccess;
+
+    void addContinuation(std::function<void(const QFutureInterfaceBase &)> continuation);
 };
 
 template <typename T>
@@ -156,6 +164,11 @@ public:
     {
         refT();
     }
+    explicit QFutureInterface(const QFutureInterfaceBase &other)
+        : QFutureInterfaceBase(other)
+    {
+        refT();
+    }
     ~QFutureInterface()
     {
         if (!derefT())
@@ -282,6 +295,9 @@ public:
     explicit QFutureInterface<void>(State initialState = NoState)
         : QFutureInterfaceBase(initialState)
     { }
+    explicit QFutureInterface<void>(const QFutureInterfaceBase &other)
+        : QFutureInterfaceBase(other)
+    { }
 
     static QFutureInterface<void> canceledResult()
     { return QFutureInterface(State(Started | Finished | Canceled)); }
@@ -55,6 +55,7 @@
 #include <QtCore/qelapsedtimer.h>
 #include <QtCore/qcoreevent.h>
 #include <QtCore/qlist.h>
+#include <QtCore/qvector.h>
 #include <QtCore/qwaitcondition.h>
 #include <QtCore/qrunnable.h>
 #include <QtCore/qthreadpool.h>
@@ -172,6 +173,7 @@ public:
     QString m_progressText;
     QRunnable *runnable;
     QThreadPool *m_pool;
+    QVector<std::function<void(const QFutureInterfaceBase &)> > continuations;
 
     inline QThreadPool *pool() const
     { return m_pool ? m_pool : QThreadPool::globalInstance(); }
@@ -48,6 +48,7 @@
 
 #include "qthread_p.h"
 #include "private/qcoreapplication_p.h"
+#include "private/qmetacallbatch_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -57,7 +58,7 @@ QT_BEGIN_NAMESPACE
 
 QThreadData::QThreadData(int initialRefCount)
     : _ref(initialRefCount), loopLevel(0), scopeLevel(0),
-      eventDispatcher(0),
+      metaCallBatchInDelivery(0), eventDispatcher(0),
       quitNow(false), canWait(true), isAdopted(false), requiresCoreApplication(true)
 {
     // fprintf(stderr, "QThreadData %p created\n", this);
@@ -90,6 +91,7 @@ QThreadData::~QThreadData()
             delete pe.event;
         }
     }
+    QMetaCallBatch::discardPendingCalls(this);
 
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
@@ -283,6 +283,8 @@ public:
 
     QStack<QEventLoop *> eventLoops;
     QPostEventList postEventList;
+    QAtomicPointer<QMetaCallBatchEntry> metaCallBatch; // see QMetaCallBatch
+    QMetaCallBatchEntry *metaCallBatchInDelivery; // taken off metaCallBatch, only used by this thread
     QAtomicPointer<QThread> thread;
     QAtomicPointer<void> threadId;
     QAtomicPointer<QAbstractEventDispatcher> eventDispatcher;
@@ -44,6 +44,7 @@
 
 #include <private/qcoreapplication_p.h>
 #include <private/qcore_unix_p.h>
+#include <private/qmetacallbatch_p.h>
 
 #if defined(Q_OS_DARWIN)
 #  include <private/qeventdispatcher_cf_p.h>
@@ -414,6 +415,7 @@ void QThreadPrivate::finish(void *arg)
         locker.unlock();
         emit thr->finished(QThread::QPrivateSignal());
         QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+        QMetaCallBatch::discardPendingCalls(d->data);
         QThreadStorageData::finish((void **)data);
         locker.relock();
 
@@ -46,6 +46,7 @@
 #include <qpointer.h>
 
 #include <private/qcoreapplication_p.h>
+#include <private/qmetacallbatch_p.h>
 #ifndef Q_OS_WINRT
 #include <private/qeventdispatcher_win_p.h>
 #else
@@ -393,6 +394,7 @@ void QThreadPrivate::finish(void *arg, bool lockAnyway) Q_DECL_NOEXCEPT
     locker.unlock();
     emit thr->finished(QThread::QPrivateSignal());
     QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    QMetaCallBatch::discardPendingCalls(d->data);
     QThreadStorageData::finish(tls_data);
     locker.relock();
 
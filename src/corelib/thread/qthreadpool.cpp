@@ -58,12 +58,18 @@ public:
     QThreadPoolThread(QThreadPoolPrivate *manager);
     void run() Q_DECL_OVERRIDE;
     void registerThreadInactive();
+    void runLocalRunnables();
 
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+    StealingQueue localQueue;
 };
 
+#ifdef Q_COMPILER_THREAD_LOCAL
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+#endif
+
 /*
     QThreadPool private class.
 */
@@ -83,6 +89,10 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+#ifdef Q_COMPILER_THREAD_LOCAL
+    currentPoolThread = this;
+#endif
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -99,6 +109,7 @@ void QThreadPoolThread::run()
                 try {
 #endif
                     r->run();
+                    runLocalRunnables();
 #ifndef QT_NO_EXCEPTIONS
                 } catch (...) {
                     qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
@@ -114,13 +125,22 @@ void QThreadPoolThread::run()
                     delete r;
             }
 
-            // if too many threads are active, expire this thread
-            if (manager->tooManyThreadsActive())
+            // if too many threads are active, expire this thread, but
+            // only once nobody else depends on it to run its local runnables
+            if (manager->tooManyThreadsActive() && localQueue.isEmpty())
                 break;
 
+            // runnables started from this thread go first, unless more important ones are queued
+            if (manager->queue.isEmpty() || manager->queue.first()->priority() <= 0) {
+                if ((r = localQueue.pop()))
+                    continue;
+            }
+
             if (manager->queue.isEmpty()) {
-                r = nullptr;
-                break;
+                r = manager->stealRunnable(this);
+                if (!r)
+                    break;
+                continue;
             }
 
             QueuePage *page = manager->queue.first();
@@ -130,6 +150,7 @@ void QThreadPoolThread::run()
                 manager->queue.removeFirst();
                 delete page;
             }
+            manager->updateStealingHints();
         } while (true);
 
         if (manager->isExiting) {
@@ -141,6 +162,7 @@ void QThreadPoolThread::run()
         bool expired = manager->tooManyThreadsActive();
         if (!expired) {
             manager->waitingThreads.enqueue(this);
+            manager->updateStealingHints();
             registerThreadInactive();
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), manager->expiryTimeout);
@@ -150,6 +172,7 @@ void QThreadPoolThread::run()
         }
         if (expired) {
             manager->expiredThreads.enqueue(this);
+            manager->updateStealingHints();
             registerThreadInactive();
             break;
         }
@@ -162,6 +185,50 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+/*
+    \internal
+    Runs the runnables this thread pushed to its local queue, without taking the
+    pool's mutex, until the queue is empty or a runnable with a higher priority
+    is waiting in the global queue. Called without the mutex held.
+*/
+void QThreadPoolThread::runLocalRunnables()
+{
+    while (!manager->highPriorityQueued.load()) {
+        QRunnable *r = localQueue.pop();
+        if (!r)
+            break;
+
+        const bool autoDelete = r->autoDelete();
+#ifndef QT_NO_EXCEPTIONS
+        try {
+#endif
+            r->run();
+#ifndef QT_NO_EXCEPTIONS
+        } catch (...) {
+            // release our reference before run() reports the exception
+            if (autoDelete) {
+                QMutexLocker locker(&manager->mutex);
+                if (!--r->ref)
+                    delete r;
+            }
+            throw;
+        }
+#endif
+
+        if (autoDelete) {
+            // Only this thread holds a reference, unless the runnable restarted
+            // itself with tryStart() and now shares the count with other threads.
+            if (r->ref == 1) {
+                delete r;
+            } else {
+                QMutexLocker locker(&manager->mutex);
+                if (!--r->ref)
+                    delete r;
+            }
+        }
+    }
+}
+
 
 /*
     \internal
@@ -254,6 +321,136 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
     }
 }
 
+/*
+    \internal
+    Pushes \a runnable to the local queue of the calling thread if it is one
+    of this pool's threads and work stealing is enabled, and wakes up a thread
+    to steal it if there are idle ones. Returns \c false if the runnable has to
+    go through the global queue instead. Called without the mutex held.
+*/
+bool QThreadPoolPrivate::tryEnqueueLocally(QRunnable *runnable)
+{
+#ifdef Q_COMPILER_THREAD_LOCAL
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this || !workStealing.load())
+        return false;
+
+    // a runnable the pool already holds a reference to is shared with other
+    // threads, and its reference count may only be changed with the mutex held
+    const bool autoDelete = runnable->autoDelete();
+    if (autoDelete && runnable->ref != 0)
+        return false;
+
+    if (autoDelete)
+        ++runnable->ref;
+
+    if (!thread->localQueue.push(runnable)) {
+        if (autoDelete)
+            --runnable->ref;
+        return false;
+    }
+
+    if (hasIdleThreads.load()) {
+        QMutexLocker locker(&mutex);
+        wakeStealingThread();
+    }
+    return true;
+#else
+    Q_UNUSED(runnable);
+    return false;
+#endif
+}
+
+/*
+    \internal
+    Moves the runnables in the calling thread's local queue to the global
+    queue, where tryTake() can find them.
+*/
+void QThreadPoolPrivate::flushLocalQueue()
+{
+#ifdef Q_COMPILER_THREAD_LOCAL
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this || thread->localQueue.isEmpty())
+        return;
+
+    // pop() returns the most recently pushed runnable first
+    QVector<QRunnable *> runnables;
+    while (QRunnable *r = thread->localQueue.pop())
+        runnables.prepend(r);
+
+    QMutexLocker locker(&mutex);
+    for (QRunnable *r : qAsConst(runnables)) {
+        enqueueTask(r);
+        if (r->autoDelete())
+            --r->ref; // enqueueTask() took another reference
+    }
+    tryToStartMoreThreads();
+    updateStealingHints();
+#endif
+}
+
+/*
+    \internal
+    Returns a runnable from \a thief's own local queue or, in work-stealing
+    mode, one taken from another thread's queue. Called with the mutex held.
+*/
+QRunnable *QThreadPoolPrivate::stealRunnable(QThreadPoolThread *thief)
+{
+    if (QRunnable *r = thief->localQueue.pop())
+        return r;
+
+    if (!workStealing.load())
+        return nullptr;
+
+    // start with the thread after the thief, so that thieves spread out
+    const int count = allThreads.count();
+    const int start = allThreads.indexOf(thief) + 1;
+    for (int i = 0; i < count; ++i) {
+        QThreadPoolThread *victim = allThreads.at((start + i) % count);
+        if (victim == thief)
+            continue;
+        while (!victim->localQueue.isEmpty()) {
+            if (QRunnable *r = victim->localQueue.steal())
+                return r;
+        }
+    }
+    return nullptr;
+}
+
+/*
+    \internal
+    Wakes up an idle thread, or starts one if the limit allows, so that it
+    steals the runnable just pushed to a local queue. Called with the mutex held.
+*/
+void QThreadPoolPrivate::wakeStealingThread()
+{
+    if (!waitingThreads.isEmpty()) {
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+    } else if (activeThreadCount() < maxThreadCount) {
+        if (!expiredThreads.isEmpty()) {
+            QThreadPoolThread *thread = expiredThreads.dequeue();
+            Q_ASSERT(thread->runnable == nullptr);
+            ++activeThreads;
+            thread->start();
+        } else {
+            startThread();
+        }
+    }
+    updateStealingHints();
+}
+
+/*
+    \internal
+    Publishes the state that threads pushing to or draining their local queues
+    need without taking the mutex. Called with the mutex held whenever the
+    global queue or the set of idle threads changes.
+*/
+void QThreadPoolPrivate::updateStealingHints()
+{
+    hasIdleThreads.store(!waitingThreads.isEmpty() || activeThreadCount() < maxThreadCount);
+    highPriorityQueued.store(!queue.isEmpty() && queue.first()->priority() > 0);
+}
+
 bool QThreadPoolPrivate::tooManyThreadsActive() const
 {
     const int activeThreadCount = this->activeThreadCount();
@@ -265,14 +462,13 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
 */
 void QThreadPoolPrivate::startThread(QRunnable *runnable)
 {
-    Q_ASSERT(runnable != nullptr);
     QScopedPointer <QThreadPoolThread> thread(new QThreadPoolThread(this));
     thread->setObjectName(QLatin1String("Thread (pooled)"));
     Q_ASSERT(!allThreads.contains(thread.data())); // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
     allThreads.append(thread.data());
     ++activeThreads;
 
-    if (runnable->autoDelete())
+    if (runnable && runnable->autoDelete())
         ++runnable->ref;
     thread->runnable = runnable;
     thread.take()->start();
@@ -305,6 +501,7 @@ void QThreadPoolPrivate::reset()
 
     waitingThreads.clear();
     expiredThreads.clear();
+    updateStealingHints();
 
     isExiting = false;
 }
@@ -338,6 +535,15 @@ void QThreadPoolPrivate::clear()
     }
     qDeleteAll(queue);
     queue.clear();
+
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        while (!thread->localQueue.isEmpty()) {
+            QRunnable *r = thread->localQueue.steal();
+            if (r && r->autoDelete() && !--r->ref)
+                delete r;
+        }
+    }
+    updateStealingHints();
 }
 
 /*!
@@ -363,6 +569,9 @@ bool QThreadPool::tryTake(QRunnable *runnable)
 
     if (runnable == nullptr)
         return false;
+
+    // runnables in the local queues of other threads cannot be taken
+    d->flushLocalQueue();
     {
         QMutexLocker locker(&d->mutex);
 
@@ -372,6 +581,7 @@ bool QThreadPool::tryTake(QRunnable *runnable)
                     d->queue.removeOne(page);
                     delete page;
                 }
+                d->updateStealingHints();
                 if (runnable->autoDelete())
                     --runnable->ref; // undo ++ref in start()
                 return true;
@@ -500,6 +710,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->tryEnqueueLocally(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
@@ -507,6 +720,7 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         if (!d->waitingThreads.isEmpty())
             d->waitingThreads.takeFirst()->runnableReady.wakeOne();
     }
+    d->updateStealingHints();
 }
 
 /*!
@@ -537,7 +751,9 @@ bool QThreadPool::tryStart(QRunnable *runnable)
     if (d->allThreads.isEmpty() == false && d->activeThreadCount() >= d->maxThreadCount)
         return false;
 
-    return d->tryStart(runnable);
+    const bool started = d->tryStart(runnable);
+    d->updateStealingHints();
+    return started;
 }
 
 /*! \property QThreadPool::expiryTimeout
@@ -595,6 +811,7 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
 
     d->maxThreadCount = maxThreadCount;
     d->tryToStartMoreThreads();
+    d->updateStealingHints();
 }
 
 /*! \property QThreadPool::activeThreadCount
@@ -631,6 +848,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateStealingHints();
 }
 
 /*! \property QThreadPool::stackSize
@@ -659,6 +877,42 @@ uint QThreadPool::stackSize() const
     return d->stackSize;
 }
 
+/*! \property QThreadPool::workStealing
+
+    This property holds whether the thread pool uses work stealing to
+    schedule runnables started from its own threads.
+
+    By default, every call to start() goes through a single queue shared
+    by all threads of the pool. When work stealing is enabled, runnables
+    started with the default priority from within one of the pool's threads
+    are instead kept in a queue local to that thread, which does not require
+    any locking. The thread runs them once its current runnable has returned,
+    most recently started first, while idle threads of the pool take
+    runnables from the other end of busy threads' queues. This greatly
+    reduces contention when many short runnables fan out from within the
+    pool on a many-core system.
+
+    Runnables with a higher priority that are waiting in the shared queue
+    still run before the ones in local queues. tryTake() can only remove
+    runnables from the shared queue and from the local queue of the calling
+    thread.
+
+    The default value is \c false.
+
+    \since 5.10
+*/
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    d->workStealing.store(enabled);
+}
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.load();
+}
+
 /*!
     Releases a thread previously reserved by a call to reserveThread().
 
@@ -677,6 +931,7 @@ void QThreadPool::releaseThread()
     QMutexLocker locker(&d->mutex);
     --d->reservedThreads;
     d->tryToStartMoreThreads();
+    d->updateStealingHints();
 }
 
 /*!
@@ -57,8 +57,11 @@
 #include "QtCore/qwaitcondition.h"
 #include "QtCore/qset.h"
 #include "QtCore/qqueue.h"
+#include "QtCore/qatomic.h"
 #include "private/qobject_p.h"
 
+#include <atomic>
+
 #ifndef QT_NO_THREAD
 
 QT_BEGIN_NAMESPACE
@@ -144,6 +147,83 @@ private:
     QRunnable *m_entries[MaxPageSize];
 };
 
+/*
+    Bounded Chase-Lev deque used in work-stealing mode. The owning pool thread
+    pushes and pops runnables at the bottom end, other pool threads steal from
+    the top end. None of the operations lock; push() fails when the deque is full
+    and steal() may fail spuriously when it races with another thread.
+*/
+class StealingQueue {
+public:
+    enum {
+        Capacity = 256 // must be a power of two
+    };
+
+    StealingQueue()
+        : m_top(0), m_bottom(0)
+    {
+        for (auto &entry : m_entries)
+            entry.store(nullptr);
+    }
+
+    bool isEmpty() const {
+        return qintptr(m_bottom.loadAcquire() - m_top.loadAcquire()) <= 0;
+    }
+
+    bool push(QRunnable *runnable) {
+        Q_ASSERT(runnable != nullptr);
+        const quintptr b = m_bottom.load();
+        const quintptr t = m_top.loadAcquire();
+        if (b - t >= Capacity)
+            return false;
+        m_entries[b & (Capacity - 1)].store(runnable);
+        m_bottom.storeRelease(b + 1);
+        return true;
+    }
+
+    // The fences order the store to one end against the load of the other
+    // end; QAtomicInteger has no equivalent, so use the standard ones.
+    QRunnable *pop() {
+        const quintptr b = m_bottom.load() - 1;
+        m_bottom.store(b);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        quintptr t = m_top.load();
+
+        if (qintptr(b - t) < 0) {
+            m_bottom.store(b + 1);
+            return nullptr;
+        }
+
+        QRunnable *runnable = m_entries[b & (Capacity - 1)].load();
+        if (b == t) {
+            // the last entry, thieves may be trying to take it too
+            if (!m_top.testAndSetOrdered(t, t + 1))
+                runnable = nullptr;
+            m_bottom.store(b + 1);
+        }
+        return runnable;
+    }
+
+    QRunnable *steal() {
+        const quintptr t = m_top.loadAcquire();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const quintptr b = m_bottom.loadAcquire();
+
+        if (qintptr(b - t) <= 0)
+            return nullptr;
+
+        QRunnable *runnable = m_entries[t & (Capacity - 1)].load();
+        if (!m_top.testAndSetOrdered(t, t + 1))
+            return nullptr;
+        return runnable;
+    }
+
+private:
+    QAtomicInteger<quintptr> m_top;
+    QAtomicInteger<quintptr> m_bottom;
+    QAtomicPointer<QRunnable> m_entries[Capacity];
+};
+
 class QThreadPoolThread;
 class Q_CORE_EXPORT QThreadPoolPrivate : public QObjectPrivate
 {
@@ -167,6 +247,12 @@ public:
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    bool tryEnqueueLocally(QRunnable *runnable);
+    void flushLocalQueue();
+    QRunnable *stealRunnable(QThreadPoolThread *thief);
+    void wakeStealingThread();
+    void updateStealingHints();
+
     mutable QMutex mutex;
     QList<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -180,6 +266,11 @@ public:
     int activeThreads = 0;
     uint stackSize = 0;
     bool isExiting = false;
+
+    // read without holding the mutex by threads pushing to or draining their local queues
+    QAtomicInt workStealing;
+    QAtomicInt hasIdleThreads;
+    QAtomicInt highPriorityQueued;
 };
 
 QT_END_NAMESPACE
@@ -41,6 +41,7 @@
 #include <QtCore/qarraydata.h>
 #include <QtCore/private/qnumeric_p.h>
 #include <QtCore/private/qtools_p.h>
+#include <QtCore/private/qscopedarena_p.h>
 
 #include <stdlib.h>
 
@@ -78,9 +79,13 @@ static inline size_t calculateBlockSize(size_t &capacity, size_t objectSize, siz
     }
 }
 
-static QArrayData *reallocateData(QArrayData *header, size_t allocSize, uint options)
+static QArrayData *reallocateData(QArrayData *header, size_t oldSize, size_t allocSize,
+                                  uint options)
 {
-    header = static_cast<QArrayData *>(::realloc(header, allocSize));
+    void *ptr = header;
+    if (!QScopedArena::tryReallocate(&ptr, oldSize, allocSize))
+        ptr = ::realloc(header, allocSize);
+    header = static_cast<QArrayData *>(ptr);
     if (header)
         header->capacityReserved = bool(options & QArrayData::CapacityReserved);
     return header;
@@ -115,7 +120,10 @@ QArrayData *QArrayData::allocate(size_t objectSize, size_t alignment,
         return 0;
 
     size_t allocSize = calculateBlockSize(capacity, objectSize, headerSize, options);
-    QArrayData *header = static_cast<QArrayData *>(::malloc(allocSize));
+    void *ptr = QScopedArena::tryAllocate(allocSize);
+    if (!ptr)
+        ptr = ::malloc(allocSize);
+    QArrayData *header = static_cast<QArrayData *>(ptr);
     if (header) {
         quintptr data = (quintptr(header) + sizeof(QArrayData) + alignment - 1)
                 & ~(alignment - 1);
@@ -142,8 +150,10 @@ QArrayData *QArrayData::reallocateUnaligned(QArrayData *data, size_t objectSize,
     Q_ASSERT(!data->ref.isShared());
 
     size_t headerSize = sizeof(QArrayData);
+    size_t oldSize = headerSize + size_t(data->alloc) * objectSize;
     size_t allocSize = calculateBlockSize(capacity, objectSize, headerSize, options);
-    QArrayData *header = static_cast<QArrayData *>(reallocateData(data, allocSize, options));
+    QArrayData *header = static_cast<QArrayData *>(reallocateData(data, oldSize, allocSize,
+                                                                  options));
     if (header)
         header->alloc = capacity;
     return header;
@@ -164,7 +174,8 @@ void QArrayData::deallocate(QArrayData *data, size_t objectSize,
 
     Q_ASSERT_X(data == 0 || !data->ref.isStatic(), "QArrayData::deallocate",
                "Static data can not be deleted");
-    ::free(data);
+    if (!QScopedArena::tryFree(data))
+        ::free(data);
 }
 
 namespace QtPrivate {
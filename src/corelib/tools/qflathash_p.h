@@ -0,0 +1,671 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QFLATHASH_P_H
+#define QFLATHASH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qiterator.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+#include <QtCore/private/qsimd_p.h>
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFlatHashPrivate {
+
+// The seed QHash uses, initialized on first use
+Q_CORE_EXPORT uint globalSeed();
+
+// One control byte per slot: the 7 low bits of the hash of a full slot,
+// or one of these (negative) markers
+enum : qint8 {
+    Empty = -128,
+    Deleted = -2
+};
+
+// A group of control bytes probed at once. The match functions return a
+// mask with one bit (SSE2) or one byte (the portable version) per slot.
+#if defined(__SSE2__)
+struct Group
+{
+    enum { Width = 16 };
+    typedef uint Mask;
+
+    explicit Group(const qint8 *ctrl) Q_DECL_NOTHROW
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl)))
+    {}
+
+    Mask match(qint8 h2) const Q_DECL_NOTHROW
+    {
+        // broadcast through a general purpose register, _mm_set1_epi8() goes through the stack
+        const __m128i pattern = _mm_shuffle_epi32(_mm_cvtsi32_si128(int(quint8(h2) * 0x01010101U)), 0);
+        return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(pattern, ctrl)));
+    }
+    Mask matchEmpty() const Q_DECL_NOTHROW
+    { return match(Empty); }
+    Mask matchEmptyOrDeleted() const Q_DECL_NOTHROW
+    { return uint(_mm_movemask_epi8(ctrl)); } // the markers are the bytes with the sign bit set
+
+    static int lowestSlot(Mask mask) Q_DECL_NOTHROW
+    { return int(qCountTrailingZeroBits(mask)); }
+
+    __m128i ctrl;
+};
+#else
+struct Group
+{
+    enum { Width = 8 };
+    typedef quint64 Mask;
+
+    explicit Group(const qint8 *ctrl) Q_DECL_NOTHROW
+        : ctrl(qFromLittleEndian<quint64>(ctrl))
+    {}
+
+    // May report a full slot following a true match as a false positive,
+    // which is harmless since the keys are compared anyway. Empty and
+    // deleted slots are never reported.
+    Mask match(qint8 h2) const Q_DECL_NOTHROW
+    {
+        const quint64 x = ctrl ^ (lsbs * quint8(h2));
+        return (x - lsbs) & ~x & msbs;
+    }
+    Mask matchEmpty() const Q_DECL_NOTHROW
+    { return ctrl & ~(ctrl << 6) & msbs; } // Empty has the sign bit set and bit 1 clear
+    Mask matchEmptyOrDeleted() const Q_DECL_NOTHROW
+    { return ctrl & msbs; }
+
+    static int lowestSlot(Mask mask) Q_DECL_NOTHROW
+    { return int(qCountTrailingZeroBits(mask)) / 8; }
+
+    static const quint64 lsbs = Q_UINT64_C(0x0101010101010101);
+    static const quint64 msbs = Q_UINT64_C(0x8080808080808080);
+    quint64 ctrl;
+};
+#endif
+
+// qHash() is the identity for integers, spread its bits over the whole word
+// so that both the group index and the control byte get some of them
+inline uint mix(uint h) Q_DECL_NOTHROW
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+} // namespace QFlatHashPrivate
+
+/*
+    QFlatHash is an implicitly shared hash table with open addressing in the
+    style of SwissTable: the nodes live in a single array, next to an array of
+    control bytes holding 7 bits of the hash of every slot. A lookup hashes
+    the key, then compares a whole group of control bytes at once (with SSE2
+    where available) and only compares keys of the matching slots.
+
+    Unlike QHash there is no allocation per insertion and no pointer chasing,
+    but inserting may move the existing nodes, so it invalidates all
+    iterators and references into the hash. Removing elements, including
+    through erase(), doesn't move anything.
+
+    Keys need qHash() and operator==(), like for QHash. The keys and values
+    must be movable.
+*/
+template <typename Key, typename T>
+class QFlatHash
+{
+    typedef QFlatHashPrivate::Group Group;
+
+    struct Node
+    {
+        Node(const Key &key, const T &value) : key(key), value(value) {}
+        Key key;
+        T value;
+    };
+    Q_STATIC_ASSERT_X(Q_ALIGNOF(Node) <= int(Group::Width), "QFlatHash doesn't support over-aligned types");
+
+    struct Data
+    {
+        QtPrivate::RefCount ref;
+        int size;
+        int growthLeft; // insertions into empty slots before a rehash
+        int capacity;   // number of slots, a power of two
+        uint seed;
+        qint8 *ctrl;    // capacity control bytes, followed by the nodes
+        Node *nodes;
+    };
+
+public:
+    class const_iterator;
+
+    class iterator
+    {
+        friend class QFlatHash<Key, T>;
+        friend class const_iterator;
+        Data *d;
+        int i;
+        iterator(Data *d, int i) : d(d), i(i) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        Q_DECL_CONSTEXPR iterator() : d(nullptr), i(0) {}
+
+        const Key &key() const { return d->nodes[i].key; }
+        T &value() const { return d->nodes[i].value; }
+        T &operator*() const { return d->nodes[i].value; }
+        T *operator->() const { return &d->nodes[i].value; }
+        bool operator==(const iterator &o) const { return i == o.i; }
+        bool operator!=(const iterator &o) const { return i != o.i; }
+        bool operator==(const const_iterator &o) const { return i == o.i; }
+        bool operator!=(const const_iterator &o) const { return i != o.i; }
+
+        iterator &operator++() { i = QFlatHash::nextFull(d, i + 1); return *this; }
+        iterator operator++(int) { iterator r = *this; ++*this; return r; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class QFlatHash<Key, T>;
+        friend class iterator;
+        const Data *d;
+        int i;
+        const_iterator(const Data *d, int i) : d(d), i(i) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        Q_DECL_CONSTEXPR const_iterator() : d(nullptr), i(0) {}
+        const_iterator(const iterator &o) : d(o.d), i(o.i) {}
+
+        const Key &key() const { return d->nodes[i].key; }
+        const T &value() const { return d->nodes[i].value; }
+        const T &operator*() const { return d->nodes[i].value; }
+        const T *operator->() const { return &d->nodes[i].value; }
+        bool operator==(const const_iterator &o) const { return i == o.i; }
+        bool operator!=(const const_iterator &o) const { return i != o.i; }
+
+        const_iterator &operator++() { i = QFlatHash::nextFull(d, i + 1); return *this; }
+        const_iterator operator++(int) { const_iterator r = *this; ++*this; return r; }
+    };
+    friend class const_iterator;
+
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    QFlatHash() Q_DECL_NOTHROW : d(nullptr) {}
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key, T> > list)
+        : d(nullptr)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key, T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    QFlatHash(const QFlatHash &other) : d(other.d) { if (d) d->ref.ref(); }
+    ~QFlatHash() { if (d && !d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other)
+    {
+        QFlatHash copy(other);
+        swap(copy);
+        return *this;
+    }
+#ifdef Q_COMPILER_RVALUE_REFS
+    QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW : d(other.d) { other.d = nullptr; }
+    QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#endif
+    void swap(QFlatHash &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    int size() const Q_DECL_NOTHROW { return d ? d->size : 0; }
+    int count() const Q_DECL_NOTHROW { return size(); }
+    bool isEmpty() const Q_DECL_NOTHROW { return size() == 0; }
+    int capacity() const Q_DECL_NOTHROW { return d ? maxLoad(d->capacity) : 0; }
+    void reserve(int size);
+    void squeeze();
+
+    void detach() { if (!d || d->ref.isShared()) detach_helper(); }
+    bool isDetached() const Q_DECL_NOTHROW { return !d || !d->ref.isShared(); }
+    bool isSharedWith(const QFlatHash &other) const Q_DECL_NOTHROW { return d && d == other.d; }
+
+    void clear() { *this = QFlatHash(); }
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const { return findSlot(key) >= 0; }
+    const T value(const Key &key, const T &defaultValue = T()) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const { return value(key); }
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    // an empty hash has nothing to iterate over, don't allocate for it
+    iterator begin() { if (!d) return iterator(); detach(); return iterator(d, nextFull(d, 0)); }
+    const_iterator begin() const Q_DECL_NOTHROW { return const_iterator(d, nextFull(d, 0)); }
+    const_iterator cbegin() const Q_DECL_NOTHROW { return begin(); }
+    const_iterator constBegin() const Q_DECL_NOTHROW { return begin(); }
+    iterator end() { if (!d) return iterator(); detach(); return iterator(d, d->capacity); }
+    const_iterator end() const Q_DECL_NOTHROW { return const_iterator(d, d ? d->capacity : 0); }
+    const_iterator cend() const Q_DECL_NOTHROW { return end(); }
+    const_iterator constEnd() const Q_DECL_NOTHROW { return end(); }
+
+    iterator erase(const_iterator it);
+    iterator erase(iterator it) { return erase(const_iterator(it)); }
+
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const;
+    const_iterator constFind(const Key &key) const { return find(key); }
+    iterator insert(const Key &key, const T &value);
+
+    // STL compatibility
+    inline bool empty() const Q_DECL_NOTHROW { return isEmpty(); }
+
+private:
+    static int maxLoad(int capacity) Q_DECL_NOTHROW { return capacity - capacity / 8; }
+    static int capacityForSize(int size) Q_DECL_NOTHROW;
+    static uint hash(const Key &key, uint seed) { return QFlatHashPrivate::mix(qHash(key, seed)); }
+    static int nextFull(const Data *d, int i) Q_DECL_NOTHROW;
+
+    static Data *allocateData(int capacity, uint seed);
+    static void freeData(Data *d);
+    void detach_helper();
+    void rehash(int capacity);
+
+    int findSlot(const Key &key) const { return d && d->size ? findSlot(d, key, hash(key, d->seed)) : -1; }
+    static int findSlot(const Data *d, const Key &key, uint h);
+    static int findEmptySlot(const Data *d, uint h) Q_DECL_NOTHROW;
+    int insertNode(const Key &key, uint h, const T &value);
+    void eraseSlot(int slot);
+
+    Data *d;
+};
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::capacityForSize(int size) Q_DECL_NOTHROW
+{
+    int capacity = Group::Width;
+    while (maxLoad(capacity) < size)
+        capacity *= 2;
+    return capacity;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::nextFull(const Data *d, int i) Q_DECL_NOTHROW
+{
+    if (!d)
+        return 0;
+    while (i < d->capacity && d->ctrl[i] < 0)
+        ++i;
+    return i;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::Data *QFlatHash<Key, T>::allocateData(int capacity, uint seed)
+{
+    Data *x = new Data;
+    x->ref.initializeOwned();
+    x->size = 0;
+    x->growthLeft = maxLoad(capacity);
+    x->capacity = capacity;
+    x->seed = seed;
+    // the control bytes are a multiple of the group width, which keeps the nodes aligned
+    x->ctrl = static_cast<qint8 *>(::malloc(size_t(capacity) * (1 + sizeof(Node))));
+    Q_CHECK_PTR(x->ctrl);
+    x->nodes = reinterpret_cast<Node *>(x->ctrl + capacity);
+    memset(x->ctrl, QFlatHashPrivate::Empty, size_t(capacity));
+    return x;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::freeData(Data *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        for (int i = 0; i < x->capacity; ++i) {
+            if (x->ctrl[i] >= 0)
+                x->nodes[i].~Node();
+        }
+    }
+    ::free(x->ctrl);
+    delete x;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    if (!d) {
+        d = allocateData(capacityForSize(0), QFlatHashPrivate::globalSeed());
+        return;
+    }
+
+    // same layout, so that slot numbers (and thus iterators) stay valid
+    Data *x = allocateData(d->capacity, d->seed);
+    memcpy(x->ctrl, d->ctrl, size_t(d->capacity));
+    for (int i = 0; i < d->capacity; ++i) {
+        if (d->ctrl[i] >= 0)
+            new (x->nodes + i) Node(d->nodes[i]);
+    }
+    x->size = d->size;
+    x->growthLeft = d->growthLeft;
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(int capacity)
+{
+    Q_ASSERT(isDetached() && d);
+    Data *x = allocateData(capacity, d->seed);
+    for (int i = 0; i < d->capacity; ++i) {
+        if (d->ctrl[i] < 0)
+            continue;
+        Node &node = d->nodes[i];
+        const uint h = hash(node.key, x->seed);
+        const int slot = findEmptySlot(x, h);
+        x->ctrl[slot] = qint8(h & 0x7f);
+        new (x->nodes + slot) Node(std::move(node));
+        node.~Node();
+    }
+    x->size = d->size;
+    x->growthLeft = maxLoad(capacity) - d->size;
+    ::free(d->ctrl);
+    delete d;
+    d = x;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findSlot(const Data *d, const Key &key, uint h)
+{
+    const qint8 h2 = qint8(h & 0x7f);
+    const int groupMask = d->capacity / Group::Width - 1;
+    int group = int(h >> 7) & groupMask;
+    // triangular probing visits every group once when their number is a power of two
+    for (int step = 1; ; ++step) {
+        const int base = group * Group::Width;
+        const Group g(d->ctrl + base);
+        for (typename Group::Mask match = g.match(h2); match; match &= match - 1) {
+            const int slot = base + Group::lowestSlot(match);
+            if (d->nodes[slot].key == key)
+                return slot;
+        }
+        // the key would have been inserted into the first group with room
+        if (g.matchEmpty())
+            return -1;
+        group = (group + step) & groupMask;
+    }
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findEmptySlot(const Data *d, uint h) Q_DECL_NOTHROW
+{
+    const int groupMask = d->capacity / Group::Width - 1;
+    int group = int(h >> 7) & groupMask;
+    for (int step = 1; ; ++step) {
+        const int base = group * Group::Width;
+        if (const typename Group::Mask match = Group(d->ctrl + base).matchEmptyOrDeleted())
+            return base + Group::lowestSlot(match);
+        group = (group + step) & groupMask;
+    }
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::insertNode(const Key &key, uint h, const T &value)
+{
+    int slot = findEmptySlot(d, h);
+    if (d->growthLeft == 0 && d->ctrl[slot] != QFlatHashPrivate::Deleted) {
+        // key and value may be references into this hash, copy them before the nodes move
+        const Key keyCopy(key);
+        const T valueCopy(value);
+        // just drop the deleted slots if they make up most of the table
+        rehash(d->size >= maxLoad(d->capacity) / 2 ? d->capacity * 2 : d->capacity);
+        slot = findEmptySlot(d, h);
+        new (d->nodes + slot) Node(keyCopy, valueCopy);
+    } else {
+        new (d->nodes + slot) Node(key, value);
+    }
+    if (d->ctrl[slot] == QFlatHashPrivate::Empty)
+        --d->growthLeft;
+    d->ctrl[slot] = qint8(h & 0x7f);
+    ++d->size;
+    return slot;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::eraseSlot(int slot)
+{
+    d->nodes[slot].~Node();
+    // if the group has an empty slot, no lookup ever probed past it, so
+    // this one can become empty too instead of a tombstone
+    if (Group(d->ctrl + (slot & ~(Group::Width - 1))).matchEmpty()) {
+        d->ctrl[slot] = QFlatHashPrivate::Empty;
+        ++d->growthLeft;
+    } else {
+        d->ctrl[slot] = QFlatHashPrivate::Deleted;
+    }
+    --d->size;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+    for (const_iterator it = begin(), end = this->end(); it != end; ++it) {
+        const int slot = other.findSlot(it.key());
+        if (slot < 0 || !(other.d->nodes[slot].value == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int size)
+{
+    detach();
+    const int capacity = capacityForSize(qMax(size, d->size));
+    if (capacity > d->capacity)
+        rehash(capacity);
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (!d)
+        return;
+    detach();
+    const int capacity = capacityForSize(d->size);
+    if (capacity != d->capacity)
+        rehash(capacity);
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &key)
+{
+    const int slot = findSlot(key);
+    if (slot < 0)
+        return 0;
+    detach();
+    eraseSlot(slot);
+    return 1;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &key)
+{
+    const int slot = findSlot(key);
+    if (slot < 0)
+        return T();
+    detach();
+    T t = std::move(d->nodes[slot].value);
+    eraseSlot(slot);
+    return t;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key, const T &defaultValue) const
+{
+    const int slot = findSlot(key);
+    return slot < 0 ? defaultValue : d->nodes[slot].value;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &key)
+{
+    detach();
+    const uint h = hash(key, d->seed);
+    int slot = findSlot(d, key, h);
+    if (slot < 0)
+        slot = insertNode(key, h, T());
+    return d->nodes[slot].value;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = begin(), end = this->end(); it != end; ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = begin(), end = this->end(); it != end; ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(it.i >= 0 && it.i < (d ? d->capacity : 0) && d->ctrl[it.i] >= 0,
+               "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    const int slot = it.i;
+    detach(); // keeps the slot numbers
+    eraseSlot(slot);
+    return iterator(d, nextFull(d, slot + 1));
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &key)
+{
+    const int slot = findSlot(key);
+    if (slot < 0) {
+        // no need to detach for a miss, detaching keeps the slot numbers
+        // and iterators only compare those
+        return iterator(d, d ? d->capacity : 0);
+    }
+    detach();
+    return iterator(d, slot);
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::find(const Key &key) const
+{
+    const int slot = findSlot(key);
+    return slot < 0 ? end() : const_iterator(d, slot);
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key, const T &value)
+{
+    detach();
+    const uint h = hash(key, d->seed);
+    int slot = findSlot(d, key, h);
+    if (slot >= 0)
+        d->nodes[slot].value = value;
+    else
+        slot = insertNode(key, h, value);
+    return iterator(d, slot);
+}
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_P_H
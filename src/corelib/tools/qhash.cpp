@@ -60,6 +60,8 @@
 #include <qbasicatomic.h>
 #include <qendian.h>
 #include <private/qsimd_p.h>
+#include <private/qflathash_p.h>
+#include <private/qscopedarena_p.h>
 
 #ifndef QT_BOOTSTRAPPED
 #include <qcoreapplication.h>
@@ -342,6 +344,18 @@ int qGlobalQHashSeed()
     return qt_qhash_seed.load();
 }
 
+/*!
+    \internal
+
+    Returns the seed for a newly created QFlatHash, which is the same one
+    QHash uses, initializing it if necessary.
+*/
+uint QFlatHashPrivate::globalSeed()
+{
+    qt_initialize_qhash_seed(); // may throw
+    return uint(qt_qhash_seed.load());
+}
+
 /*! \relates QHash
     \since 5.6
 
@@ -475,7 +489,16 @@ const QHashData QHashData::shared_null = {
 
 void *QHashData::allocateNode(int nodeAlign)
 {
-    void *ptr = strictAlignment ? qMallocAligned(nodeSize, nodeAlign) : malloc(nodeSize);
+    void *ptr;
+    if (strictAlignment) {
+        // neither the arena nor malloc() guarantee the alignment, and
+        // freeNode() hands the node to qFreeAligned()
+        ptr = qMallocAligned(nodeSize, nodeAlign);
+    } else {
+        ptr = QScopedArena::tryAllocate(nodeSize);
+        if (!ptr)
+            ptr = malloc(nodeSize);
+    }
     Q_CHECK_PTR(ptr);
     return ptr;
 }
@@ -484,7 +507,7 @@ void QHashData::freeNode(void *node)
 {
     if (strictAlignment)
         qFreeAligned(node);
-    else
+    else if (!QScopedArena::tryFree(node))
         free(node);
 }
 
@@ -3313,6 +3313,37 @@ bool QLocaleData::numberToCLocale(QStringView s, QLocale::NumberOptions number_o
     auto l = s.size();
     decltype(l) idx = 0;
 
+    // Fast path: plain ASCII numbers in a locale using the C symbols only need
+    // narrowing. Anything unusual restarts on the general path below.
+    if (m_zero == '0' && m_decimal == '.' && m_exponential == 'e' && l < 256
+            && !(number_options & (QLocale::RejectLeadingZeroInExponent
+                                   | QLocale::RejectTrailingZeroesAfterDot))) {
+        result->resize(int(l) + 1);
+        char *out = result->data();
+        bool seenDot = false;
+        bool seenExponent = false;
+        for (; idx < l; ++idx) {
+            const ushort c = uc[idx].unicode();
+            if ((c >= '0' && c <= '9') || c == '+' || c == '-') {
+                out[idx] = char(c);
+            } else if (c == '.' && !seenDot && !seenExponent) {
+                seenDot = true;
+                out[idx] = '.';
+            } else if (c == 'e' || c == 'E') {
+                seenExponent = true;
+                out[idx] = 'e';
+            } else {
+                break;
+            }
+        }
+        if (idx == l && l) {
+            out[idx] = '\0';
+            return true;
+        }
+        result->clear();
+        idx = 0;
+    }
+
     // Skip whitespace
     while (idx < l && uc[idx].isSpace())
         ++idx;
@@ -3596,6 +3627,19 @@ qlonglong QLocaleData::bytearrayToLongLong(const char *num, int base, bool *ok)
         return 0;
     }
 
+    if (base == 10) {
+        quint64 value;
+        bool negative;
+        if (fastDecimalToInteger(num, num + strlen(num), &value, &negative)) {
+            const quint64 limit = quint64(std::numeric_limits<qlonglong>::max()) + negative;
+            if (ok != 0)
+                *ok = value <= limit;
+            if (value > limit)
+                return 0;
+            return negative ? qlonglong(0 - value) : qlonglong(value);
+        }
+    }
+
     qlonglong l = qstrtoll(num, &endptr, base, &_ok);
 
     if (!_ok) {
@@ -3620,6 +3664,18 @@ qulonglong QLocaleData::bytearrayToUnsLongLong(const char *num, int base, bool *
 {
     bool _ok;
     const char *endptr;
+
+    if (base == 10) {
+        quint64 value;
+        bool negative;
+        if (fastDecimalToInteger(num, num + strlen(num), &value, &negative)) {
+            // like qstrtoull(), reject negative numbers, even -0
+            if (ok != 0)
+                *ok = !negative;
+            return negative ? 0 : value;
+        }
+    }
+
     qulonglong l = qstrtoull(num, &endptr, base, &_ok);
 
     if (!_ok || *endptr != '\0') {
@@ -41,8 +41,10 @@
 #include "qlocale_tools_p.h"
 #include "qdoublescanprint_p.h"
 #include "qlocale_p.h"
+#include "qpowersoffive_p.h"
 #include "qstring.h"
 
+#include <QtCore/qendian.h>
 #include <private/qnumeric_p.h>
 
 #include <ctype.h>
@@ -277,6 +279,228 @@ void doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, char *
         --length;
 }
 
+// 8 ASCII digits at a time (SWAR), for the fast paths below. The bytes are
+// loaded in memory order, so the first digit is in the lowest byte.
+static inline quint64 loadEightChars(const char *p)
+{
+    return qFromLittleEndian<quint64>(p);
+}
+
+static inline bool isEightDigits(quint64 v)
+{
+    return ((v & Q_UINT64_C(0xF0F0F0F0F0F0F0F0))
+            | (((v + Q_UINT64_C(0x0606060606060606)) & Q_UINT64_C(0xF0F0F0F0F0F0F0F0)) >> 4))
+            == Q_UINT64_C(0x3333333333333333);
+}
+
+static inline quint32 parseEightDigits(quint64 v)
+{
+    const quint64 mask = Q_UINT64_C(0x000000FF000000FF);
+    const quint64 mul1 = 100 + (Q_UINT64_C(1000000) << 32);
+    const quint64 mul2 = 1 + (Q_UINT64_C(10000) << 32);
+    v -= Q_UINT64_C(0x3030303030303030);
+    v = (v * 10) + (v >> 8);
+    return quint32((((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32);
+}
+
+static inline bool isAsciiDigit(char c)
+{
+    return uchar(c - '0') < 10;
+}
+
+// Accumulates a run of digits into *value; returns the end of the run.
+static inline const char *parseDigits(const char *p, const char *end, quint64 *value)
+{
+    quint64 v = *value;
+    while (end - p >= 8) {
+        const quint64 chars = loadEightChars(p);
+        if (!isEightDigits(chars))
+            break;
+        v = v * 100000000 + parseEightDigits(chars);
+        p += 8;
+    }
+    while (p != end && isAsciiDigit(*p))
+        v = v * 10 + uint(*p++ - '0');
+    *value = v;
+    return p;
+}
+
+/*
+    Parses [begin, end) if it is a plain base-10 integer, [+-]digits with at
+    most 19 digits. Returns false otherwise, leaving the general parser to
+    deal with whitespace, other bases and overflow.
+*/
+bool fastDecimalToInteger(const char *begin, const char *end, quint64 *value, bool *negative)
+{
+    const char *p = begin;
+    *negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+        *negative = *p++ == '-';
+    if (p == end || end - p > 19)
+        return false;
+    *value = 0;
+    return parseDigits(p, end, value) == end;
+}
+
+static inline quint64 multiplyHigh(quint64 a, quint64 b, quint64 *low)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    *low = quint64(r);
+    return quint64(r >> 64);
+#elif defined(Q_CC_MSVC) && (defined(Q_PROCESSOR_X86_64) || defined(Q_PROCESSOR_IA64))
+    quint64 high;
+    *low = _umul128(a, b, &high);
+    return high;
+#else
+    const quint64 aLow = quint32(a), aHigh = a >> 32;
+    const quint64 bLow = quint32(b), bHigh = b >> 32;
+    const quint64 ll = aLow * bLow, lh = aLow * bHigh, hl = aHigh * bLow, hh = aHigh * bHigh;
+    const quint64 mid = (ll >> 32) + quint32(lh) + quint32(hl);
+    *low = (mid << 32) | quint32(ll);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+/*
+    Computes the double closest to mantissa * 10^exponent with the algorithm
+    of Eisel and Lemire (Daniel Lemire, "Number Parsing at a Gigabyte per
+    Second", 2021). Returns false in the rare cases that it cannot decide the
+    rounding, and for results that are subnormal or out of range.
+*/
+static bool eiselLemire(quint64 mantissa, int exponent, bool negative, double *result)
+{
+    if (exponent < QtPowersOfFiveMinExponent || exponent > QtPowersOfFiveMaxExponent)
+        return false;
+
+    const quint64 *power = qt_powersOfFive[exponent - QtPowersOfFiveMinExponent];
+    int lz = int(qCountLeadingZeroBits(mantissa));
+    mantissa <<= lz;
+
+    quint64 lower;
+    quint64 upper = multiplyHigh(mantissa, power[0], &lower);
+    if ((upper & 0x1FF) == 0x1FF && lower + mantissa < lower) {
+        // The truncated product may be off; bring in the next 64 bits of 5^q.
+        quint64 productLow;
+        const quint64 productMiddle2 = multiplyHigh(mantissa, power[1], &productLow);
+        const quint64 productMiddle = lower + productMiddle2;
+        if (productMiddle < lower)
+            ++upper;
+        if (productMiddle + 1 == 0 && (upper & 0x1FF) == 0x1FF && productLow + mantissa < productLow)
+            return false;
+        lower = productMiddle;
+    }
+
+    const quint64 upperBit = upper >> 63;
+    quint64 bits = upper >> (upperBit + 9);
+    lz += int(1 ^ upperBit);
+
+    // Exactly halfway between two doubles: let the exact parser break the tie.
+    if (lower == 0 && (upper & 0x1FF) == 0 && (bits & 3) == 1)
+        return false;
+
+    bits += bits & 1;
+    bits >>= 1;
+    if (bits >= (Q_UINT64_C(1) << 53)) {
+        bits = Q_UINT64_C(1) << 52;
+        --lz;
+    }
+    bits &= ~(Q_UINT64_C(1) << 52);
+
+    // floor(exponent * log2(10)) + bias + 63
+    const qint64 binaryExponent = (((152170 + 65536) * qint64(exponent)) >> 16) + 1024 + 63 - lz;
+    if (binaryExponent < 1 || binaryExponent > 2046)
+        return false;
+
+    bits |= quint64(binaryExponent) << 52;
+    bits |= quint64(negative) << 63;
+    memcpy(result, &bits, sizeof(bits));
+    return true;
+}
+
+/*
+    Converts [num, num + numLen) if it is a plain decimal number,
+    [+-]digits[.digits][(e|E)[+-]digits], with at most 19 significant digits,
+    and the result is a normal double. Anything else is left to the exact
+    parser in asciiToDouble().
+*/
+static bool fastAsciiToDouble(const char *num, int numLen, double *result)
+{
+    const char *p = num;
+    const char *const end = num + numLen;
+
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+
+    const char *const integerBegin = p;
+    while (p != end && *p == '0')
+        ++p;
+    const char *const significantBegin = p;
+    quint64 mantissa = 0;
+    p = parseDigits(p, end, &mantissa);
+    if (p == integerBegin)
+        return false;
+    qptrdiff significantDigits = p - significantBegin;
+
+    int exponent = 0;
+    if (p != end && *p == '.') {
+        const char *const fractionBegin = ++p;
+        p = parseDigits(p, end, &mantissa);
+        const qptrdiff fractionDigits = p - fractionBegin;
+        if (!fractionDigits || fractionDigits > 400)
+            return false;
+        exponent = -int(fractionDigits);
+        if (significantDigits) {
+            significantDigits += fractionDigits;
+        } else {
+            const char *q = fractionBegin;
+            while (q != p && *q == '0')
+                ++q;
+            significantDigits = p - q;
+        }
+    }
+    if (significantDigits > 19)
+        return false;
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p != end && (*p == '-' || *p == '+'))
+            negativeExponent = *p++ == '-';
+        if (p == end || end - p > 4)
+            return false;
+        quint64 e = 0;
+        if (parseDigits(p, end, &e) != end)
+            return false;
+        exponent += negativeExponent ? -int(e) : int(e);
+        p = end;
+    }
+    if (p != end)
+        return false;
+
+    if (mantissa == 0) {
+        *result = negative ? -0.0 : 0.0;
+        return true;
+    }
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    // Clinger's fast path: both operands are exact, so is the result.
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    if (mantissa <= (Q_UINT64_C(1) << 53) && exponent >= -22 && exponent <= 22) {
+        double d = double(mantissa);
+        d = exponent < 0 ? d / powersOfTen[-exponent] : d * powersOfTen[exponent];
+        *result = negative ? -d : d;
+        return true;
+    }
+#endif
+
+    return eiselLemire(mantissa, exponent, negative, result);
+}
+
 double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
                      TrailingJunkMode trailingJunkMode)
 {
@@ -288,6 +512,12 @@ double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
 
     ok = true;
 
+    double d = 0.0;
+    if (fastAsciiToDouble(num, numLen, &d)) {
+        processed = numLen;
+        return d;
+    }
+
     // We have to catch NaN before because we need NaN as marker for "garbage" in the
     // libdouble-conversion case and, in contrast to libdouble-conversion or sscanf, we don't allow
     // "-nan" or "+nan"
@@ -313,7 +543,6 @@ double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
         return -qt_inf();
     }
 
-    double d = 0.0;
 #if !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
     int conv_flags = (trailingJunkMode == TrailingJunkAllowed) ?
                 double_conversion::StringToDoubleConverter::ALLOW_TRAILING_JUNK :
@@ -118,6 +118,7 @@ Q_CORE_EXPORT double qstrtod(const char *s00, char const **se, bool *ok);
 Q_CORE_EXPORT double qstrntod(const char *s00, int len, char const **se, bool *ok);
 qlonglong qstrtoll(const char *nptr, const char **endptr, int base, bool *ok);
 qulonglong qstrtoull(const char *nptr, const char **endptr, int base, bool *ok);
+bool fastDecimalToInteger(const char *begin, const char *end, quint64 *value, bool *negative);
 
 QT_END_NAMESPACE
 
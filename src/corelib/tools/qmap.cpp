@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qmap.h"
+#include <private/qscopedarena_p.h>
 
 #include <stdlib.h>
 
@@ -290,7 +291,8 @@ void QMapDataBase::freeNodeAndRebalance(QMapNodeBase *z)
     if (x)
         x->setColor(QMapNodeBase::Black);
     }
-    free(y);
+    if (!QScopedArena::tryFree(y))
+        free(y);
     --size;
 }
 
@@ -311,16 +313,18 @@ static inline int qMapAlignmentThreshold()
 
 static inline void *qMapAllocate(int alloc, int alignment)
 {
-    return alignment > qMapAlignmentThreshold()
-        ? qMallocAligned(alloc, alignment)
-        : ::malloc(alloc);
+    if (alignment > qMapAlignmentThreshold())
+        return qMallocAligned(alloc, alignment);
+    if (void *ptr = QScopedArena::tryAllocate(alloc))
+        return ptr;
+    return ::malloc(alloc);
 }
 
 static inline void qMapDeallocate(QMapNodeBase *node, int alignment)
 {
     if (alignment > qMapAlignmentThreshold())
         qFreeAligned(node);
-    else
+    else if (!QScopedArena::tryFree(node))
         ::free(node);
 }
 
@@ -0,0 +1,386 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qscopedarena_p.h"
+
+#include <QtCore/qmutex.h>
+
+#include <new>
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef Q_OS_WIN
+#  include <malloc.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QScopedArena
+    \inmodule QtCore
+    \internal
+
+    \brief The QScopedArena class provides a per-thread monotonic arena for
+    container allocations.
+
+    While a QScopedArena object is alive, QArrayData (and therefore QString,
+    QByteArray and QVector), QHash and QMap allocate their storage on the
+    creating thread from the arena instead of malloc(). The arena hands out
+    memory by bumping a pointer through 64 KiB chunks and does not reuse
+    freed memory. This makes it a good fit for code that builds and then
+    discards many short-lived containers.
+
+    Arenas nest; the innermost one on the current thread wins. Allocations
+    larger than a quarter of a chunk still go to malloc(). A few released
+    chunks are kept per thread, so that creating an arena is cheap.
+
+    Memory may outlive the scope. Each chunk counts the allocations it holds
+    and is only released once all of them have been freed, from any thread.
+    Containers that escape the scope therefore stay valid, but they keep
+    their whole chunk alive.
+*/
+
+#ifdef QT_HAS_SCOPED_ARENA
+
+namespace {
+
+enum {
+    ChunkShift = 16,
+    ChunkSize = 1 << ChunkShift,
+    MaxAllocation = ChunkSize / 4,
+    Alignment = 2 * sizeof(void *),     // matches what malloc() guarantees
+    OwnerBias = 1 << 30,
+
+    LeafBits = 16,
+    AddressBits = QT_POINTER_SIZE == 8 ? 48 : 32,
+    RootBits = AddressBits - ChunkShift - LeafBits
+};
+
+} // unnamed namespace
+
+struct QArenaChunk
+{
+    // OwnerBias plus the allocations flushed by the owner, minus the frees.
+    // The chunk is released when this drops to zero.
+    QAtomicInt live;
+};
+
+namespace {
+
+const size_t ChunkHeaderSize = (sizeof(QArenaChunk) + Alignment - 1) & ~size_t(Alignment - 1);
+
+// Two-level page map from 64 KiB-aligned address to chunk, as used by
+// tcmalloc. Lookups are lock-free; leaves are never freed.
+struct PageMapLeaf
+{
+    QBasicAtomicPointer<QArenaChunk> chunks[1 << LeafBits];
+};
+
+QBasicAtomicPointer<PageMapLeaf> pageMap[1 << RootBits];
+QBasicMutex pageMapMutex;
+
+inline bool pageMapIndex(const void *ptr, quintptr *root, quintptr *leaf)
+{
+    const quintptr page = quintptr(ptr) >> ChunkShift;
+    *root = page >> LeafBits;
+    *leaf = page & ((1 << LeafBits) - 1);
+    return *root < (quintptr(1) << RootBits);
+}
+
+inline QArenaChunk *findChunk(const void *ptr)
+{
+    quintptr root, leaf;
+    if (!pageMapIndex(ptr, &root, &leaf))
+        return nullptr;
+    PageMapLeaf *l = pageMap[root].loadAcquire();
+    return l ? l->chunks[leaf].loadAcquire() : nullptr;
+}
+
+bool registerChunk(QArenaChunk *chunk)
+{
+    quintptr root, leaf;
+    if (!pageMapIndex(chunk, &root, &leaf))
+        return false;
+    PageMapLeaf *l = pageMap[root].loadAcquire();
+    if (!l) {
+        QMutexLocker locker(&pageMapMutex);
+        l = pageMap[root].loadAcquire();
+        if (!l) {
+            l = static_cast<PageMapLeaf *>(::calloc(1, sizeof(PageMapLeaf)));
+            if (!l)
+                return false;
+            pageMap[root].storeRelease(l);
+        }
+    }
+    l->chunks[leaf].storeRelease(chunk);
+    return true;
+}
+
+void unregisterChunk(QArenaChunk *chunk)
+{
+    quintptr root, leaf;
+    pageMapIndex(chunk, &root, &leaf);
+    pageMap[root].loadAcquire()->chunks[leaf].storeRelease(nullptr);
+}
+
+void *allocateChunkMemory()
+{
+#if defined(Q_OS_WIN)
+    return ::_aligned_malloc(ChunkSize, ChunkSize);
+#elif defined(Q_OS_UNIX)
+    void *ptr;
+    return ::posix_memalign(&ptr, ChunkSize, ChunkSize) == 0 ? ptr : nullptr;
+#else
+    return qMallocAligned(ChunkSize, ChunkSize);
+#endif
+}
+
+void freeChunkMemory(void *ptr)
+{
+#if defined(Q_OS_WIN)
+    ::_aligned_free(ptr);
+#elif defined(Q_OS_UNIX)
+    ::free(ptr);
+#else
+    qFreeAligned(ptr);
+#endif
+}
+
+thread_local QScopedArena *currentArena = nullptr;
+
+// Chunks released while an arena is active on the thread are kept for
+// reuse; a monotonic arena otherwise keeps touching fresh memory.
+struct ChunkCache
+{
+    enum { MaxChunks = 4 };
+    void *chunks[MaxChunks];
+    int count;
+
+    ChunkCache() : count(0) {}
+    ~ChunkCache()
+    {
+        while (count)
+            freeChunkMemory(chunks[--count]);
+    }
+};
+
+thread_local ChunkCache chunkCache;
+
+} // unnamed namespace
+
+QBasicAtomicInt QScopedArena::activeArenas = Q_BASIC_ATOMIC_INITIALIZER(0);
+QBasicAtomicInt QScopedArena::liveChunks = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static void destroyChunk(QArenaChunk *chunk, QBasicAtomicInt &liveChunks)
+{
+    unregisterChunk(chunk);
+    chunk->~QArenaChunk();
+    liveChunks.deref();
+
+    if (currentArena) {
+        ChunkCache &cache = chunkCache;
+        if (cache.count < ChunkCache::MaxChunks) {
+            cache.chunks[cache.count++] = chunk;
+            return;
+        }
+    }
+    freeChunkMemory(chunk);
+}
+
+/*!
+    Installs a new arena as the current arena of the calling thread.
+*/
+QScopedArena::QScopedArena()
+    : previous(currentArena), chunk(nullptr), pos(nullptr), end(nullptr),
+      last(nullptr), allocations(0), used(0)
+{
+    currentArena = this;
+    activeArenas.ref();
+}
+
+/*!
+    Uninstalls the arena and releases every chunk that holds no live
+    allocations. The arena must be destroyed on the thread that created it.
+*/
+QScopedArena::~QScopedArena()
+{
+    Q_ASSERT(currentArena == this);
+    releaseChunk();
+    currentArena = previous;
+    activeArenas.deref();
+}
+
+/*!
+    Returns the innermost arena of the calling thread, or \c nullptr.
+*/
+QScopedArena *QScopedArena::current()
+{
+    return currentArena;
+}
+
+/*!
+    \fn size_t QScopedArena::bytesUsed() const
+
+    Returns the number of bytes handed out by this arena so far.
+*/
+
+void QScopedArena::releaseChunk()
+{
+    if (!chunk)
+        return;
+    // Drop the owner's bias and account for the allocations made meanwhile.
+    if (chunk->live.fetchAndAddOrdered(allocations - OwnerBias) == OwnerBias - allocations)
+        destroyChunk(chunk, liveChunks);
+    chunk = nullptr;
+    pos = end = last = nullptr;
+    allocations = 0;
+}
+
+bool QScopedArena::nextChunk()
+{
+    releaseChunk();
+
+    ChunkCache &cache = chunkCache;
+    void *memory = cache.count ? cache.chunks[--cache.count] : allocateChunkMemory();
+    if (!memory)
+        return false;
+    QArenaChunk *c = new (memory) QArenaChunk;
+    c->live.store(OwnerBias);
+    liveChunks.ref();
+    if (!registerChunk(c)) {
+        c->~QArenaChunk();
+        freeChunkMemory(c);
+        liveChunks.deref();
+        return false;
+    }
+
+    chunk = c;
+    pos = static_cast<char *>(memory) + ChunkHeaderSize;
+    end = static_cast<char *>(memory) + ChunkSize;
+    return true;
+}
+
+void *QScopedArena::allocateSlow(size_t size)
+{
+    QScopedArena *arena = currentArena;
+    if (!arena || size > MaxAllocation)
+        return nullptr;
+
+    size = (size + Alignment - 1) & ~size_t(Alignment - 1);
+    if (size_t(arena->end - arena->pos) < size && !arena->nextChunk())
+        return nullptr;
+
+    char *ptr = arena->pos;
+    arena->pos += size;
+    arena->last = ptr;
+    ++arena->allocations;
+    arena->used += size;
+    return ptr;
+}
+
+bool QScopedArena::freeSlow(void *ptr)
+{
+    QArenaChunk *c = findChunk(ptr);
+    if (!c)
+        return false;
+
+    QScopedArena *arena = currentArena;
+    if (arena && arena->last == ptr) {
+        // Undo the most recent allocation, so that build-then-discard
+        // patterns keep reusing the same memory.
+        arena->pos = arena->last;
+        arena->last = nullptr;
+        --arena->allocations;
+        return true;
+    }
+
+    if (!c->live.deref())
+        destroyChunk(c, liveChunks);
+    return true;
+}
+
+bool QScopedArena::reallocateSlow(void **ptr, size_t oldSize, size_t newSize)
+{
+    char *old = static_cast<char *>(*ptr);
+    if (!findChunk(old))
+        return false;
+
+    QScopedArena *arena = currentArena;
+    if (arena && arena->last == old) {
+        const size_t size = (newSize + Alignment - 1) & ~size_t(Alignment - 1);
+        if (size <= size_t(arena->end - old)) {
+            arena->used += size - (arena->pos - old);
+            arena->pos = old + size;
+            return true;
+        }
+    }
+
+    void *p = tryAllocate(newSize);
+    if (!p)
+        p = ::malloc(newSize);
+    if (p) {
+        ::memcpy(p, old, qMin(oldSize, newSize));
+        freeSlow(old);
+    }
+    *ptr = p;
+    return true;
+}
+
+#else // !QT_HAS_SCOPED_ARENA
+
+QScopedArena::QScopedArena()
+    : previous(nullptr), chunk(nullptr), pos(nullptr), end(nullptr),
+      last(nullptr), allocations(0), used(0)
+{
+}
+
+QScopedArena::~QScopedArena()
+{
+}
+
+QScopedArena *QScopedArena::current()
+{
+    return nullptr;
+}
+
+#endif // QT_HAS_SCOPED_ARENA
+
+QT_END_NAMESPACE
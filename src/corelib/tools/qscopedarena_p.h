@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSCOPEDARENA_P_H
+#define QSCOPEDARENA_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+
+QT_BEGIN_NAMESPACE
+
+#if defined(Q_COMPILER_THREAD_LOCAL) && !defined(QT_BOOTSTRAPPED)
+#  define QT_HAS_SCOPED_ARENA
+#endif
+
+struct QArenaChunk;
+
+class Q_CORE_EXPORT QScopedArena
+{
+public:
+    QScopedArena();
+    ~QScopedArena();
+
+    static QScopedArena *current();
+    size_t bytesUsed() const { return used; }
+
+    // Hooks for the containers. tryAllocate() returns null if there is no
+    // arena on this thread; tryFree() and tryReallocate() return false if
+    // ptr was not allocated from an arena.
+    static inline void *tryAllocate(size_t size)
+    {
+#ifdef QT_HAS_SCOPED_ARENA
+        if (Q_UNLIKELY(activeArenas.load()))
+            return allocateSlow(size);
+#else
+        Q_UNUSED(size);
+#endif
+        return nullptr;
+    }
+
+    static inline bool tryFree(void *ptr)
+    {
+#ifdef QT_HAS_SCOPED_ARENA
+        if (Q_UNLIKELY(liveChunks.load()))
+            return freeSlow(ptr);
+#else
+        Q_UNUSED(ptr);
+#endif
+        return false;
+    }
+
+    static inline bool tryReallocate(void **ptr, size_t oldSize, size_t newSize)
+    {
+#ifdef QT_HAS_SCOPED_ARENA
+        if (Q_UNLIKELY(liveChunks.load()))
+            return reallocateSlow(ptr, oldSize, newSize);
+#else
+        Q_UNUSED(ptr); Q_UNUSED(oldSize); Q_UNUSED(newSize);
+#endif
+        return false;
+    }
+
+private:
+    Q_DISABLE_COPY(QScopedArena)
+
+    static void *allocateSlow(size_t size);
+    static bool freeSlow(void *ptr);
+    static bool reallocateSlow(void **ptr, size_t oldSize, size_t newSize);
+    bool nextChunk();
+    void releaseChunk();
+
+    static QBasicAtomicInt activeArenas;
+    static QBasicAtomicInt liveChunks;
+
+    QScopedArena *previous;
+    QArenaChunk *chunk;
+    char *pos;
+    char *end;
+    char *last;
+    int allocations;
+    size_t used;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSCOPEDARENA_P_H
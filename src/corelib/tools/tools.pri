@@ -23,6 +23,7 @@ HEADERS +=  \
         tools/qdatetime_p.h \
         tools/qdoublescanprint_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash_p.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qhashfunctions.h \
@@ -40,11 +41,13 @@ HEADERS +=  \
         tools/qcontiguouscache.h \
         tools/qpair.h \
         tools/qpoint.h \
+        tools/qpowersoffive_p.h \
         tools/qqueue.h \
         tools/qrect.h \
         tools/qregexp.h \
         tools/qringbuffer_p.h \
         tools/qrefcount.h \
+        tools/qscopedarena_p.h \
         tools/qscopedpointer.h \
         tools/qscopedpointer_p.h \
         tools/qscopedvaluerollback.h \
@@ -100,6 +103,7 @@ SOURCES += \
         tools/qregexp.cpp \
         tools/qrefcount.cpp \
         tools/qringbuffer.cpp \
+        tools/qscopedarena.cpp \
         tools/qshareddata.cpp \
         tools/qsharedpointer.cpp \
         tools/qsimd.cpp \
@@ -35,6 +35,7 @@ HEADERS += \
     access/qhttpmultipart.h \
     access/qhttpmultipart_p.h \
     access/qnetworkfile_p.h \
+    access/qhttp2configuration.h \
     access/qhttp2protocolhandler_p.h \
     access/qhsts_p.h \
     access/qhstspolicy.h \
@@ -68,6 +69,7 @@ SOURCES += \
     access/qhttpthreaddelegate.cpp \
     access/qhttpmultipart.cpp \
     access/qnetworkfile.cpp \
+    access/qhttp2configuration.cpp \
     access/qhttp2protocolhandler.cpp \
     access/qhsts.cpp \
     access/qhstspolicy.cpp \
@@ -305,7 +305,7 @@ FrameStatus FrameReader::read(QAbstractSocket &socket)
             return status;
         }
 
-        if (Http2PredefinedParameters::maxFrameSize < frame.payloadSize())
+        if (maxFrameSize < frame.payloadSize())
             return FrameStatus::sizeError;
 
         frame.buffer.resize(frame.payloadSize() + frameHeaderSize);
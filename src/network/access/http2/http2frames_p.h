@@ -107,11 +107,18 @@ public:
     {
         return frame;
     }
+
+    // The largest payload we advertised in SETTINGS_MAX_FRAME_SIZE:
+    void setMaxFrameSize(quint32 size)
+    {
+        maxFrameSize = size;
+    }
 private:
     bool readHeader(QAbstractSocket &socket);
     bool readPayload(QAbstractSocket &socket);
 
     quint32 offset = 0;
+    quint32 maxFrameSize = Http2PredefinedParameters::maxFrameSize;
     Frame frame;
 };
 
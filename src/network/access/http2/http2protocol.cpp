@@ -43,6 +43,10 @@
 #include "private/qhttpnetworkrequest_p.h"
 #include "private/qhttpnetworkreply_p.h"
 
+#include "hpacktable_p.h"
+
+#include <QtNetwork/qhttp2configuration.h>
+
 #include <QtCore/qbytearray.h>
 #include <QtCore/qstring.h>
 
@@ -62,9 +66,9 @@ const char Http2clientPreface[clientPrefaceLength] =
      0x2e, 0x30, 0x0d, 0x0a, 0x0d, 0x0a,
      0x53, 0x4d, 0x0d, 0x0a, 0x0d, 0x0a};
 
-QByteArray default_SETTINGS_to_Base64()
+static QByteArray SETTINGS_to_Base64(const QHttp2Configuration &configuration)
 {
-    Frame frame(default_SETTINGS_frame());
+    Frame frame(configuration_to_SETTINGS_frame(configuration));
     // SETTINGS frame's payload consists of pairs:
     // 2-byte-identifier | 4-byte-value == multiple of 6.
     Q_ASSERT(frame.payloadSize() && !(frame.payloadSize() % 6));
@@ -78,7 +82,8 @@ QByteArray default_SETTINGS_to_Base64()
     return wrapper.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
 }
 
-void prepare_for_protocol_upgrade(QHttpNetworkRequest &request)
+void prepare_for_protocol_upgrade(QHttpNetworkRequest &request,
+                                  const QHttp2Configuration &configuration)
 {
     // RFC 2616, 14.10
     // RFC 7540, 3.2
@@ -92,7 +97,7 @@ void prepare_for_protocol_upgrade(QHttpNetworkRequest &request)
     // This we just (re)write.
     request.setHeaderField("Upgrade", "h2c");
     // This we just (re)write.
-    request.setHeaderField("HTTP2-Settings", default_SETTINGS_to_Base64());
+    request.setHeaderField("HTTP2-Settings", SETTINGS_to_Base64(configuration));
 }
 
 void qt_error(quint32 errorCode, QNetworkReply::NetworkError &error,
@@ -209,17 +214,22 @@ bool is_protocol_upgraded(const QHttpNetworkReply &reply)
     return false;
 }
 
-Frame default_SETTINGS_frame()
+Frame configuration_to_SETTINGS_frame(const QHttp2Configuration &config)
 {
     // 6.5 SETTINGS
     FrameWriter builder(FrameType::SETTINGS, FrameFlag::EMPTY, connectionStreamID);
-    // MAX frame size (16 kb), disable/enable PUSH_PROMISE
+    // MAX frame size (16 kb by default), disable/enable PUSH_PROMISE
     builder.append(Settings::MAX_FRAME_SIZE_ID);
-    builder.append(quint32(maxFrameSize));
+    builder.append(quint32(config.maxFrameSize()));
     builder.append(Settings::INITIAL_WINDOW_SIZE_ID);
-    builder.append(initialStreamReceiveWindowSize);
+    builder.append(quint32(config.streamReceiveWindowSize()));
     builder.append(Settings::ENABLE_PUSH_ID);
     builder.append(quint32(is_PUSH_PROMISE_enabled()));
+    // Only mention the table size if it differs from the protocol's default:
+    if (config.headerTableSize() != HPack::FieldLookupTable::DefaultSize) {
+        builder.append(Settings::HEADER_TABLE_SIZE_ID);
+        builder.append(quint32(config.headerTableSize()));
+    }
 
     return builder.outboundFrame();
 }
@@ -60,6 +60,7 @@
 QT_BEGIN_NAMESPACE
 
 class QHttpNetworkRequest;
+class QHttp2Configuration;
 class QHttpNetworkReply;
 class QString;
 
@@ -132,6 +133,10 @@ enum Http2PredefinedParameters
 // These are ints, const, they have internal linkage, it's ok to have them in
 // headers - no ODR violation.
 const quint32 lastValidStreamID((quint32(1) << 31) - 1); // HTTP/2, 5.1.1
+const quint32 maxSessionReceiveWindowSize((quint32(1) << 31) - 1); // HTTP/2, 6.9.1
+// The largest header table we let the peer's encoder and our decoder use,
+// 16 times the default size of 4096 (HPACK, 4.2):
+const quint32 maxAcceptableTableSize(16 * 4096);
 
 // The default size of 64K is too small and limiting: if we use it, we end up
 // sending WINDOW_UPDATE frames on a stream/session all the time, for each
@@ -144,7 +149,8 @@ const qint32 initialSessionReceiveWindowSize = defaultSessionWindowSize * 10000;
 const qint32 initialStreamReceiveWindowSize = initialSessionReceiveWindowSize / maxConcurrentStreams;
 
 extern const Q_AUTOTEST_EXPORT char Http2clientPreface[clientPrefaceLength];
-void prepare_for_protocol_upgrade(QHttpNetworkRequest &request);
+void prepare_for_protocol_upgrade(QHttpNetworkRequest &request,
+                                  const QHttp2Configuration &configuration);
 
 enum class FrameStatus
 {
@@ -184,7 +190,7 @@ QString qt_error_string(quint32 errorCode);
 QNetworkReply::NetworkError qt_error(quint32 errorCode);
 bool is_PUSH_PROMISE_enabled();
 bool is_protocol_upgraded(const QHttpNetworkReply &reply);
-struct Frame default_SETTINGS_frame();
+struct Frame configuration_to_SETTINGS_frame(const QHttp2Configuration &configuration);
 
 }
 
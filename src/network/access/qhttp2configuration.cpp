@@ -0,0 +1,304 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qhttp2configuration.h"
+
+#include "http2/http2protocol_p.h"
+#include "http2/hpacktable_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QHttp2Configuration
+    \brief The QHttp2Configuration class controls HTTP/2 parameters and settings.
+    \since 5.10
+    \ingroup network
+    \inmodule QtNetwork
+
+    QHttp2Configuration controls HTTP/2 parameters and settings that
+    QNetworkAccessManager will use to send requests and process responses
+    when the HTTP/2 protocol is enabled.
+
+    The HTTP/2 parameters that QHttp2Configuration currently supports include:
+
+    \list
+      \li The session window size for connection-level flow control.
+      \li The stream window size for stream-level flow control.
+      \li The maximum frame size the peer is allowed to send.
+      \li The size of the header compression table the peer is allowed to use.
+      \li Whether the window sizes are grown automatically, based on the
+          measured bandwidth-delay product of the connection.
+    \endlist
+
+    The defaults are chosen to give good throughput on typical links. On
+    links with a large bandwidth-delay product, a single stream can be
+    limited by its receive window; either raise the stream window or enable
+    window auto-tuning.
+
+    \note The configuration is applied when a connection is opened; requests
+    that reuse an existing connection share the settings of the request that
+    opened it.
+
+    \sa QNetworkRequest::setHttp2Configuration(), QNetworkRequest::http2Configuration()
+*/
+
+class QHttp2ConfigurationPrivate : public QSharedData
+{
+public:
+    unsigned sessionWindowSize = Http2::initialSessionReceiveWindowSize;
+    // The size of our stream window is normally a fraction of the session
+    // window, so that all concurrent streams together cannot exhaust it:
+    unsigned streamWindowSize = Http2::initialStreamReceiveWindowSize;
+    unsigned maxFrameSize = Http2::maxFrameSize;
+    unsigned headerTableSize = HPack::FieldLookupTable::DefaultSize;
+    bool windowAutoTuning = false;
+
+    bool operator == (const QHttp2ConfigurationPrivate &other) const
+    {
+        return sessionWindowSize == other.sessionWindowSize
+               && streamWindowSize == other.streamWindowSize
+               && maxFrameSize == other.maxFrameSize
+               && headerTableSize == other.headerTableSize
+               && windowAutoTuning == other.windowAutoTuning;
+    }
+};
+
+/*!
+    Returns \c true if \a lhs and \a rhs have the same set of HTTP/2
+    parameters.
+*/
+bool operator==(const QHttp2Configuration &lhs, const QHttp2Configuration &rhs)
+{
+    if (lhs.d == rhs.d)
+        return true;
+    return *lhs.d == *rhs.d;
+}
+
+/*!
+    Default constructs a QHttp2Configuration object.
+
+    The session window is 655350000 bytes, the stream window 6553500 bytes,
+    the maximum frame size 16384 bytes (the HTTP/2 default) and the header
+    table size 4096 bytes (the HTTP/2 default). Window auto-tuning is
+    disabled.
+*/
+QHttp2Configuration::QHttp2Configuration()
+    : d(new QHttp2ConfigurationPrivate)
+{
+}
+
+/*!
+    Copy-constructs this QHttp2Configuration from \a other.
+*/
+QHttp2Configuration::QHttp2Configuration(const QHttp2Configuration &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Destructor.
+*/
+QHttp2Configuration::~QHttp2Configuration()
+{
+}
+
+/*!
+    Copy-assigns \a other to this QHttp2Configuration.
+*/
+QHttp2Configuration &QHttp2Configuration::operator=(const QHttp2Configuration &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn QHttp2Configuration &QHttp2Configuration::operator=(QHttp2Configuration &&other)
+
+    Move-assigns \a other to this QHttp2Configuration.
+*/
+
+/*!
+    \fn void QHttp2Configuration::swap(QHttp2Configuration &other)
+
+    Swaps this configuration with the \a other configuration.
+*/
+
+/*!
+    Sets the window size for connection-level flow control to \a size.
+    Returns \c true if \a size is a valid HTTP/2 window size, \c false
+    otherwise, in which case the configuration is left unchanged.
+
+    \sa sessionReceiveWindowSize()
+*/
+bool QHttp2Configuration::setSessionReceiveWindowSize(unsigned size)
+{
+    if (!size || size > Http2::maxSessionReceiveWindowSize) {
+        qCWarning(QT_HTTP2) << "Invalid session window size" << size;
+        return false;
+    }
+
+    d->sessionWindowSize = size;
+    return true;
+}
+
+/*!
+    Returns the window size for connection-level flow control.
+
+    \sa setSessionReceiveWindowSize()
+*/
+unsigned QHttp2Configuration::sessionReceiveWindowSize() const
+{
+    return d->sessionWindowSize;
+}
+
+/*!
+    Sets the window size for stream-level flow control to \a size. This is
+    the amount of data the peer may send on a single stream before it has
+    to wait for a WINDOW_UPDATE. Returns \c true if \a size is a valid
+    HTTP/2 window size, \c false otherwise, in which case the configuration
+    is left unchanged.
+
+    \sa streamReceiveWindowSize()
+*/
+bool QHttp2Configuration::setStreamReceiveWindowSize(unsigned size)
+{
+    if (!size || size > Http2::maxSessionReceiveWindowSize) {
+        qCWarning(QT_HTTP2) << "Invalid stream window size" << size;
+        return false;
+    }
+
+    d->streamWindowSize = size;
+    return true;
+}
+
+/*!
+    Returns the window size for stream-level flow control.
+
+    \sa setStreamReceiveWindowSize()
+*/
+unsigned QHttp2Configuration::streamReceiveWindowSize() const
+{
+    return d->streamWindowSize;
+}
+
+/*!
+    Sets the maximum frame size that QNetworkAccessManager will advertise
+    to the peer to \a size. The size must be between 16384 and 16777215
+    bytes, as required by RFC 7540. Returns \c true on success, \c false
+    otherwise, in which case the configuration is left unchanged.
+
+    \sa maxFrameSize()
+*/
+bool QHttp2Configuration::setMaxFrameSize(unsigned size)
+{
+    if (size < Http2::maxFrameSize || size > Http2::maxPayloadSize) {
+        qCWarning(QT_HTTP2) << "Maximum frame size to advertise is invalid" << size;
+        return false;
+    }
+
+    d->maxFrameSize = size;
+    return true;
+}
+
+/*!
+    Returns the maximum frame size that QNetworkAccessManager will advertise
+    to the peer.
+
+    \sa setMaxFrameSize()
+*/
+unsigned QHttp2Configuration::maxFrameSize() const
+{
+    return d->maxFrameSize;
+}
+
+/*!
+    Sets the maximum size of the header compression table that the peer's
+    encoder may use to \a size bytes. A larger table improves compression
+    of repeated headers, at the cost of memory per connection. Returns
+    \c true if \a size is no larger than 65536 bytes, \c false otherwise,
+    in which case the configuration is left unchanged.
+
+    \sa headerTableSize()
+*/
+bool QHttp2Configuration::setHeaderTableSize(unsigned size)
+{
+    if (size > Http2::maxAcceptableTableSize) {
+        qCWarning(QT_HTTP2) << "Header table size to advertise is invalid" << size;
+        return false;
+    }
+
+    d->headerTableSize = size;
+    return true;
+}
+
+/*!
+    Returns the maximum size of the header compression table advertised to
+    the peer.
+
+    \sa setHeaderTableSize()
+*/
+unsigned QHttp2Configuration::headerTableSize() const
+{
+    return d->headerTableSize;
+}
+
+/*!
+    If \a enable is \c true, the receive windows start at the configured
+    sizes and are grown while a connection is in use, whenever the measured
+    bandwidth-delay product shows that the window is what limits the
+    transfer rate. The measurement uses PING frames, one at a time.
+
+    \sa windowAutoTuningEnabled()
+*/
+void QHttp2Configuration::setWindowAutoTuningEnabled(bool enable)
+{
+    d->windowAutoTuning = enable;
+}
+
+/*!
+    Returns \c true if the receive windows are tuned automatically.
+
+    \sa setWindowAutoTuningEnabled()
+*/
+bool QHttp2Configuration::windowAutoTuningEnabled() const
+{
+    return d->windowAutoTuning;
+}
+
+QT_END_NAMESPACE
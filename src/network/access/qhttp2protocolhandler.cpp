@@ -58,6 +58,7 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 
 QT_BEGIN_NAMESPACE
@@ -161,17 +162,30 @@ bool sum_will_overflow(qint32 windowSize, qint32 delta)
 using namespace Http2;
 
 const std::deque<quint32>::size_type QHttp2ProtocolHandler::maxRecycledStreams = 10000;
-const quint32 QHttp2ProtocolHandler::maxAcceptableTableSize;
+const uchar QHttp2ProtocolHandler::bdpPingPayload[8] = {'q', 't', '-', 'b', 'd', 'p', 0, 0};
 
 QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *channel)
     : QAbstractProtocolHandler(channel),
-      decoder(HPack::FieldLookupTable::DefaultSize),
+      // Until our SETTINGS are ACKed the peer may still use the default
+      // table size, so never go below it:
+      decoder(std::max<quint32>(m_connection->http2Parameters().headerTableSize(),
+                                HPack::FieldLookupTable::DefaultSize)),
       encoder(HPack::FieldLookupTable::DefaultSize, true)
 {
     Q_ASSERT(channel);
     continuedFrames.reserve(20);
     pushPromiseEnabled = is_PUSH_PROMISE_enabled();
 
+    const QHttp2Configuration config = m_connection->http2Parameters();
+    frameReader.setMaxFrameSize(config.maxFrameSize());
+    // The session window can only grow from its default size:
+    maxSessionReceiveWindowSize = std::max<qint32>(config.sessionReceiveWindowSize(),
+                                                   Http2::defaultSessionWindowSize);
+    sessionRecvWindowSize = maxSessionReceiveWindowSize;
+    streamInitialReceiveWindowSize = config.streamReceiveWindowSize();
+    maxStreamReceiveWindowSize = streamInitialReceiveWindowSize;
+    windowAutoTuning = config.windowAutoTuningEnabled();
+
     if (!channel->ssl) {
         // We upgraded from HTTP/1.1 to HTTP/2. channel->request was already sent
         // as HTTP/1.1 request. The response with status code 101 triggered
@@ -316,7 +330,11 @@ bool QHttp2ProtocolHandler::sendRequest()
         initReplyFromPushPromise(message, key);
     }
 
-    const auto streamsToUse = std::min<quint32>(maxConcurrentStreams - activeStreams.size(),
+    quint32 streamLimit = maxConcurrentStreams;
+    if (const quint32 localLimit = m_connection->maxConcurrentStreams())
+        streamLimit = std::min(streamLimit, localLimit);
+    const quint32 nActive = quint32(activeStreams.size());
+    const auto streamsToUse = std::min<quint32>(nActive < streamLimit ? streamLimit - nActive : 0,
                                                 requests.size());
     auto it = requests.begin();
     for (quint32 i = 0; i < streamsToUse; ++i) {
@@ -366,15 +384,15 @@ bool QHttp2ProtocolHandler::sendClientPreface()
         return false;
 
     // 6.5 SETTINGS
-    frameWriter.setOutboundFrame(default_SETTINGS_frame());
+    frameWriter.setOutboundFrame(configuration_to_SETTINGS_frame(m_connection->http2Parameters()));
     Q_ASSERT(frameWriter.outboundFrame().payloadSize());
 
     if (!frameWriter.write(*m_socket))
         return false;
 
-    sessionRecvWindowSize = Http2::initialSessionReceiveWindowSize;
-    const auto delta = Http2::initialSessionReceiveWindowSize - Http2::defaultSessionWindowSize;
-    if (!sendWINDOW_UPDATE(Http2::connectionStreamID, delta))
+    sessionRecvWindowSize = maxSessionReceiveWindowSize;
+    const auto delta = maxSessionReceiveWindowSize - Http2::defaultSessionWindowSize;
+    if (delta && !sendWINDOW_UPDATE(Http2::connectionStreamID, delta))
         return false;
 
     prefaceSent = true;
@@ -528,6 +546,12 @@ void QHttp2ProtocolHandler::handleDATA()
 
     sessionRecvWindowSize -= inboundFrame.payloadSize();
 
+    if (windowAutoTuning) {
+        bdpBytesReceived += inboundFrame.payloadSize();
+        if (!bdpPingInFlight)
+            startBdpMeasurement();
+    }
+
     if (activeStreams.contains(streamID)) {
         auto &stream = activeStreams[streamID];
 
@@ -545,20 +569,20 @@ void QHttp2ProtocolHandler::handleDATA()
             if (inboundFrame.flags().testFlag(FrameFlag::END_STREAM)) {
                 finishStream(stream);
                 deleteActiveStream(stream.streamID);
-            } else if (stream.recvWindow < Http2::initialStreamReceiveWindowSize / 2) {
+            } else if (stream.recvWindow < maxStreamReceiveWindowSize / 2) {
                 QMetaObject::invokeMethod(this, "sendWINDOW_UPDATE", Qt::QueuedConnection,
                                           Q_ARG(quint32, stream.streamID),
-                                          Q_ARG(quint32, Http2::initialStreamReceiveWindowSize - stream.recvWindow));
-                stream.recvWindow = Http2::initialStreamReceiveWindowSize;
+                                          Q_ARG(quint32, maxStreamReceiveWindowSize - stream.recvWindow));
+                stream.recvWindow = maxStreamReceiveWindowSize;
             }
         }
     }
 
-    if (sessionRecvWindowSize < Http2::initialSessionReceiveWindowSize / 2) {
+    if (sessionRecvWindowSize < maxSessionReceiveWindowSize / 2) {
         QMetaObject::invokeMethod(this, "sendWINDOW_UPDATE", Qt::QueuedConnection,
                                   Q_ARG(quint32, connectionStreamID),
-                                  Q_ARG(quint32, Http2::initialSessionReceiveWindowSize - sessionRecvWindowSize));
-        sessionRecvWindowSize = Http2::initialSessionReceiveWindowSize;
+                                  Q_ARG(quint32, maxSessionReceiveWindowSize - sessionRecvWindowSize));
+        sessionRecvWindowSize = maxSessionReceiveWindowSize;
     }
 }
 
@@ -747,16 +771,61 @@ void QHttp2ProtocolHandler::handlePING()
     if (inboundFrame.streamID() != connectionStreamID)
         return connectionError(PROTOCOL_ERROR, "PING on invalid stream");
 
-    if (inboundFrame.flags() & FrameFlag::ACK)
-        return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
-
     Q_ASSERT(inboundFrame.dataSize() == 8);
 
+    if (inboundFrame.flags() & FrameFlag::ACK) {
+        if (!bdpPingInFlight || std::memcmp(inboundFrame.dataBegin(), bdpPingPayload, 8))
+            return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
+        return finishBdpMeasurement();
+    }
+
     frameWriter.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
     frameWriter.append(inboundFrame.dataBegin(), inboundFrame.dataBegin() + 8);
     frameWriter.write(*m_socket);
 }
 
+void QHttp2ProtocolHandler::startBdpMeasurement()
+{
+    Q_ASSERT(m_socket);
+    Q_ASSERT(!bdpPingInFlight);
+
+    frameWriter.start(FrameType::PING, FrameFlag::EMPTY, connectionStreamID);
+    frameWriter.append(bdpPingPayload, bdpPingPayload + 8);
+    if (!frameWriter.write(*m_socket))
+        return;
+
+    bdpPingInFlight = true;
+    bdpTimer.start();
+}
+
+void QHttp2ProtocolHandler::finishBdpMeasurement()
+{
+    Q_ASSERT(bdpPingInFlight);
+
+    bdpPingInFlight = false;
+    const qint64 sample = bdpBytesReceived;
+    bdpBytesReceived = 0;
+    const qint64 rtt = std::max<qint64>(bdpTimer.elapsed(), 1);
+    const qint64 bandwidth = sample * 1000 / rtt;
+
+    // Only grow if the window is the bottleneck: we received close to a
+    // full window in one round-trip and the throughput is still improving.
+    if (bandwidth < maxBandwidth || sample * 3 < qint64(maxStreamReceiveWindowSize) * 2)
+        return;
+
+    maxBandwidth = bandwidth;
+    const qint64 newWindowSize = std::min<qint64>(sample * 2, Http2::maxSessionReceiveWindowSize);
+    if (newWindowSize <= maxStreamReceiveWindowSize)
+        return;
+
+    qCDebug(QT_HTTP2) << "growing stream receive window to" << newWindowSize
+                      << "bytes, rtt:" << rtt << "ms";
+    maxStreamReceiveWindowSize = qint32(newWindowSize);
+    // The new windows are announced by the next WINDOW_UPDATE frames.
+    if (maxSessionReceiveWindowSize < maxStreamReceiveWindowSize)
+        maxSessionReceiveWindowSize = maxStreamReceiveWindowSize;
+}
+
 void QHttp2ProtocolHandler::handleGOAWAY()
 {
     // 6.8 GOAWAY
@@ -1199,7 +1268,7 @@ quint32 QHttp2ProtocolHandler::createNewStream(const HttpMessagePair &message, b
 
     const Stream newStream(message, newStreamID,
                            streamInitialSendWindowSize,
-                           Http2::initialStreamReceiveWindowSize);
+                           streamInitialReceiveWindowSize);
 
     if (!uploadDone) {
         if (auto src = newStream.data()) {
@@ -1395,7 +1464,7 @@ bool QHttp2ProtocolHandler::tryReserveStream(const Http2::Frame &pushPromiseFram
     promise.pushHeader = requestHeader;
 
     activeStreams.insert(reservedID, Stream(urlKey, reservedID,
-                                            Http2::initialStreamReceiveWindowSize));
+                                            streamInitialReceiveWindowSize));
     return true;
 }
 
@@ -1429,7 +1498,7 @@ void QHttp2ProtocolHandler::initReplyFromPushPromise(const HttpMessagePair &mess
         // Let's pretent we're sending a request now:
         Stream closedStream(message, promise.reservedID,
                             streamInitialSendWindowSize,
-                            Http2::initialStreamReceiveWindowSize);
+                            streamInitialReceiveWindowSize);
         closedStream.state = Stream::halfClosedLocal;
         activeStreams.insert(promise.reservedID, closedStream);
         promisedStream = &activeStreams[promise.reservedID];
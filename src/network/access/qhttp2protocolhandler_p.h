@@ -64,6 +64,7 @@
 #include "http2/hpack_p.h"
 
 #include <QtCore/qnamespace.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qbytearray.h>
 #include <QtCore/qglobal.h>
 #include <QtCore/qobject.h>
@@ -122,6 +123,9 @@ private:
 
     void handleContinuedHEADERS();
 
+    void startBdpMeasurement();
+    void finishBdpMeasurement();
+
     bool acceptSetting(Http2::Settings identifier, quint32 newValue);
 
     void updateStream(Stream &stream, const HPack::HttpHeader &headers,
@@ -150,7 +154,6 @@ private:
     // the client's preface 24-byte message.
     bool waitingForSettingsACK = false;
 
-    static const quint32 maxAcceptableTableSize = 16 * HPack::FieldLookupTable::DefaultSize;
     // HTTP/2 4.3: Header compression is stateful. One compression context and
     // one decompression context are used for the entire connection.
     HPack::Decoder decoder;
@@ -179,6 +182,21 @@ private:
 
     // Signed integer, it can become negative (it's still a valid window size):
     qint32 sessionRecvWindowSize = Http2::initialSessionReceiveWindowSize;
+    // Our receive windows, from QHttp2Configuration. The initial stream
+    // window is what we advertise in SETTINGS, the maximum ones are what we
+    // replenish the windows to and can grow with auto-tuning:
+    qint32 maxSessionReceiveWindowSize = Http2::initialSessionReceiveWindowSize;
+    qint32 streamInitialReceiveWindowSize = Http2::initialStreamReceiveWindowSize;
+    qint32 maxStreamReceiveWindowSize = Http2::initialStreamReceiveWindowSize;
+
+    // Window auto-tuning: we estimate the bandwidth-delay product by
+    // counting the bytes received during one PING round-trip.
+    bool windowAutoTuning = false;
+    static const uchar bdpPingPayload[8];
+    bool bdpPingInFlight = false;
+    qint64 bdpBytesReceived = 0;
+    qint64 maxBandwidth = 0; // bytes per second
+    QElapsedTimer bdpTimer;
 
     // Updated by SETTINGS and WINDOW_UPDATE.
     qint32 sessionSendWindowSize = Http2::defaultSessionWindowSize;
@@ -424,6 +424,16 @@ void QHttpNetworkConnectionPrivate::copyCredentials(int fromChannel, QAuthentica
     }
 }
 
+void QHttpNetworkConnectionPrivate::resetCredentials()
+{
+    for (int i = 0; i < channelCount; ++i) {
+        channels[i].authenticator = QAuthenticator();
+        channels[i].authMethod = QAuthenticatorPrivate::None;
+        channels[i].proxyAuthenticator = QAuthenticator();
+        channels[i].proxyAuthMethod = QAuthenticatorPrivate::None;
+    }
+}
+
 
 // handles the authentication for one channel and eventually re-starts the other channels
 bool QHttpNetworkConnectionPrivate::handleAuthenticateChallenge(QAbstractSocket *socket, QHttpNetworkReply *reply,
@@ -1437,6 +1447,30 @@ void QHttpNetworkConnection::setConnectionType(ConnectionType type)
     d->connectionType = type;
 }
 
+quint32 QHttpNetworkConnection::maxConcurrentStreams() const
+{
+    Q_D(const QHttpNetworkConnection);
+    return d->maxConcurrentStreams;
+}
+
+void QHttpNetworkConnection::setMaxConcurrentStreams(quint32 max)
+{
+    Q_D(QHttpNetworkConnection);
+    d->maxConcurrentStreams = max;
+}
+
+QHttp2Configuration QHttpNetworkConnection::http2Parameters() const
+{
+    Q_D(const QHttpNetworkConnection);
+    return d->http2Parameters;
+}
+
+void QHttpNetworkConnection::setHttp2Parameters(const QHttp2Configuration &params)
+{
+    Q_D(QHttpNetworkConnection);
+    d->http2Parameters = params;
+}
+
 // SSL support below
 #ifndef QT_NO_SSL
 void QHttpNetworkConnection::setSslConfiguration(const QSslConfiguration &config)
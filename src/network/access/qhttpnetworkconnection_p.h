@@ -53,6 +53,7 @@
 
 #include <QtNetwork/private/qtnetworkglobal_p.h>
 #include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qhttp2configuration.h>
 #include <QtNetwork/qnetworkreply.h>
 #include <QtNetwork/qabstractsocket.h>
 #include <QtNetwork/qnetworksession.h>
@@ -139,6 +140,13 @@ public:
     ConnectionType connectionType();
     void setConnectionType(ConnectionType type);
 
+    // local cap on concurrent HTTP/2 streams, 0 means only the peer's limit applies
+    quint32 maxConcurrentStreams() const;
+    void setMaxConcurrentStreams(quint32 max);
+
+    QHttp2Configuration http2Parameters() const;
+    void setHttp2Parameters(const QHttp2Configuration &params);
+
 #ifndef QT_NO_SSL
     void setSslConfiguration(const QSslConfiguration &config);
     void ignoreSslErrors(int channel = -1);
@@ -222,6 +230,7 @@ public:
     void readMoreLater(QHttpNetworkReply *reply);
 
     void copyCredentials(int fromChannel, QAuthenticator *auth, bool isProxy);
+    void resetCredentials();
 
     void startHostInfoLookup();
     void startNetworkLayerStateLookup();
@@ -273,6 +282,8 @@ public:
     int preConnectRequests;
 
     QHttpNetworkConnection::ConnectionType connectionType;
+    quint32 maxConcurrentStreams = 0;
+    QHttp2Configuration http2Parameters;
 
 #ifndef QT_NO_SSL
     QSharedPointer<QSslContext> sslContext;
@@ -901,7 +901,7 @@ void QHttpNetworkConnectionChannel::_q_connected()
             if (tryProtocolUpgrade) {
                 // Let's augment our request with some magic headers and try to
                 // switch to HTTP/2.
-                Http2::prepare_for_protocol_upgrade(request);
+                Http2::prepare_for_protocol_upgrade(request, connection->http2Parameters());
             }
             sendRequest();
         }
@@ -45,6 +45,11 @@
 #include <QAuthenticator>
 #include <QEventLoop>
 #include <QCryptographicHash>
+#ifndef QT_NO_SSL
+#include <QSslCertificate>
+#include <QSslCipher>
+#include <QSslKey>
+#endif
 
 #include "private/qhttpnetworkreply_p.h"
 #include "private/qnetworkaccesscache_p.h"
@@ -125,6 +130,54 @@ static QNetworkReply::NetworkError statusCodeFromHttp(int httpStatusCode, const
 }
 
 
+#ifndef QT_NO_SSL
+// Connections may only be reused by requests that would have negotiated
+// the same TLS session, so fold everything that influences the handshake
+// and the trust decision into the key.
+static QByteArray sslConfigurationKey(const QSslConfiguration &config)
+{
+    QByteArray key = QByteArray::number(int(config.protocol())) + ':'
+            + QByteArray::number(int(config.peerVerifyMode())) + ':'
+            + QByteArray::number(config.peerVerifyDepth()) + ':';
+    const QList<QByteArray> protocols = config.allowedNextProtocols();
+    for (const QByteArray &protocol : protocols)
+        key += protocol + ',';
+
+    // Certificates, keys and ciphers are expensive to hash. Most requests
+    // keep those of the default configuration, whose lists they share and
+    // which therefore compare cheaply, so only hash them otherwise.
+    const QSslConfiguration defaultConfiguration = QSslConfiguration::defaultConfiguration();
+    if (config.localCertificate() == defaultConfiguration.localCertificate()
+            && config.privateKey() == defaultConfiguration.privateKey()
+            && config.caCertificates() == defaultConfiguration.caCertificates()
+            && config.ciphers() == defaultConfiguration.ciphers()) {
+        return key;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(config.localCertificate().digest(QCryptographicHash::Sha1));
+    hash.addData(config.privateKey().toDer());
+    const QList<QSslCertificate> caCertificates = config.caCertificates();
+    for (const QSslCertificate &certificate : caCertificates)
+        hash.addData(certificate.digest(QCryptographicHash::Sha1));
+    const QList<QSslCipher> ciphers = config.ciphers();
+    for (const QSslCipher &cipher : ciphers)
+        hash.addData(cipher.name().toLatin1() + ',');
+    return key + hash.result().toHex();
+}
+#endif
+
+// Connections only take the HTTP/2 parameters of the request that created
+// them, so requests asking for other ones must not share them.
+static QByteArray http2ConfigurationKey(const QHttp2Configuration &config)
+{
+    return QByteArray::number(config.sessionReceiveWindowSize()) + ':'
+            + QByteArray::number(config.streamReceiveWindowSize()) + ':'
+            + QByteArray::number(config.maxFrameSize()) + ':'
+            + QByteArray::number(config.headerTableSize()) + ':'
+            + (config.windowAutoTuningEnabled() ? '1' : '0');
+}
+
 static QByteArray makeCacheKey(QUrl &url, QNetworkProxy *proxy)
 {
     QString result;
@@ -197,6 +250,16 @@ public:
         setShareable(true);
     }
 
+    // The credentials held by the channels belong to the manager that
+    // issued the last request. Returns true if that was another manager.
+    bool setCredentialOwner(const QSharedPointer<QNetworkAccessAuthenticationManager> &owner)
+    {
+        if (credentialOwner.toStrongRef() == owner)
+            return false;
+        credentialOwner = owner;
+        return true;
+    }
+
     virtual void dispose() Q_DECL_OVERRIDE
     {
 #if 0  // sample code; do this right with the API
@@ -204,6 +267,9 @@ public:
 #endif
         delete this;
     }
+
+private:
+    QWeakPointer<QNetworkAccessAuthenticationManager> credentialOwner;
 };
 
 
@@ -234,6 +300,9 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , pendingDownloadData()
     , pendingDownloadProgress()
     , synchronous(false)
+    , connectionIdleTimeout(-1)
+    , maxConcurrentStreams(0)
+    , sharedConnectionPool(false)
     , incomingStatusCode(0)
     , isPipeliningUsed(false)
     , isSpdyUsed(false)
@@ -284,6 +353,8 @@ void QHttpThreadDelegate::startRequest()
     if (!connections.hasLocalData()) {
         connections.setLocalData(new QNetworkAccessCache());
     }
+    if (connectionIdleTimeout >= 0)
+        connections.localData()->setExpiryTimeout(connectionIdleTimeout);
 
     // check if we have an open connection to this host
     QUrl urlCopy = httpRequest.url();
@@ -320,6 +391,20 @@ void QHttpThreadDelegate::startRequest()
     else
 #endif
         cacheKey = makeCacheKey(urlCopy, 0);
+#ifndef QT_NO_SSL
+    // Only the shared pool mixes the requests of several managers.
+    if (sharedConnectionPool && ssl)
+        cacheKey += '#' + sslConfigurationKey(*incomingSslConfiguration);
+#endif
+    // Channels keep the credentials of the last authenticated request and
+    // send them with the following ones, so in the shared pool a manager that
+    // has credentials gets connections of its own.
+    if (sharedConnectionPool && authenticationManager->hasCachedCredentials())
+        cacheKey += '@' + QByteArray::number(quintptr(authenticationManager.data()), 16);
+    if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
+            && http2Parameters != QHttp2Configuration()) {
+        cacheKey += '%' + http2ConfigurationKey(http2Parameters);
+    }
 
 
     // the http object is actually a QHttpNetworkConnection
@@ -345,10 +430,18 @@ void QHttpThreadDelegate::startRequest()
         httpConnection->setTransparentProxy(transparentProxy);
         httpConnection->setCacheProxy(cacheProxy);
 #endif
+        httpConnection->setMaxConcurrentStreams(maxConcurrentStreams);
+        if (sharedConnectionPool)
+            httpConnection->setCredentialOwner(authenticationManager);
+        if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2)
+            httpConnection->setHttp2Parameters(http2Parameters);
 
         // cache the QHttpNetworkConnection corresponding to this cache key
         connections.localData()->addEntry(cacheKey, httpConnection);
     } else {
+        // don't let the previous manager's credentials leak into our requests
+        if (sharedConnectionPool && httpConnection->setCredentialOwner(authenticationManager))
+            httpConnection->d_func()->resetCredentials();
         if (httpRequest.withCredentials()) {
             QNetworkAuthenticationCredential credential = authenticationManager->fetchCachedCredentials(httpRequest.url(), 0);
             if (!credential.user.isEmpty() && !credential.password.isEmpty()) {
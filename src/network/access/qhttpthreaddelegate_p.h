@@ -103,6 +103,12 @@ public:
 #endif
     QSharedPointer<QNetworkAccessAuthenticationManager> authenticationManager;
     bool synchronous;
+    QHttp2Configuration http2Parameters;
+    // Connection pool tuning, -1 and 0 keep the defaults
+    int connectionIdleTimeout;
+    quint32 maxConcurrentStreams;
+    // connections are shared with other managers' delegates
+    bool sharedConnectionPool;
 
     // outgoing, Retrieved in the synchronous HTTP case
     QByteArray synchronousDownloadData;
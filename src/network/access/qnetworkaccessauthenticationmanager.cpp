@@ -298,6 +298,15 @@ QNetworkAccessAuthenticationManager::fetchCachedCredentials(const QUrl &url,
     return ret;
 }
 
+/*!
+    Returns \c true if credentials for any host or proxy are cached.
+*/
+bool QNetworkAccessAuthenticationManager::hasCachedCredentials()
+{
+    QMutexLocker mutexLocker(&mutex);
+    return !authenticationCache.isEmpty();
+}
+
 void QNetworkAccessAuthenticationManager::clearCache()
 {
     authenticationCache.clear();
@@ -98,6 +98,7 @@ public:
                                                              const QAuthenticator *auth = 0);
 #endif
 
+    bool hasCachedCredentials();
     void clearCache();
 
 protected:
@@ -102,7 +102,7 @@ void QNetworkAccessCache::CacheableObject::setShareable(bool enable)
 }
 
 QNetworkAccessCache::QNetworkAccessCache()
-    : oldest(0), newest(0)
+    : oldest(0), newest(0), expiry(ExpiryTime)
 {
 }
 
@@ -132,6 +132,21 @@ void QNetworkAccessCache::clear()
     oldest = newest = 0;
 }
 
+/*!
+    Sets the number of seconds an unused entry is kept in the cache before it
+    is disposed of to \a seconds. Entries that are already idle keep the
+    expiry time they were given when they were released.
+ */
+void QNetworkAccessCache::setExpiryTimeout(int seconds)
+{
+    expiry = seconds < 0 ? int(ExpiryTime) : seconds;
+}
+
+int QNetworkAccessCache::expiryTimeout() const
+{
+    return expiry;
+}
+
 /*!
     Appends the entry given by \a key to the end of the linked list.
     (i.e., makes it the newest entry)
@@ -157,7 +172,7 @@ void QNetworkAccessCache::linkEntry(const QByteArray &key)
         oldest = node;
     }
 
-    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(ExpiryTime);
+    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(expiry);
     newest = node;
 }
 
@@ -265,6 +280,11 @@ bool QNetworkAccessCache::hasEntry(const QByteArray &key) const
     return hash.contains(key);
 }
 
+bool QNetworkAccessCache::isEmpty() const
+{
+    return hash.isEmpty();
+}
+
 bool QNetworkAccessCache::requestEntry(const QByteArray &key, QObject *target, const char *member)
 {
     NodeHash::Iterator it = hash.find(key);
@@ -95,8 +95,12 @@ public:
 
     void clear();
 
+    void setExpiryTimeout(int seconds);
+    int expiryTimeout() const;
+
     void addEntry(const QByteArray &key, CacheableObject *entry);
     bool hasEntry(const QByteArray &key) const;
+    bool isEmpty() const;
     bool requestEntry(const QByteArray &key, QObject *target, const char *member);
     CacheableObject *requestEntryNow(const QByteArray &key);
     void releaseEntry(const QByteArray &key);
@@ -115,6 +119,7 @@ private:
     Node *newest;
 
     QBasicTimer timer;
+    int expiry;
 
     void linkEntry(const QByteArray &key);
     bool unlinkEntry(const QByteArray &key);
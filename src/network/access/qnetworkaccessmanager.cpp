@@ -72,6 +72,7 @@
 #include "qnetworkreplyhttpimpl_p.h"
 
 #include "qthread.h"
+#include "qmutex.h"
 
 #include <QHostInfo>
 
@@ -88,6 +89,18 @@ Q_GLOBAL_STATIC(QNetworkAccessFileBackendFactory, fileBackend)
 Q_GLOBAL_STATIC(QNetworkAccessFtpBackendFactory, ftpBackend)
 #endif // QT_CONFIG(ftp)
 
+namespace {
+struct QNetworkAccessSharedConnectionPool
+{
+    QMutex mutex;
+    QThread *thread = nullptr;
+    int users = 0;
+    QAtomicInt maximumStreams {0};
+    QAtomicInt idleTimeout {120};
+};
+}
+Q_GLOBAL_STATIC(QNetworkAccessSharedConnectionPool, connectionPool)
+
 #ifdef QT_BUILD_INTERNAL
 Q_GLOBAL_STATIC(QNetworkAccessDebugPipeBackendFactory, debugpipeBackend)
 #endif
@@ -1240,6 +1253,106 @@ QNetworkRequest::RedirectPolicy QNetworkAccessManager::redirectPolicy() const
     return d->redirectPolicy;
 }
 
+/*!
+    \since 5.10
+
+    If \a enabled is \c true, HTTP requests issued by this manager are
+    served from a connection pool that is shared by all managers in the
+    process that enabled it, regardless of the thread they live in.
+    Otherwise, the manager keeps its own connections, which is the default.
+
+    Connections in the pool are keyed by host, port, proxy and TLS
+    configuration, so requests only share a connection when they would have
+    negotiated an identical one. This is most useful for HTTP/2, where all
+    requests to the same origin are multiplexed as streams over a single
+    connection instead of each manager opening its own.
+
+    Authentication never carries over between managers: once a manager has
+    cached credentials, it no longer shares connections with other managers,
+    and credentials that a shared connection acquired for one manager are
+    discarded before another manager uses it.
+
+    The setting applies to requests created after the call; requests that
+    are in progress continue on the connection they were started on.
+    Synchronous requests never use the shared pool.
+
+    \sa isSharedConnectionPoolEnabled(), setSharedConnectionPoolMaximumStreams(),
+    setSharedConnectionPoolIdleTimeout()
+*/
+void QNetworkAccessManager::setSharedConnectionPoolEnabled(bool enabled)
+{
+    Q_D(QNetworkAccessManager);
+    d->sharedConnectionPool = enabled;
+}
+
+/*!
+    \since 5.10
+
+    Returns \c true if this manager issues its HTTP requests through the
+    process-wide connection pool.
+
+    \sa setSharedConnectionPoolEnabled()
+*/
+bool QNetworkAccessManager::isSharedConnectionPoolEnabled() const
+{
+    Q_D(const QNetworkAccessManager);
+    return d->sharedConnectionPool;
+}
+
+/*!
+    \since 5.10
+
+    Limits the number of concurrent HTTP/2 streams the shared connection
+    pool opens to a single origin to \a streams. Requests beyond the limit
+    are queued until a stream finishes. A value of 0, the default, means
+    that only the limit advertised by the server applies.
+
+    The limit is applied to connections opened after the call.
+
+    \sa sharedConnectionPoolMaximumStreams(), setSharedConnectionPoolEnabled()
+*/
+void QNetworkAccessManager::setSharedConnectionPoolMaximumStreams(int streams)
+{
+    connectionPool()->maximumStreams.store(qMax(0, streams));
+}
+
+/*!
+    \since 5.10
+
+    Returns the per-origin stream limit of the shared connection pool.
+
+    \sa setSharedConnectionPoolMaximumStreams()
+*/
+int QNetworkAccessManager::sharedConnectionPoolMaximumStreams()
+{
+    return connectionPool()->maximumStreams.load();
+}
+
+/*!
+    \since 5.10
+
+    Sets the time in \a seconds a connection in the shared connection pool
+    may stay idle before it is closed. The default is 120 seconds.
+
+    \sa sharedConnectionPoolIdleTimeout(), setSharedConnectionPoolEnabled()
+*/
+void QNetworkAccessManager::setSharedConnectionPoolIdleTimeout(int seconds)
+{
+    connectionPool()->idleTimeout.store(qMax(0, seconds));
+}
+
+/*!
+    \since 5.10
+
+    Returns the idle timeout of the shared connection pool, in seconds.
+
+    \sa setSharedConnectionPoolIdleTimeout()
+*/
+int QNetworkAccessManager::sharedConnectionPoolIdleTimeout()
+{
+    return connectionPool()->idleTimeout.load();
+}
+
 /*!
     \since 4.7
 
@@ -1779,6 +1892,11 @@ QNetworkAccessManagerPrivate::~QNetworkAccessManagerPrivate()
 
 QThread * QNetworkAccessManagerPrivate::createThread()
 {
+    if (sharedConnectionPool) {
+        if (!sharedThread)
+            sharedThread = acquireSharedThread();
+        return sharedThread;
+    }
     if (!thread) {
         thread = new QThread;
         thread->setObjectName(QStringLiteral("QNetworkAccessManager thread"));
@@ -1799,6 +1917,44 @@ void QNetworkAccessManagerPrivate::destroyThread()
             QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
         thread = 0;
     }
+    if (sharedThread) {
+        releaseSharedThread();
+        sharedThread = 0;
+    }
+}
+
+QThread *QNetworkAccessManagerPrivate::acquireSharedThread()
+{
+    QNetworkAccessSharedConnectionPool *pool = connectionPool();
+    QMutexLocker locker(&pool->mutex);
+    if (!pool->thread) {
+        pool->thread = new QThread;
+        pool->thread->setObjectName(QStringLiteral("QNetworkAccessManager shared thread"));
+        pool->thread->start();
+    }
+    ++pool->users;
+    return pool->thread;
+}
+
+void QNetworkAccessManagerPrivate::releaseSharedThread()
+{
+    QNetworkAccessSharedConnectionPool *pool = connectionPool();
+    QMutexLocker locker(&pool->mutex);
+    Q_ASSERT(pool->users > 0);
+    if (--pool->users)
+        return;
+
+    // the last user is gone: shut the thread down, which disposes of the pooled connections
+    QThread *thread = pool->thread;
+    pool->thread = 0;
+    locker.unlock();
+
+    thread->quit();
+    thread->wait(5000);
+    if (thread->isFinished())
+        delete thread;
+    else
+        QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
 }
 
 #ifndef QT_NO_BEARERMANAGEMENT
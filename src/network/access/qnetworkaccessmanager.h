@@ -161,6 +161,13 @@ public:
     void setRedirectPolicy(QNetworkRequest::RedirectPolicy policy);
     QNetworkRequest::RedirectPolicy redirectPolicy() const;
 
+    void setSharedConnectionPoolEnabled(bool enabled);
+    bool isSharedConnectionPoolEnabled() const;
+    static void setSharedConnectionPoolMaximumStreams(int streams);
+    static int sharedConnectionPoolMaximumStreams();
+    static void setSharedConnectionPoolIdleTimeout(int seconds);
+    static int sharedConnectionPoolIdleTimeout();
+
 Q_SIGNALS:
 #ifndef QT_NO_NETWORKPROXY
     void proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
@@ -78,7 +78,7 @@ class QNetworkAccessManagerPrivate: public QObjectPrivate
 public:
     QNetworkAccessManagerPrivate()
         : networkCache(0), cookieJar(0),
-          thread(0),
+          thread(0), sharedThread(0),
 #ifndef QT_NO_NETWORKPROXY
           proxyFactory(0),
 #endif
@@ -114,6 +114,8 @@ public:
 
     QThread * createThread();
     void destroyThread();
+    static QThread *acquireSharedThread();
+    static void releaseSharedThread();
 
     void _q_replyFinished();
     void _q_replyEncrypted();
@@ -172,6 +174,9 @@ public:
     QNetworkCookieJar *cookieJar;
 
     QThread *thread;
+    // the process-wide thread hosting the shared connection pool, if we use it
+    QThread *sharedThread;
+    bool sharedConnectionPool = false;
 
 
 #ifndef QT_NO_NETWORKPROXY
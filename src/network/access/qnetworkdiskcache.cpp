@@ -51,12 +51,19 @@
 #include <qdiriterator.h>
 #include <qurl.h>
 #include <qcryptographichash.h>
+#include <qrunnable.h>
+#include <qthread.h>
+#include <qthreadpool.h>
 #include <qdebug.h>
 
+#include <algorithm>
+
 #define CACHE_POSTFIX QLatin1String(".d")
 #define PREPARED_SLASH QLatin1String("prepared/")
 #define CACHE_VERSION 8
 #define DATA_DIR QLatin1String("data")
+#define INDEX_FILE QLatin1String("index")
+#define INDEX_LOCK_FILE QLatin1String("index.lock")
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
 
@@ -74,8 +81,15 @@ QT_BEGIN_NAMESPACE
     are compressed using qCompress.  Data is written to disk only in insert()
     and updateMetaData().
 
+    The size and last access time of every cache file are tracked in a
+    memory-mapped index stored next to the cache files, so the cache does
+    not need to scan the directory to find out how large it is. Disk caches
+    in the same process that use the same cache directory share that index.
+    When an insertion makes the cache grow beyond maximumCacheSize(), the
+    least recently used files are removed by a background thread.
+
     Currently you cannot share the same cache files with more than
-    one disk cache.
+    one process.
 
     QNetworkDiskCache by default limits the amount of space that the cache will
     use on the system to 50MB.
@@ -150,6 +164,7 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
 
     d->dataDirectory = d->cacheDirectory + DATA_DIR + QString::number(CACHE_VERSION) + QLatin1Char('/');
     d->prepareLayout();
+    d->index = QNetworkDiskCacheIndex::open(d->dataDirectory);
 }
 
 /*!
@@ -163,6 +178,8 @@ qint64 QNetworkDiskCache::cacheSize() const
     Q_D(const QNetworkDiskCache);
     if (d->cacheDirectory.isEmpty())
         return 0;
+    if (d->index)
+        return d->index->totalSize();
     if (d->currentCacheSize < 0) {
         QNetworkDiskCache *that = const_cast<QNetworkDiskCache*>(this);
         that->d_func()->currentCacheSize = that->expire();
@@ -270,16 +287,21 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
     QString fileName = cacheFileName(cacheItem->metaData.url());
     Q_ASSERT(!fileName.isEmpty());
 
+    const QByteArray id = cacheId(cacheItem->metaData.url());
     if (QFile::exists(fileName)) {
         if (!QFile::remove(fileName)) {
             qWarning() << "QNetworkDiskCache: couldn't remove the cache file " << fileName;
             return;
         }
+        if (index)
+            index->remove(id);
     }
 
-    if (currentCacheSize > 0)
-        currentCacheSize += 1024 + cacheItem->size();
-    currentCacheSize = q->expire();
+    if (!index) {
+        if (currentCacheSize > 0)
+            currentCacheSize += 1024 + cacheItem->size();
+        currentCacheSize = q->expire();
+    }
     if (!cacheItem->file) {
         QString templateName = tmpCacheFileName();
         cacheItem->file = new QTemporaryFile(templateName, &cacheItem->data);
@@ -294,13 +316,24 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         && cacheItem->file->error() == QFile::NoError) {
         cacheItem->file->setAutoRemove(false);
         // ### use atomic rename rather then remove & rename
-        if (cacheItem->file->rename(fileName))
-            currentCacheSize += cacheItem->file->size();
-        else
+        if (cacheItem->file->rename(fileName)) {
+            const qint64 size = cacheItem->file->size();
+            currentCacheSize += size;
+            if (index)
+                index->insert(id, size);
+        } else {
             cacheItem->file->setAutoRemove(true);
+        }
     }
     if (cacheItem->metaData.url() == lastItem.metaData.url())
         lastItem.reset();
+
+    if (index && index->totalSize() >= maximumCacheSize) {
+        // expire() only schedules the eviction, the insertion doesn't wait for it
+        expireInBackground = true;
+        currentCacheSize = q->expire();
+        expireInBackground = false;
+    }
 }
 
 /*!
@@ -345,6 +378,11 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
     qint64 size = info.size();
     if (QFile::remove(file)) {
         currentCacheSize -= size;
+        if (index) {
+            const QByteArray id = cacheIdForFile(file);
+            if (!id.isEmpty())
+                index->remove(id);
+        }
         return true;
     }
     return false;
@@ -361,7 +399,13 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     Q_D(QNetworkDiskCache);
     if (d->lastItem.metaData.url() == url)
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+    if (!url.isValid())
+        return QNetworkCacheMetaData();
+    const QByteArray id = QNetworkDiskCachePrivate::cacheId(url);
+    QNetworkCacheMetaData metaData = fileMetaData(d->dataDirectory + QNetworkDiskCachePrivate::pathFragment(id));
+    if (d->index && metaData.isValid())
+        d->index->touch(id);
+    return metaData;
 }
 
 /*!
@@ -402,7 +446,8 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
-        QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
+        const QByteArray id = QNetworkDiskCachePrivate::cacheId(url);
+        QScopedPointer<QFile> file(new QFile(d->dataDirectory + QNetworkDiskCachePrivate::pathFragment(id)));
         if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
             return 0;
 
@@ -411,6 +456,8 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
             remove(url);
             return 0;
         }
+        if (d->index)
+            d->index->touch(id);
         if (d->lastItem.data.isOpen()) {
             // compressed
             buffer.reset(new QBuffer);
@@ -501,8 +548,14 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
 
     When the current size of the cache is greater than the maximumCacheSize()
     older cache files are removed until the total size is less then 90% of
-    maximumCacheSize() starting with the oldest ones first using the file
-    creation date to determine how old a cache file is.
+    maximumCacheSize() starting with the least recently used ones first, as
+    recorded in the cache index. If the index could not be opened, the cache
+    directory is scanned instead and the file creation date is used to
+    determine how old a cache file is.
+
+    When expire() is called because an insertion made the cache grow beyond
+    maximumCacheSize(), the files are removed by a background thread and the
+    returned size does not account for them yet.
 
     Subclasses can reimplement this function to change the order that cache
     files are removed taking into account information in the application
@@ -516,6 +569,20 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
 qint64 QNetworkDiskCache::expire()
 {
     Q_D(QNetworkDiskCache);
+    if (d->index) {
+        const qint64 size = d->index->totalSize();
+        if (size < maximumCacheSize())
+            return size;
+        const qint64 goal = (maximumCacheSize() * 9) / 10;
+        if (d->expireInBackground) {
+            d->index->scheduleEviction(goal);
+            return size;
+        }
+        // close file handle to prevent "in use" error when QFile::remove() is called
+        d->lastItem.reset();
+        return d->index->evict(goal);
+    }
+
     if (d->currentCacheSize >= 0 && d->currentCacheSize < maximumCacheSize())
         return d->currentCacheSize;
 
@@ -598,6 +665,15 @@ void QNetworkDiskCache::clear()
     Given a URL, generates a unique enough filename (and subdirectory)
  */
 QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
+{
+    return pathFragment(cacheId(url));
+}
+
+/*!
+    Returns the 8-char id of the cache file for \a url, which is also the
+    key of its entry in the cache index.
+ */
+QByteArray QNetworkDiskCachePrivate::cacheId(const QUrl &url)
 {
     QUrl cleanUrl = url;
     cleanUrl.setPassword(QString());
@@ -606,7 +682,11 @@ QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
     QCryptographicHash hash(QCryptographicHash::Sha1);
     hash.addData(cleanUrl.toEncoded());
     // convert sha1 to base36 form and return first 8 bytes for use as string
-    const QByteArray id = QByteArray::number(*(qlonglong*)hash.result().constData(), 36).left(8);
+    return QByteArray::number(*(qlonglong*)hash.result().constData(), 36).left(8);
+}
+
+QString QNetworkDiskCachePrivate::pathFragment(const QByteArray &id)
+{
     // generates <one-char subdir>/<8-char filname.d>
     uint code = (uint)id.at(id.length()-1) % 16;
     QString pathFragment = QString::number(code, 16) + QLatin1Char('/')
@@ -615,6 +695,23 @@ QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
     return pathFragment;
 }
 
+/*!
+    Returns the id of the cache file \a fileName, or an empty byte array if
+    \a fileName is not a file of the data directory.
+ */
+QByteArray QNetworkDiskCachePrivate::cacheIdForFile(const QString &fileName) const
+{
+    const QString name = QFileInfo(fileName).fileName();
+    if (!name.endsWith(CACHE_POSTFIX))
+        return QByteArray();
+    const QByteArray id = name.left(name.length() - CACHE_POSTFIX.size()).toLatin1();
+    if (id.isEmpty() || id.size() >= int(sizeof(QNetworkDiskCacheIndex::Record::id)))
+        return QByteArray();
+    if (QFileInfo(fileName).absoluteFilePath() != dataDirectory + pathFragment(id))
+        return QByteArray();
+    return id;
+}
+
 QString QNetworkDiskCachePrivate::tmpCacheFileName() const
 {
     //The subdirectory is presumed to be already read for use.
@@ -736,4 +833,411 @@ bool QCacheItem::read(QFile *device, bool readData)
     return metaData.isValid();
 }
 
+enum
+{
+    IndexMagic = 0x51444e49, // "INDQ"
+    IndexVersion = 1,
+    IndexInitialCapacity = 1024,
+    EvictionBatchSize = 32
+};
+
+struct QNetworkDiskCacheIndexRegistry
+{
+    QMutex mutex;
+    QHash<QString, QWeakPointer<QNetworkDiskCacheIndex> > indexes;
+};
+
+Q_GLOBAL_STATIC(QNetworkDiskCacheIndexRegistry, indexRegistry)
+
+#ifndef QT_NO_THREAD
+class QNetworkDiskCacheEvictor : public QRunnable
+{
+public:
+    explicit QNetworkDiskCacheEvictor(const QSharedPointer<QNetworkDiskCacheIndex> &index)
+        : index(index)
+    {
+    }
+
+    void run() override
+    {
+        index->runScheduledEviction();
+    }
+
+private:
+    QSharedPointer<QNetworkDiskCacheIndex> index;
+};
+#endif
+
+/*!
+    Returns the index of the cache files in \a dataDirectory, loading it or
+    rebuilding it from the files on disk if no disk cache of this process
+    uses that directory yet. Returns a null pointer if the index file cannot
+    be created or mapped, or if another process uses it; the disk cache then
+    falls back to scanning the directory.
+ */
+QSharedPointer<QNetworkDiskCacheIndex> QNetworkDiskCacheIndex::open(const QString &dataDirectory)
+{
+    QNetworkDiskCacheIndexRegistry *registry = indexRegistry();
+    if (!registry)
+        return QSharedPointer<QNetworkDiskCacheIndex>();
+
+    QMutexLocker locker(&registry->mutex);
+    QSharedPointer<QNetworkDiskCacheIndex> index = registry->indexes.value(dataDirectory).toStrongRef();
+    if (index)
+        return index;
+
+    index.reset(new QNetworkDiskCacheIndex(dataDirectory));
+    if (!index->load()) {
+        if (index->lockFile.error() != QLockFile::LockFailedError) {
+            qWarning() << "QNetworkDiskCache: couldn't open the cache index" << index->file.fileName()
+                       << index->file.errorString();
+        }
+        return QSharedPointer<QNetworkDiskCacheIndex>();
+    }
+    registry->indexes.insert(dataDirectory, index);
+    return index;
+}
+
+QNetworkDiskCacheIndex::QNetworkDiskCacheIndex(const QString &dataDirectory)
+    : dataDirectory(dataDirectory),
+      lockFile(dataDirectory + INDEX_LOCK_FILE),
+      address(0),
+      capacity(0),
+      total(0),
+      lastStamp(0),
+      pendingGoal(-1)
+{
+}
+
+QNetworkDiskCacheIndex::~QNetworkDiskCacheIndex()
+{
+    if (address) {
+        // everything that was written is consistent, no need to rebuild next time
+        header()->clean = 1;
+        file.unmap(address);
+    }
+}
+
+qint64 QNetworkDiskCacheIndex::totalSize() const
+{
+    QMutexLocker locker(&mutex);
+    return total;
+}
+
+int QNetworkDiskCacheIndex::count() const
+{
+    QMutexLocker locker(&mutex);
+    return entries.count();
+}
+
+void QNetworkDiskCacheIndex::insert(const QByteArray &id, qint64 size)
+{
+    QMutexLocker locker(&mutex);
+    int slot = entries.value(id, -1);
+    if (slot < 0) {
+        slot = allocateSlot();
+        if (slot < 0)
+            return;
+        entries.insert(id, slot);
+    } else {
+        total -= records()[slot].size;
+    }
+    writeRecord(slot, id, size, nextStamp());
+    total += size;
+}
+
+void QNetworkDiskCacheIndex::remove(const QByteArray &id)
+{
+    QMutexLocker locker(&mutex);
+    const auto it = entries.find(id);
+    if (it == entries.end())
+        return;
+    const int slot = it.value();
+    entries.erase(it);
+    total -= records()[slot].size;
+    clearRecord(slot);
+    freeSlots.append(slot);
+}
+
+void QNetworkDiskCacheIndex::touch(const QByteArray &id)
+{
+    QMutexLocker locker(&mutex);
+    const int slot = entries.value(id, -1);
+    if (slot >= 0)
+        writeRecord(slot, id, records()[slot].size, nextStamp());
+}
+
+/*!
+    Removes the least recently used cache files until the total size is
+    less than \a goal and returns the new total size.
+
+    If \a incremental is true the lock is released after every few removed
+    files, so that insertions and lookups are not blocked for the duration
+    of the whole eviction.
+ */
+qint64 QNetworkDiskCacheIndex::evict(qint64 goal, bool incremental)
+{
+    QMutexLocker locker(&mutex);
+    while (total >= goal) {
+        QVector<QPair<qint64, int> > order;
+        order.reserve(entries.count());
+        for (int slot : qAsConst(entries))
+            order.append(qMakePair(records()[slot].lastAccess, slot));
+        std::sort(order.begin(), order.end());
+
+        int removedFiles = 0;
+        int batch = 0;
+        for (const auto &candidate : qAsConst(order)) {
+            if (total < goal)
+                break;
+            const Record &record = records()[candidate.second];
+            // skip entries that were used or replaced while the lock was released
+            if (!isValid(record) || record.lastAccess != candidate.first)
+                continue;
+            const QByteArray id = recordId(record);
+            const QString fileName = dataDirectory + QNetworkDiskCachePrivate::pathFragment(id);
+            if (!QFile::remove(fileName) && QFile::exists(fileName))
+                continue;
+            total -= record.size;
+            entries.remove(id);
+            clearRecord(candidate.second);
+            freeSlots.append(candidate.second);
+            ++removedFiles;
+
+            if (incremental && ++batch == EvictionBatchSize) {
+                batch = 0;
+                locker.unlock();
+                QThread::yieldCurrentThread();
+                locker.relock();
+            }
+        }
+#if defined(QNETWORKDISKCACHE_DEBUG)
+        qDebug() << "QNetworkDiskCacheIndex::evict()"
+                 << "Removed:" << removedFiles
+                 << "Kept:" << entries.count();
+#endif
+        if (removedFiles == 0)
+            break;
+    }
+    return total;
+}
+
+/*!
+    Makes a background thread evict files until the total size is less
+    than \a goal. Returns immediately.
+ */
+void QNetworkDiskCacheIndex::scheduleEviction(qint64 goal)
+{
+#ifndef QT_NO_THREAD
+    QMutexLocker locker(&mutex);
+    if (pendingGoal >= 0) {
+        pendingGoal = qMin(pendingGoal, goal);
+        return;
+    }
+    pendingGoal = goal;
+    locker.unlock();
+    QThreadPool::globalInstance()->start(new QNetworkDiskCacheEvictor(sharedFromThis()));
+#else
+    evict(goal);
+#endif
+}
+
+void QNetworkDiskCacheIndex::runScheduledEviction()
+{
+    for (;;) {
+        qint64 goal;
+        {
+            QMutexLocker locker(&mutex);
+            goal = pendingGoal;
+            if (total < goal) {
+                pendingGoal = -1;
+                return;
+            }
+        }
+        evict(goal, true);
+        QMutexLocker locker(&mutex);
+        // run again if another insertion lowered the goal meanwhile
+        if (pendingGoal == goal) {
+            pendingGoal = -1;
+            return;
+        }
+    }
+}
+
+bool QNetworkDiskCacheIndex::load()
+{
+    // Loading may truncate the file, and the records are written through a
+    // shared mapping, so only one process at a time may use the index.
+    // Only a lock left behind by a dead process is stale.
+    lockFile.setStaleLockTime(0);
+    if (!lockFile.tryLock())
+        return false;
+
+    file.setFileName(dataDirectory + INDEX_FILE);
+    if (!file.open(QIODevice::ReadWrite))
+        return false;
+
+    Header stored;
+    const qint64 fileSize = file.size();
+    const bool valid = file.read(reinterpret_cast<char *>(&stored), sizeof(stored)) == qint64(sizeof(stored))
+            && stored.magic == IndexMagic
+            && stored.version == IndexVersion
+            && stored.clean == 1
+            && stored.capacity > 0
+            && fileSize == qint64(sizeof(Header)) + qint64(stored.capacity) * qint64(sizeof(Record));
+
+    if (valid) {
+        capacity = stored.capacity;
+    } else {
+        capacity = IndexInitialCapacity;
+        if (!file.resize(0) || !file.resize(qint64(sizeof(Header)) + qint64(capacity) * qint64(sizeof(Record))))
+            return false;
+    }
+    if (!map())
+        return false;
+
+    if (valid) {
+        freeSlots.reserve(capacity);
+        for (int slot = int(capacity) - 1; slot >= 0; --slot) {
+            const Record &record = records()[slot];
+            const QByteArray id = isValid(record) ? recordId(record) : QByteArray();
+            if (id.isEmpty() || entries.contains(id)) {
+                clearRecord(slot);
+                freeSlots.append(slot);
+                continue;
+            }
+            entries.insert(id, slot);
+            total += record.size;
+            lastStamp = qMax(lastStamp, record.lastAccess);
+        }
+    } else {
+        rebuild();
+    }
+
+    // a crash before the destructor resets this makes the next load rebuild the index
+    header()->clean = 0;
+    return true;
+}
+
+bool QNetworkDiskCacheIndex::map()
+{
+    const qint64 size = qint64(sizeof(Header)) + qint64(capacity) * qint64(sizeof(Record));
+    // size() also refreshes the size QFile remembers from before the resize
+    if (file.size() < size)
+        return false;
+    address = file.map(0, size);
+    if (!address)
+        return false;
+    header()->magic = IndexMagic;
+    header()->version = IndexVersion;
+    header()->capacity = capacity;
+    return true;
+}
+
+bool QNetworkDiskCacheIndex::grow()
+{
+    const quint32 newCapacity = capacity * 2;
+    file.unmap(address);
+    address = 0;
+    if (!file.resize(qint64(sizeof(Header)) + qint64(newCapacity) * qint64(sizeof(Record)))) {
+        map();
+        return false;
+    }
+    const quint32 oldCapacity = capacity;
+    capacity = newCapacity;
+    if (!map()) {
+        capacity = oldCapacity;
+        map();
+        return false;
+    }
+    for (int slot = int(newCapacity) - 1; slot >= int(oldCapacity); --slot) {
+        clearRecord(slot);
+        freeSlots.append(slot);
+    }
+    return true;
+}
+
+/*!
+    Recreates the index from the cache files on disk. This is only needed
+    when the index file is missing, from an older version, or was not
+    closed cleanly.
+ */
+void QNetworkDiskCacheIndex::rebuild()
+{
+    entries.clear();
+    freeSlots.clear();
+    total = 0;
+    for (int slot = int(capacity) - 1; slot >= 0; --slot) {
+        clearRecord(slot);
+        freeSlots.append(slot);
+    }
+
+    QDirIterator it(dataDirectory, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QString fileName = info.fileName();
+        if (!fileName.endsWith(CACHE_POSTFIX))
+            continue;
+        const QByteArray id = fileName.left(fileName.length() - CACHE_POSTFIX.size()).toLatin1();
+        if (id.isEmpty() || id.size() >= int(sizeof(Record::id))
+            || info.absoluteFilePath() != dataDirectory + QNetworkDiskCachePrivate::pathFragment(id)) {
+            continue;
+        }
+        const int slot = allocateSlot();
+        if (slot < 0)
+            break;
+        QDateTime time = info.fileTime(QFile::FileAccessTime);
+        if (!time.isValid())
+            time = info.fileTime(QFile::FileModificationTime);
+        const qint64 lastAccess = time.toMSecsSinceEpoch();
+        entries.insert(id, slot);
+        writeRecord(slot, id, info.size(), lastAccess);
+        total += info.size();
+        lastStamp = qMax(lastStamp, lastAccess);
+    }
+}
+
+int QNetworkDiskCacheIndex::allocateSlot()
+{
+    if (freeSlots.isEmpty() && !grow())
+        return -1;
+    return freeSlots.takeLast();
+}
+
+void QNetworkDiskCacheIndex::writeRecord(int slot, const QByteArray &id, qint64 size, qint64 lastAccess)
+{
+    Record record;
+    memset(&record, 0, sizeof(record));
+    memcpy(record.id, id.constData(), qMin<size_t>(id.size(), sizeof(record.id) - 1));
+    record.size = size;
+    record.lastAccess = lastAccess;
+    record.checksum = qChecksum(reinterpret_cast<const char *>(&record), offsetof(Record, checksum));
+    records()[slot] = record;
+}
+
+void QNetworkDiskCacheIndex::clearRecord(int slot)
+{
+    memset(&records()[slot], 0, sizeof(Record));
+}
+
+qint64 QNetworkDiskCacheIndex::nextStamp()
+{
+    // strictly increasing, so that entries used within the same millisecond keep their order
+    lastStamp = qMax(QDateTime::currentMSecsSinceEpoch(), lastStamp + 1);
+    return lastStamp;
+}
+
+bool QNetworkDiskCacheIndex::isValid(const Record &record)
+{
+    return record.id[0] != 0
+            && record.size >= 0
+            && record.checksum == qChecksum(reinterpret_cast<const char *>(&record), offsetof(Record, checksum));
+}
+
+QByteArray QNetworkDiskCacheIndex::recordId(const Record &record)
+{
+    return QByteArray(record.id, qstrnlen(record.id, sizeof(record.id)));
+}
+
 QT_END_NAMESPACE
@@ -55,8 +55,13 @@
 #include "private/qabstractnetworkcache_p.h"
 
 #include <qbuffer.h>
+#include <qfile.h>
 #include <qhash.h>
+#include <qlockfile.h>
+#include <qmutex.h>
+#include <qsharedpointer.h>
 #include <qtemporaryfile.h>
+#include <qvector.h>
 
 QT_REQUIRE_CONFIG(networkdiskcache);
 
@@ -94,6 +99,73 @@ public:
     bool canCompress() const;
 };
 
+class QNetworkDiskCacheIndex : public QEnableSharedFromThis<QNetworkDiskCacheIndex>
+{
+public:
+    struct Header
+    {
+        quint32 magic;
+        quint32 version;
+        quint32 capacity;
+        quint32 clean;
+    };
+
+    // One fixed-size slot per cache file. A record whose checksum does not
+    // match (torn write) is treated as free when the index is loaded.
+    struct Record
+    {
+        char id[16];
+        qint64 size;
+        qint64 lastAccess;
+        quint32 reserved;
+        quint32 checksum;
+    };
+
+    static QSharedPointer<QNetworkDiskCacheIndex> open(const QString &dataDirectory);
+    ~QNetworkDiskCacheIndex();
+
+    qint64 totalSize() const;
+    int count() const;
+    void insert(const QByteArray &id, qint64 size);
+    void remove(const QByteArray &id);
+    void touch(const QByteArray &id);
+
+    qint64 evict(qint64 goal, bool incremental = false);
+    void scheduleEviction(qint64 goal);
+    void runScheduledEviction();
+
+private:
+    explicit QNetworkDiskCacheIndex(const QString &dataDirectory);
+    Q_DISABLE_COPY(QNetworkDiskCacheIndex)
+
+    bool load();
+    bool map();
+    bool grow();
+    void rebuild();
+    int allocateSlot();
+    void writeRecord(int slot, const QByteArray &id, qint64 size, qint64 lastAccess);
+    void clearRecord(int slot);
+    qint64 nextStamp();
+
+    Header *header() const { return reinterpret_cast<Header *>(address); }
+    Record *records() const { return reinterpret_cast<Record *>(address + sizeof(Header)); }
+    static bool isValid(const Record &record);
+    static QByteArray recordId(const Record &record);
+
+    mutable QMutex mutex;
+    QString dataDirectory;
+    // held while the index is mapped; unlocked after the file is closed
+    QLockFile lockFile;
+    QFile file;
+    uchar *address;
+    quint32 capacity;
+    QHash<QByteArray, int> entries;
+    QVector<int> freeSlots;
+    qint64 total;
+    qint64 lastStamp;
+    qint64 pendingGoal;
+};
+
 class QNetworkDiskCachePrivate : public QAbstractNetworkCachePrivate
 {
 public:
@@ -101,9 +173,13 @@ public:
         : QAbstractNetworkCachePrivate()
         , maximumCacheSize(1024 * 1024 * 50)
         , currentCacheSize(-1)
+        , expireInBackground(false)
         {}
 
     static QString uniqueFileName(const QUrl &url);
+    static QByteArray cacheId(const QUrl &url);
+    static QString pathFragment(const QByteArray &id);
+    QByteArray cacheIdForFile(const QString &fileName) const;
     QString cacheFileName(const QUrl &url) const;
     QString tmpCacheFileName() const;
     bool removeFile(const QString &file);
@@ -116,6 +192,8 @@ public:
     QString dataDirectory;
     qint64 maximumCacheSize;
     qint64 currentCacheSize;
+    bool expireInBackground;
+    QSharedPointer<QNetworkDiskCacheIndex> index;
 
     QHash<QIODevice*, QCacheItem*> inserting;
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
@@ -793,9 +793,17 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
         delegate->incomingSslConfiguration.reset(new QSslConfiguration(newHttpRequest.sslConfiguration()));
 #endif
 
+    delegate->http2Parameters = newHttpRequest.http2Configuration();
+
     // Do we use synchronous HTTP?
     delegate->synchronous = synchronous;
 
+    if (!synchronous && managerPrivate->sharedConnectionPool) {
+        delegate->connectionIdleTimeout = QNetworkAccessManager::sharedConnectionPoolIdleTimeout();
+        delegate->maxConcurrentStreams = QNetworkAccessManager::sharedConnectionPoolMaximumStreams();
+        delegate->sharedConnectionPool = true;
+    }
+
     // The authentication manager is used to avoid the BlockingQueuedConnection communication
     // from HTTP thread to user thread in some cases.
     delegate->authenticationManager = managerPrivate->authenticationManager;
@@ -42,6 +42,7 @@
 #include "qplatformdefs.h"
 #include "qnetworkcookie.h"
 #include "qsslconfiguration.h"
+#include "qhttp2configuration.h"
 #include "QtCore/qshareddata.h"
 #include "QtCore/qlocale.h"
 #include "QtCore/qdatetime.h"
@@ -400,6 +401,7 @@ public:
         url = other.url;
         priority = other.priority;
         maxRedirectsAllowed = other.maxRedirectsAllowed;
+        http2Configuration = other.http2Configuration;
 #ifndef QT_NO_SSL
         sslConfiguration = 0;
         if (other.sslConfiguration)
@@ -413,7 +415,8 @@ public:
             priority == other.priority &&
             rawHeaders == other.rawHeaders &&
             attributes == other.attributes &&
-            maxRedirectsAllowed == other.maxRedirectsAllowed;
+            maxRedirectsAllowed == other.maxRedirectsAllowed &&
+            http2Configuration == other.http2Configuration;
         // don't compare cookedHeaders
     }
 
@@ -423,6 +426,7 @@ public:
     mutable QSslConfiguration *sslConfiguration;
 #endif
     int maxRedirectsAllowed;
+    QHttp2Configuration http2Configuration;
 };
 
 /*!
@@ -759,6 +763,36 @@ void QNetworkRequest::setMaximumRedirectsAllowed(int maxRedirectsAllowed)
     d->maxRedirectsAllowed = maxRedirectsAllowed;
 }
 
+/*!
+    \since 5.10
+
+    Returns the current parameters that QNetworkAccessManager is
+    using for this request and its underlying HTTP/2 connection.
+    This is either a configuration previously set by an application
+    or a default configuration.
+
+    \sa setHttp2Configuration(), QHttp2Configuration
+*/
+QHttp2Configuration QNetworkRequest::http2Configuration() const
+{
+    return d->http2Configuration;
+}
+
+/*!
+    \since 5.10
+
+    Sets request's HTTP/2 parameters from \a configuration.
+
+    \note The configuration must be set prior to making a request.
+    It only takes effect if the request opens a new HTTP/2 connection.
+
+    \sa http2Configuration(), QNetworkRequest::HTTP2AllowedAttribute, QHttp2Configuration
+*/
+void QNetworkRequest::setHttp2Configuration(const QHttp2Configuration &configuration)
+{
+    d->http2Configuration = configuration;
+}
+
 static QByteArray headerName(QNetworkRequest::KnownHeaders header)
 {
     switch (header) {
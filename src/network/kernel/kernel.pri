@@ -27,6 +27,11 @@ SOURCES += kernel/qauthenticator.cpp \
            kernel/qnetworkinterface.cpp \
            kernel/qnetworkproxy.cpp
 
+qtConfig(dnsstubresolver) {
+    HEADERS += kernel/qdnsstubresolver_p.h
+    SOURCES += kernel/qdnsstubresolver.cpp
+}
+
 qtConfig(ftp) {
     HEADERS += kernel/qurlinfo_p.h
     SOURCES += kernel/qurlinfo.cpp
@@ -0,0 +1,610 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+//#define QDNSSTUBRESOLVER_DEBUG
+
+#include "qdnsstubresolver_p.h"
+#include "qhostinfo_p.h"
+
+#include <qcoreapplication.h>
+#include <qendian.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qnetworkdatagram.h>
+#include <qrandom.h>
+#include <qset.h>
+#include <qudpsocket.h>
+#include <qurl.h>
+#include <qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+enum
+{
+    DnsHeaderSize = 12,
+    DnsFlagResponse = 0x8000,
+    DnsFlagTruncated = 0x0200,
+    DnsFlagRecursionDesired = 0x0100,
+    DnsRcodeMask = 0x000f,
+
+    DnsRcodeNoError = 0,
+    DnsRcodeNameError = 3,
+
+    DnsTypeA = 1,
+    DnsTypeSOA = 6,
+    DnsTypeAAAA = 28,
+    DnsClassIN = 1,
+
+    DnsDefaultPort = 53,
+    DnsMaximumNameservers = 3, // MAXNS in resolv.h
+    DnsTimerInterval = 100
+};
+
+static const char resolvConfPath[] = "/etc/resolv.conf";
+static const char hostsPath[] = "/etc/hosts";
+
+static bool encodeName(const QByteArray &name, QByteArray *packet)
+{
+    if (name.isEmpty() || name.size() > 253)
+        return false;
+    const QList<QByteArray> labels = name.split('.');
+    for (const QByteArray &label : labels) {
+        if (label.isEmpty() || label.size() > 63)
+            return false;
+        packet->append(char(label.size()));
+        packet->append(label);
+    }
+    packet->append('\0');
+    return true;
+}
+
+static QByteArray buildQuery(quint16 id, const QByteArray &name, quint16 type)
+{
+    QByteArray packet(DnsHeaderSize, Qt::Uninitialized);
+    uchar *header = reinterpret_cast<uchar *>(packet.data());
+    qToBigEndian<quint16>(id, header);
+    qToBigEndian<quint16>(DnsFlagRecursionDesired, header + 2);
+    qToBigEndian<quint16>(1, header + 4); // QDCOUNT
+    qToBigEndian<quint16>(0, header + 6);
+    qToBigEndian<quint16>(0, header + 8);
+    qToBigEndian<quint16>(0, header + 10);
+    if (!encodeName(name, &packet))
+        return QByteArray();
+    uchar trailer[4];
+    qToBigEndian<quint16>(type, trailer);
+    qToBigEndian<quint16>(DnsClassIN, trailer + 2);
+    packet.append(reinterpret_cast<const char *>(trailer), sizeof(trailer));
+    return packet;
+}
+
+// Reads the uncompressed name at *offset. Only used for the question,
+// which never contains compression pointers.
+static bool readName(const QByteArray &packet, int *offset, QByteArray *name)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(packet.constData());
+    int pos = *offset;
+    name->clear();
+    while (pos < packet.size()) {
+        const int length = data[pos++];
+        if (length == 0) {
+            *offset = pos;
+            return true;
+        }
+        if (length > 63 || pos + length > packet.size())
+            return false;
+        if (!name->isEmpty())
+            name->append('.');
+        name->append(packet.constData() + pos, length);
+        pos += length;
+    }
+    return false;
+}
+
+static bool skipName(const QByteArray &packet, int *offset)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(packet.constData());
+    int pos = *offset;
+    while (pos < packet.size()) {
+        const int length = data[pos];
+        if ((length & 0xc0) == 0xc0) {
+            // compression pointer ends the name
+            if (pos + 2 > packet.size())
+                return false;
+            *offset = pos + 2;
+            return true;
+        }
+        if (length == 0) {
+            *offset = pos + 1;
+            return true;
+        }
+        pos += 1 + length;
+    }
+    return false;
+}
+
+QDnsStubResolver::QDnsStubResolver(QObject *parent)
+    : QObject(parent),
+      explicitNameservers(false),
+      ndots(1),
+      timeout(5000),
+      attempts(2)
+{
+}
+
+QDnsStubResolver::~QDnsStubResolver()
+{
+    QSet<Query *> pending;
+    for (Query *query : qAsConst(queries))
+        pending.insert(query);
+    for (Query *query : qAsConst(pending)) {
+        // the runnables of unfinished lookups are ours, not the thread pool's
+        delete query->runnable;
+        delete query;
+    }
+}
+
+/*!
+    Returns \c true if the resolver can look up \a hostName, that is if
+    it is a name rather than an IP address literal. Reverse lookups are
+    left to the system resolver.
+ */
+bool QDnsStubResolver::canResolve(const QString &hostName)
+{
+    QHostAddress address;
+    return !hostName.isEmpty() && !address.setAddress(hostName);
+}
+
+/*!
+    Makes the resolver ask \a nameservers instead of the servers listed in
+    /etc/resolv.conf. No search domains are applied in this case. An empty
+    list restores the system configuration.
+ */
+void QDnsStubResolver::setNameservers(const QVector<Nameserver> &nameservers)
+{
+    explicitNameservers = !nameservers.isEmpty();
+    this->nameservers = nameservers;
+    searchDomains.clear();
+    configurationTimestamp = QDateTime();
+}
+
+void QDnsStubResolver::readConfiguration()
+{
+    if (explicitNameservers)
+        return;
+
+    const QFileInfo info(QString::fromLatin1(resolvConfPath));
+    const QDateTime timestamp = info.lastModified();
+    if (!nameservers.isEmpty() && timestamp == configurationTimestamp)
+        return;
+    configurationTimestamp = timestamp;
+
+    nameservers.clear();
+    searchDomains.clear();
+    ndots = 1;
+    timeout = 5000;
+    attempts = 2;
+
+    QFile resolvconf(info.filePath());
+    if (resolvconf.open(QIODevice::ReadOnly)) {
+        while (!resolvconf.atEnd()) {
+            const QByteArray line = resolvconf.readLine().simplified();
+            if (line.isEmpty() || line.startsWith('#') || line.startsWith(';'))
+                continue;
+            QList<QByteArray> fields = line.split(' ');
+            const QByteArray keyword = fields.takeFirst();
+            if (keyword == "nameserver" && !fields.isEmpty()) {
+                QHostAddress address;
+                if (nameservers.size() < DnsMaximumNameservers && address.setAddress(QString::fromLatin1(fields.first())))
+                    nameservers.append(Nameserver{ address, quint16(DnsDefaultPort) });
+            } else if (keyword == "domain" && !fields.isEmpty()) {
+                searchDomains = QList<QByteArray>() << fields.first().toLower();
+            } else if (keyword == "search") {
+                searchDomains.clear();
+                for (const QByteArray &domain : qAsConst(fields))
+                    searchDomains.append(domain.toLower());
+            } else if (keyword == "options") {
+                for (const QByteArray &option : qAsConst(fields)) {
+                    bool ok = false;
+                    if (option.startsWith("ndots:")) {
+                        const int value = option.mid(6).toInt(&ok);
+                        if (ok)
+                            ndots = qBound(0, value, 15);
+                    } else if (option.startsWith("timeout:")) {
+                        const int value = option.mid(8).toInt(&ok);
+                        if (ok)
+                            timeout = qBound(1, value, 30) * 1000;
+                    } else if (option.startsWith("attempts:")) {
+                        const int value = option.mid(9).toInt(&ok);
+                        if (ok)
+                            attempts = qBound(1, value, 5);
+                    }
+                }
+            }
+        }
+    }
+
+    // same default as the system resolver
+    if (nameservers.isEmpty())
+        nameservers.append(Nameserver{ QHostAddress(QHostAddress::LocalHost), quint16(DnsDefaultPort) });
+}
+
+bool QDnsStubResolver::lookupHostsFile(const QByteArray &name, QList<QHostAddress> *addresses)
+{
+    const QFileInfo info(QString::fromLatin1(hostsPath));
+    const QDateTime timestamp = info.lastModified();
+    if (timestamp != hostsTimestamp) {
+        hostsTimestamp = timestamp;
+        hosts.clear();
+        QFile file(info.filePath());
+        if (file.open(QIODevice::ReadOnly)) {
+            while (!file.atEnd()) {
+                QByteArray line = file.readLine();
+                const int comment = line.indexOf('#');
+                if (comment != -1)
+                    line.truncate(comment);
+                QList<QByteArray> fields = line.simplified().split(' ');
+                if (fields.size() < 2)
+                    continue;
+                QHostAddress address;
+                if (!address.setAddress(QString::fromLatin1(fields.takeFirst())))
+                    continue;
+                for (const QByteArray &alias : qAsConst(fields)) {
+                    QList<QHostAddress> &list = hosts[alias.toLower()];
+                    if (!list.contains(address))
+                        list.append(address);
+                }
+            }
+        }
+    }
+
+    const auto it = hosts.constFind(name);
+    if (it == hosts.cend())
+        return false;
+    *addresses = it.value();
+    return true;
+}
+
+/*!
+    Starts resolving \a hostName for \a runnable. The result is handed to
+    QHostInfoRunnable::resolved() once it is known.
+
+    Must be called in the thread of the resolver.
+ */
+void QDnsStubResolver::lookup(QHostInfoRunnable *runnable, const QString &hostName)
+{
+    QHostInfo hostInfo;
+    hostInfo.setHostName(hostName);
+
+    QByteArray name = QUrl::toAce(hostName).toLower();
+    const bool absolute = name.endsWith('.');
+    if (absolute)
+        name.chop(1);
+    if (name.isEmpty()) {
+        hostInfo.setError(QHostInfo::HostNotFound);
+        hostInfo.setErrorString(QCoreApplication::translate("QHostInfoAgent", "Invalid hostname"));
+        runnable->resolved(hostInfo, 0);
+        return;
+    }
+
+    // like the system resolver, consult the hosts file first
+    QList<QHostAddress> addresses;
+    if (lookupHostsFile(name, &addresses)
+        || name == "localhost" || name.endsWith(".localhost")) {
+        if (addresses.isEmpty())
+            addresses << QHostAddress(QHostAddress::LocalHost) << QHostAddress(QHostAddress::LocalHostIPv6);
+        hostInfo.setAddresses(addresses);
+        runnable->resolved(hostInfo, -1);
+        return;
+    }
+
+    readConfiguration();
+
+    // every lookup gets its own socket, so that the source port the kernel
+    // picks for it is as hard to guess as the query id
+    QUdpSocket *socket = new QUdpSocket(this);
+    if (!socket->bind(QHostAddress(QHostAddress::Any))) {
+        hostInfo.setError(QHostInfo::UnknownError);
+        hostInfo.setErrorString(socket->errorString());
+        delete socket;
+        runnable->resolved(hostInfo, 0);
+        return;
+    }
+    connect(socket, &QUdpSocket::readyRead, this, [this, socket] { processDatagrams(socket); });
+
+    Query *query = new Query;
+    query->runnable = runnable;
+    query->socket = socket;
+    query->hostName = hostName;
+    query->candidate = 0;
+    query->ttl = -1;
+    query->negativeTtl = -1;
+    query->serverFailure = false;
+    query->ids[A] = query->ids[AAAA] = 0;
+
+    QList<QByteArray> searchNames;
+    if (!absolute) {
+        for (const QByteArray &domain : qAsConst(searchDomains))
+            searchNames.append(name + '.' + domain);
+    }
+    if (name.count('.') >= ndots)
+        query->candidates << name << searchNames;
+    else
+        query->candidates << searchNames << name;
+
+#if defined(QDNSSTUBRESOLVER_DEBUG)
+    qDebug() << "QDnsStubResolver::lookup()" << hostName << query->candidates;
+#endif
+
+    startCandidate(query);
+}
+
+void QDnsStubResolver::startCandidate(Query *query)
+{
+    query->server = 0;
+    query->attempt = 0;
+    for (int index = A; index <= AAAA; ++index) {
+        query->finished[index] = false;
+        query->nameError[index] = false;
+        query->addresses[index].clear();
+    }
+    sendQueries(query);
+}
+
+void QDnsStubResolver::sendQueries(Query *query)
+{
+    const QByteArray &name = query->candidates.at(query->candidate);
+    const Nameserver &nameserver = nameservers.at(query->server);
+    bool sent = false;
+    for (int index = A; index <= AAAA; ++index) {
+        if (query->finished[index])
+            continue;
+        // a fresh id for every transmission, late answers from the previous server are ignored
+        queries.remove(query->ids[index]);
+        query->ids[index] = nextQueryId();
+        const QByteArray packet = buildQuery(query->ids[index], name, index == A ? DnsTypeA : DnsTypeAAAA);
+        if (packet.isEmpty()) {
+            // not a valid DNS name
+            query->finished[index] = true;
+            query->nameError[index] = true;
+            continue;
+        }
+        queries.insert(query->ids[index], query);
+        if (query->socket->writeDatagram(packet, nameserver.address, nameserver.port) == packet.size())
+            sent = true;
+    }
+
+    if (query->finished[A] && query->finished[AAAA]) {
+        candidateFinished(query);
+        return;
+    }
+
+    query->deadline.setRemainingTime(sent ? timeout : 0);
+    if (!timer.isActive())
+        timer.start(DnsTimerInterval, Qt::CoarseTimer, this);
+}
+
+void QDnsStubResolver::retry(Query *query)
+{
+    if (++query->server >= nameservers.size()) {
+        query->server = 0;
+        if (++query->attempt >= attempts) {
+            QHostInfo hostInfo;
+            hostInfo.setHostName(query->hostName);
+            hostInfo.setError(QHostInfo::UnknownError);
+            hostInfo.setErrorString(query->serverFailure
+                                    ? QCoreApplication::translate("QHostInfoAgent", "Name server failure")
+                                    : QCoreApplication::translate("QHostInfoAgent", "Host lookup timed out"));
+            finish(query, hostInfo, 0);
+            return;
+        }
+    }
+    sendQueries(query);
+}
+
+void QDnsStubResolver::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != timer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    QSet<Query *> expired;
+    for (Query *query : qAsConst(queries)) {
+        if (query->deadline.hasExpired())
+            expired.insert(query);
+    }
+    for (Query *query : qAsConst(expired))
+        retry(query);
+
+    if (queries.isEmpty())
+        timer.stop();
+}
+
+void QDnsStubResolver::processDatagrams(QUdpSocket *socket)
+{
+    while (socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = socket->receiveDatagram();
+        const QByteArray response = datagram.data();
+        if (response.size() < DnsHeaderSize)
+            continue;
+
+        const quint16 id = qFromBigEndian<quint16>(response.constData());
+        Query *query = queries.value(id);
+        if (!query || query->socket != socket)
+            continue;
+        const Nameserver &nameserver = nameservers.at(query->server);
+        if (!datagram.senderAddress().isEqual(nameserver.address, QHostAddress::TolerantConversion)
+            || datagram.senderPort() != nameserver.port) {
+            continue;
+        }
+        processResponse(query, query->ids[A] == id ? A : AAAA, response);
+    }
+}
+
+void QDnsStubResolver::processResponse(Query *query, RecordIndex index, const QByteArray &response)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(response.constData());
+    const quint16 flags = qFromBigEndian<quint16>(data + 2);
+    const int questions = qFromBigEndian<quint16>(data + 4);
+    const int answers = qFromBigEndian<quint16>(data + 6);
+    const int authorities = qFromBigEndian<quint16>(data + 8);
+    const quint16 type = index == A ? DnsTypeA : DnsTypeAAAA;
+
+    if (!(flags & DnsFlagResponse) || questions != 1)
+        return;
+
+    // the answer must be for the question we asked
+    int offset = DnsHeaderSize;
+    QByteArray name;
+    if (!readName(response, &offset, &name) || offset + 4 > response.size())
+        return;
+    if (name.toLower() != query->candidates.at(query->candidate)
+        || qFromBigEndian<quint16>(data + offset) != type
+        || qFromBigEndian<quint16>(data + offset + 2) != DnsClassIN) {
+        return;
+    }
+    offset += 4;
+
+    if (flags & DnsFlagTruncated) {
+        // the answer didn't fit into a datagram; rather than taking part of
+        // it for all of it, let the system resolver do the lookup
+        queries.remove(query->ids[A]);
+        queries.remove(query->ids[AAAA]);
+        QHostInfoRunnable *runnable = query->runnable;
+        query->socket->deleteLater();
+        delete query;
+        runnable->fallBack();
+        return;
+    }
+
+    const int rcode = flags & DnsRcodeMask;
+    if (rcode != DnsRcodeNoError && rcode != DnsRcodeNameError) {
+        // SERVFAIL, REFUSED and friends: ask the next server
+        query->serverFailure = true;
+        retry(query);
+        return;
+    }
+
+    queries.remove(query->ids[index]);
+    query->ids[index] = 0;
+    query->finished[index] = true;
+    query->nameError[index] = rcode == DnsRcodeNameError;
+
+    for (int i = 0; i < answers + authorities; ++i) {
+        if (!skipName(response, &offset) || offset + 10 > response.size())
+            break;
+        const quint16 recordType = qFromBigEndian<quint16>(data + offset);
+        const quint16 recordClass = qFromBigEndian<quint16>(data + offset + 2);
+        const qint64 ttl = qFromBigEndian<quint32>(data + offset + 4) & 0x7fffffff;
+        const int length = qFromBigEndian<quint16>(data + offset + 8);
+        offset += 10;
+        if (offset + length > response.size() || recordClass != DnsClassIN)
+            break;
+
+        if (i < answers) {
+            // CNAME records before the addresses limit the TTL as well
+            query->ttl = query->ttl < 0 ? ttl : qMin(query->ttl, ttl);
+            if (recordType == DnsTypeA && length == 4) {
+                query->addresses[A].append(QHostAddress(qFromBigEndian<quint32>(data + offset)));
+            } else if (recordType == DnsTypeAAAA && length == 16) {
+                query->addresses[AAAA].append(QHostAddress(data + offset));
+            }
+        } else if (recordType == DnsTypeSOA && length >= 22) {
+            // RFC 2308: negative answers are cached for min(SOA TTL, SOA MINIMUM)
+            const qint64 minimum = qFromBigEndian<quint32>(data + offset + length - 4) & 0x7fffffff;
+            const qint64 negativeTtl = qMin(ttl, minimum);
+            query->negativeTtl = query->negativeTtl < 0 ? negativeTtl : qMin(query->negativeTtl, negativeTtl);
+        }
+        offset += length;
+    }
+
+#if defined(QDNSSTUBRESOLVER_DEBUG)
+    qDebug() << "QDnsStubResolver::processResponse()" << name << "type" << type << "rcode" << rcode
+             << query->addresses[index];
+#endif
+
+    if (query->finished[A] && query->finished[AAAA])
+        candidateFinished(query);
+}
+
+void QDnsStubResolver::candidateFinished(Query *query)
+{
+    QHostInfo hostInfo;
+    hostInfo.setHostName(query->hostName);
+
+    // IPv4 addresses first, same as the system resolver backend
+    const QList<QHostAddress> addresses = query->addresses[A] + query->addresses[AAAA];
+    if (!addresses.isEmpty()) {
+        hostInfo.setAddresses(addresses);
+        finish(query, hostInfo, query->ttl);
+        return;
+    }
+
+    if (++query->candidate < query->candidates.size()) {
+        startCandidate(query);
+        return;
+    }
+
+    hostInfo.setError(QHostInfo::HostNotFound);
+    hostInfo.setErrorString(QCoreApplication::translate("QHostInfoAgent", "Host not found"));
+    finish(query, hostInfo, query->negativeTtl);
+}
+
+void QDnsStubResolver::finish(Query *query, const QHostInfo &hostInfo, qint64 ttl)
+{
+    queries.remove(query->ids[A]);
+    queries.remove(query->ids[AAAA]);
+    QHostInfoRunnable *runnable = query->runnable;
+    // we might be called from the socket's readyRead()
+    query->socket->deleteLater();
+    delete query;
+    runnable->resolved(hostInfo, int(qMin<qint64>(ttl, INT_MAX)));
+}
+
+quint16 QDnsStubResolver::nextQueryId() const
+{
+    quint16 id;
+    do {
+        id = quint16(QRandomGenerator::generate());
+    } while (id == 0 || queries.contains(id));
+    return id;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QDNSSTUBRESOLVER_P_H
+#define QDNSSTUBRESOLVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QHostInfo class.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include "QtCore/qbasictimer.h"
+#include "QtCore/qdatetime.h"
+#include "QtCore/qdeadlinetimer.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qobject.h"
+#include "QtCore/qvector.h"
+#include "QtNetwork/qhostaddress.h"
+#include "QtNetwork/qhostinfo.h"
+
+QT_REQUIRE_CONFIG(dnsstubresolver);
+
+QT_BEGIN_NAMESPACE
+
+class QHostInfoRunnable;
+class QUdpSocket;
+
+class QDnsStubResolver : public QObject
+{
+    Q_OBJECT
+public:
+    struct Nameserver
+    {
+        QHostAddress address;
+        quint16 port;
+    };
+
+    explicit QDnsStubResolver(QObject *parent = nullptr);
+    ~QDnsStubResolver();
+
+    static bool canResolve(const QString &hostName);
+
+    void setNameservers(const QVector<Nameserver> &nameservers);
+    void lookup(QHostInfoRunnable *runnable, const QString &hostName);
+
+protected:
+    void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE;
+
+private:
+    enum RecordIndex { A, AAAA };
+
+    struct Query
+    {
+        QHostInfoRunnable *runnable;
+        QUdpSocket *socket;
+        QString hostName;
+        QList<QByteArray> candidates;
+        int candidate;
+        int server;
+        int attempt;
+        QDeadlineTimer deadline;
+
+        quint16 ids[2];
+        bool finished[2];
+        bool nameError[2];
+        QList<QHostAddress> addresses[2];
+        qint64 ttl;
+        qint64 negativeTtl;
+        bool serverFailure;
+    };
+
+    void readConfiguration();
+    bool lookupHostsFile(const QByteArray &name, QList<QHostAddress> *addresses);
+    void startCandidate(Query *query);
+    void sendQueries(Query *query);
+    void retry(Query *query);
+    void processDatagrams(QUdpSocket *socket);
+    void processResponse(Query *query, RecordIndex index, const QByteArray &response);
+    void candidateFinished(Query *query);
+    void finish(Query *query, const QHostInfo &hostInfo, qint64 ttl);
+    quint16 nextQueryId() const;
+
+    QBasicTimer timer;
+    QHash<quint16, Query *> queries;
+
+    bool explicitNameservers;
+    QVector<Nameserver> nameservers;
+    QList<QByteArray> searchDomains;
+    int ndots;
+    int timeout; // msecs
+    int attempts;
+    QDateTime configurationTimestamp;
+
+    QHash<QByteArray, QList<QHostAddress> > hosts;
+    QDateTime hostsTimestamp;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDNSSTUBRESOLVER_P_H
@@ -48,6 +48,9 @@
 #include <qthread.h>
 #include <qurl.h>
 #include <private/qnetworksession_p.h>
+#if QT_CONFIG(dnsstubresolver)
+#include "qdnsstubresolver_p.h"
+#endif
 
 #include <algorithm>
 
@@ -179,6 +182,12 @@ void emit_results_ready(const QHostInfo &hostInfo, const QObject *receiver,
     compared to previous versions of Qt.
     \note Since Qt 4.6.3 QHostInfo is using a small internal 60 second DNS cache
     for performance improvements.
+    \note Since Qt 5.10 failed lookups are cached as well, for a shorter time.
+    On Unix, if the environment variable \c QT_HOSTINFO_ASYNC_RESOLVER is set,
+    lookupHost() asks the name servers listed in \c /etc/resolv.conf directly
+    instead of blocking a thread of its thread pool in the system resolver.
+    The results are then cached according to the time-to-live of the DNS
+    records.
 
     \sa QAbstractSocket, {http://www.rfc-editor.org/rfc/rfc3492.txt}{RFC 3492}
 */
@@ -653,14 +662,14 @@ int QHostInfo::lookupHostImpl(const QString &name,
     return id;
 }
 
-QHostInfoRunnable::QHostInfoRunnable(const QString &hn, int i) : toBeLookedUp(hn), id(i)
+QHostInfoRunnable::QHostInfoRunnable(const QString &hn, int i) : toBeLookedUp(hn), id(i), asynchronous(false)
 {
     setAutoDelete(true);
 }
 
 QHostInfoRunnable::QHostInfoRunnable(const QString &hn, int i, const QObject *receiver,
                                      QtPrivate::QSlotObjectBase *slotObj) :
-    toBeLookedUp(hn), id(i), resultEmitter(receiver, slotObj)
+    toBeLookedUp(hn), id(i), asynchronous(false), resultEmitter(receiver, slotObj)
 {
     setAutoDelete(true);
 }
@@ -694,6 +703,15 @@ void QHostInfoRunnable::run()
         hostInfo = QHostInfoAgent::fromName(toBeLookedUp);
     }
 
+    finish(hostInfo);
+
+    // thread goes back to QThreadPool
+}
+
+void QHostInfoRunnable::finish(QHostInfo hostInfo)
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+
     // check aborted again
     if (manager->wasAborted(id)) {
         manager->lookupFinished(this);
@@ -721,15 +739,91 @@ void QHostInfoRunnable::run()
     }
 
     manager->lookupFinished(this);
+}
 
-    // thread goes back to QThreadPool
+#if QT_CONFIG(dnsstubresolver)
+// the QHostInfoLookupManager calls this in the thread of the asynchronous
+// resolver instead of handing the runnable to the thread pool
+void QHostInfoRunnable::runAsync(QDnsStubResolver *resolver)
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    if (!manager) {
+        // nobody is waiting for us anymore, and nobody else will delete us
+        delete this;
+        return;
+    }
+
+    // check aborted
+    if (manager->wasAborted(id)) {
+        manager->lookupFinished(this);
+        delete this;
+        return;
+    }
+
+    // might have been cache saved by another lookup in the meanwhile, see run()
+    if (manager->cache.isEnabled()) {
+        bool valid = false;
+        QHostInfo hostInfo = manager->cache.get(toBeLookedUp, &valid);
+        if (valid) {
+            finish(hostInfo);
+            delete this;
+            return;
+        }
+    }
+
+    resolver->lookup(this, toBeLookedUp);
+}
+
+// called by the asynchronous resolver with the result of the lookup and
+// its time-to-live in seconds, or -1 if it is not known
+void QHostInfoRunnable::resolved(const QHostInfo &hostInfo, int ttl)
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    if (!manager) {
+        // nobody is waiting for us anymore, and nobody else will delete us
+        delete this;
+        return;
+    }
+
+    if (manager->cache.isEnabled())
+        manager->cache.put(toBeLookedUp, hostInfo, ttl);
+    finish(hostInfo);
+    delete this;
+}
+
+// called by the asynchronous resolver when it can't do the lookup itself;
+// the runnable is then handed to the thread pool like any other
+void QHostInfoRunnable::fallBack()
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    if (!manager) {
+        delete this;
+        return;
+    }
+
+    QMutexLocker locker(&manager->mutex);
+    asynchronous = false;
+    manager->threadPool.start(this);
 }
+#endif
 
-QHostInfoLookupManager::QHostInfoLookupManager() : mutex(QMutex::Recursive), wasDeleted(false)
+QHostInfoLookupManager::QHostInfoLookupManager()
+    : mutex(QMutex::Recursive), wasDeleted(false)
 {
+#if QT_CONFIG(dnsstubresolver)
+    resolverThread = nullptr;
+    resolver = nullptr;
+    useResolver = false;
+#endif
     moveToThread(QCoreApplicationPrivate::mainThread());
     connect(QCoreApplication::instance(), SIGNAL(destroyed()), SLOT(waitForThreadPoolDone()), Qt::DirectConnection);
     threadPool.setMaxThreadCount(20); // do up to 20 DNS lookups in parallel
+#if QT_CONFIG(dnsstubresolver)
+    if (qEnvironmentVariableIsSet("QT_HOSTINFO_ASYNC_RESOLVER")) {
+        startResolver();
+        useResolver = true;
+    }
+#endif
 }
 
 QHostInfoLookupManager::~QHostInfoLookupManager()
@@ -738,8 +832,52 @@ QHostInfoLookupManager::~QHostInfoLookupManager()
 
     // don't qDeleteAll currentLookups, the QThreadPool has ownership
     clear();
+
+#if QT_CONFIG(dnsstubresolver)
+    if (resolverThread) {
+        resolverThread->quit();
+        resolverThread->wait();
+        delete resolver;
+        delete resolverThread;
+    }
+#endif
+}
+
+#if QT_CONFIG(dnsstubresolver)
+void QHostInfoLookupManager::startResolver()
+{
+    if (resolverThread)
+        return;
+    resolverThread = new QThread;
+    resolverThread->setObjectName(QStringLiteral("Qt DNS resolver"));
+    resolver = new QDnsStubResolver;
+    resolver->moveToThread(resolverThread);
+    resolverThread->start();
 }
 
+// Makes lookupHost() use the asynchronous resolver with the name server at
+// address and port, or go back to the system resolver if address is null.
+void QHostInfoLookupManager::setNameserver(const QHostAddress &address, quint16 port)
+{
+    if (wasDeleted)
+        return;
+
+    QMutexLocker locker(&mutex);
+    QVector<QDnsStubResolver::Nameserver> nameservers;
+    if (!address.isNull())
+        nameservers.append(QDnsStubResolver::Nameserver{ address, port });
+    else if (!resolverThread)
+        return;
+
+    startResolver();
+    QDnsStubResolver *stubResolver = resolver;
+    QMetaObject::invokeMethod(resolver, [stubResolver, nameservers] {
+        stubResolver->setNameservers(nameservers);
+    }, Qt::BlockingQueuedConnection);
+    useResolver = !address.isNull() || qEnvironmentVariableIsSet("QT_HOSTINFO_ASYNC_RESOLVER");
+}
+#endif
+
 void QHostInfoLookupManager::clear()
 {
     {
@@ -796,7 +934,33 @@ void QHostInfoLookupManager::work()
                                        isAlreadyRunning).second,
                            scheduledLookups.end());
 
-    const int availableThreads = threadPool.maxThreadCount() - currentLookups.size();
+#if QT_CONFIG(dnsstubresolver)
+    if (useResolver) {
+        // the asynchronous resolver doesn't need a thread for every lookup,
+        // start all the lookups it can do right away
+        auto isAsynchronous = [](QHostInfoRunnable *lookup) {
+            return QDnsStubResolver::canResolve(lookup->toBeLookedUp);
+        };
+        const auto asyncBegin = std::stable_partition(scheduledLookups.begin(), scheduledLookups.end(),
+                                                      [&](QHostInfoRunnable *lookup) { return !isAsynchronous(lookup); });
+        for (auto it = asyncBegin; it != scheduledLookups.end(); ++it) {
+            QHostInfoRunnable *runnable = *it;
+            QDnsStubResolver *stubResolver = resolver;
+            runnable->asynchronous = true;
+            QMetaObject::invokeMethod(resolver, [runnable, stubResolver] {
+                runnable->runAsync(stubResolver);
+            }, Qt::QueuedConnection);
+            currentLookups.push_back(runnable);
+        }
+        scheduledLookups.erase(asyncBegin, scheduledLookups.end());
+    }
+    const int runningThreads = int(std::count_if(currentLookups.cbegin(), currentLookups.cend(),
+                                                 [](QHostInfoRunnable *lookup) { return !lookup->asynchronous; }));
+#else
+    const int runningThreads = currentLookups.size();
+#endif
+
+    const int availableThreads = threadPool.maxThreadCount() - runningThreads;
     if (availableThreads > 0) {
         int readyToStartCount = qMin(availableThreads, scheduledLookups.size());
         auto it = scheduledLookups.begin();
@@ -918,11 +1082,25 @@ void qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolut
 
     manager->cache.put(hostname, resolution);
 }
+
+void qt_qhostinfo_set_nameserver(const QHostAddress &address, quint16 port)
+{
+#if QT_CONFIG(dnsstubresolver)
+    if (QHostInfoLookupManager *manager = theHostInfoLookupManager())
+        manager->setNameserver(address, port);
+#else
+    Q_UNUSED(address);
+    Q_UNUSED(port);
+#endif
+}
 #endif
 
-// cache for 60 seconds
+// cache for 60 seconds, or for the TTL of the answer up to an hour
+// cache failed lookups for 10 seconds, or for the negative TTL up to 5 minutes
 // cache 128 items
-QHostInfoCache::QHostInfoCache() : max_age(60), enabled(true), cache(128)
+QHostInfoCache::QHostInfoCache()
+    : max_age(60), max_ttl(3600), negative_max_age(10), negative_max_ttl(300),
+      enabled(true), cache(128)
 {
 #ifdef QT_QHOSTINFO_CACHE_DISABLED_BY_DEFAULT
     enabled = false;
@@ -948,7 +1126,7 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
 
     *valid = false;
     if (QHostInfoCacheElement *element = cache.object(name)) {
-        if (element->age.elapsed() < max_age*1000)
+        if (!element->expiry.hasExpired())
             *valid = true;
         return element->info;
 
@@ -960,16 +1138,32 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
     return QHostInfo();
 }
 
-void QHostInfoCache::put(const QString &name, const QHostInfo &info)
+/*
+    Caches \a info for \a name. \a ttl is the time to live in seconds
+    reported by the resolver, or -1 if it is not known (getaddrinfo() and
+    friends don't tell), in which case the default maximum age is used.
+
+    A host that doesn't exist is cached too, so that an application
+    repeatedly asking for it doesn't hit the network every time; any other
+    error is considered transient and not cached.
+*/
+void QHostInfoCache::put(const QString &name, const QHostInfo &info, int ttl)
 {
-    // if the lookup failed, don't cache
-    if (info.error() != QHostInfo::NoError)
+    int seconds;
+    if (info.error() == QHostInfo::NoError)
+        seconds = ttl < 0 ? max_age : qMin(ttl, max_ttl);
+    else if (info.error() == QHostInfo::HostNotFound)
+        seconds = ttl < 0 ? negative_max_age : qMin(ttl, negative_max_ttl);
+    else
+        return;
+
+    // the name server said not to cache it
+    if (seconds == 0)
         return;
 
     QHostInfoCacheElement* element = new QHostInfoCacheElement();
     element->info = info;
-    element->age = QElapsedTimer();
-    element->age.start();
+    element->expiry = QDeadlineTimer(qint64(seconds) * 1000);
 
     QMutexLocker locker(&this->mutex);
     cache.insert(name, element); // cache will take ownership
@@ -56,6 +56,7 @@
 #include "private/qcoreapplication_p.h"
 #include "private/qmetaobject_p.h"
 #include "QtNetwork/qhostinfo.h"
+#include "QtNetwork/qhostaddress.h"
 #include "QtCore/qmutex.h"
 #include "QtCore/qwaitcondition.h"
 #include "QtCore/qobject.h"
@@ -65,7 +66,7 @@
 #include "QtCore/qrunnable.h"
 #include "QtCore/qlist.h"
 #include "QtCore/qqueue.h"
-#include <QElapsedTimer>
+#include <QDeadlineTimer>
 #include <QCache>
 
 #include <QNetworkSession>
@@ -163,15 +164,19 @@ QHostInfo Q_NETWORK_EXPORT qt_qhostinfo_lookup(const QString &name, QObject *rec
 void Q_AUTOTEST_EXPORT qt_qhostinfo_clear_cache();
 void Q_AUTOTEST_EXPORT qt_qhostinfo_enable_cache(bool e);
 void Q_AUTOTEST_EXPORT qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolution);
+void Q_AUTOTEST_EXPORT qt_qhostinfo_set_nameserver(const QHostAddress &address, quint16 port);
 
 class QHostInfoCache
 {
 public:
     QHostInfoCache();
     const int max_age; // seconds
+    const int max_ttl; // seconds
+    const int negative_max_age; // seconds
+    const int negative_max_ttl; // seconds
 
     QHostInfo get(const QString &name, bool *valid);
-    void put(const QString &name, const QHostInfo &info);
+    void put(const QString &name, const QHostInfo &info, int ttl = -1);
     void clear();
 
     bool isEnabled();
@@ -180,12 +185,16 @@ private:
     bool enabled;
     struct QHostInfoCacheElement {
         QHostInfo info;
-        QElapsedTimer age;
+        QDeadlineTimer expiry;
     };
     QCache<QString,QHostInfoCacheElement> cache;
     QMutex mutex;
 };
 
+#if QT_CONFIG(dnsstubresolver)
+class QDnsStubResolver;
+#endif
+
 // the following classes are used for the (normal) case: We use multiple threads to lookup DNS
 
 class QHostInfoRunnable : public QRunnable
@@ -195,10 +204,19 @@ public:
     QHostInfoRunnable(const QString &hn, int i, const QObject *receiver,
                       QtPrivate::QSlotObjectBase *slotObj);
     void run() Q_DECL_OVERRIDE;
+#if QT_CONFIG(dnsstubresolver)
+    void runAsync(QDnsStubResolver *resolver);
+    void resolved(const QHostInfo &hostInfo, int ttl);
+    void fallBack();
+#endif
 
     QString toBeLookedUp;
     int id;
+    bool asynchronous; // done by the asynchronous resolver, not in the thread pool
     QHostInfoResult resultEmitter;
+
+private:
+    void finish(QHostInfo hostInfo);
 };
 
 
@@ -236,6 +254,10 @@ public:
     void lookupFinished(QHostInfoRunnable *r);
     bool wasAborted(int id);
 
+#if QT_CONFIG(dnsstubresolver)
+    void setNameserver(const QHostAddress &address, quint16 port);
+#endif
+
     friend class QHostInfoRunnable;
 protected:
     QList<QHostInfoRunnable*> currentLookups; // in progress
@@ -245,6 +267,12 @@ protected:
     QList<int> abortedLookups; // ids of aborted lookups
 
     QThreadPool threadPool;
+#if QT_CONFIG(dnsstubresolver)
+    QThread *resolverThread;
+    QDnsStubResolver *resolver;
+    bool useResolver;
+    void startResolver();
+#endif
 
     QMutex mutex;
 
@@ -594,6 +594,7 @@ void QAbstractSocketPrivate::resetSocketLayer()
 #endif
 
     hasPendingData = false;
+    pendingFiles.clear();
     if (socketEngine) {
         socketEngine->close();
         socketEngine->disconnect();
@@ -825,7 +826,7 @@ bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
     if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
-        && socketEngine->bytesToWrite() == 0)) {
+        && pendingFiles.isEmpty() && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
            (socketEngine && socketEngine->isValid()) ? "yes" : "no", writeBuffer.isEmpty() ? "yes" : "no");
@@ -842,7 +843,13 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
+    // Data written before a pending file goes out first.
+    if (!pendingFiles.isEmpty() && pendingFiles.constFirst().precedingBytes == 0)
+        return writeFileToSocket();
+
     qint64 nextSize = writeBuffer.nextDataBlockSize();
+    if (!pendingFiles.isEmpty())
+        nextSize = qMin(nextSize, pendingFiles.constFirst().precedingBytes);
     const char *ptr = writeBuffer.readPointer();
 
     // Attempt to write it all in one chunk.
@@ -866,12 +873,64 @@ bool QAbstractSocketPrivate::writeToSocket()
     if (written > 0) {
         // Remove what we wrote so far.
         writeBuffer.free(written);
+        if (!pendingFiles.isEmpty())
+            pendingFiles.first().precedingBytes -= written;
 
         // Emit notifications.
         emitBytesWritten(written);
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+    if (writeBuffer.isEmpty() && pendingFiles.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+        socketEngine->setWriteNotificationEnabled(false);
+    if (state == QAbstractSocket::ClosingState)
+        q->disconnectFromHost();
+
+    return written > 0;
+}
+
+/*! \internal
+
+    Writes as much as possible of the first file queued by
+    QAbstractSocket::sendFile() to the socket. Returns true if any data
+    was written; otherwise false is returned.
+*/
+bool QAbstractSocketPrivate::writeFileToSocket()
+{
+    Q_Q(QAbstractSocket);
+    PendingFile &pending = pendingFiles.first();
+    if (!pending.file || !pending.file->isOpen()) {
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("File was closed before it could be sent"));
+        q->abort();
+        return false;
+    }
+
+    qint64 written = socketEngine->sendFile(pending.file, pending.offset, pending.remaining);
+    if (written < 0) {
+#if defined (QABSTRACTSOCKET_DEBUG)
+        qDebug() << "QAbstractSocketPrivate::writeFileToSocket() write error, aborting."
+                 << socketEngine->errorString();
+#endif
+        setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+        q->abort();
+        return false;
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::writeFileToSocket() %lld bytes written to the network",
+           written);
+#endif
+
+    if (written > 0) {
+        pending.offset += written;
+        pending.remaining -= written;
+        if (pending.remaining == 0)
+            pendingFiles.removeFirst();
+
+        emitBytesWritten(written);
+    }
+
+    if (writeBuffer.isEmpty() && pendingFiles.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
         socketEngine->setWriteNotificationEnabled(false);
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
@@ -879,6 +938,18 @@ bool QAbstractSocketPrivate::writeToSocket()
     return written > 0;
 }
 
+/*! \internal
+
+    Returns the number of bytes of queued files that remain to be sent.
+*/
+qint64 QAbstractSocketPrivate::pendingFileBytes() const
+{
+    qint64 bytes = 0;
+    for (const PendingFile &pending : pendingFiles)
+        bytes += pending.remaining;
+    return bytes;
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -889,7 +960,7 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!allWriteBuffersEmpty() && writeToSocket())
+    while (hasPendingWrites() && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
@@ -1769,7 +1840,7 @@ void QAbstractSocket::connectToHost(const QHostAddress &address, quint16 port,
 */
 qint64 QAbstractSocket::bytesToWrite() const
 {
-    const qint64 pendingBytes = QIODevice::bytesToWrite();
+    const qint64 pendingBytes = QIODevice::bytesToWrite() + d_func()->pendingFileBytes();
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::bytesToWrite() == %lld", pendingBytes);
 #endif
@@ -2222,7 +2293,7 @@ bool QAbstractSocket::waitForReadyRead(int msecs)
 
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2274,7 +2345,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (!d->hasPendingWrites())
         return false;
 
     QElapsedTimer stopWatch;
@@ -2291,7 +2362,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite,
                                   !d->readBufferMaxSize || d->buffer.size() < d->readBufferMaxSize,
-                                  !d->writeBuffer.isEmpty(),
+                                  d->hasPendingWrites(),
                                   qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2370,7 +2441,7 @@ bool QAbstractSocket::waitForDisconnected(int msecs)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state() == ConnectedState,
-                                               !d->writeBuffer.isEmpty(),
+                                               d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2463,6 +2534,78 @@ bool QAbstractSocket::flush()
     return d_func()->flush();
 }
 
+/*!
+    \since 5.10
+
+    Queues \a length bytes of \a file, starting at \a offset, to be written
+    to the socket after any data that was previously written with write().
+    If \a length is -1 (the default), everything from \a offset to the end of
+    the file is sent. Returns \c true if the data was queued; otherwise
+    returns \c false.
+
+    On Linux, the contents of a file with a native handle are passed from
+    the file to an unencrypted TCP connection by the kernel with \c
+    sendfile(), without being copied into the socket's write buffer. On
+    other platforms, through proxies and for encrypted connections, the
+    data is read from \a file and written as if by write(). In either case,
+    bytesToWrite() includes the data that has not been sent yet and
+    bytesWritten() is emitted as it is written.
+
+    \a file must be open for reading and must stay open until all of the
+    data has been written; its current position is unspecified during the
+    transfer. If it is closed or deleted before that, the connection is
+    aborted.
+
+    \sa write(), bytesToWrite(), QFileDevice::handle()
+*/
+bool QAbstractSocket::sendFile(QFileDevice *file, qint64 offset, qint64 length)
+{
+    Q_D(QAbstractSocket);
+    if (!file || !file->isReadable()) {
+        qWarning("QAbstractSocket::sendFile: file is not open for reading");
+        return false;
+    }
+    if (!isWritable()) {
+        qWarning("QAbstractSocket::sendFile: device not open for writing");
+        return false;
+    }
+
+    const qint64 fileSize = file->size();
+    if (offset < 0 || offset > fileSize || length > fileSize - offset) {
+        qWarning("QAbstractSocket::sendFile: range exceeds the size of the file");
+        return false;
+    }
+    if (length < 0)
+        length = fileSize - offset;
+    if (length == 0)
+        return true;
+
+    if (d->socketEngine && d->socketType == TcpSocket && d->state != UnconnectedState) {
+        QAbstractSocketPrivate::PendingFile pending;
+        pending.file = file;
+        pending.offset = offset;
+        pending.remaining = length;
+        pending.precedingBytes = d->writeBuffer.size();
+        for (const QAbstractSocketPrivate::PendingFile &queued : qAsConst(d->pendingFiles))
+            pending.precedingBytes -= queued.precedingBytes;
+        d->pendingFiles.append(pending);
+        d->socketEngine->setWriteNotificationEnabled(true);
+        return true;
+    }
+
+    // The socket is not written to directly (QSslSocket, for instance),
+    // so fall back to copying the data.
+    if (!file->seek(offset))
+        return false;
+    while (length > 0) {
+        const QByteArray chunk = file->read(qMin<qint64>(length, QABSTRACTSOCKET_BUFFERSIZE));
+        if (chunk.isEmpty() || write(chunk) != chunk.size())
+            return false;
+        length -= chunk.size();
+    }
+    return true;
+}
+
 /*! \reimp
 */
 qint64 QAbstractSocket::readData(char *data, qint64 maxSize)
@@ -2516,7 +2659,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     }
 
     if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+        && d->socketEngine && d->writeBuffer.isEmpty() && d->pendingFiles.isEmpty()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = size ? d->socketEngine->write(data, size) : Q_INT64_C(0);
         if (written < 0) {
@@ -2746,7 +2889,7 @@ void QAbstractSocket::disconnectFromHost()
         }
 
         // Wait for pending data to be written.
-        if (d->socketEngine && d->socketEngine->isValid() && (!d->allWriteBuffersEmpty()
+        if (d->socketEngine && d->socketEngine->isValid() && (d->hasPendingWrites()
             || d->socketEngine->bytesToWrite() > 0)) {
             d->socketEngine->setWriteNotificationEnabled(true);
 
@@ -50,6 +50,7 @@
 QT_BEGIN_NAMESPACE
 
 
+class QFileDevice;
 class QHostAddress;
 #ifndef QT_NO_NETWORKPROXY
 class QNetworkProxy;
@@ -187,6 +188,8 @@ public:
     bool atEnd() const Q_DECL_OVERRIDE; // ### Qt6: remove me
     bool flush();
 
+    bool sendFile(QFileDevice *file, qint64 offset = 0, qint64 length = -1);
+
     // for synchronous access
     virtual bool waitForConnected(int msecs = 30000);
     bool waitForReadyRead(int msecs = 30000) Q_DECL_OVERRIDE;
@@ -55,7 +55,10 @@
 #include "QtNetwork/qabstractsocket.h"
 #include "QtCore/qbytearray.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qpointer.h"
 #include "QtCore/qtimer.h"
+#include "QtCore/qvector.h"
+#include "QtCore/qfiledevice.h"
 #include "private/qiodevice_p.h"
 #include "private/qabstractsocketengine_p.h"
 #include "qnetworkproxy.h"
@@ -130,6 +133,20 @@ public:
     void resetSocketLayer();
     virtual bool flush();
 
+    // a region of a file queued by sendFile(); it is sent once the first
+    // precedingBytes bytes of the write buffer have been written
+    struct PendingFile {
+        QPointer<QFileDevice> file;
+        qint64 offset;
+        qint64 remaining;
+        qint64 precedingBytes;
+    };
+    QVector<PendingFile> pendingFiles;
+    inline bool hasPendingWrites() const
+    { return !allWriteBuffersEmpty() || !pendingFiles.isEmpty(); }
+    qint64 pendingFileBytes() const;
+    bool writeFileToSocket();
+
     bool initSocketLayer(QAbstractSocket::NetworkLayerProtocol protocol);
     virtual void configureCreatedSocket();
     void startConnectingByName(const QString &host);
@@ -45,6 +45,7 @@
 #include "qnativesocketengine_winrt_p.h"
 #endif
 
+#include "qfiledevice.h"
 #include "qmutex.h"
 #include "qnetworkproxy.h"
 
@@ -149,6 +150,86 @@ void QAbstractSocketEngine::setError(QAbstractSocket::SocketError error, const Q
     d->socketErrorString = errorString;
 }
 
+/*!
+    \internal
+
+    Writes up to \a length bytes of \a file, starting at \a offset, to the
+    socket. Returns the number of bytes written, which may be 0 if the
+    socket cannot take more data right now, or -1 if an error occurred.
+
+    The default implementation reads a chunk of the file and passes it to
+    write(); engines that can send file contents without copying them
+    through user space reimplement it.
+*/
+qint64 QAbstractSocketEngine::sendFile(QFileDevice *file, qint64 offset, qint64 length)
+{
+    char buffer[16384];
+    if (!file->seek(offset)) {
+        setError(QAbstractSocket::UnknownSocketError, file->errorString());
+        return -1;
+    }
+    qint64 readBytes = file->read(buffer, qMin<qint64>(length, sizeof(buffer)));
+    if (readBytes <= 0) {
+        setError(QAbstractSocket::UnknownSocketError,
+                 readBytes < 0 ? file->errorString() : QAbstractSocket::tr("Unexpected end of file"));
+        return -1;
+    }
+    return write(buffer, readBytes);
+}
+
+#ifndef QT_NO_UDPSOCKET
+/*!
+    \internal
+
+    Reads up to \a maxCount datagrams into the buffers pointed to by
+    \a buffers, each of which must be able to hold \a maxSize bytes. Datagram
+    \e i is stored in \a buffers[\e i], its size in \a sizes[\e i] and its
+    header, filled according to \a options, in \a headers[\e i].
+
+    Returns the number of datagrams read, -2 if no datagram was available or
+    -1 if an error occurred before any datagram could be read.
+
+    The default implementation calls readDatagram() repeatedly; engines that
+    can receive several datagrams with one system call reimplement it.
+*/
+int QAbstractSocketEngine::readDatagrams(char * const *buffers, qint64 maxSize, int maxCount, qint64 *sizes,
+                                         QIpPacketHeader *headers, PacketHeaderOptions options)
+{
+    int count = 0;
+    while (count < maxCount) {
+        if (count && !hasPendingDatagrams())
+            break;
+        qint64 readBytes = readDatagram(buffers[count], maxSize, headers + count, options);
+        if (readBytes < 0)
+            return count ? count : int(readBytes);
+        sizes[count++] = readBytes;
+    }
+    return count;
+}
+
+/*!
+    \internal
+
+    Writes the \a count datagrams in \a datagrams, in order. Returns the
+    number of datagrams that were sent, -2 if the first one could not be
+    sent without blocking or -1 if it failed with an error.
+
+    The default implementation calls writeDatagram() repeatedly; engines that
+    can send several datagrams with one system call reimplement it.
+*/
+int QAbstractSocketEngine::writeDatagrams(const QNetworkDatagramPrivate * const *datagrams, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const QNetworkDatagramPrivate *datagram = datagrams[i];
+        qint64 sent = writeDatagram(datagram->data.constData(), datagram->data.size(),
+                                    datagram->header);
+        if (sent < 0)
+            return i ? i : int(sent);
+    }
+    return count;
+}
+#endif // QT_NO_UDPSOCKET
+
 void QAbstractSocketEngine::setReceiver(QAbstractSocketEngineReceiver *receiver)
 {
     d_func()->receiver = receiver;
@@ -61,6 +61,7 @@
 QT_BEGIN_NAMESPACE
 
 class QAuthenticator;
+class QFileDevice;
 class QAbstractSocketEnginePrivate;
 #ifndef QT_NO_NETWORKINTERFACE
 class QNetworkInterface;
@@ -105,7 +106,8 @@ public:
         TypeOfServiceOption,
         ReceivePacketInformation,
         ReceiveHopLimit,
-        MaxStreamsSocketOption
+        MaxStreamsSocketOption,
+        ReusePortOption
     };
 
     enum PacketHeaderOption {
@@ -139,6 +141,7 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 sendFile(QFileDevice *file, qint64 offset, qint64 length);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -152,6 +155,10 @@ public:
 
     virtual bool hasPendingDatagrams() const = 0;
     virtual qint64 pendingDatagramSize() const = 0;
+
+    virtual int readDatagrams(char * const *buffers, qint64 maxSize, int maxCount, qint64 *sizes,
+                              QIpPacketHeader *headers, PacketHeaderOptions = WantNone);
+    virtual int writeDatagrams(const QNetworkDatagramPrivate * const *datagrams, int count);
 #endif // QT_NO_UDPSOCKET
 
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = 0,
@@ -119,6 +119,7 @@
 #include <qabstracteventdispatcher.h>
 #include <qsocketnotifier.h>
 #include <qnetworkinterface.h>
+#include <qfiledevice.h>
 
 #include <private/qthread_p.h>
 #include <private/qobject_p.h>
@@ -902,6 +903,40 @@ qint64 QNativeSocketEngine::writeDatagram(const char *data, qint64 size, const Q
     return d->nativeSendDatagram(data, size, header);
 }
 
+#if !defined(QT_NO_UDPSOCKET) && QT_CONFIG(recvmmsg)
+/*!
+    \reimp
+
+    Receives up to \a maxCount datagrams with a single system call.
+*/
+int QNativeSocketEngine::readDatagrams(char * const *buffers, qint64 maxSize, int maxCount, qint64 *sizes,
+                                       QIpPacketHeader *headers, PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+    return d->nativeReceiveDatagrams(buffers, maxSize, maxCount, sizes, headers, options);
+}
+
+/*!
+    \reimp
+
+    Sends the \a count datagrams in \a datagrams with as few system calls as
+    possible.
+*/
+int QNativeSocketEngine::writeDatagrams(const QNetworkDatagramPrivate * const *datagrams, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+    return d->nativeSendDatagrams(datagrams, count);
+}
+#endif
+
 /*!
     Writes a block of \a size bytes from \a data to the socket.
     Returns the number of bytes written, or -1 if an error occurred.
@@ -924,6 +959,28 @@ qint64 QNativeSocketEngine::bytesToWrite() const
     return 0;
 }
 
+#if QT_CONFIG(sendfile)
+/*!
+    \reimp
+
+    Lets the kernel copy up to \a length bytes of \a file, starting at \a
+    offset, to the socket. Files without a native handle, and files the
+    kernel cannot send from, are copied through user space instead.
+*/
+qint64 QNativeSocketEngine::sendFile(QFileDevice *file, qint64 offset, qint64 length)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+
+    const int fd = file->handle();
+    qint64 written = fd == -1 ? qint64(-2) : d->nativeSendFile(fd, offset, length);
+    if (written == -2)
+        return QAbstractSocketEngine::sendFile(file, offset, length);
+    return written;
+}
+#endif
+
 /*!
     Reads up to \a maxSize bytes into \a data from the socket.
     Returns the number of bytes read, or -1 if an error occurred.
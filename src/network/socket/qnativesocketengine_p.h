@@ -159,12 +159,21 @@ public:
 
     bool hasPendingDatagrams() const Q_DECL_OVERRIDE;
     qint64 pendingDatagramSize() const Q_DECL_OVERRIDE;
+
+#if QT_CONFIG(recvmmsg)
+    int readDatagrams(char * const *buffers, qint64 maxSize, int maxCount, qint64 *sizes,
+                      QIpPacketHeader *headers, PacketHeaderOptions = WantNone) Q_DECL_OVERRIDE;
+    int writeDatagrams(const QNetworkDatagramPrivate * const *datagrams, int count) Q_DECL_OVERRIDE;
+#endif
 #endif // QT_NO_UDPSOCKET
 
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = 0,
                         PacketHeaderOptions = WantNone) Q_DECL_OVERRIDE;
     qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &) Q_DECL_OVERRIDE;
     qint64 bytesToWrite() const Q_DECL_OVERRIDE;
+#if QT_CONFIG(sendfile)
+    qint64 sendFile(QFileDevice *file, qint64 offset, qint64 length) Q_DECL_OVERRIDE;
+#endif
 
 #if 0   // currently unused
     qint64 receiveBufferSize() const;
@@ -277,8 +286,17 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#if QT_CONFIG(recvmmsg)
+    int nativeReceiveDatagrams(char * const *buffers, qint64 maxSize, int maxCount, qint64 *sizes,
+                               QIpPacketHeader *headers,
+                               QAbstractSocketEngine::PacketHeaderOptions options);
+    int nativeSendDatagrams(const QNetworkDatagramPrivate * const *datagrams, int count);
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+#if QT_CONFIG(sendfile)
+    qint64 nativeSendFile(int fileDescriptor, qint64 offset, qint64 length);
+#endif
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
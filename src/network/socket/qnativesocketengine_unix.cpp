@@ -61,6 +61,9 @@
 #ifdef Q_OS_INTEGRITY
 #include <sys/uio.h>
 #endif
+#if QT_CONFIG(sendfile)
+#include <sys/sendfile.h>
+#endif
 
 #if defined QNATIVESOCKETENGINE_DEBUG
 #include <qstring.h>
@@ -226,6 +229,13 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
 #endif
         }
         break;
+    case QNativeSocketEngine::ReusePortOption:
+        // only Linux distributes incoming connections among the sockets
+        // sharing a port; elsewhere, SO_REUSEPORT has different semantics
+#if defined(Q_OS_LINUX) && defined(SO_REUSEPORT)
+        n = SO_REUSEPORT;
+#endif
+        break;
     }
 }
 
@@ -410,6 +420,8 @@ bool QNativeSocketEnginePrivate::setOption(QNativeSocketEngine::SocketOption opt
 
     int n, level;
     convertToLevelAndOption(opt, socketProtocol, level, n);
+    if (n == -1)
+        return false;
 #if defined(SO_REUSEPORT) && !defined(Q_OS_LINUX)
     if (opt == QNativeSocketEngine::AddressReusable) {
         // on OS X, SO_REUSEADDR isn't sufficient to allow multiple binds to the
@@ -905,170 +917,112 @@ qint64 QNativeSocketEnginePrivate::nativePendingDatagramSize() const
     return qint64(recvResult);
 }
 
-qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
-                                                         QAbstractSocketEngine::PacketHeaderOptions options)
-{
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+// we use quintptr to force the alignment
+enum {
+    ReceiveControlBufferSize = (CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
 #if !defined(IP_PKTINFO) && defined(IP_RECVIF) && defined(Q_OS_BSD4)
-                   + CMSG_SPACE(sizeof(sockaddr_dl))
+                                + CMSG_SPACE(sizeof(sockaddr_dl))
 #endif
 #ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+                                + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
 #endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
-
-    struct msghdr msg;
-    struct iovec vec;
-    qt_sockaddr aa;
-    char c;
-    memset(&msg, 0, sizeof(msg));
-    memset(&aa, 0, sizeof(aa));
-
-    // we need to receive at least one byte, even if our user isn't interested in it
-    vec.iov_base = maxSize ? data : &c;
-    vec.iov_len = maxSize ? maxSize : 1;
-    msg.msg_iov = &vec;
-    msg.msg_iovlen = 1;
-    if (options & QAbstractSocketEngine::WantDatagramSender) {
-        msg.msg_name = &aa;
-        msg.msg_namelen = sizeof(aa);
-    }
-    if (options & (QAbstractSocketEngine::WantDatagramHopLimit | QAbstractSocketEngine::WantDatagramDestination
-                   | QAbstractSocketEngine::WantStreamNumber)) {
-        msg.msg_control = cbuf;
-        msg.msg_controllen = sizeof(cbuf);
-    }
-
-    ssize_t recvResult = 0;
-    do {
-        recvResult = ::recvmsg(socketDescriptor, &msg, 0);
-    } while (recvResult == -1 && errno == EINTR);
-
-    if (recvResult == -1) {
-        switch (errno) {
-#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
-        case EWOULDBLOCK:
+                                + sizeof(quintptr) - 1) / sizeof(quintptr),
+    SendControlBufferSize = (CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+#ifndef QT_NO_SCTP
+                             + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
 #endif
-        case EAGAIN:
-            // No datagram was available for reading
-            recvResult = -2;
-            break;
-        case ECONNREFUSED:
-            setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
-            break;
-        default:
-            setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+                             + sizeof(quintptr) - 1) / sizeof(quintptr)
+};
+
+/*
+    Fills \a header from the sender address in \a aa and the ancillary data
+    of the received message \a msg.
+*/
+static void qt_socket_parseDatagramHeader(struct msghdr *msg, const qt_sockaddr *aa,
+                                          quint16 localPort, QIpPacketHeader *header)
+{
+    qt_socket_getPortAndAddress(aa, &header->senderPort, &header->senderAddress);
+    header->destinationPort = localPort;
+    header->endOfRecord = (msg->msg_flags & MSG_EOR) != 0;
+
+    // parse the ancillary data
+    struct cmsghdr *cmsgptr;
+    for (cmsgptr = CMSG_FIRSTHDR(msg); cmsgptr != NULL;
+         cmsgptr = CMSG_NXTHDR(msg, cmsgptr)) {
+        if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
+            in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
+            header->ifindex = info->ipi6_ifindex;
+            if (header->ifindex)
+                header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
         }
-        if (header)
-            header->clear();
-    } else if (options != QAbstractSocketEngine::WantNone) {
-        Q_ASSERT(header);
-        qt_socket_getPortAndAddress(&aa, &header->senderPort, &header->senderAddress);
-        header->destinationPort = localPort;
-        header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
-
-        // parse the ancillary data
-        struct cmsghdr *cmsgptr;
-        for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != NULL;
-             cmsgptr = CMSG_NXTHDR(&msg, cmsgptr)) {
-            if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
-                in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
-                header->ifindex = info->ipi6_ifindex;
-                if (header->ifindex)
-                    header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
-            }
 
 #ifdef IP_PKTINFO
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
-                in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
+            in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
 
-                header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
-                header->ifindex = info->ipi_ifindex;
-            }
+            header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
+            header->ifindex = info->ipi_ifindex;
+        }
 #else
 #  ifdef IP_RECVDSTADDR
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
-                in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
+            in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
 
-                header->destinationAddress.setAddress(ntohl(addr->s_addr));
-            }
+            header->destinationAddress.setAddress(ntohl(addr->s_addr));
+        }
 #  endif
 #  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
-                sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
-                header->ifindex = sdl->sdl_index;
-            }
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
+            sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
+            header->ifindex = sdl->sdl_index;
+        }
 #  endif
 #endif
 
-            if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
-                    && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
-                        || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
-                Q_STATIC_ASSERT(sizeof(header->hopLimit) == sizeof(int));
-                memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
-            }
+        if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
+                && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
+                    || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
+            Q_STATIC_ASSERT(sizeof(header->hopLimit) == sizeof(int));
+            memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
+        }
 
 #ifndef QT_NO_SCTP
-            if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
-                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
-                sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
+        if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
+            && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
+            sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
 
-                header->streamNumber = int(rcvInfo->sinfo_stream);
-            }
-#endif
+            header->streamNumber = int(rcvInfo->sinfo_stream);
         }
-    }
-
-#if defined (QNATIVESOCKETENGINE_DEBUG)
-    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagram(%p \"%s\", %lli, %s, %i) == %lli",
-           data, qt_prettyDebug(data, qMin(recvResult, ssize_t(16)), recvResult).data(), maxSize,
-           (recvResult != -1 && options != QAbstractSocketEngine::WantNone)
-           ? header->senderAddress.toString().toLatin1().constData() : "(unknown)",
-           (recvResult != -1 && options != QAbstractSocketEngine::WantNone)
-           ? header->senderPort : 0, (qint64) recvResult);
 #endif
-
-    return qint64((maxSize || recvResult < 0) ? recvResult : Q_INT64_C(0));
+    }
 }
 
-qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+/*
+    Prepares \a msg for sending a datagram as described by \a header: the
+    destination is stored in \a aa and the ancillary data in \a cbuf, which
+    must hold SendControlBufferSize elements.
+*/
+static void qt_socket_prepareDatagramMessage(QNativeSocketEnginePrivate *d, const QIpPacketHeader &header,
+                                             struct msghdr *msg, qt_sockaddr *aa, quintptr *cbuf)
 {
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
-#ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
-#endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
-
     struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(cbuf);
-    struct msghdr msg;
-    struct iovec vec;
-    qt_sockaddr aa;
-
-    memset(&msg, 0, sizeof(msg));
-    memset(&aa, 0, sizeof(aa));
-    vec.iov_base = const_cast<char *>(data);
-    vec.iov_len = len;
-    msg.msg_iov = &vec;
-    msg.msg_iovlen = 1;
-    msg.msg_control = &cbuf;
+    msg->msg_control = cbuf;
 
     if (header.destinationPort != 0) {
-        msg.msg_name = &aa.a;
-        setPortAndAddress(header.destinationPort, header.destinationAddress,
-                          &aa, &msg.msg_namelen);
+        msg->msg_name = &aa->a;
+        d->setPortAndAddress(header.destinationPort, header.destinationAddress,
+                             aa, &msg->msg_namelen);
     }
 
-    if (msg.msg_namelen == sizeof(aa.a6)) {
+    if (msg->msg_namelen == sizeof(aa->a6)) {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_HOPLIMIT;
@@ -1078,7 +1032,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         if (header.ifindex != 0 || !header.senderAddress.isNull()) {
             struct in6_pktinfo *data = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
             memset(data, 0, sizeof(*data));
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_PKTINFO;
@@ -1090,7 +1044,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         }
     } else {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IP;
             cmsgptr->cmsg_type = IP_TTL;
@@ -1112,7 +1066,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
             data->s_addr = htonl(header.senderAddress.toIPv4Address());
 #  endif
             cmsgptr->cmsg_level = IPPROTO_IP;
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
         }
@@ -1123,7 +1077,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     if (header.streamNumber != -1) {
         struct sctp_sndrcvinfo *data = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
         memset(data, 0, sizeof(*data));
-        msg.msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
+        msg->msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_len = CMSG_LEN(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_level = IPPROTO_SCTP;
         cmsgptr->cmsg_type =  SCTP_SNDRCV;
@@ -1132,8 +1086,92 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     }
 #endif
 
-    if (msg.msg_controllen == 0)
-        msg.msg_control = 0;
+    if (msg->msg_controllen == 0)
+        msg->msg_control = 0;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
+                                                         QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    quintptr cbuf[ReceiveControlBufferSize];
+
+    struct msghdr msg;
+    struct iovec vec;
+    qt_sockaddr aa;
+    char c;
+    memset(&msg, 0, sizeof(msg));
+    memset(&aa, 0, sizeof(aa));
+
+    // we need to receive at least one byte, even if our user isn't interested in it
+    vec.iov_base = maxSize ? data : &c;
+    vec.iov_len = maxSize ? maxSize : 1;
+    msg.msg_iov = &vec;
+    msg.msg_iovlen = 1;
+    if (options & QAbstractSocketEngine::WantDatagramSender) {
+        msg.msg_name = &aa;
+        msg.msg_namelen = sizeof(aa);
+    }
+    if (options & (QAbstractSocketEngine::WantDatagramHopLimit | QAbstractSocketEngine::WantDatagramDestination
+                   | QAbstractSocketEngine::WantStreamNumber)) {
+        msg.msg_control = cbuf;
+        msg.msg_controllen = sizeof(cbuf);
+    }
+
+    ssize_t recvResult = 0;
+    do {
+        recvResult = ::recvmsg(socketDescriptor, &msg, 0);
+    } while (recvResult == -1 && errno == EINTR);
+
+    if (recvResult == -1) {
+        switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            // No datagram was available for reading
+            recvResult = -2;
+            break;
+        case ECONNREFUSED:
+            setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+        }
+        if (header)
+            header->clear();
+    } else if (options != QAbstractSocketEngine::WantNone) {
+        Q_ASSERT(header);
+        qt_socket_parseDatagramHeader(&msg, &aa, localPort, header);
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagram(%p \"%s\", %lli, %s, %i) == %lli",
+           data, qt_prettyDebug(data, qMin(recvResult, ssize_t(16)), recvResult).data(), maxSize,
+           (recvResult != -1 && options != QAbstractSocketEngine::WantNone)
+           ? header->senderAddress.toString().toLatin1().constData() : "(unknown)",
+           (recvResult != -1 && options != QAbstractSocketEngine::WantNone)
+           ? header->senderPort : 0, (qint64) recvResult);
+#endif
+
+    return qint64((maxSize || recvResult < 0) ? recvResult : Q_INT64_C(0));
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+{
+    quintptr cbuf[SendControlBufferSize];
+
+    struct msghdr msg;
+    struct iovec vec;
+    qt_sockaddr aa;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&aa, 0, sizeof(aa));
+    vec.iov_base = const_cast<char *>(data);
+    vec.iov_len = len;
+    msg.msg_iov = &vec;
+    msg.msg_iovlen = 1;
+    qt_socket_prepareDatagramMessage(this, header, &msg, &aa, cbuf);
+
     ssize_t sentBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
 
     if (sentBytes < 0) {
@@ -1165,6 +1203,134 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+#if QT_CONFIG(recvmmsg)
+// upper bound for the number of messages handed to the kernel in one go;
+// Linux rejects more than UIO_MAXIOV (1024) anyway
+enum { MaxDatagramBatchSize = 64 };
+
+int QNativeSocketEnginePrivate::nativeReceiveDatagrams(char * const *buffers, qint64 maxSize, int maxCount,
+                                                       qint64 *sizes, QIpPacketHeader *headers,
+                                                       QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    const bool wantSender = options & QAbstractSocketEngine::WantDatagramSender;
+    const bool wantControl = options & (QAbstractSocketEngine::WantDatagramHopLimit
+                                        | QAbstractSocketEngine::WantDatagramDestination
+                                        | QAbstractSocketEngine::WantStreamNumber);
+    const int batchSize = qMin<int>(maxCount, MaxDatagramBatchSize);
+
+    struct mmsghdr msgs[MaxDatagramBatchSize];
+    struct iovec vecs[MaxDatagramBatchSize];
+    qt_sockaddr addrs[MaxDatagramBatchSize];
+    quintptr cbufs[MaxDatagramBatchSize][ReceiveControlBufferSize];
+    char c;
+
+    memset(msgs, 0, batchSize * sizeof(mmsghdr));
+    for (int i = 0; i < batchSize; ++i) {
+        // we need to receive at least one byte, even if our user isn't interested in it
+        vecs[i].iov_base = maxSize ? buffers[i] : &c;
+        vecs[i].iov_len = maxSize ? maxSize : 1;
+        msgs[i].msg_hdr.msg_iov = &vecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        if (wantSender) {
+            memset(&addrs[i], 0, sizeof(qt_sockaddr));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(qt_sockaddr);
+        }
+        if (wantControl) {
+            msgs[i].msg_hdr.msg_control = cbufs[i];
+            msgs[i].msg_hdr.msg_controllen = sizeof(cbufs[i]);
+        }
+    }
+
+    int received = qt_safe_recvmmsg(socketDescriptor, msgs, batchSize, 0);
+
+    if (received == -1) {
+        switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            // No datagram was available for reading
+            return -2;
+        case ENOSYS:
+            // kernel without recvmmsg(); fall back to one recvmsg() per datagram
+            return q_func()->QAbstractSocketEngine::readDatagrams(buffers, maxSize, maxCount, sizes,
+                                                                 headers, options);
+        case ECONNREFUSED:
+            setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+        }
+        return -1;
+    }
+
+    for (int i = 0; i < received; ++i) {
+        sizes[i] = maxSize ? qint64(msgs[i].msg_len) : Q_INT64_C(0);
+        if (options != QAbstractSocketEngine::WantNone)
+            qt_socket_parseDatagramHeader(&msgs[i].msg_hdr, &addrs[i], localPort, &headers[i]);
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%p, %lli, %i) == %i",
+           buffers, maxSize, maxCount, received);
+#endif
+
+    return received;
+}
+
+int QNativeSocketEnginePrivate::nativeSendDatagrams(const QNetworkDatagramPrivate * const *datagrams,
+                                                    int count)
+{
+    const int batchSize = qMin<int>(count, MaxDatagramBatchSize);
+
+    struct mmsghdr msgs[MaxDatagramBatchSize];
+    struct iovec vecs[MaxDatagramBatchSize];
+    qt_sockaddr addrs[MaxDatagramBatchSize];
+    quintptr cbufs[MaxDatagramBatchSize][SendControlBufferSize];
+
+    memset(msgs, 0, batchSize * sizeof(mmsghdr));
+    memset(addrs, 0, batchSize * sizeof(qt_sockaddr));
+    for (int i = 0; i < batchSize; ++i) {
+        const QNetworkDatagramPrivate *datagram = datagrams[i];
+        vecs[i].iov_base = const_cast<char *>(datagram->data.constData());
+        vecs[i].iov_len = datagram->data.size();
+        msgs[i].msg_hdr.msg_iov = &vecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        qt_socket_prepareDatagramMessage(this, datagram->header, &msgs[i].msg_hdr, &addrs[i], cbufs[i]);
+    }
+
+    int sent = qt_safe_sendmmsg(socketDescriptor, msgs, batchSize, 0);
+
+    if (sent == -1) {
+        switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            return -2;
+        case ENOSYS:
+            return q_func()->QAbstractSocketEngine::writeDatagrams(datagrams, count);
+        case EMSGSIZE:
+            setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+            break;
+        case ECONNRESET:
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
+        }
+        return -1;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%p, %i) == %i", datagrams, count, sent);
+#endif
+
+    return sent;
+}
+#endif // QT_CONFIG(recvmmsg)
+
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
     localPort = 0;
@@ -1330,6 +1496,61 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+#if QT_CONFIG(sendfile)
+/*
+    Returns -2 if the kernel cannot send from this file, in which case the
+    caller copies the data instead.
+*/
+qint64 QNativeSocketEnginePrivate::nativeSendFile(int fileDescriptor, qint64 offset, qint64 length)
+{
+    Q_Q(QNativeSocketEngine);
+
+    // the kernel refuses to transfer more than this in one call anyway
+    const qint64 maxChunk = 0x7ffff000;
+    off_t fileOffset = offset;
+    ssize_t writtenBytes;
+    EINTR_LOOP(writtenBytes, ::sendfile(socketDescriptor, fileDescriptor, &fileOffset,
+                                        size_t(qMin(length, maxChunk))));
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        case EINVAL:
+        case ENOSYS:
+        case EOVERFLOW:
+            writtenBytes = -2;
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, WriteErrorString);
+            break;
+        }
+    } else if (writtenBytes == 0 && length > 0) {
+        // the file is shorter than it was when the transfer was queued
+        writtenBytes = -1;
+        setError(QAbstractSocket::UnknownSocketError, WriteErrorString);
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%d, %lld, %lld) == %lld",
+           fileDescriptor, offset, length, qint64(writtenBytes));
+#endif
+
+    return qint64(writtenBytes);
+}
+#endif
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
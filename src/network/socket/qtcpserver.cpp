@@ -124,6 +124,7 @@ QTcpServerPrivate::QTcpServerPrivate()
  , socketEngine(0)
  , serverSocketError(QAbstractSocket::UnknownSocketError)
  , maxConnections(30)
+ , portSharingEnabled(false)
 {
 }
 
@@ -329,6 +330,13 @@ bool QTcpServer::listen(const QHostAddress &address, quint16 port)
 
     d->configureCreatedSocket();
 
+    if (d->portSharingEnabled
+        && !d->socketEngine->setOption(QAbstractSocketEngine::ReusePortOption, 1)) {
+        d->serverSocketError = QAbstractSocket::UnsupportedSocketOperationError;
+        d->serverSocketErrorString = tr("Port sharing is not supported on this platform");
+        return false;
+    }
+
     if (!d->socketEngine->bind(addr, port)) {
         d->serverSocketError = d->socketEngine->error();
         d->serverSocketErrorString = d->socketEngine->errorString();
@@ -657,6 +665,49 @@ int QTcpServer::maxPendingConnections() const
     return d_func()->maxConnections;
 }
 
+/*!
+    \since 5.10
+
+    If \a enabled is true, the next call to listen() allows other servers
+    that enabled port sharing as well to listen on the same address and
+    port, and the operating system distributes the incoming connections
+    among them. This lets an application accept connections in several
+    threads: each thread runs its own event loop and owns its own
+    QTcpServer, so newConnection() is emitted, and the accepted sockets
+    live, in that thread.
+
+    \code
+    // in each acceptor thread
+    QTcpServer server;
+    server.setPortSharingEnabled(true);
+    server.listen(QHostAddress::Any, 8080);
+    \endcode
+
+    All servers must listen on the same, explicitly chosen, port. Port
+    sharing is supported on Linux; on other platforms listen() fails with
+    QAbstractSocket::UnsupportedSocketOperationError while it is enabled.
+
+    Port sharing is disabled by default.
+
+    \sa isPortSharingEnabled(), listen()
+*/
+void QTcpServer::setPortSharingEnabled(bool enabled)
+{
+    d_func()->portSharingEnabled = enabled;
+}
+
+/*!
+    \since 5.10
+
+    Returns \c true if port sharing is enabled; otherwise returns \c false.
+
+    \sa setPortSharingEnabled()
+*/
+bool QTcpServer::isPortSharingEnabled() const
+{
+    return d_func()->portSharingEnabled;
+}
+
 /*!
     Returns an error code for the last error that occurred.
 
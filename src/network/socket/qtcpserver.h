@@ -69,6 +69,9 @@ public:
     void setMaxPendingConnections(int numConnections);
     int maxPendingConnections() const;
 
+    void setPortSharingEnabled(bool enabled);
+    bool isPortSharingEnabled() const;
+
     quint16 serverPort() const;
     QHostAddress serverAddress() const;
 
@@ -84,6 +84,7 @@ public:
     QString serverSocketErrorString;
 
     int maxConnections;
+    bool portSharingEnabled;
 
 #ifndef QT_NO_NETWORKPROXY
     QNetworkProxy proxy;
@@ -133,12 +133,18 @@ int runRcc(int argc, char *argv[])
     QCommandLineOption nocompressOption(QStringLiteral("no-compress"), QStringLiteral("Disable all compression."));
     parser.addOption(nocompressOption);
 
+    QCommandLineOption compressAlgoOption(QStringLiteral("compress-algo"), QStringLiteral("Compress input files using algorithm <algo> (zlib, zstd or none)."), QStringLiteral("algo"));
+    parser.addOption(compressAlgoOption);
+
     QCommandLineOption thresholdOption(QStringLiteral("threshold"), QStringLiteral("Threshold to consider compressing files."), QStringLiteral("level"));
     parser.addOption(thresholdOption);
 
     QCommandLineOption binaryOption(QStringLiteral("binary"), QStringLiteral("Output a binary file for use as a dynamic resource."));
     parser.addOption(binaryOption);
 
+    QCommandLineOption alignOption(QStringLiteral("align"), QStringLiteral("Align uncompressed data in a binary file to <bytes>, e.g. the page size, so it can be mapped without copying."), QStringLiteral("bytes"));
+    parser.addOption(alignOption);
+
     QCommandLineOption passOption(QStringLiteral("pass"), QStringLiteral("Pass number for big resources"), QStringLiteral("number"));
     parser.addOption(passOption);
 
@@ -165,14 +171,21 @@ int runRcc(int argc, char *argv[])
 
     QString errorMsg;
 
-    quint8 formatVersion = 2;
+    RCCResourceLibrary::CompressionAlgorithm compressionAlgo = RCCResourceLibrary::CompressionAlgorithm::Zlib;
+    if (parser.isSet(compressAlgoOption))
+        compressionAlgo = RCCResourceLibrary::parseCompressionAlgorithm(parser.value(compressAlgoOption), &errorMsg);
+
+    // Zstandard compressed files need format version 3, which older Qt versions cannot read
+    quint8 formatVersion = compressionAlgo == RCCResourceLibrary::CompressionAlgorithm::Zstd ? 3 : 2;
     if (parser.isSet(formatVersionOption)) {
         bool ok = false;
         formatVersion = parser.value(formatVersionOption).toUInt(&ok);
         if (!ok) {
             errorMsg = QLatin1String("Invalid format version specified");
-        } else if (formatVersion != 1 && formatVersion != 2) {
+        } else if (formatVersion < 1 || formatVersion > 3) {
             errorMsg = QLatin1String("Unsupported format version specified");
+        } else if (formatVersion < 3 && compressionAlgo == RCCResourceLibrary::CompressionAlgorithm::Zstd) {
+            errorMsg = QLatin1String("Zstandard compression requires format version 3");
         }
     }
 
@@ -191,8 +204,19 @@ int runRcc(int argc, char *argv[])
         library.setCompressLevel(-2);
     if (parser.isSet(thresholdOption))
         library.setCompressThreshold(parser.value(thresholdOption).toInt());
+    library.setCompressionAlgorithm(compressionAlgo);
     if (parser.isSet(binaryOption))
         library.setFormat(RCCResourceLibrary::Binary);
+    if (parser.isSet(alignOption)) {
+        bool ok = false;
+        const int alignment = parser.value(alignOption).toInt(&ok);
+        if (!ok || alignment <= 0)
+            errorMsg = QLatin1String("Invalid alignment specified");
+        else if (!parser.isSet(binaryOption))
+            errorMsg = QLatin1String("Alignment is only supported for binary output");
+        else
+            library.setAlignment(alignment);
+    }
     if (parser.isSet(passOption)) {
         if (parser.value(passOption) == QLatin1String("1"))
             library.setFormat(RCCResourceLibrary::Pass1);
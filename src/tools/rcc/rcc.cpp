@@ -37,10 +37,15 @@
 #include <qiodevice.h>
 #include <qlocale.h>
 #include <qstack.h>
+#include <qvector.h>
 #include <qxmlstream.h>
 
 #include <algorithm>
 
+#if QT_CONFIG(zstd)
+#  include <zstd.h>
+#endif
+
 // Note: A copy of this file is used in Qt Designer (qttools/src/designer/src/lib/shared/rcc.cpp)
 
 QT_BEGIN_NAMESPACE
@@ -48,7 +53,9 @@ QT_BEGIN_NAMESPACE
 enum {
     CONSTANT_USENAMESPACE = 1,
     CONSTANT_COMPRESSLEVEL_DEFAULT = -1,
-    CONSTANT_COMPRESSTHRESHOLD_DEFAULT = 70
+    CONSTANT_COMPRESSTHRESHOLD_DEFAULT = 70,
+    CONSTANT_ZSTDCOMPRESSLEVEL_DEFAULT = 14,
+    CONSTANT_ZSTD_FRAMESIZE = 64 * 1024
 };
 
 
@@ -90,13 +97,15 @@ public:
     {
         NoFlags = 0x00,
         Compressed = 0x01,
-        Directory = 0x02
+        Directory = 0x02,
+        CompressedZstd = 0x04
     };
 
     RCCFileInfo(const QString &name = QString(), const QFileInfo &fileInfo = QFileInfo(),
                 QLocale::Language language = QLocale::C,
                 QLocale::Country country = QLocale::AnyCountry,
                 uint flags = NoFlags,
+                RCCResourceLibrary::CompressionAlgorithm compressAlgo = RCCResourceLibrary::CompressionAlgorithm::Zlib,
                 int compressLevel = CONSTANT_COMPRESSLEVEL_DEFAULT,
                 int compressThreshold = CONSTANT_COMPRESSTHRESHOLD_DEFAULT);
     ~RCCFileInfo();
@@ -115,6 +124,7 @@ public:
     QFileInfo m_fileInfo;
     RCCFileInfo *m_parent;
     QHash<QString, RCCFileInfo*> m_children;
+    RCCResourceLibrary::CompressionAlgorithm m_compressAlgo;
     int m_compressLevel;
     int m_compressThreshold;
 
@@ -125,7 +135,7 @@ public:
 
 RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo,
     QLocale::Language language, QLocale::Country country, uint flags,
-    int compressLevel, int compressThreshold)
+    RCCResourceLibrary::CompressionAlgorithm compressAlgo, int compressLevel, int compressThreshold)
 {
     m_name = name;
     m_fileInfo = fileInfo;
@@ -136,6 +146,7 @@ RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo,
     m_nameOffset = 0;
     m_dataOffset = 0;
     m_childOffset = 0;
+    m_compressAlgo = compressAlgo;
     m_compressLevel = compressLevel;
     m_compressThreshold = compressThreshold;
 }
@@ -213,6 +224,57 @@ void RCCFileInfo::writeDataInfo(RCCResourceLibrary &lib)
     }
 }
 
+#if QT_CONFIG(zstd)
+static inline void appendLittleEndian32(QByteArray *out, quint32 number)
+{
+    out->append(char(number));
+    out->append(char(number >> 8));
+    out->append(char(number >> 16));
+    out->append(char(number >> 24));
+}
+
+// Compresses data as a sequence of independent Zstandard frames, each holding
+// at most CONSTANT_ZSTD_FRAMESIZE bytes of input, and appends a seek table in
+// the Zstandard seekable format. QResourceFileEngine uses the seek table to
+// decompress only the frames that are actually read.
+static QByteArray zstdCompress(const QByteArray &data, int level)
+{
+    ZSTD_CCtx *context = ZSTD_createCCtx();
+    if (!context)
+        return QByteArray();
+
+    QByteArray out;
+    QVector<QPair<quint32, quint32> > frames;
+    for (int pos = 0; pos < data.size(); pos += CONSTANT_ZSTD_FRAMESIZE) {
+        const int chunk = qMin(int(CONSTANT_ZSTD_FRAMESIZE), data.size() - pos);
+        const int start = out.size();
+        out.resize(start + int(ZSTD_compressBound(chunk)));
+        const size_t n = ZSTD_compressCCtx(context, out.data() + start, out.size() - start,
+                                           data.constData() + pos, chunk, level);
+        if (ZSTD_isError(n)) {
+            ZSTD_freeCCtx(context);
+            return QByteArray();
+        }
+        out.resize(start + int(n));
+        frames.append(qMakePair(quint32(n), quint32(chunk)));
+    }
+    ZSTD_freeCCtx(context);
+
+    // skippable frame header, the seek table entries (without checksums) and
+    // the seek table footer
+    appendLittleEndian32(&out, 0x184D2A5E);
+    appendLittleEndian32(&out, quint32(frames.size() * 8 + 9));
+    for (const QPair<quint32, quint32> &frame : qAsConst(frames)) {
+        appendLittleEndian32(&out, frame.first);
+        appendLittleEndian32(&out, frame.second);
+    }
+    appendLittleEndian32(&out, quint32(frames.size()));
+    out.append(char(0));
+    appendLittleEndian32(&out, 0x8F92EAB1);
+    return out;
+}
+#endif // QT_CONFIG(zstd)
+
 qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
     QString *errorMessage)
 {
@@ -221,9 +283,6 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
     const bool pass2 = lib.m_format == RCCResourceLibrary::Pass2;
     const bool binary = lib.m_format == RCCResourceLibrary::Binary;
 
-    //capture the offset
-    m_dataOffset = offset;
-
     //find the data to be written
     QFile file(m_fileInfo.absoluteFilePath());
     if (!file.open(QFile::ReadOnly)) {
@@ -232,19 +291,50 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
     }
     QByteArray data = file.readAll();
 
-#ifndef QT_NO_COMPRESS
     // Check if compression is useful for this file
     if (m_compressLevel != 0 && data.size() != 0) {
-        QByteArray compressed =
-            qCompress(reinterpret_cast<uchar *>(data.data()), data.size(), m_compressLevel);
+        QByteArray compressed;
+        int flag = NoFlags;
+        switch (m_compressAlgo) {
+        case RCCResourceLibrary::CompressionAlgorithm::Zlib:
+#ifndef QT_NO_COMPRESS
+            compressed = qCompress(reinterpret_cast<uchar *>(data.data()), data.size(), m_compressLevel);
+            flag = Compressed;
+#endif
+            break;
+        case RCCResourceLibrary::CompressionAlgorithm::Zstd:
+#if QT_CONFIG(zstd)
+            // a high level only costs build time, decompression is as fast
+            compressed = zstdCompress(data, m_compressLevel == CONSTANT_COMPRESSLEVEL_DEFAULT
+                                            ? int(CONSTANT_ZSTDCOMPRESSLEVEL_DEFAULT) : m_compressLevel);
+            flag = CompressedZstd;
+#endif
+            break;
+        case RCCResourceLibrary::CompressionAlgorithm::None:
+            break;
+        }
 
-        int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
-        if (compressRatio >= m_compressThreshold) {
-            data = compressed;
-            m_flags |= Compressed;
+        if (!compressed.isEmpty()) {
+            int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
+            if (compressRatio >= m_compressThreshold) {
+                data = compressed;
+                m_flags |= flag;
+                lib.m_overallFlags |= flag;
+            }
         }
     }
-#endif // QT_NO_COMPRESS
+
+    // align the payload, which follows the length, so it can be mapped directly
+    if (binary && lib.m_alignment > 1 && !(m_flags & (Compressed | CompressedZstd))
+            && data.size() != 0) {
+        const qint64 payloadPos = lib.m_dataOffset + offset + 4;
+        const int padding = int((lib.m_alignment - payloadPos % lib.m_alignment) % lib.m_alignment);
+        lib.m_out.append(QByteArray(padding, '\0'));
+        offset += padding;
+    }
+
+    //capture the offset
+    m_dataOffset = offset;
 
     // some info
     if (text || pass1) {
@@ -339,7 +429,8 @@ RCCResourceLibrary::Strings::Strings() :
    ATTRIBUTE_PREFIX(QLatin1String("prefix")),
    ATTRIBUTE_ALIAS(QLatin1String("alias")),
    ATTRIBUTE_THRESHOLD(QLatin1String("threshold")),
-   ATTRIBUTE_COMPRESS(QLatin1String("compress"))
+   ATTRIBUTE_COMPRESS(QLatin1String("compress")),
+   ATTRIBUTE_COMPRESSALGO(QLatin1String("compression-algorithm"))
 {
 }
 
@@ -349,6 +440,9 @@ RCCResourceLibrary::RCCResourceLibrary(quint8 formatVersion)
     m_verbose(false),
     m_compressLevel(CONSTANT_COMPRESSLEVEL_DEFAULT),
     m_compressThreshold(CONSTANT_COMPRESSTHRESHOLD_DEFAULT),
+    m_compressionAlgo(CompressionAlgorithm::Zlib),
+    m_alignment(0),
+    m_overallFlags(0),
     m_treeOffset(0),
     m_namesOffset(0),
     m_dataOffset(0),
@@ -365,6 +459,29 @@ RCCResourceLibrary::~RCCResourceLibrary()
     delete m_root;
 }
 
+RCCResourceLibrary::CompressionAlgorithm
+RCCResourceLibrary::parseCompressionAlgorithm(const QString &name, QString *errorMsg)
+{
+    if (name == QLatin1String("zlib")) {
+#ifndef QT_NO_COMPRESS
+        return CompressionAlgorithm::Zlib;
+#else
+        *errorMsg = QLatin1String("zlib support not compiled in");
+#endif
+    } else if (name == QLatin1String("zstd")) {
+#if QT_CONFIG(zstd)
+        return CompressionAlgorithm::Zstd;
+#else
+        *errorMsg = QLatin1String("Zstandard support not compiled in");
+#endif
+    } else if (name == QLatin1String("none")) {
+        return CompressionAlgorithm::None;
+    } else {
+        *errorMsg = QString::fromLatin1("Unknown compression algorithm '%1'").arg(name);
+    }
+    return CompressionAlgorithm::None;
+}
+
 enum RCCXmlTag {
     RccTag,
     ResourceTag,
@@ -387,6 +504,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
     QLocale::Language language = QLocale::c().language();
     QLocale::Country country = QLocale::c().country();
     QString alias;
+    CompressionAlgorithm compressAlgo = m_compressionAlgo;
     int compressLevel = m_compressLevel;
     int compressThreshold = m_compressThreshold;
 
@@ -440,6 +558,16 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                     if (attributes.hasAttribute(m_strings.ATTRIBUTE_ALIAS))
                         alias = attributes.value(m_strings.ATTRIBUTE_ALIAS).toString();
 
+                    compressAlgo = m_compressionAlgo;
+                    if (attributes.hasAttribute(m_strings.ATTRIBUTE_COMPRESSALGO)) {
+                        QString errorString;
+                        compressAlgo = parseCompressionAlgorithm(attributes.value(m_strings.ATTRIBUTE_COMPRESSALGO).toString(), &errorString);
+                        if (!errorString.isEmpty())
+                            reader.raiseError(errorString);
+                        else if (compressAlgo == CompressionAlgorithm::Zstd && m_formatVersion < 3)
+                            reader.raiseError(QLatin1String("Zstandard compression requires format version 3"));
+                    }
+
                     compressLevel = m_compressLevel;
                     if (attributes.hasAttribute(m_strings.ATTRIBUTE_COMPRESS))
                         compressLevel = attributes.value(m_strings.ATTRIBUTE_COMPRESS).toString().toInt();
@@ -517,6 +645,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                                             language,
                                             country,
                                             RCCFileInfo::NoFlags,
+                                            compressAlgo,
                                             compressLevel,
                                             compressThreshold)
                                 );
@@ -546,6 +675,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                                                     language,
                                                     country,
                                                     child.isDir() ? RCCFileInfo::Directory : RCCFileInfo::NoFlags,
+                                                    compressAlgo,
                                                     compressLevel,
                                                     compressThreshold)
                                         );
@@ -892,6 +1022,8 @@ bool RCCResourceLibrary::writeHeader()
         writeNumber4(0);
         writeNumber4(0);
         writeNumber4(0);
+        if (m_formatVersion >= 3)
+            writeNumber4(m_overallFlags);
     }
     return true;
 }
@@ -1098,6 +1230,11 @@ bool RCCResourceLibrary::writeInitializer()
             writeString("bool qUnregisterResourceData"
                 "(int, const unsigned char *, "
                 "const unsigned char *, const unsigned char *);\n\n");
+
+            if (m_overallFlags & RCCFileInfo::CompressedZstd) {
+                // Fail to link against a Qt that cannot decompress the data
+                writeString("bool qResourceFeatureZstd();\n\n");
+            }
         }
 
         if (m_useNameSpace)
@@ -1116,6 +1253,11 @@ bool RCCResourceLibrary::writeInitializer()
         writeString("()\n{\n");
 
         if (m_root) {
+            if (m_overallFlags & RCCFileInfo::CompressedZstd) {
+                writeString("    ");
+                writeAddNamespaceFunction("qResourceFeatureZstd");
+                writeString("();\n");
+            }
             writeString("    ");
             writeAddNamespaceFunction("qRegisterResourceData");
             writeString("\n        (");
@@ -1179,6 +1321,13 @@ bool RCCResourceLibrary::writeInitializer()
         p[i++] = (m_namesOffset >> 16) & 0xff;
         p[i++] = (m_namesOffset >>  8) & 0xff;
         p[i++] = (m_namesOffset >>  0) & 0xff;
+
+        if (m_formatVersion >= 3) {
+            p[i++] = (m_overallFlags >> 24) & 0xff;
+            p[i++] = (m_overallFlags >> 16) & 0xff;
+            p[i++] = (m_overallFlags >>  8) & 0xff;
+            p[i++] = (m_overallFlags >>  0) & 0xff;
+        }
     }
     return true;
 }
@@ -83,6 +83,15 @@ public:
     void setCompressThreshold(int t) { m_compressThreshold = t; }
     int compressThreshold() const { return m_compressThreshold; }
 
+    enum class CompressionAlgorithm { Zlib, Zstd, None = -1 };
+    static CompressionAlgorithm parseCompressionAlgorithm(const QString &name, QString *errorMsg);
+    void setCompressionAlgorithm(CompressionAlgorithm algo) { m_compressionAlgo = algo; }
+    CompressionAlgorithm compressionAlgorithm() const { return m_compressionAlgo; }
+
+    // Alignment of the data of uncompressed files in binary output, 0 for none.
+    void setAlignment(int a) { m_alignment = a; }
+    int alignment() const { return m_alignment; }
+
     void setResourceRoot(const QString &root) { m_resourceRoot = root; }
     QString resourceRoot() const { return m_resourceRoot; }
 
@@ -104,6 +113,7 @@ private:
         const QString ATTRIBUTE_ALIAS;
         const QString ATTRIBUTE_THRESHOLD;
         const QString ATTRIBUTE_COMPRESS;
+        const QString ATTRIBUTE_COMPRESSALGO;
     };
     friend class RCCFileInfo;
     void reset();
@@ -135,6 +145,9 @@ private:
     bool m_verbose;
     int m_compressLevel;
     int m_compressThreshold;
+    CompressionAlgorithm m_compressionAlgo;
+    int m_alignment;
+    int m_overallFlags;
     int m_treeOffset;
     int m_namesOffset;
     int m_dataOffset;
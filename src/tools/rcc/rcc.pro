@@ -6,5 +6,14 @@ DEFINES += QT_RCC QT_NO_CAST_FROM_ASCII QT_NO_FOREACH
 include(rcc.pri)
 SOURCES += main.cpp
 
+QT_FOR_CONFIG += core-private
+# The zstd library found by configure is the target's, which a host tool
+# cannot link against when cross-compiling.
+qtConfig(zstd):!cross_compile {
+    # The bootstrap library does not see the configure results.
+    DEFINES += QT_FEATURE_zstd=1
+    QMAKE_USE_PRIVATE += zstd
+}
+
 QMAKE_TARGET_DESCRIPTION = "Qt Resource Compiler"
 load(qt_tool)
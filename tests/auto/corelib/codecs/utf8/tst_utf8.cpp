@@ -30,6 +30,7 @@
 
 #include <qtextcodec.h>
 #include <QScopedPointer>
+#include <private/qutfcodec_p.h>
 
 static const char utf8bom[] = "\xEF\xBB\xBF";
 
@@ -61,6 +62,11 @@ private slots:
 
     void nonCharacters_data();
     void nonCharacters();
+
+    void invalidUtf8InContext_data();
+    void invalidUtf8InContext();
+    void invalidUtf16InContext_data();
+    void invalidUtf16InContext();
 };
 
 void tst_Utf8::initTestCase()
@@ -264,5 +270,157 @@ void tst_Utf8::nonCharacters()
         qWarning("System codec reports failure when it shouldn't. Should report bug upstream.");
 }
 
+// The rows below put an invalid sequence at every offset of a run of
+// multi-byte characters long enough for the SIMD code paths to kick in
+// (those only look at blocks of 16 bytes or 8 characters). The expected
+// result is what the scalar code alone produces.
+static QString scalarFromUtf8(const QByteArray &utf8)
+{
+    QString result(utf8.size(), Qt::Uninitialized);
+    ushort *dst = reinterpret_cast<ushort *>(result.data());
+    const uchar *src = reinterpret_cast<const uchar *>(utf8.constData());
+    const uchar *const end = src + utf8.size();
+    while (src < end) {
+        const uchar b = *src++;
+        if (QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, src, end) < 0)
+            *dst++ = QChar::ReplacementCharacter;
+    }
+    result.truncate(dst - reinterpret_cast<const ushort *>(result.constData()));
+    return result;
+}
+
+static QByteArray scalarToUtf8(const QString &utf16)
+{
+    QByteArray result(utf16.size() * 3, Qt::Uninitialized);
+    uchar *dst = reinterpret_cast<uchar *>(result.data());
+    const ushort *src = reinterpret_cast<const ushort *>(utf16.constData());
+    const ushort *const end = src + utf16.size();
+    while (src < end) {
+        const ushort uc = *src++;
+        if (QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, dst, src, end) < 0)
+            *dst++ = '?';
+    }
+    result.truncate(dst - reinterpret_cast<const uchar *>(result.constData()));
+    return result;
+}
+
+void tst_Utf8::invalidUtf8InContext_data()
+{
+    QTest::addColumn<QByteArray>("sequence");
+    QTest::addColumn<QByteArray>("filler");
+
+    const struct {
+        const char *name;
+        const char *sequence;
+    } sequences[] = {
+        { "c0", "\xC0\x80" },
+        { "c1", "\xC1\xBF" },
+        { "c1-alone", "\xC1" },
+        { "overlong-e0-1", "\xE0\x80\x80" },
+        { "overlong-e0-2", "\xE0\x9F\xBF" },
+        { "overlong-f0-1", "\xF0\x80\x80\x80" },
+        { "overlong-f0-2", "\xF0\x8F\xBF\xBF" },
+        { "surrogate-ed-a0", "\xED\xA0\x80" },
+        { "surrogate-ed-bf", "\xED\xBF\xBF" },
+        { "surrogate-pair", "\xED\xA0\x80\xED\xB0\x80" },
+        { "above-10ffff-f4", "\xF4\x90\x80\x80" },
+        { "above-10ffff-f5", "\xF5\x80\x80\x80" },
+        { "truncated-2", "\xD0" },
+        { "truncated-3-1", "\xE4" },
+        { "truncated-3-2", "\xE4\xB8" },
+        { "truncated-4-3", "\xF0\x9F\x98" },
+        { "extra-continuation-1", "\x80" },
+        { "extra-continuation-2", "\xD0\xB4\xB4" },
+        { "extra-continuation-3", "\xE4\xB8\xAD\xAD\xBF" },
+        { "valid-4", "\xF0\x9F\x98\x80" }
+    };
+    const struct {
+        const char *name;
+        const char *character;
+    } fillers[] = {
+        { "cyrillic", "\xD0\xB4" },
+        { "cjk", "\xE4\xB8\xAD" }
+    };
+
+    for (const auto &filler : fillers) {
+        for (const auto &sequence : sequences) {
+            QTest::newRow(QByteArray(sequence.name).append('/').append(filler.name))
+                    << QByteArray(sequence.sequence) << QByteArray(filler.character);
+        }
+    }
+}
+
+void tst_Utf8::invalidUtf8InContext()
+{
+    QFETCH(QByteArray, sequence);
+    QFETCH(QByteArray, filler);
+
+    const QByteArray suffix = filler.repeated(32 / filler.size() + 1);
+    for (int offset = 0; offset < 34; ++offset) {
+        // ASCII to get to offsets that aren't a multiple of the filler's size
+        QByteArray utf8(offset % filler.size(), 'a');
+        utf8 += filler.repeated(offset / filler.size());
+        utf8 += sequence;
+        utf8 += suffix;
+
+        const QString expected = scalarFromUtf8(utf8);
+        const QByteArray message = "at offset " + QByteArray::number(offset);
+        QVERIFY2(from8Bit(utf8) == expected, message);
+        const QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+        QVERIFY2(decoder->toUnicode(utf8) == expected, message);
+    }
+}
+
+void tst_Utf8::invalidUtf16InContext_data()
+{
+    QTest::addColumn<QString>("sequence");
+    QTest::addColumn<QChar>("filler");
+
+    const struct {
+        const char *name;
+        ushort sequence[3];
+    } sequences[] = {
+        { "lone-high", { 0xd83d } },
+        { "lone-low", { 0xde00 } },
+        { "pair", { 0xd83d, 0xde00 } },
+        { "reversed-pair", { 0xde00, 0xd83d } },
+        { "two-highs", { 0xd83d, 0xd83d, 0xde00 } },
+        { "two-lows", { 0xd83d, 0xde00, 0xde00 } }
+    };
+    const struct {
+        const char *name;
+        ushort character;
+    } fillers[] = {
+        { "cyrillic", 0x0434 },
+        { "cjk", 0x4e2d }
+    };
+
+    for (const auto &filler : fillers) {
+        for (const auto &sequence : sequences) {
+            QTest::newRow(QByteArray(sequence.name).append('/').append(filler.name))
+                    << QString::fromUtf16(sequence.sequence, sequence.sequence[2] ? 3 : sequence.sequence[1] ? 2 : 1)
+                    << QChar(filler.character);
+        }
+    }
+}
+
+void tst_Utf8::invalidUtf16InContext()
+{
+    QFETCH(QString, sequence);
+    QFETCH(QChar, filler);
+
+    for (int offset = 0; offset < 18; ++offset) {
+        QString utf16(offset, filler);
+        utf16 += sequence;
+        utf16 += QString(16, filler);
+
+        const QByteArray expected = scalarToUtf8(utf16);
+        const QByteArray message = "at offset " + QByteArray::number(offset);
+        QVERIFY2(to8Bit(utf16) == expected, message);
+        const QScopedPointer<QTextEncoder> encoder(codec->makeEncoder(QTextCodec::IgnoreHeader));
+        QVERIFY2(encoder->fromUnicode(utf16) == expected, message);
+    }
+}
+
 QTEST_MAIN(tst_Utf8)
 #include "tst_utf8.moc"
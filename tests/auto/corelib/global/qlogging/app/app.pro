@@ -9,6 +9,7 @@ CONFIG -= app_bundle
 CONFIG += console
 
 SOURCES += main.cpp
+unix: SOURCES += fork.cpp
 DEFINES += QT_MESSAGELOGCONTEXT
 
 gcc:!mingw:!haiku {
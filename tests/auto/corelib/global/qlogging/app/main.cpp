@@ -82,6 +82,20 @@ int main(int argc, char **argv)
     MyClass cl;
     QMetaObject::invokeMethod(&cl, "mySlot1");
 
+#ifdef Q_OS_UNIX
+    if (app.arguments().contains(QLatin1String("--fork"))) {
+        int logAfterFork(); // in fork.cpp, not to move the lines tst_qlogging checks
+        return logAfterFork();
+    }
+#endif
+
+    if (app.arguments().contains(QLatin1String("--fatal"))) {
+        qSetMessagePattern("%{message}");
+        for (int i = 0; i < 1000; ++i)
+            qInfo("%d", i);
+        qFatal("fatal");
+    }
+
     return 0;
 }
 
@@ -59,6 +59,12 @@ private slots:
     void qMessagePattern_data();
     void qMessagePattern();
     void setMessagePattern();
+    void asyncOutput_data();
+    void asyncOutput();
+    void asyncOutputFlushedOnFatal_data();
+    void asyncOutputFlushedOnFatal();
+    void asyncOutputAfterFork_data();
+    void asyncOutputAfterFork();
 
     void formatLogMessage_data();
     void formatLogMessage();
@@ -897,6 +903,132 @@ void tst_qmessagehandler::setMessagePattern()
 #endif // QT_CONFIG(process)
 }
 
+void tst_qmessagehandler::asyncOutput_data()
+{
+    QTest::addColumn<QByteArray>("mode");
+    QTest::newRow("block") << QByteArray("block");
+    QTest::newRow("drop") << QByteArray("drop");
+}
+
+void tst_qmessagehandler::asyncOutput()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    QFETCH(QByteArray, mode);
+
+    QProcess process;
+    const QString appExe = m_appDir + "/app";
+
+    QStringList environment = m_baseEnvironment;
+    environment.prepend("QT_LOGGING_ASYNC=" + QString::fromLatin1(mode));
+    process.setEnvironment(environment);
+
+    process.start(appExe);
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    process.waitForFinished();
+
+    // the same output as with synchronous output, and no messages dropped
+    QByteArray output = process.readAllStandardError();
+    QByteArray expected = "static constructor\n"
+            "[debug] qDebug\n"
+            "[info] qInfo\n"
+            "[warning] qWarning\n"
+            "[critical] qCritical\n"
+            "[warning] qDebug with category\n";
+#ifdef Q_OS_WIN
+    output.replace("\r\n", "\n");
+#endif
+    QCOMPARE(QString::fromLatin1(output), QString::fromLatin1(expected));
+#endif // QT_CONFIG(process)
+}
+
+void tst_qmessagehandler::asyncOutputFlushedOnFatal_data()
+{
+    asyncOutput_data();
+}
+
+void tst_qmessagehandler::asyncOutputFlushedOnFatal()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    QFETCH(QByteArray, mode);
+
+    QProcess process;
+    const QString appExe = m_appDir + "/app";
+
+    QStringList environment = m_baseEnvironment;
+    environment.prepend("QT_LOGGING_ASYNC=" + QString::fromLatin1(mode));
+    environment.prepend("QT_LOGGING_ASYNC_CAPACITY=16");
+    process.setEnvironment(environment);
+
+    process.start(appExe, QStringList() << "--fatal");
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    process.waitForFinished();
+    QCOMPARE(process.exitStatus(), QProcess::CrashExit);
+
+    QByteArray output = process.readAllStandardError();
+#ifdef Q_OS_WIN
+    output.replace("\r\n", "\n");
+#endif
+    if (mode == "drop") {
+        // messages may have been dropped, but not the fatal one
+        QVERIFY(output.endsWith("\nfatal\n"));
+    } else {
+        QByteArray expected;
+        for (int i = 0; i < 1000; ++i)
+            expected += QByteArray::number(i) + '\n';
+        expected += "fatal\n";
+        QVERIFY(output.endsWith(expected));
+    }
+#endif // QT_CONFIG(process)
+}
+
+void tst_qmessagehandler::asyncOutputAfterFork_data()
+{
+    asyncOutput_data();
+}
+
+void tst_qmessagehandler::asyncOutputAfterFork()
+{
+#if !QT_CONFIG(process) || !defined(Q_OS_UNIX)
+    QSKIP("This test requires QProcess and fork()");
+#else
+    QFETCH(QByteArray, mode);
+
+    QProcess process;
+    const QString appExe = m_appDir + "/app";
+
+    // the child doesn't have the writer thread; it must neither lose its
+    // messages nor wait for the writer once the ring is full
+    QStringList environment = m_baseEnvironment;
+    environment.prepend("QT_LOGGING_ASYNC=" + QString::fromLatin1(mode));
+    environment.prepend("QT_LOGGING_ASYNC_CAPACITY=16");
+    process.setEnvironment(environment);
+
+    process.start(appExe, QStringList() << "--fork");
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    QVERIFY(process.waitForFinished(60000));
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+
+    QByteArray output = process.readAllStandardError();
+    QByteArray childOutput;
+    for (const QByteArray &line : output.split('\n')) {
+        if (line.startsWith("child "))
+            childOutput += line + '\n';
+    }
+    QByteArray expected;
+    for (int i = 0; i < 2000; ++i)
+        expected += "child " + QByteArray::number(i) + '\n';
+    QCOMPARE(childOutput, expected);
+    QVERIFY(output.contains("\nparent 0\n"));
+#endif // QT_CONFIG(process)
+}
+
 Q_DECLARE_METATYPE(QtMsgType)
 
 void tst_qmessagehandler::formatLogMessage_data()
@@ -36,6 +36,9 @@
 #include <qstringlist.h>
 
 #include <QtCore/private/qfsfileengine_p.h>
+#ifdef QT_BUILD_INTERNAL
+#include <QtCore/private/qfilesystemwalker_p.h>
+#endif
 
 #if defined(Q_OS_VXWORKS) || defined(Q_OS_WINRT)
 #define Q_NO_SYMLINKS
@@ -110,6 +113,10 @@ private slots:
 #ifndef Q_OS_WIN
     void hiddenDirs_hiddenFiles();
 #endif
+#ifdef QT_BUILD_INTERNAL
+    void fileSystemWalker_data();
+    void fileSystemWalker();
+#endif
 #ifdef BUILTIN_TESTDATA
 private:
     QSharedPointer<QTemporaryDir> m_dataDir;
@@ -647,6 +654,66 @@ void tst_QDirIterator::hiddenDirs_hiddenFiles()
 }
 #endif // Q_OS_WIN
 
+#ifdef QT_BUILD_INTERNAL
+void tst_QDirIterator::fileSystemWalker_data()
+{
+    QTest::addColumn<QString>("dirName");
+    QTest::addColumn<bool>("parallel");
+    QTest::addColumn<bool>("fetchMetaData");
+
+    const char *dirs[] = { "entrylist", "recursiveDirs", "hiddenDirs_hiddenFiles" };
+    for (const char *dir : dirs) {
+        const QString dirName = QLatin1String(dir);
+        QTest::newRow(dir) << dirName << false << false;
+        QTest::newRow(QByteArray(dir) + "-parallel") << dirName << true << false;
+        QTest::newRow(QByteArray(dir) + "-metadata") << dirName << false << true;
+        QTest::newRow(QByteArray(dir) + "-parallel-metadata") << dirName << true << true;
+    }
+}
+
+void tst_QDirIterator::fileSystemWalker()
+{
+    QFETCH(QString, dirName);
+    QFETCH(bool, parallel);
+    QFETCH(bool, fetchMetaData);
+
+    QStringList expected;
+    QDirIterator it(dirName, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext())
+        expected << it.next();
+    expected.sort();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    QFileSystemWalker walker(dirName, fetchMetaData ? QFileSystemWalker::FetchMetaData
+                                                    : QFileSystemWalker::NoWalkerFlags);
+    if (parallel)
+        walker.setThreadPool(&pool);
+    walker.setBatchSize(2);
+
+    QStringList found;
+    int batches = 0;
+    QVERIFY(walker.walk([&](const QFileSystemWalker::Batch &batch) {
+        ++batches;
+        QVERIFY(batch.size() <= 2);
+        for (const QFileSystemWalker::Entry &entry : batch) {
+            found << entry.entry.filePath();
+            const QFileInfo info = entry.fileInfo();
+            const QFileInfo reference(entry.entry.filePath());
+            QCOMPARE(info.isDir(), reference.isDir());
+            QCOMPARE(info.isSymLink(), reference.isSymLink());
+            if (fetchMetaData)
+                QCOMPARE(info.size(), reference.size());
+        }
+    }));
+    found.sort();
+
+    QCOMPARE(found, expected);
+    QVERIFY(batches >= found.size() / 2);
+}
+#endif // QT_BUILD_INTERNAL
+
 QTEST_MAIN(tst_QDirIterator)
 
 #include "tst_qdiriterator.moc"
@@ -39,6 +39,9 @@
 #include <QtCore/QMetaType>
 #include <QtNetwork/QHostInfo>
 #include <stdlib.h>
+#ifdef Q_OS_UNIX
+#  include <unistd.h>
+#endif
 
 typedef void (QProcess::*QProcessFinishedSignal1)(int);
 typedef void (QProcess::*QProcessFinishedSignal2)(int, QProcess::ExitStatus);
@@ -109,6 +112,12 @@ private slots:
     void discardUnwantedOutput();
     void setWorkingDirectory();
     void setNonExistentWorkingDirectory();
+#ifdef Q_OS_UNIX
+    void setupChildProcess_data();
+    void setupChildProcess();
+    void setupChildProcessFailToStart_data();
+    void setupChildProcessFailToStart();
+#endif
 
     void exitStatus_data();
     void exitStatus();
@@ -2246,6 +2255,115 @@ void tst_QProcess::setNonExistentWorkingDirectory()
 #endif
 }
 
+#ifdef Q_OS_UNIX
+class SetupChildProcess : public QProcess
+{
+public:
+    SetupChildProcess() : ranHere(false) {}
+    bool ranHere;
+
+protected:
+    void setupChildProcess() Q_DECL_OVERRIDE
+    {
+        // only visible in the parent if the child shares its memory
+        ranHere = true;
+        static const char message[] = "setupChildProcess\n";
+        ::write(STDOUT_FILENO, message, sizeof(message) - 1);
+    }
+};
+
+// Opts in to starting children with vfork() semantics while it exists.
+class VforkOptIn
+{
+public:
+    explicit VforkOptIn(bool enable) : enabled(enable)
+    {
+        if (enabled)
+            qputenv("QT_PROCESS_USE_VFORK", "1");
+    }
+    ~VforkOptIn()
+    {
+        if (enabled)
+            qunsetenv("QT_PROCESS_USE_VFORK");
+    }
+
+private:
+    bool enabled;
+};
+
+void tst_QProcess::setupChildProcess_data()
+{
+    QTest::addColumn<bool>("vfork");
+
+    QTest::newRow("fork") << false;
+    QTest::newRow("vfork") << true;
+}
+
+void tst_QProcess::setupChildProcess()
+{
+    QFETCH(bool, vfork);
+    VforkOptIn optIn(vfork);
+
+    SetupChildProcess process;
+    process.start("testProcessNormal/testProcessNormal");
+    QVERIFY2(process.waitForFinished(), process.errorString().toLocal8Bit());
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(process.exitCode(), 0);
+    QCOMPARE(process.readAllStandardOutput(), QByteArray("setupChildProcess\n"));
+#ifdef Q_OS_LINUX
+    QCOMPARE(process.ranHere, vfork);
+#else
+    QVERIFY(!process.ranHere);
+#endif
+}
+
+void tst_QProcess::setupChildProcessFailToStart_data()
+{
+    QTest::addColumn<bool>("vfork");
+    QTest::addColumn<bool>("reimplemented");
+    QTest::addColumn<QString>("workingDirectory");
+    QTest::addColumn<QString>("program");
+    QTest::addColumn<QString>("error");
+
+    const QString nonExistentDirectory = "this/directory/should/not/exist/for/sure";
+    const QString program = QFileInfo("testSetWorkingDirectory/testSetWorkingDirectory").absoluteFilePath();
+    for (int i = 0; i < 4; ++i) {
+        const bool vfork = i & 1;
+        const bool reimplemented = i & 2;
+        const QByteArray prefix = QByteArray(vfork ? "vfork-" : "fork-")
+                + (reimplemented ? "reimplemented-" : "default-");
+        QTest::newRow((prefix + "exec").constData())
+                << vfork << reimplemented << QString() << "/blurp" << "execvp:";
+        QTest::newRow((prefix + "chdir").constData())
+                << vfork << reimplemented << nonExistentDirectory << program << "chdir:";
+    }
+}
+
+// the child reports failures through childStartedPipe, however it was started
+void tst_QProcess::setupChildProcessFailToStart()
+{
+    QFETCH(bool, vfork);
+    QFETCH(bool, reimplemented);
+    QFETCH(QString, workingDirectory);
+    QFETCH(QString, program);
+    QFETCH(QString, error);
+    VforkOptIn optIn(vfork);
+
+    QScopedPointer<QProcess> process(reimplemented ? new SetupChildProcess : new QProcess);
+    QSignalSpy errorSpy(process.data(), &QProcess::errorOccurred);
+    QVERIFY(errorSpy.isValid());
+
+    process->setWorkingDirectory(workingDirectory);
+    process->start(program);
+    QVERIFY(!process->waitForStarted());
+    QCOMPARE(process->error(), QProcess::FailedToStart);
+    QCOMPARE(process->state(), QProcess::NotRunning);
+    QCOMPARE(errorSpy.count(), 1);
+    QVERIFY2(process->errorString().startsWith(error), process->errorString().toLocal8Bit());
+    QCOMPARE(process->readAllStandardOutput(), QByteArray());
+}
+#endif
+
 void tst_QProcess::startFinishStartFinish()
 {
     QProcess process;
@@ -187,6 +187,8 @@ private slots:
     void bom();
     void embeddedZeroByte_data();
     void embeddedZeroByte();
+    void overriddenIniKeys();
+    void iniMapping();
 
     void testXdg();
 private:
@@ -764,6 +766,110 @@ void tst_QSettings::embeddedZeroByte()
     }
 }
 
+void tst_QSettings::overriddenIniKeys()
+{
+    QTemporaryFile file;
+    QVERIFY2(file.open(), qPrintable(file.errorString()));
+    file.write("[General]\nfoo=1\n\n[section]\nbar=2\nbaz=3\n\n"
+               "[section]\nbar=4\n\n[General]\nfoo=5\nqux=6\n");
+    file.close();
+
+    QSettings settings(file.fileName(), QSettings::IniFormat);
+    QCOMPARE(settings.status(), QSettings::NoError);
+    QCOMPARE(settings.childGroups(), QStringList() << "section");
+    QCOMPARE(settings.childKeys(), QStringList() << "foo" << "qux");
+    QCOMPARE(settings.allKeys(), QStringList() << "foo" << "qux" << "section/bar" << "section/baz");
+    QCOMPARE(settings.value("foo").toString(), QString("5"));
+    QCOMPARE(settings.value("section/bar").toString(), QString("4"));
+    QCOMPARE(settings.value("section/baz").toString(), QString("3"));
+
+    settings.remove("section");
+    QCOMPARE(settings.allKeys(), QStringList() << "foo" << "qux");
+}
+
+void tst_QSettings::iniMapping()
+{
+    const QString fileName = settingsPath("mapped.ini");
+    {
+        QSettings settings(fileName, QSettings::IniFormat);
+        for (int i = 0; i < 10; ++i)
+            settings.setValue(QString("section/key%1").arg(i), i);
+    }
+    QConfFile::clearCache();
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray initialContents = file.readAll();
+    const qint64 initialSize = initialContents.size();
+    file.close();
+
+    {
+        QSettings settings(fileName, QSettings::IniFormat);
+        QVERIFY(!settings.isIniMappingEnabled());
+        settings.setIniMappingEnabled(true);
+        QVERIFY(settings.isIniMappingEnabled());
+        QCOMPARE(settings.value("section/key3").toInt(), 3);
+
+        // changes are appended...
+        settings.setValue("section/key3", 33);
+        settings.setValue("other/key", "value");
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("section/key3").toInt(), 33);
+
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QByteArray contents = file.readAll();
+        file.close();
+        QVERIFY(contents.startsWith(initialContents));
+        contents.remove(0, initialSize);
+        contents.replace("\r\n", "\n");
+        QVERIFY(contents.contains("[section]\nkey3=33\n"));
+        QVERIFY(contents.contains("[other]\nkey=value\n"));
+    }
+    QConfFile::clearCache();
+
+    {
+        // ...and read back as usual
+        QSettings settings(fileName, QSettings::IniFormat);
+        QCOMPARE(settings.value("section/key3").toInt(), 33);
+        QCOMPARE(settings.value("section/key4").toInt(), 4);
+        QCOMPARE(settings.value("other/key").toString(), QString("value"));
+        QCOMPARE(settings.allKeys().size(), 11);
+    }
+    QConfFile::clearCache();
+
+    {
+        // removing keys compacts the file
+        QSettings settings(fileName, QSettings::IniFormat);
+        settings.setIniMappingEnabled(true);
+        settings.remove("other");
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(QFileInfo(fileName).size(), initialSize + 1);
+        QCOMPARE(settings.value("section/key3").toInt(), 33);
+    }
+    QConfFile::clearCache();
+
+    {
+        // so does overriding the same key over and over
+        QSettings settings(fileName, QSettings::IniFormat);
+        settings.setIniMappingEnabled(true);
+        for (int i = 0; i < 100; ++i) {
+            settings.setValue("section/key0", i);
+            settings.sync();
+            QVERIFY(QFileInfo(fileName).size() < 3 * initialSize);
+        }
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+    QConfFile::clearCache();
+
+    {
+        QSettings settings(fileName, QSettings::IniFormat);
+        QCOMPARE(settings.value("section/key0").toInt(), 99);
+        QCOMPARE(settings.allKeys().size(), 10);
+    }
+}
+
 void tst_QSettings::testErrorHandling_data()
 {
     QTest::addColumn<int>("filePerms"); // -1 means file should not exist
@@ -32,6 +32,7 @@
 #include "qjsonobject.h"
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
+#include "qjsonstream.h"
 #include "qregularexpression.h"
 #include <limits>
 
@@ -39,6 +40,8 @@
 #define UNICODE_NON_CHARACTER "\xEF\xBF\xBF"
 #define UNICODE_DJE "\320\202" // Character from the Serbian Cyrillic alphabet
 
+Q_DECLARE_METATYPE(QJsonParseError::ParseError)
+
 class tst_QtJson: public QObject
 {
     Q_OBJECT
@@ -151,6 +154,22 @@ private Q_SLOTS:
     void implicitValueType();
     void implicitDocumentType();
 
+    void streamReaderTokens();
+    void streamReaderIncremental();
+    void streamReaderDevice();
+    void streamReaderErrors_data();
+    void streamReaderErrors();
+    void streamReaderSkip();
+    void streamWriter_data();
+    void streamWriter();
+    void streamWriterCopy();
+
+    void lazyParse_data();
+    void lazyParse();
+    void lazyParseErrors();
+    void lazyParseMalformed_data();
+    void lazyParseMalformed();
+
 private:
     QString testDataDir;
 };
@@ -2986,5 +3005,406 @@ void tst_QtJson::implicitDocumentType()
     QCOMPARE(arrayDocument[-1].toInt(123), 123);
 }
 
+static QStringList streamTokens(QJsonStreamReader &reader)
+{
+    QStringList tokens;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        QString token = reader.tokenString();
+        if (reader.isName())
+            token += QLatin1Char(' ') + reader.name();
+        else if (reader.tokenType() >= QJsonStreamReader::String)
+            token += QLatin1Char(' ') + QJsonDocument(QJsonArray{reader.value()}).toJson(QJsonDocument::Compact);
+        tokens << token;
+    }
+    return tokens;
+}
+
+void tst_QtJson::streamReaderTokens()
+{
+    QJsonStreamReader reader(QByteArray("\xEF\xBB\xBF { \"a\": [1, \"x\\ty\", true, null, {}],\n"
+                                        "\"b\\u00e9\": -1.5e3, \"" UNICODE_DJE "\": \"\\ud83d\\ude00\" }  "));
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+
+    const QStringList expected = {
+        "StartObject",
+        "Name a",
+        "StartArray",
+        "Number [1]",
+        "String [\"x\\ty\"]",
+        "Bool [true]",
+        "Null [null]",
+        "StartObject",
+        "EndObject",
+        "EndArray",
+        QString::fromUtf8("Name b\xc3\xa9"),
+        "Number [-1500]",
+        QString::fromUtf8("Name " UNICODE_DJE),
+        QString::fromUtf8("String [\"\xf0\x9f\x98\x80\"]"),
+        "EndObject",
+        "EndDocument"
+    };
+    QCOMPARE(streamTokens(reader), expected);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.depth(), 0);
+
+    // reading past the end is harmless
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QtJson::streamReaderIncremental()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+
+    QJsonStreamReader whole(json);
+    const QStringList expected = streamTokens(whole);
+    QVERIFY(!whole.hasError());
+
+    // feed the document in one byte at a time
+    QJsonStreamReader reader;
+    QStringList tokens;
+    int fed = 0;
+    while (!reader.atEnd() || reader.error() == QJsonParseError::PrematureEndOfDocument) {
+        if (reader.readNext() == QJsonStreamReader::Invalid) {
+            QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+            QVERIFY(reader.atEnd());
+            if (fed == json.size())
+                break;
+            reader.addData(json.mid(fed++, 1));
+            continue;
+        }
+        QString token = reader.tokenString();
+        if (reader.isName())
+            token += QLatin1Char(' ') + reader.name();
+        else if (reader.tokenType() >= QJsonStreamReader::String)
+            token += QLatin1Char(' ') + QJsonDocument(QJsonArray{reader.value()}).toJson(QJsonDocument::Compact);
+        tokens << token;
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(tokens, expected);
+    // the end of the document is reported as soon as the input runs out
+    // after the top-level array, without waiting for the trailing whitespace
+    QCOMPARE(reader.offset(), qint64(json.lastIndexOf(']') + 1));
+
+    // and read it as a whole
+    reader.clear();
+    reader.addData(json);
+    reader.readNext();
+    const QJsonValue value = reader.readValue();
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    QCOMPARE(value, QJsonValue(QJsonDocument::fromJson(json).array()));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QtJson::streamReaderDevice()
+{
+    // larger than what the reader reads at a time, with a string that
+    // spans several reads
+    QJsonArray array;
+    for (int i = 0; i < 5000; ++i)
+        array.append(QJsonObject{{"index", i}, {"name", QString::number(i, 16)}, {"odd", bool(i & 1)}});
+    array.append(QString(100000, QChar(0xe9)));
+    const QByteArray json = QJsonDocument(array).toJson();
+
+    QBuffer buffer;
+    buffer.setData(json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readValue(), QJsonValue(array));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QCOMPARE(reader.offset(), qint64(json.size()));
+
+    // truncated input
+    buffer.close();
+    buffer.setData(json.left(json.size() - 10));
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    reader.setDevice(&buffer);
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+}
+
+void tst_QtJson::streamReaderErrors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonParseError::ParseError>("error");
+
+    QTest::newRow("empty") << QByteArray() << QJsonParseError::PrematureEndOfDocument;
+    QTest::newRow("unterminated object") << QByteArray("{\n    \n\n") << QJsonParseError::PrematureEndOfDocument;
+    QTest::newRow("unterminated array") << QByteArray("[\n   1, true\n\n") << QJsonParseError::PrematureEndOfDocument;
+    QTest::newRow("unterminated string") << QByteArray("[\"foo") << QJsonParseError::PrematureEndOfDocument;
+    QTest::newRow("unterminated number") << QByteArray("[12") << QJsonParseError::PrematureEndOfDocument;
+    QTest::newRow("unterminated literal") << QByteArray("[tr") << QJsonParseError::PrematureEndOfDocument;
+
+    QTest::newRow("scalar document") << QByteArray("true") << QJsonParseError::IllegalValue;
+    QTest::newRow("stray }") << QByteArray("  }  ") << QJsonParseError::IllegalValue;
+    QTest::newRow("missing name separator") << QByteArray("{\n    \"key\" 10\n") << QJsonParseError::MissingNameSeparator;
+    QTest::newRow("missing value separator") << QByteArray("[ 1 2 ]") << QJsonParseError::MissingValueSeparator;
+    QTest::newRow("name without quotes") << QByteArray("{ key: 1 }") << QJsonParseError::UnterminatedObject;
+    QTest::newRow("missing member separator") << QByteArray("{ \"a\": 1 \"b\": 2 }") << QJsonParseError::UnterminatedObject;
+    QTest::newRow("trailing comma in object") << QByteArray("{ \"value\": false, }") << QJsonParseError::MissingObject;
+    QTest::newRow("trailing comma in array") << QByteArray("[ false, ]") << QJsonParseError::MissingObject;
+    QTest::newRow("missing value in object") << QByteArray("{ \"value\": , } ") << QJsonParseError::IllegalValue;
+    QTest::newRow("missing value in array") << QByteArray("[ \"value\" , , ] ") << QJsonParseError::IllegalValue;
+    QTest::newRow("bad literal") << QByteArray("[ trve ]") << QJsonParseError::IllegalValue;
+    QTest::newRow("bad number") << QByteArray("[ 1.e ]") << QJsonParseError::IllegalNumber;
+    QTest::newRow("bad escape") << QByteArray("[ \"\\u12\" ]") << QJsonParseError::IllegalEscapeSequence;
+    QTest::newRow("bad utf8") << QByteArray("[ \"" INVALID_UNICODE "\" ]") << QJsonParseError::IllegalUTF8String;
+    QTest::newRow("garbage at end") << QByteArray("{} x") << QJsonParseError::GarbageAtEnd;
+    QTest::newRow("deep nesting") << QByteArray(1025, '[') + QByteArray(1025, ']') << QJsonParseError::DeepNesting;
+}
+
+void tst_QtJson::streamReaderErrors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonParseError::ParseError, error);
+
+    QJsonStreamReader reader(json);
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), error);
+    QVERIFY(!reader.errorString().isEmpty());
+
+    if (error != QJsonParseError::PrematureEndOfDocument) {
+        // errors are final, and the same as those of QJsonDocument
+        QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+        QJsonParseError parseError;
+        QJsonDocument::fromJson(json, &parseError);
+        QCOMPARE(parseError.error, error);
+    }
+}
+
+void tst_QtJson::streamReaderSkip()
+{
+    QJsonStreamReader reader(QByteArray("{ \"skip\": { \"a\": [ [], {} ], \"b\": 1 }, \"keep\": [ 1, { \"c\": null } ] }"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.name(), QLatin1String("skip"));
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.name(), QLatin1String("keep"));
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray{1, QJsonObject{{"c", QJsonValue::Null}}}));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QtJson::streamWriter_data()
+{
+    QTest::addColumn<QJsonValue>("value");
+
+    QFile file(testDataDir + "/test.json");
+    file.open(QFile::ReadOnly);
+    const QJsonArray testJson = QJsonDocument::fromJson(file.readAll()).array();
+
+    QTest::newRow("empty object") << QJsonValue(QJsonObject());
+    QTest::newRow("empty array") << QJsonValue(QJsonArray());
+    QTest::newRow("nested empty") << QJsonValue(QJsonObject{{"a", QJsonArray{QJsonObject(), QJsonArray()}}, {"b", QJsonObject()}});
+    QTest::newRow("test.json") << QJsonValue(testJson);
+}
+
+void tst_QtJson::streamWriter()
+{
+    QFETCH(QJsonValue, value);
+    const QJsonDocument doc = value.isObject() ? QJsonDocument(value.toObject()) : QJsonDocument(value.toArray());
+
+    QByteArray compact;
+    QJsonStreamWriter writer(&compact);
+    QVERIFY(!writer.autoFormatting());
+    writer.writeValue(value);
+    QCOMPARE(compact, doc.toJson(QJsonDocument::Compact));
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    writer.setDevice(&buffer);
+    writer.setAutoFormatting(true);
+    writer.writeValue(value);
+    QVERIFY(!writer.hasError());
+    QCOMPARE(buffer.data(), doc.toJson(QJsonDocument::Indented));
+}
+
+void tst_QtJson::streamWriterCopy()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+
+    QByteArray copy;
+    {
+        QJsonStreamReader reader(json);
+        QJsonStreamWriter writer(&copy);
+        while (!reader.atEnd()) {
+            reader.readNext();
+            writer.writeCurrentToken(reader);
+        }
+        QVERIFY(!reader.hasError());
+    }
+    QCOMPARE(QJsonDocument::fromJson(copy), QJsonDocument::fromJson(json));
+
+    // members are written in the order they are passed
+    QByteArray ordered;
+    QJsonStreamWriter writer(&ordered);
+    writer.writeStartObject();
+    writer.writeMember("z", "last\n");
+    writer.writeMember("a", 1.5);
+    writer.writeName("n");
+    writer.writeStartArray();
+    writer.writeValue(QJsonValue::Null);
+    writer.writeValue(false);
+    writer.writeEndArray();
+    writer.writeEndObject();
+    QCOMPARE(ordered, QByteArray("{\"z\":\"last\\n\",\"a\":1.5,\"n\":[null,false]}"));
+}
+
+void tst_QtJson::lazyParse_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    const char *files[] = { "test.json", "test2.json", "test3.json", "bom.json" };
+    for (const char *file : files) {
+        QFile f(testDataDir + QLatin1Char('/') + QLatin1String(file));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QTest::newRow(file) << f.readAll();
+    }
+    QTest::newRow("empty object") << QByteArray(" { } ");
+    QTest::newRow("empty array") << QByteArray("[]");
+    QTest::newRow("escapes") << QByteArray("{ \"a\\\"b\": [\"]\\\\\", \"\\\\\"], \"\\u00e9\": { \"}\": \"{\" }, \"" UNICODE_DJE "\": 1 }");
+    QTest::newRow("duplicate keys") << QByteArray("{ \"a\": 1, \"b\": [2], \"a\": { \"c\": 3 } }");
+    // long enough for the vectorized scan, with strings crossing blocks
+    QTest::newRow("long strings") << QByteArray("[\"" + QByteArray(37, 'x') + "\\\"" + QByteArray(20, ',')
+                                                + "\", {\"" + QByteArray(50, '[') + "\": null}, \"\\\\\"]");
+}
+
+void tst_QtJson::lazyParse()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError error;
+    const QJsonDocument eager = QJsonDocument::fromJson(json, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QJsonDocument lazy = QJsonDocument::fromJson(json, &error, QJsonDocument::ParseLazily);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(!lazy.isNull());
+    QCOMPARE(lazy.isObject(), eager.isObject());
+    QCOMPARE(lazy.isArray(), eager.isArray());
+
+    // lookups that do not parse the whole document
+    if (eager.isObject()) {
+        const QJsonObject object = eager.object();
+        for (auto it = object.begin(); it != object.end(); ++it)
+            QCOMPARE(lazy[it.key()], it.value());
+        // again, from the values kept by the first lookups
+        for (auto it = object.begin(); it != object.end(); ++it)
+            QCOMPARE(lazy[it.key()], it.value());
+        QCOMPARE(lazy[QLatin1String("missing")], QJsonValue(QJsonValue::Undefined));
+        QCOMPARE(lazy[0], QJsonValue(QJsonValue::Undefined));
+    } else {
+        const QJsonArray array = eager.array();
+        for (int i = -1; i <= array.size(); ++i)
+            QCOMPARE(lazy[i], array.at(i));
+        QCOMPARE(lazy[QLatin1String("missing")], QJsonValue(QJsonValue::Undefined));
+    }
+
+    // copies share the parsed document
+    const QJsonDocument copy = lazy;
+    QCOMPARE(lazy.toJson(), eager.toJson());
+    QCOMPARE(copy, eager);
+    QCOMPARE(lazy.toBinaryData(), eager.toBinaryData());
+    if (eager.isObject()) {
+        for (const QString &key : eager.object().keys())
+            QCOMPARE(copy[key], eager[key]);
+    }
+}
+
+void tst_QtJson::lazyParseErrors()
+{
+    const struct {
+        const char *json;
+        QJsonParseError::ParseError error;
+        int offset;
+    } rows[] = {
+        { "", QJsonParseError::IllegalValue, 0 },
+        { "  true", QJsonParseError::IllegalValue, 2 },
+        { "{ \"a\": [1, 2 }", QJsonParseError::UnterminatedArray, 13 },
+        { "[ { ]", QJsonParseError::UnterminatedObject, 4 },
+        { "{ \"a\": 1 ", QJsonParseError::UnterminatedObject, 9 },
+        { "[ \"abc ]", QJsonParseError::UnterminatedString, 8 },
+        { "[ \"a\\\" ]", QJsonParseError::UnterminatedString, 8 },
+        { "{} {}", QJsonParseError::GarbageAtEnd, 3 },
+        { "[] , ", QJsonParseError::GarbageAtEnd, 3 },
+        { "[] x", QJsonParseError::GarbageAtEnd, 3 },
+    };
+    for (const auto &row : rows) {
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(row.json, &error, QJsonDocument::ParseLazily);
+        QVERIFY2(doc.isNull(), row.json);
+        QCOMPARE(error.error, row.error);
+        QCOMPARE(error.offset, row.offset);
+    }
+
+    QJsonParseError error;
+    QJsonDocument::fromJson(QByteArray(1025, '[') + QByteArray(1025, ']'), &error, QJsonDocument::ParseLazily);
+    QCOMPARE(error.error, QJsonParseError::DeepNesting);
+}
+
+void tst_QtJson::lazyParseMalformed_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("literal") << QByteArray("{ \"good\": [1, 2], \"bad\": [tru] }");
+    QTest::newRow("literal garbage") << QByteArray("[nullx]");
+    QTest::newRow("false") << QByteArray("[fals]");
+    QTest::newRow("number") << QByteArray("[1, -]");
+    QTest::newRow("number garbage") << QByteArray("[1, 2x]");
+    QTest::newRow("leading zero") << QByteArray("[01]");
+    QTest::newRow("exponent") << QByteArray("{ \"a\": 1e }");
+    QTest::newRow("word") << QByteArray("[abc]");
+    QTest::newRow("escape") << QByteArray("[\"\\u12x4\"]");
+    QTest::newRow("utf8") << QByteArray("[\"\xc3\x28\"]");
+    QTest::newRow("utf8 name") << QByteArray("{ \"\xff\": 1 }");
+    QTest::newRow("missing value separator") << QByteArray("[1, 2 3]");
+    QTest::newRow("strings") << QByteArray("[\"a\" \"b\"]");
+    QTest::newRow("after array") << QByteArray("[[] 1]");
+    QTest::newRow("arrays") << QByteArray("[[] []]");
+    QTest::newRow("after object") << QByteArray("{ \"a\": {} 1 }");
+    QTest::newRow("missing name separator") << QByteArray("{ \"a\" 1 }");
+    QTest::newRow("missing member") << QByteArray("{ \"a\" }");
+    QTest::newRow("unquoted name") << QByteArray("{ a: 1 }");
+    QTest::newRow("missing name") << QByteArray("{ : 1 }");
+    QTest::newRow("container name") << QByteArray("{ {}: 1 }");
+    QTest::newRow("missing value") << QByteArray("{ \"a\": }");
+    QTest::newRow("empty value") << QByteArray("{ \"a\": , \"b\": 1 }");
+    QTest::newRow("two values") << QByteArray("{ \"a\": 1 2 }");
+    QTest::newRow("colons") << QByteArray("{ \"a\": 1: 2 }");
+    QTest::newRow("trailing comma in object") << QByteArray("{ \"a\": 1, }");
+    QTest::newRow("trailing comma in array") << QByteArray("[1, ]");
+    QTest::newRow("leading comma") << QByteArray("[, 1]");
+    QTest::newRow("colon in array") << QByteArray("[1: 2]");
+}
+
+void tst_QtJson::lazyParseMalformed()
+{
+    QFETCH(QByteArray, json);
+
+    // the values are checked up front too, so the error is that of the parser
+    QJsonParseError eagerError;
+    QVERIFY(QJsonDocument::fromJson(json, &eagerError).isNull());
+    QVERIFY(eagerError.error != QJsonParseError::NoError);
+
+    QJsonParseError error;
+    QVERIFY(QJsonDocument::fromJson(json, &error, QJsonDocument::ParseLazily).isNull());
+    QCOMPARE(error.error, eagerError.error);
+}
+
 QTEST_MAIN(tst_QtJson)
 #include "tst_qtjson.moc"
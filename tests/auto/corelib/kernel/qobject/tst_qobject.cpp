@@ -50,6 +50,7 @@
 #endif
 
 #include <math.h>
+#include <functional>
 
 class tst_QObject : public QObject
 {
@@ -137,6 +138,12 @@ private slots:
     void connectFunctorArgDifference();
     void connectFunctorOverloads();
     void connectFunctorQueued();
+    void batchedConnection();
+    void batchedConnectionAcrossThreads();
+    void batchedConnectionNestedEventLoop();
+    void batchedConnectionOverflow();
+    void coalescedConnection();
+    void batchedConnectionDeclaredType();
     void connectFunctorWithContext();
     void connectFunctorWithContextUnique();
     void connectFunctorDeadlock();
@@ -151,6 +158,12 @@ private slots:
     void deleteLaterInAboutToBlockHandler();
     void mutableFunctor();
     void checkArgumentsForNarrowing();
+    void disconnectDuringConcurrentEmission();
+    void connectDuringConcurrentEmission();
+    void deleteReceiverDuringConcurrentEmission();
+    void deleteSenderDuringConcurrentEmission();
+    void disconnectSelfDuringConcurrentEmission();
+    void senderDuringConcurrentEmission();
 };
 
 struct QObjectCreatedOnShutdown
@@ -6050,6 +6063,201 @@ void tst_QObject::connectFunctorQueued()
 #endif
 }
 
+class BatchSender : public QThread
+{
+    Q_OBJECT
+public:
+    int count;
+    BatchSender() : count(0) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i)
+            emit valueChanged(i, QVariant(QString::number(i)));
+    }
+
+signals:
+    void valueChanged(int value, const QVariant &text);
+};
+
+class BatchReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QList<int> values;
+    QStringList texts;
+
+public slots:
+    void setValue(int value, const QVariant &text)
+    {
+        values << value;
+        texts << text.toString();
+    }
+};
+
+void tst_QObject::batchedConnection()
+{
+    BatchSender sender;
+    BatchReceiver receiver;
+    connect(&sender, SIGNAL(valueChanged(int,QVariant)), &receiver, SLOT(setValue(int,QVariant)),
+            Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection));
+    int functorValue = -1;
+    connect(&sender, &BatchSender::valueChanged, &receiver, [&functorValue](int value) { functorValue = value; },
+            Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection));
+
+    sender.count = 100;
+    sender.run();
+    QVERIFY(receiver.values.isEmpty());
+    QCOMPARE(functorValue, -1);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.values.size(), 100);
+    QCOMPARE(receiver.texts.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(receiver.values.at(i), i);
+        QCOMPARE(receiver.texts.at(i), QString::number(i));
+    }
+    QCOMPARE(functorValue, 99);
+
+    // calls pending when the connection is broken are not delivered
+    receiver.values.clear();
+    sender.run();
+    QVERIFY(QObject::disconnect(&sender, SIGNAL(valueChanged(int,QVariant)), &receiver, SLOT(setValue(int,QVariant))));
+    QCoreApplication::processEvents();
+    QVERIFY(receiver.values.isEmpty());
+    QCOMPARE(functorValue, 99);
+
+    // nor when the receiver is destroyed
+    BatchReceiver *transient = new BatchReceiver;
+    connect(&sender, SIGNAL(valueChanged(int,QVariant)), transient, SLOT(setValue(int,QVariant)),
+            Qt::ConnectionType(Qt::AutoConnection | Qt::BatchedConnection));
+    sender.run();
+    delete transient;
+    QCoreApplication::processEvents();
+}
+
+void tst_QObject::batchedConnectionAcrossThreads()
+{
+    BatchSender sender;
+    BatchReceiver receiver;
+    connect(&sender, &BatchSender::valueChanged, &receiver, &BatchReceiver::setValue,
+            Qt::ConnectionType(Qt::AutoConnection | Qt::BatchedConnection));
+
+    sender.count = 10000;
+    sender.start();
+    QVERIFY(sender.wait());
+    QTRY_COMPARE(receiver.values.size(), sender.count);
+    for (int i = 0; i < sender.count; ++i)
+        QCOMPARE(receiver.values.at(i), i);
+}
+
+void tst_QObject::batchedConnectionNestedEventLoop()
+{
+    BatchSender sender;
+    QList<int> values;
+    connect(&sender, &BatchSender::valueChanged, this, [&sender, &values](int value) {
+        values << value;
+        // the calls not delivered yet by the outer loop must come first
+        if (value == 1) {
+            emit sender.valueChanged(5, QVariant());
+            QCoreApplication::processEvents();
+        }
+    }, Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection));
+
+    sender.count = 5;
+    sender.run();
+    QCoreApplication::processEvents();
+    QCOMPARE(values, QList<int>() << 0 << 1 << 2 << 3 << 4 << 5);
+}
+
+void tst_QObject::batchedConnectionOverflow()
+{
+    // beyond the pending calls limit, the calls are posted as events
+    BatchSender sender;
+    int calls = 0;
+    qint64 sum = 0;
+    connect(&sender, &BatchSender::valueChanged, this, [&calls, &sum](int value) {
+        ++calls;
+        sum += value;
+    }, Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection));
+
+    sender.count = 100000;
+    sender.run();
+    QCoreApplication::processEvents();
+    QCOMPARE(calls, sender.count);
+    QCOMPARE(sum, qint64(sender.count) * (sender.count - 1) / 2);
+}
+
+void tst_QObject::coalescedConnection()
+{
+    BatchSender sender;
+    BatchReceiver receiver;
+    connect(&sender, &BatchSender::valueChanged, &receiver, &BatchReceiver::setValue,
+            Qt::ConnectionType(Qt::QueuedConnection | Qt::CoalescedConnection));
+
+    sender.count = 100;
+    sender.run();
+    QVERIFY(receiver.values.isEmpty());
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.values, QList<int>() << 99);
+    QCOMPARE(receiver.texts, QStringList() << QStringLiteral("99"));
+
+    sender.count = 5;
+    sender.run();
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.values, QList<int>() << 99 << 4);
+
+    // across threads, the last value is always delivered
+    receiver.values.clear();
+    sender.count = 10000;
+    sender.start();
+    QVERIFY(sender.wait());
+    QTRY_VERIFY(!receiver.values.isEmpty() && receiver.values.last() == sender.count - 1);
+    QVERIFY(receiver.values.size() <= sender.count);
+    for (int i = 1; i < receiver.values.size(); ++i)
+        QVERIFY(receiver.values.at(i - 1) < receiver.values.at(i));
+}
+
+// only declared: the connections have to register them
+struct BatchedDeclaredType { int value; };
+struct CoalescedDeclaredType { int value; };
+Q_DECLARE_METATYPE(BatchedDeclaredType)
+Q_DECLARE_METATYPE(CoalescedDeclaredType)
+
+class DeclaredTypeSender : public QObject
+{
+    Q_OBJECT
+signals:
+    void batched(BatchedDeclaredType);
+    void coalesced(CoalescedDeclaredType);
+};
+
+void tst_QObject::batchedConnectionDeclaredType()
+{
+    QCOMPARE(QMetaType::type("BatchedDeclaredType"), int(QMetaType::UnknownType));
+    QCOMPARE(QMetaType::type("CoalescedDeclaredType"), int(QMetaType::UnknownType));
+
+    DeclaredTypeSender sender;
+    int batched = 0;
+    int coalesced = 0;
+    connect(&sender, &DeclaredTypeSender::batched, this,
+            [&batched](BatchedDeclaredType arg) { batched = arg.value; },
+            Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection));
+    connect(&sender, &DeclaredTypeSender::coalesced, this,
+            [&coalesced](CoalescedDeclaredType arg) { coalesced = arg.value; },
+            Qt::ConnectionType(Qt::QueuedConnection | Qt::CoalescedConnection));
+
+    BatchedDeclaredType batchedArg = { 1 };
+    CoalescedDeclaredType coalescedArg = { 2 };
+    emit sender.batched(batchedArg);
+    emit sender.coalesced(coalescedArg);
+    QCOMPARE(batched, 0);
+    QCOMPARE(coalesced, 0);
+    QCoreApplication::processEvents();
+    QCOMPARE(batched, 1);
+    QCOMPARE(coalesced, 2);
+}
+
 void tst_QObject::connectFunctorWithContext()
 {
     int status = 1;
@@ -7422,6 +7630,268 @@ void tst_QObject::checkArgumentsForNarrowing()
 #undef FITS
 }
 
+// The following tests change the connections of a signal while other
+// threads emit it. The slots are functors that don't touch their context
+// object, so that deleting it from another thread is fine.
+
+class FunctionThread : public QThread
+{
+public:
+    explicit FunctionThread(const std::function<void()> &function) : function(function) {}
+
+protected:
+    void run() Q_DECL_OVERRIDE { function(); }
+
+private:
+    std::function<void()> function;
+};
+
+// Emits signal1() of the sender over and over in a thread of its own
+class EmissionLoop : public FunctionThread
+{
+public:
+    explicit EmissionLoop(SenderObject *sender)
+        : FunctionThread([this, sender] {
+              while (!stopped.loadAcquire()) {
+                  sender->emitSignal1();
+                  emissions.ref();
+              }
+          })
+    {}
+    ~EmissionLoop() { stop(); }
+
+    void stop() { stopped.storeRelease(1); wait(); }
+    // waits for an emission that started after the call
+    bool waitForEmissions()
+    {
+        const int n = emissions.load() + 2;
+        QDeadlineTimer deadline(10000);
+        while (emissions.load() < n) {
+            if (deadline.hasExpired())
+                return false;
+            yieldCurrentThread();
+        }
+        return true;
+    }
+
+    QAtomicInt emissions;
+
+private:
+    QAtomicInt stopped;
+};
+
+void tst_QObject::disconnectDuringConcurrentEmission()
+{
+    SenderObject sender;
+    QObject context;
+    QAtomicInt permanentCalls;
+    QAtomicInt temporaryCalls;
+    connect(&sender, &SenderObject::signal1, &context, [&] { permanentCalls.ref(); }, Qt::DirectConnection);
+
+    EmissionLoop loop1(&sender);
+    EmissionLoop loop2(&sender);
+    loop1.start();
+    loop2.start();
+    for (int i = 0; i < 1000; ++i) {
+        const QMetaObject::Connection connection =
+                connect(&sender, &SenderObject::signal1, &context, [&] { temporaryCalls.ref(); }, Qt::DirectConnection);
+        if (i % 100 == 0)
+            QVERIFY(loop1.waitForEmissions());
+        QVERIFY(QObject::disconnect(connection));
+    }
+    loop1.stop();
+    loop2.stop();
+    QVERIFY(permanentCalls.load() > 0);
+
+    const int calls = temporaryCalls.load();
+    permanentCalls.store(0);
+    sender.emitSignal1();
+    QCOMPARE(permanentCalls.load(), 1);
+    QCOMPARE(temporaryCalls.load(), calls);
+}
+
+void tst_QObject::connectDuringConcurrentEmission()
+{
+    enum { Count = 50 };
+    SenderObject sender;
+    QObject context;
+    QAtomicInt calls[Count];
+
+    EmissionLoop loop1(&sender);
+    EmissionLoop loop2(&sender);
+    loop1.start();
+    loop2.start();
+    for (int i = 0; i < Count; ++i) {
+        QAtomicInt *counter = calls + i;
+        connect(&sender, &SenderObject::signal1, &context, [counter] { counter->ref(); }, Qt::DirectConnection);
+        // later emissions see the new connection
+        QTRY_VERIFY(counter->load() > 0);
+    }
+    loop1.stop();
+    loop2.stop();
+
+    int before[Count];
+    for (int i = 0; i < Count; ++i)
+        before[i] = calls[i].load();
+    sender.emitSignal1();
+    for (int i = 0; i < Count; ++i)
+        QCOMPARE(calls[i].load(), before[i] + 1);
+}
+
+void tst_QObject::deleteReceiverDuringConcurrentEmission()
+{
+    enum { Count = 200 };
+    SenderObject sender;
+    QAtomicInt calls;
+    QObject *receivers[Count];
+    for (QObject *&receiver : receivers) {
+        receiver = new QObject;
+        connect(&sender, &SenderObject::signal1, receiver, [&] { calls.ref(); }, Qt::DirectConnection);
+    }
+
+    EmissionLoop loop1(&sender);
+    EmissionLoop loop2(&sender);
+    loop1.start();
+    loop2.start();
+    for (int i = 0; i < Count; ++i) {
+        if (i % 20 == 0)
+            QVERIFY(loop1.waitForEmissions());
+        delete receivers[i];
+    }
+    loop1.stop();
+    loop2.stop();
+    QVERIFY(calls.load() > 0);
+
+    const int before = calls.load();
+    sender.emitSignal1();
+    QCOMPARE(calls.load(), before);
+}
+
+void tst_QObject::deleteSenderDuringConcurrentEmission()
+{
+    // a slot deletes the sender in the emitting thread while the main
+    // thread destroys receivers, which breaks connections of the sender
+    for (int i = 0; i < 50; ++i) {
+        SenderObject *sender = new SenderObject;
+        QObject context;
+        QAtomicInt before;
+        QAtomicInt after;
+        QObject *receivers[20];
+        for (QObject *&receiver : receivers) {
+            receiver = new QObject;
+            connect(sender, &SenderObject::signal1, receiver, [&] { before.ref(); }, Qt::DirectConnection);
+        }
+        connect(sender, &SenderObject::signal1, &context, [sender] { delete sender; }, Qt::DirectConnection);
+        connect(sender, &SenderObject::signal1, &context, [&] { after.ref(); }, Qt::DirectConnection);
+
+        FunctionThread thread([sender] { sender->emitSignal1(); });
+        sender->moveToThread(&thread);
+        thread.start();
+        for (QObject *receiver : receivers)
+            delete receiver;
+        QVERIFY(thread.wait(10000));
+
+        QVERIFY(before.load() <= 20);
+        // the emission stops once the sender is gone
+        QCOMPARE(after.load(), 0);
+    }
+}
+
+void tst_QObject::disconnectSelfDuringConcurrentEmission()
+{
+    SenderObject sender;
+    QObject context;
+    QAtomicInt selfCalls;
+    QAtomicInt otherCalls;
+    QMetaObject::Connection self;
+    self = connect(&sender, &SenderObject::signal1, &context, [&] {
+        selfCalls.ref();
+        QObject::disconnect(self);
+    }, Qt::DirectConnection);
+
+    // only one thread emits, so the slot must not run again once it has
+    // disconnected itself, while the main thread changes other connections
+    EmissionLoop loop(&sender);
+    loop.start();
+    for (int i = 0; i < 500; ++i) {
+        const QMetaObject::Connection connection =
+                connect(&sender, &SenderObject::signal1, &context, [&] { otherCalls.ref(); }, Qt::DirectConnection);
+        if (i % 100 == 0)
+            QVERIFY(loop.waitForEmissions());
+        QObject::disconnect(connection);
+    }
+    QVERIFY(loop.waitForEmissions());
+    loop.stop();
+    QCOMPARE(selfCalls.load(), 1);
+
+    sender.emitSignal1();
+    QCOMPARE(selfCalls.load(), 1);
+}
+
+class SenderChecker : public QObject
+{
+    Q_OBJECT
+public:
+    SenderChecker() : expected(nullptr), calls(0), mismatches(0) {}
+
+    QObject *expected;
+    int calls;
+    int mismatches;
+
+public slots:
+    void check()
+    {
+        ++calls;
+        if (sender() != expected)
+            ++mismatches;
+        if (senderSignalIndex() < 0)
+            ++mismatches;
+    }
+};
+
+void tst_QObject::senderDuringConcurrentEmission()
+{
+    // every thread emits its own sender to a receiver living in it, while
+    // the main thread connects to and disconnects from both senders
+    enum { Threads = 2 };
+    QAtomicPointer<SenderObject> senders[Threads];
+    QAtomicInt stopped;
+    int calls[Threads] = {};
+    int mismatches[Threads] = {};
+    QScopedPointer<FunctionThread> threads[Threads];
+    for (int i = 0; i < Threads; ++i) {
+        threads[i].reset(new FunctionThread([&, i] {
+            SenderObject sender;
+            SenderChecker checker;
+            checker.expected = &sender;
+            connect(&sender, SIGNAL(signal1()), &checker, SLOT(check()));
+            senders[i].storeRelease(&sender);
+            while (!stopped.loadAcquire())
+                sender.emitSignal1();
+            calls[i] = checker.calls;
+            mismatches[i] = checker.mismatches;
+        }));
+        threads[i]->start();
+    }
+    for (int i = 0; i < Threads; ++i)
+        QTRY_VERIFY(senders[i].loadAcquire());
+
+    QObject context;
+    for (int n = 0; n < 500; ++n) {
+        for (int i = 0; i < Threads; ++i) {
+            const QMetaObject::Connection connection =
+                    connect(senders[i].loadAcquire(), &SenderObject::signal1, &context, [] {}, Qt::DirectConnection);
+            QObject::disconnect(connection);
+        }
+    }
+    stopped.storeRelease(1);
+    for (int i = 0; i < Threads; ++i) {
+        QVERIFY(threads[i]->wait(10000));
+        QVERIFY(calls[i] > 0);
+        QCOMPARE(mismatches[i], 0);
+    }
+}
+
 // Test for QtPrivate::HasQ_OBJECT_Macro
 Q_STATIC_ASSERT(QtPrivate::HasQ_OBJECT_Macro<tst_QObject>::Value);
 Q_STATIC_ASSERT(!QtPrivate::HasQ_OBJECT_Macro<SiblingDeleter>::Value);
@@ -31,6 +31,9 @@
 #include <QtTest/QTestEventLoop>
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
 #include <QtCore/QSocketNotifier>
 #include <QtNetwork/QTcpServer>
@@ -61,6 +64,8 @@ private slots:
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+    void dispatcherBackends_data();
+    void dispatcherBackends();
 #endif
     void asyncMultipleDatagram();
 
@@ -325,6 +330,131 @@ void tst_QSocketNotifier::posixSockets()
 }
 #endif
 
+// Runs the checks in a thread of its own, so that they use an event dispatcher
+// created with the QT_EVENT_DISPATCHER_EPOLL value of the test row.
+class DispatcherBackendThread : public QThread
+{
+public:
+    bool ready = false;
+    int readsAfterFirstWrite = 0;
+    int readsAfterSecondWrite = 0;
+    int writeActivations = 0;
+    bool enabledOnClosedSocket = true;
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1)
+            return;
+        ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+        {
+            // each activation reads only one of the bytes available
+            int reads = 0;
+            QSocketNotifier notifier(fds[0], QSocketNotifier::Read);
+            QObject::connect(&notifier, &QSocketNotifier::activated, [&reads](int fd) {
+                char c;
+                if (qt_safe_read(fd, &c, 1) == 1)
+                    ++reads;
+            });
+            qt_safe_write(fds[1], "ab", 2);
+            spin(200);
+            readsAfterFirstWrite = reads;
+            qt_safe_write(fds[1], "c", 1);
+            spin(200);
+            readsAfterSecondWrite = reads;
+        }
+
+        {
+            QSocketNotifier notifier(fds[1], QSocketNotifier::Write);
+            QObject::connect(&notifier, &QSocketNotifier::activated, [this]() { ++writeActivations; });
+            spin(50);
+        }
+
+        qt_safe_close(fds[0]);
+        qt_safe_close(fds[1]);
+
+        {
+            // closed while the notifier is enabled
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1)
+                return;
+            QSocketNotifier notifier(fds[0], QSocketNotifier::Read);
+            qt_safe_close(fds[0]);
+            spin(50);
+            notifier.setEnabled(false);
+            qt_safe_close(fds[1]);
+        }
+
+        {
+            // enabled on a closed descriptor
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1)
+                return;
+            qt_safe_close(fds[0]);
+            qt_safe_close(fds[1]);
+            QSocketNotifier notifier(fds[0], QSocketNotifier::Read);
+            spin(50);
+            enabledOnClosedSocket = notifier.isEnabled();
+        }
+
+        ready = true;
+    }
+
+private:
+    static void spin(int msecs)
+    {
+        QEventLoop loop;
+        QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+};
+
+void tst_QSocketNotifier::dispatcherBackends_data()
+{
+    QTest::addColumn<QByteArray>("backend");
+    QTest::addColumn<bool>("edgeTriggered");
+
+    QTest::newRow("poll") << QByteArray() << false;
+#if QT_CONFIG(epoll)
+    QTest::newRow("epoll") << QByteArray("1") << false;
+    QTest::newRow("epoll-edge") << QByteArray("edge") << true;
+#endif
+}
+
+void tst_QSocketNotifier::dispatcherBackends()
+{
+    QFETCH(QByteArray, backend);
+    QFETCH(bool, edgeTriggered);
+
+    const QByteArray oldBackend = qgetenv("QT_EVENT_DISPATCHER_EPOLL");
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", backend);
+
+    // both the socket closed under an enabled notifier and the notifier
+    // enabled on a closed socket are reported, whatever the backend
+    const QRegularExpression invalidSocket("^QSocketNotifier: Invalid socket \\d+ with type Read, disabling...$");
+    QTest::ignoreMessage(QtWarningMsg, invalidSocket);
+    QTest::ignoreMessage(QtWarningMsg, invalidSocket);
+
+    DispatcherBackendThread thread;
+    thread.start();
+    const bool finished = thread.wait(10000);
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", oldBackend);
+    QVERIFY(finished);
+    QVERIFY(thread.ready);
+
+    if (edgeTriggered) {
+        // a slot that leaves data behind is only activated again for new data
+        QCOMPARE(thread.readsAfterFirstWrite, 1);
+        QCOMPARE(thread.readsAfterSecondWrite, 2);
+        QCOMPARE(thread.writeActivations, 1);
+    } else {
+        QCOMPARE(thread.readsAfterFirstWrite, 2);
+        QCOMPARE(thread.readsAfterSecondWrite, 3);
+        QVERIFY(thread.writeActivations > 1);
+    }
+    QVERIFY(!thread.enabledOnClosedSocket);
+}
+
 void tst_QSocketNotifier::async_readDatagramSlot()
 {
     char buf[1];
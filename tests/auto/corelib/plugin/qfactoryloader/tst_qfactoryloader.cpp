@@ -30,7 +30,12 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qplugin.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qtemporarydir.h>
 #include <private/qfactoryloader_p.h>
+#if QT_CONFIG(library)
+#include <private/qpluginmetadatacache_p.h>
+#endif
 #include "plugin1/plugininterface1.h"
 #include "plugin2/plugininterface2.h"
 
@@ -47,12 +52,19 @@ public slots:
 
 private slots:
     void usingTwoFactoriesFromSameDir();
+#if QT_CONFIG(library)
+    void metaDataCache();
+    void metaDataCacheInvalidation();
+#endif
 };
 
 static const char binFolderC[] = "bin";
 
 void tst_QFactoryLoader::initTestCase()
 {
+    // keep the plugin meta data cache out of the user's cache directory
+    QStandardPaths::setTestModeEnabled(true);
+
     const QString binFolder = QFINDTESTDATA(binFolderC);
     QVERIFY2(!binFolder.isEmpty(), "Unable to locate 'bin' folder");
 #if QT_CONFIG(library)
@@ -81,5 +93,92 @@ void tst_QFactoryLoader::usingTwoFactoriesFromSameDir()
     QCOMPARE(plugin2->pluginName(), QLatin1String("Plugin2 ok"));
 }
 
+#if QT_CONFIG(library)
+void tst_QFactoryLoader::metaDataCache()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY2(cacheDir.isValid(), qPrintable(cacheDir.errorString()));
+    qputenv("QT_PLUGIN_CACHE_PATH", QFile::encodeName(cacheDir.path()));
+
+    const QString suffix = QLatin1Char('/') + QLatin1String(binFolderC);
+    QList<QJsonObject> metaData;
+    {
+        QFactoryLoader loader(PluginInterface1_iid, suffix);
+        metaData = loader.metaData();
+        QCOMPARE(metaData.size(), 1);
+    }
+    QCOMPARE(QDir(cacheDir.path()).entryList(QDir::Files).size(), 1);
+
+    // a second scan of the same directory is served from the cache
+    QFactoryLoader loader(PluginInterface1_iid, suffix);
+    QCOMPARE(loader.metaData(), metaData);
+    QVERIFY(qobject_cast<PluginInterface1 *>(loader.instance(0)));
+
+    qunsetenv("QT_PLUGIN_CACHE_PATH");
+}
+
+void tst_QFactoryLoader::metaDataCacheInvalidation()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    qputenv("QT_PLUGIN_CACHE_PATH", QFile::encodeName(dir.path() + QLatin1String("/cache")));
+
+    const QString pluginDir = dir.path() + QLatin1String("/plugins");
+    QVERIFY(QDir().mkpath(pluginDir));
+    QFile plugin(pluginDir + QLatin1String("/libfake.so"));
+    QVERIFY(plugin.open(QIODevice::WriteOnly));
+    plugin.write("not really a plugin");
+    plugin.close();
+
+    QJsonObject metaData;
+    metaData.insert(QLatin1String("IID"), QLatin1String("org.qt-project.fake"));
+    metaData.insert(QLatin1String("version"), QT_VERSION);
+
+    {
+        QPluginMetaDataCache cache(pluginDir);
+        QVERIFY(cache.isEnabled());
+        QVERIFY(cache.find(QLatin1String("libfake.so"), QFileInfo(plugin.fileName())).isEmpty());
+        cache.insert(QLatin1String("libfake.so"), QFileInfo(plugin.fileName()), metaData);
+        QVERIFY(cache.save());
+        QVERIFY(QFile::exists(cache.fileName()));
+    }
+    {
+        QPluginMetaDataCache cache(pluginDir);
+        QCOMPARE(cache.find(QLatin1String("libfake.so"), QFileInfo(plugin.fileName())), metaData);
+        // the cache is keyed by directory
+        QPluginMetaDataCache other(dir.path());
+        QVERIFY(other.fileName() != cache.fileName());
+        QVERIFY(other.find(QLatin1String("libfake.so"), QFileInfo(plugin.fileName())).isEmpty());
+    }
+
+    // changing the plugin invalidates its entry
+    QVERIFY(plugin.open(QIODevice::Append));
+    plugin.write(" and never was");
+    plugin.close();
+    {
+        QPluginMetaDataCache cache(pluginDir);
+        QVERIFY(cache.find(QLatin1String("libfake.so"), QFileInfo(plugin.fileName())).isEmpty());
+    }
+
+    // a damaged cache file is ignored
+    {
+        QPluginMetaDataCache cache(pluginDir);
+        cache.insert(QLatin1String("libfake.so"), QFileInfo(plugin.fileName()), metaData);
+        QVERIFY(cache.save());
+        QFile cacheFile(cache.fileName());
+        QVERIFY(cacheFile.resize(cacheFile.size() / 2));
+    }
+    {
+        QPluginMetaDataCache cache(pluginDir);
+        QVERIFY(cache.find(QLatin1String("libfake.so"), QFileInfo(plugin.fileName())).isEmpty());
+    }
+
+    qputenv("QT_NO_PLUGIN_CACHE", "1");
+    QVERIFY(!QPluginMetaDataCache(pluginDir).isEnabled());
+    qunsetenv("QT_NO_PLUGIN_CACHE");
+    qunsetenv("QT_PLUGIN_CACHE_PATH");
+}
+#endif // QT_CONFIG(library)
+
 QTEST_MAIN(tst_QFactoryLoader)
 #include "tst_qfactoryloader.moc"
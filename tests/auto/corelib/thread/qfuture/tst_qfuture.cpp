@@ -72,8 +72,17 @@ private slots:
 #ifndef QT_NO_EXCEPTIONS
     void exceptions();
     void nestedExceptions();
+    void continuationExceptions();
+    void onFailed();
 #endif
     void nonGlobalThreadPool();
+    void continuations();
+    void continuationOnThreadPool();
+    void continuationWithContext();
+    void continuationCancellation();
+    void continuationOfAbandonedFuture();
+    void whenAll();
+    void whenAny();
 };
 
 void tst_QFuture::resultStore()
@@ -1436,6 +1445,136 @@ void tst_QFuture::nestedExceptions()
     QVERIFY(MyClass::caught);
 }
 
+void tst_QFuture::continuationExceptions()
+{
+    // a failed parent skips continuations that take its result
+    {
+        bool called = false;
+        QFuture<int> f = createExceptionResultFuture().then([&called](int value) {
+            called = true;
+            return value;
+        });
+        QVERIFY(f.isFinished());
+        QVERIFY(f.isCanceled());
+        QVERIFY(!called);
+        bool caught = false;
+        try {
+            f.waitForFinished();
+        } catch (QException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+
+    // ... but not those that take the future
+    {
+        QFuture<bool> f = createDerivedExceptionFuture().then([](QFuture<void> parent) {
+            try {
+                parent.waitForFinished();
+            } catch (DerivedException &) {
+                return true;
+            }
+            return false;
+        });
+        QVERIFY(f.isFinished());
+        QVERIFY(f.result());
+    }
+
+    // exceptions thrown by a continuation are reported in its future
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        QFuture<int> f = i.future().then([](int) -> int { throw DerivedException(); });
+        QFuture<int> g = i.future().then([](int) -> int { throw 42; });
+        i.reportResult(0);
+        i.reportFinished();
+        QVERIFY(f.isFinished());
+        bool caught = false;
+        try {
+            f.result();
+        } catch (DerivedException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+        caught = false;
+        try {
+            g.result();
+        } catch (QUnhandledException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+}
+
+void tst_QFuture::onFailed()
+{
+    // typed handler
+    {
+        QFuture<void> f = createDerivedExceptionFuture().onFailed([](const DerivedException &) {
+        });
+        QVERIFY(f.isFinished());
+        QVERIFY(!f.isCanceled());
+        f.waitForFinished();
+    }
+
+    // handler for another exception type: the exception is propagated
+    {
+        bool called = false;
+        QFuture<void> f = createExceptionFuture().onFailed([&called](const DerivedException &) {
+            called = true;
+        });
+        QVERIFY(f.isFinished());
+        QVERIFY(!called);
+        bool caught = false;
+        try {
+            f.waitForFinished();
+        } catch (QException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+
+    // handler without arguments, providing a replacement result
+    {
+        QFuture<int> f = createExceptionResultFuture()
+                .then([](int value) { return value + 1; })
+                .onFailed([]() { return -1; });
+        QVERIFY(f.isFinished());
+        QCOMPARE(f.result(), -1);
+    }
+
+    // exceptions thrown by the handler
+    {
+        QFuture<void> f = createExceptionFuture().onFailed([](const QException &) {
+            throw DerivedException();
+        });
+        bool caught = false;
+        try {
+            f.waitForFinished();
+        } catch (DerivedException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+
+    // no failure: the results are passed through
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        bool called = false;
+        QFuture<int> f = i.future().onFailed([&called]() {
+            called = true;
+            return 0;
+        });
+        i.reportResult(1);
+        i.reportResult(2);
+        i.reportFinished();
+        QVERIFY(f.isFinished());
+        QVERIFY(!called);
+        QCOMPARE(f.results(), QList<int>() << 1 << 2);
+    }
+}
+
 #endif // QT_NO_EXCEPTIONS
 
 void tst_QFuture::nonGlobalThreadPool()
@@ -1485,5 +1624,256 @@ void tst_QFuture::nonGlobalThreadPool()
     }
 }
 
+void tst_QFuture::continuations()
+{
+    // continuation attached before the parent finishes
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        QFuture<QString> f = i.future()
+                .then([](int value) { return value * 2; })
+                .then([](int value) { return QString::number(value); });
+        QVERIFY(!f.isFinished());
+        const int answer = 21;
+        i.reportFinished(&answer);
+        QVERIFY(f.isFinished());
+        QCOMPARE(f.result(), QString("42"));
+    }
+
+    // continuation attached to a finished future runs right away
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        i.reportResult(1);
+        i.reportFinished();
+        int value = 0;
+        QFuture<void> f = i.future().then([&value](int result) { value = result; });
+        QVERIFY(f.isFinished());
+        QVERIFY(!f.isCanceled());
+        QCOMPARE(value, 1);
+    }
+
+    // continuation taking the parent future
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        QFuture<int> f = i.future().then([](QFuture<int> parent) {
+            return parent.resultCount();
+        });
+        i.reportResult(1, 0);
+        i.reportResult(2, 1);
+        i.reportFinished();
+        QCOMPARE(f.result(), 2);
+    }
+
+    // void futures
+    {
+        QFutureInterface<void> i;
+        i.reportStarted();
+        QFuture<int> f = i.future().then([]() { return 42; });
+        QFuture<void> g = f.then([](QFuture<int> parent) { QCOMPARE(parent.result(), 42); });
+        QVERIFY(!g.isFinished());
+        i.reportFinished();
+        QVERIFY(g.isFinished());
+        QCOMPARE(f.result(), 42);
+    }
+
+    // several continuations on the same future
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        QFuture<int> f = i.future();
+        QFuture<int> a = f.then([](int value) { return value + 1; });
+        QFuture<int> b = f.then([](int value) { return value + 2; });
+        i.reportResult(1);
+        i.reportFinished();
+        QCOMPARE(a.result(), 2);
+        QCOMPARE(b.result(), 3);
+    }
+}
+
+void tst_QFuture::continuationOnThreadPool()
+{
+    QThreadPool pool;
+    QFutureInterface<int> i;
+    i.reportStarted();
+    QFuture<QThread *> onPool = i.future().then(&pool, [](int) { return QThread::currentThread(); });
+    QFuture<QThread *> async = i.future().then(QtFuture::Launch::Async, [](int) {
+        return QThread::currentThread();
+    });
+    QFuture<QThread *> sync = i.future().then(QtFuture::Launch::Sync, [](int) {
+        return QThread::currentThread();
+    });
+    i.reportResult(0);
+    i.reportFinished();
+
+    QVERIFY(sync.isFinished());
+    QCOMPARE(sync.result(), QThread::currentThread());
+    QVERIFY(onPool.result() != QThread::currentThread());
+    QVERIFY(async.result() != QThread::currentThread());
+    QVERIFY(pool.waitForDone(10000));
+}
+
+void tst_QFuture::continuationWithContext()
+{
+    QThread thread;
+    QObject context;
+    context.moveToThread(&thread);
+    thread.start();
+
+    QFutureInterface<int> i;
+    i.reportStarted();
+    QFuture<QThread *> f = i.future().then(&context, [](int) { return QThread::currentThread(); });
+    i.reportResult(0);
+    i.reportFinished();
+    QCOMPARE(f.result(), &thread);
+
+    // a context in the current thread runs the continuation directly
+    QObject localContext;
+    QFuture<int> g = i.future().then(&localContext, [](int value) { return value + 1; });
+    QVERIFY(g.isFinished());
+    QCOMPARE(g.result(), 1);
+
+    thread.quit();
+    QVERIFY(thread.wait());
+
+    // a destroyed context cancels the continuation
+    QFutureInterface<int> j;
+    j.reportStarted();
+    QObject *deadContext = new QObject;
+    bool called = false;
+    QFuture<void> h = j.future().then(deadContext, [&called](int) { called = true; });
+    delete deadContext;
+    j.reportResult(0);
+    j.reportFinished();
+    QVERIFY(h.isFinished());
+    QVERIFY(h.isCanceled());
+    QVERIFY(!called);
+}
+
+void tst_QFuture::continuationCancellation()
+{
+    QFutureInterface<int> i;
+    i.reportStarted();
+    bool called = false;
+    QFuture<int> f = i.future().then([&called](int value) {
+        called = true;
+        return value;
+    });
+    QFuture<bool> g = i.future().then([](QFuture<int> parent) { return parent.isCanceled(); });
+    i.reportCanceled();
+    // the continuations run on cancellation, without waiting for reportFinished()
+    QVERIFY(f.isFinished());
+    QVERIFY(f.isCanceled());
+    QVERIFY(!called);
+    QVERIFY(g.isFinished());
+    QVERIFY(g.result());
+    i.reportFinished();
+    QVERIFY(!called);
+
+    // a future that is canceled and never finished
+    {
+        QFutureInterface<int> j;
+        j.reportStarted();
+        QFuture<int> k = j.future().then([](int value) { return value; });
+        j.future().cancel();
+        QVERIFY(k.isFinished());
+        QVERIFY(k.isCanceled());
+
+        // continuations attached after the cancellation run right away
+        QFuture<bool> l = j.future().then([](QFuture<int> parent) { return parent.isCanceled(); });
+        QVERIFY(l.isFinished());
+        QVERIFY(l.result());
+
+        QList<QFuture<int> > futures;
+        futures << j.future();
+        QFuture<QList<QFuture<int> > > all = QtFuture::whenAll(futures.begin(), futures.end());
+        QVERIFY(all.isFinished());
+        QVERIFY(all.result().at(0).isCanceled());
+        QFuture<QtFuture::WhenAnyResult<int> > any = QtFuture::whenAny(futures.begin(), futures.end());
+        QVERIFY(any.isFinished());
+        QCOMPARE(any.result().index, 0);
+    }
+
+    // a default-constructed future is canceled and finished
+    QFuture<void> h = QFuture<int>().then([](int) { });
+    QVERIFY(h.isFinished());
+    QVERIFY(h.isCanceled());
+}
+
+void tst_QFuture::continuationOfAbandonedFuture()
+{
+    QFuture<int> f;
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        f = i.future().then([](int value) { return value; });
+        QVERIFY(!f.isFinished());
+    }
+    // the parent can never finish now
+    QVERIFY(f.isFinished());
+    QVERIFY(f.isCanceled());
+}
+
+void tst_QFuture::whenAll()
+{
+    QFutureInterface<int> i1, i2, i3;
+    i1.reportStarted();
+    i2.reportStarted();
+    i3.reportStarted();
+    QList<QFuture<int> > futures;
+    futures << i1.future() << i2.future() << i3.future();
+
+    QFuture<QList<QFuture<int> > > all = QtFuture::whenAll(futures.begin(), futures.end());
+    QVERIFY(!all.isFinished());
+    const int three = 3;
+    i3.reportFinished(&three);
+    i1.reportResult(1);
+    i1.reportFinished();
+    QVERIFY(!all.isFinished());
+    i2.reportCanceled();
+    i2.reportFinished();
+    QVERIFY(all.isFinished());
+    QVERIFY(!all.isCanceled());
+
+    const QList<QFuture<int> > results = all.result();
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results.at(0).result(), 1);
+    QVERIFY(results.at(1).isCanceled());
+    QCOMPARE(results.at(2).result(), 3);
+    QVERIFY(results.at(0) == futures.at(0));
+
+    const QList<QFuture<void> > none;
+    QFuture<QList<QFuture<void> > > empty = QtFuture::whenAll(none.begin(), none.end());
+    QVERIFY(empty.isFinished());
+    QVERIFY(empty.result().isEmpty());
+}
+
+void tst_QFuture::whenAny()
+{
+    QFutureInterface<int> i1, i2;
+    i1.reportStarted();
+    i2.reportStarted();
+    QVector<QFuture<int> > futures;
+    futures << i1.future() << i2.future();
+
+    QFuture<QtFuture::WhenAnyResult<int> > any = QtFuture::whenAny(futures.begin(), futures.end());
+    QVERIFY(!any.isFinished());
+    i2.reportResult(2);
+    i2.reportFinished();
+    QVERIFY(any.isFinished());
+    i1.reportResult(1);
+    i1.reportFinished();
+
+    const QtFuture::WhenAnyResult<int> result = any.result();
+    QCOMPARE(result.index, 1);
+    QCOMPARE(result.future.result(), 2);
+
+    const QList<QFuture<void> > none;
+    QFuture<QtFuture::WhenAnyResult<void> > empty = QtFuture::whenAny(none.begin(), none.end());
+    QVERIFY(empty.isFinished());
+    QCOMPARE(empty.result().index, -1);
+}
+
 QTEST_MAIN(tst_QFuture)
 #include "tst_qfuture.moc"
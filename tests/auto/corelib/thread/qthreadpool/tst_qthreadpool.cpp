@@ -93,6 +93,9 @@ private slots:
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
     void stackSize();
+    void workStealing_data();
+    void workStealing();
+    void workStealingTryTake();
     void stressTest();
     void takeAllAndIncreaseMaxThreadCount();
 
@@ -1171,6 +1174,96 @@ void tst_QThreadPool::stackSize()
     QCOMPARE(threadStackSize, targetStackSize);
 }
 
+void tst_QThreadPool::workStealing_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("8") << 8;
+}
+
+void tst_QThreadPool::workStealing()
+{
+    QFETCH(int, threadCount);
+
+    class FanOutTask : public QRunnable
+    {
+    public:
+        FanOutTask(QThreadPool *pool, QAtomicInt *count, int depth)
+            : pool(pool), count(count), depth(depth) {}
+
+        void run()
+        {
+            count->ref();
+            if (depth > 0) {
+                pool->start(new FanOutTask(pool, count, depth - 1));
+                pool->start(new FanOutTask(pool, count, depth - 1));
+            }
+        }
+
+    private:
+        QThreadPool *pool;
+        QAtomicInt *count;
+        int depth;
+    };
+
+    QThreadPool threadPool;
+    QVERIFY(!threadPool.isWorkStealingEnabled());
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(threadPool.isWorkStealingEnabled());
+    threadPool.setMaxThreadCount(threadCount);
+
+    // more children than fit into one local queue
+    const int depth = 12;
+    QAtomicInt count;
+    threadPool.start(new FanOutTask(&threadPool, &count, depth));
+    QVERIFY(threadPool.waitForDone(30000)); // 30s timeout
+    QCOMPARE(count.load(), (2 << depth) - 1);
+    QCOMPARE(threadPool.activeThreadCount(), 0);
+}
+
+void tst_QThreadPool::workStealingTryTake()
+{
+    class ChildTask : public QRunnable
+    {
+    public:
+        ChildTask() { setAutoDelete(false); }
+        void run() { ran = true; }
+        bool ran = false;
+    };
+
+    class ParentTask : public QRunnable
+    {
+    public:
+        ParentTask(QThreadPool *pool, ChildTask *child)
+            : pool(pool), child(child) {}
+
+        void run()
+        {
+            // the child is kept in this thread's local queue until the parent returns
+            pool->start(child);
+            taken = pool->tryTake(child);
+        }
+
+        QThreadPool *pool;
+        ChildTask *child;
+        bool taken = false;
+    };
+
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.setMaxThreadCount(1);
+
+    ChildTask child;
+    ParentTask parent(&threadPool, &child);
+    parent.setAutoDelete(false);
+    threadPool.start(&parent);
+    QVERIFY(threadPool.waitForDone(30000)); // 30s timeout
+    QVERIFY(parent.taken);
+    QVERIFY(!child.ran);
+}
+
 void tst_QThreadPool::stressTest()
 {
     class Task : public QRunnable
@@ -0,0 +1,312 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QString>
+#include <private/qflathash_p.h>
+#include <QtTest/QtTest>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertAndLookup();
+    void operatorBrackets();
+    void remove();
+    void eraseWhileIterating();
+    void tombstones();
+    void implicitSharing();
+    void reserveAndSqueeze();
+    void complexTypes();
+    void collisions();
+    void compare();
+};
+
+void tst_QFlatHash::insertAndLookup()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(0));
+    QCOMPARE(hash.value(0, -1), -1);
+    QVERIFY(hash.constFind(0) == hash.constEnd());
+    QVERIFY(hash.constBegin() == hash.constEnd());
+
+    const int count = 10000;
+    for (int i = 0; i < count; ++i)
+        hash.insert(i, i * 2);
+    QCOMPARE(hash.size(), count);
+    QVERIFY(hash.capacity() >= count);
+
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), i * 2);
+        QCOMPARE(hash.constFind(i).key(), i);
+    }
+    QVERIFY(!hash.contains(-1));
+    QVERIFY(!hash.contains(count));
+
+    // inserting an existing key replaces the value
+    QFlatHash<int, int>::iterator it = hash.insert(42, 0);
+    QCOMPARE(it.key(), 42);
+    QCOMPARE(*it, 0);
+    QCOMPARE(hash.size(), count);
+
+    int iterated = 0;
+    qint64 sum = 0;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        ++iterated;
+        sum += it.key();
+    }
+    QCOMPARE(iterated, count);
+    QCOMPARE(sum, qint64(count) * (count - 1) / 2);
+
+    QList<int> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys.size(), count);
+    QCOMPARE(keys.first(), 0);
+    QCOMPARE(keys.last(), count - 1);
+    QCOMPARE(hash.values().size(), count);
+}
+
+void tst_QFlatHash::operatorBrackets()
+{
+    QFlatHash<QString, int> hash;
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash[QStringLiteral("one")], 0);
+    QVERIFY(hash.isEmpty());
+
+    hash[QStringLiteral("one")] = 1;
+    ++hash[QStringLiteral("two")];
+    ++hash[QStringLiteral("two")];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(constHash[QStringLiteral("one")], 1);
+    QCOMPARE(constHash[QStringLiteral("two")], 2);
+
+    // the value may refer to the hash itself while it grows
+    QFlatHash<int, QString> strings;
+    strings.insert(0, QStringLiteral("zero"));
+    for (int i = 1; i < 1000; ++i)
+        strings.insert(i, strings[0]);
+    QCOMPARE(strings.size(), 1000);
+    QCOMPARE(strings.value(999), QStringLiteral("zero"));
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+
+    QCOMPARE(hash.remove(1000), 0);
+    for (int i = 0; i < 1000; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.size(), 500);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), i % 2 == 1);
+
+    QCOMPARE(hash.take(1), 1);
+    QCOMPARE(hash.take(1), 0);
+    QCOMPARE(hash.size(), 499);
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(3));
+}
+
+void tst_QFlatHash::eraseWhileIterating()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(hash.size(), 666);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+}
+
+void tst_QFlatHash::tombstones()
+{
+    // keep inserting and removing, the table must not fill up with deleted slots
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    const int capacity = hash.capacity();
+    for (int i = 100; i < 100000; ++i) {
+        hash.insert(i, i);
+        QCOMPARE(hash.remove(i - 100), 1);
+    }
+    QCOMPARE(hash.size(), 100);
+    QVERIFY(hash.capacity() <= 2 * capacity);
+    for (int i = 100000 - 100; i < 100000; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QStringLiteral("one"));
+    hash.insert(2, QStringLiteral("two"));
+
+    QFlatHash<int, QString> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    // lookups in a shared hash don't detach
+    QCOMPARE(qAsConst(copy).value(1), QStringLiteral("one"));
+    QVERIFY(copy.remove(3) == 0);
+    QVERIFY(copy.isSharedWith(hash));
+
+    copy.insert(3, QStringLiteral("three"));
+    QVERIFY(!copy.isSharedWith(hash));
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(copy.size(), 3);
+
+    // erasing through an iterator taken before detaching
+    copy = hash;
+    QFlatHash<int, QString>::const_iterator it = qAsConst(copy).constFind(2);
+    QFlatHash<int, QString>::iterator next = copy.erase(it);
+    Q_UNUSED(next);
+    QCOMPARE(copy.size(), 1);
+    QVERIFY(!copy.contains(2));
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(2), QStringLiteral("two"));
+
+    QFlatHash<int, QString> moved = std::move(copy);
+    QCOMPARE(moved.size(), 1);
+    QVERIFY(copy.isEmpty());
+
+    // iterating over or looking up in an empty hash doesn't allocate
+    QFlatHash<int, QString> empty;
+    QVERIFY(empty.begin() == empty.end());
+    QVERIFY(empty.find(1) == empty.end());
+    QCOMPARE(empty.capacity(), 0);
+
+    // nor does a failed lookup detach
+    copy = hash;
+    QVERIFY(copy.find(3) == qAsConst(copy).end());
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(copy.find(1) != copy.end());
+    QVERIFY(!copy.isSharedWith(hash));
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+}
+
+struct Counted
+{
+    Counted(int value = 0) : value(value) { ++instances; }
+    Counted(const Counted &other) : value(other.value) { ++instances; }
+    ~Counted() { --instances; }
+    Counted &operator=(const Counted &other) { value = other.value; return *this; }
+    bool operator==(const Counted &other) const { return value == other.value; }
+
+    int value;
+    static int instances;
+};
+int Counted::instances = 0;
+
+void tst_QFlatHash::complexTypes()
+{
+    {
+        QFlatHash<QString, Counted> hash;
+        for (int i = 0; i < 500; ++i)
+            hash.insert(QString::number(i), Counted(i));
+        QCOMPARE(Counted::instances, 500);
+        for (int i = 0; i < 500; i += 5)
+            hash.remove(QString::number(i));
+        QCOMPARE(Counted::instances, 400);
+        QFlatHash<QString, Counted> copy = hash;
+        copy[QStringLiteral("new")] = Counted(-1);
+        QCOMPARE(Counted::instances, 801);
+        QCOMPARE(copy.value(QStringLiteral("499")).value, 499);
+    }
+    QCOMPARE(Counted::instances, 0);
+}
+
+struct BadKey
+{
+    int value;
+    bool operator==(const BadKey &other) const { return value == other.value; }
+};
+uint qHash(const BadKey &, uint seed = 0) { return seed; }
+
+void tst_QFlatHash::collisions()
+{
+    // every key has the same hash: lookups must still find them all
+    QFlatHash<BadKey, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(BadKey{i}, i);
+    for (int i = 0; i < 200; i += 2)
+        hash.remove(BadKey{i});
+    QCOMPARE(hash.size(), 100);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(BadKey{i}, -1), i % 2 ? i : -1);
+}
+
+void tst_QFlatHash::compare()
+{
+    QFlatHash<int, int> a;
+    QFlatHash<int, int> b;
+    QVERIFY(a == b);
+    for (int i = 0; i < 100; ++i)
+        a.insert(i, i);
+    for (int i = 99; i >= 0; --i)
+        b.insert(i, i);
+    QVERIFY(a == b);
+    b.insert(50, 0);
+    QVERIFY(a != b);
+    b.remove(50);
+    QVERIFY(a != b);
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
@@ -89,6 +89,8 @@ private slots:
     void doubleToString();
     void strtod_data();
     void strtod();
+    void strtodExact_data();
+    void strtodExact();
     void long_long_conversion_data();
     void long_long_conversion();
     void long_long_conversion_extra();
@@ -1030,6 +1032,58 @@ void tst_QLocale::strtod()
     QCOMPARE(actualOk, ok);
 }
 
+void tst_QLocale::strtodExact_data()
+{
+    QTest::addColumn<QString>("num_str");
+    QTest::addColumn<double>("num");
+
+    // QCOMPARE() is fuzzy for doubles, so these are compared bit by bit. The
+    // rows exercise the exact fast paths as well as the cases they defer to
+    // the general parser: ties, subnormals, overflow and long mantissas.
+    QTest::newRow("0.1")              << QString("0.1")                     << 0.1;
+    QTest::newRow("-0.0")             << QString("-0.0")                    << -0.0;
+    QTest::newRow("1e22")             << QString("1e22")                    << 1e22;
+    QTest::newRow("1e23")             << QString("1e23")                    << 1e23;
+    QTest::newRow("2^53+1")           << QString("9007199254740993")        << 9007199254740993.0;
+    QTest::newRow("2^53+3")           << QString("9007199254740995")        << 9007199254740995.0;
+    QTest::newRow("19 digits")        << QString("1234567890123456789")     << 1234567890123456789.0;
+    QTest::newRow("20 digits")        << QString("12345678901234567890")    << 12345678901234567890.0;
+    QTest::newRow("long fraction")    << QString("3.14159265358979323846264338327950288")
+                                      << 3.14159265358979323846264338327950288;
+    QTest::newRow("trailing zeroes")  << QString("1.50000000000000000000000000") << 1.5;
+    QTest::newRow("leading zeroes")   << QString("0000000000000000000000001.25") << 1.25;
+    QTest::newRow("small fraction")   << QString("0.000000000000000000000000123") << 1.23e-25;
+    QTest::newRow("min normal")       << QString("2.2250738585072014e-308") << 2.2250738585072014e-308;
+    QTest::newRow("subnormal")        << QString("2.2250738585072011e-308") << 2.2250738585072011e-308;
+    QTest::newRow("min subnormal")    << QString("4.9406564584124654e-324") << 4.9406564584124654e-324;
+    QTest::newRow("max")              << QString("1.7976931348623157e308") << 1.7976931348623157e308;
+    QTest::newRow("halfway")          << QString("7.2057594037927933e16")   << 7.2057594037927933e16;
+    QTest::newRow("large exponent")   << QString("8.98846567431158e307")    << 8.98846567431158e307;
+    QTest::newRow("uppercase E")      << QString("-6.02214076E+23")         << -6.02214076e23;
+}
+
+void tst_QLocale::strtodExact()
+{
+    QFETCH(QString, num_str);
+    QFETCH(double, num);
+
+    quint64 expected;
+    memcpy(&expected, &num, sizeof(num));
+    auto bits = [](double d) { quint64 b; memcpy(&b, &d, sizeof(d)); return b; };
+
+    bool ok = false;
+    QCOMPARE(bits(num_str.toLatin1().toDouble(&ok)), expected);
+    QVERIFY(ok);
+
+    ok = false;
+    QCOMPARE(bits(num_str.toDouble(&ok)), expected);
+    QVERIFY(ok);
+
+    ok = false;
+    QCOMPARE(bits(QLocale::c().toDouble(num_str, &ok)), expected);
+    QVERIFY(ok);
+}
+
 void tst_QLocale::long_long_conversion_data()
 {
     QTest::addColumn<QString>("locale_name");
@@ -1081,6 +1135,15 @@ void tst_QLocale::long_long_conversion_data()
     QTest::newRow("C   1234")                 << QString("C")     << "  1234"        << true  << (qlonglong) 1234;
     QTest::newRow("C 1234  ")                 << QString("C")     << "1234  "        << true  << (qlonglong) 1234;
     QTest::newRow("C   1234  ")               << QString("C")     << "  1234  "      << true  << (qlonglong) 1234;
+
+    QTest::newRow("C max")                    << QString("C")     << "9223372036854775807"  << true  << Q_INT64_C(9223372036854775807);
+    QTest::newRow("C min")                    << QString("C")     << "-9223372036854775808" << true  << (-Q_INT64_C(9223372036854775807) - 1);
+    QTest::newRow("C max+1")                  << QString("C")     << "9223372036854775808"  << false << (qlonglong) 0;
+    QTest::newRow("C min-1")                  << QString("C")     << "-9223372036854775809" << false << (qlonglong) 0;
+    QTest::newRow("C 20 digits")              << QString("C")     << "12345678901234567890" << false << (qlonglong) 0;
+    QTest::newRow("C leading zeroes")         << QString("C")     << "00000000000000000000001" << true << (qlonglong) 1;
+    QTest::newRow("C +1234")                  << QString("C")     << "+1234"         << true  << (qlonglong) 1234;
+    QTest::newRow("C -0")                     << QString("C")     << "-0"            << true  << (qlonglong) 0;
 }
 
 void tst_QLocale::long_long_conversion()
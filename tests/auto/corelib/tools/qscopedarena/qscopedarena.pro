@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qscopedarena
+QT = core-private testlib
+SOURCES = tst_qscopedarena.cpp
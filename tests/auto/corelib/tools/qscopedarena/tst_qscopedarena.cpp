@@ -0,0 +1,194 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/private/qscopedarena_p.h>
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+class tst_QScopedArena : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void current();
+    void containers();
+    void growInPlace();
+    void escape();
+    void crossThreadFree();
+    void largeAllocation();
+};
+
+void tst_QScopedArena::initTestCase()
+{
+#ifndef QT_HAS_SCOPED_ARENA
+    QSKIP("QScopedArena is not supported on this platform");
+#endif
+}
+
+void tst_QScopedArena::current()
+{
+    QVERIFY(!QScopedArena::current());
+    {
+        QScopedArena outer;
+        QCOMPARE(QScopedArena::current(), &outer);
+        {
+            QScopedArena inner;
+            QCOMPARE(QScopedArena::current(), &inner);
+            QString s = QString::number(42);
+            QVERIFY(inner.bytesUsed() > 0);
+            QCOMPARE(outer.bytesUsed(), size_t(0));
+        }
+        QCOMPARE(QScopedArena::current(), &outer);
+    }
+    QVERIFY(!QScopedArena::current());
+}
+
+void tst_QScopedArena::containers()
+{
+    QScopedArena arena;
+
+    QVector<int> vector;
+    QHash<int, QString> hash;
+    QMap<QString, int> map;
+    for (int i = 0; i < 1000; ++i) {
+        vector.append(i);
+        hash.insert(i, QString::number(i));
+        map.insert(QString::number(i), i);
+    }
+    QVERIFY(arena.bytesUsed() > 0);
+
+    for (int i = 0; i < 1000; i += 2) {
+        hash.remove(i);
+        map.remove(QString::number(i));
+    }
+    QCOMPARE(vector.size(), 1000);
+    QCOMPARE(hash.size(), 500);
+    QCOMPARE(map.size(), 500);
+    for (int i = 1; i < 1000; i += 2) {
+        QCOMPARE(vector.at(i), i);
+        QCOMPARE(hash.value(i), QString::number(i));
+        QCOMPARE(map.value(QString::number(i)), i);
+    }
+}
+
+void tst_QScopedArena::growInPlace()
+{
+    QScopedArena arena;
+    QString s;
+    for (int i = 0; i < 2000; ++i)
+        s.append(QLatin1Char('a' + i % 26));
+    QCOMPARE(s.size(), 2000);
+    for (int i = 0; i < 2000; ++i)
+        QCOMPARE(s.at(i), QLatin1Char('a' + i % 26));
+    s.squeeze();
+    QCOMPARE(s.size(), 2000);
+    QCOMPARE(s.at(1999), QLatin1Char('a' + 1999 % 26));
+}
+
+void tst_QScopedArena::escape()
+{
+    QString escaped;
+    QHash<int, QString> escapedHash;
+    {
+        QScopedArena arena;
+        QString local = QString::number(1234).repeated(8);
+        escaped = local;
+        for (int i = 0; i < 100; ++i)
+            escapedHash.insert(i, QString::number(i));
+    }
+
+    // The memory must stay valid after the arena is gone and must be
+    // released correctly when the containers are destroyed later.
+    QCOMPARE(escaped, QString::number(1234).repeated(8));
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(escapedHash.value(i), QString::number(i));
+    escapedHash.clear();
+    escaped.append(QLatin1String("more"));
+    QVERIFY(escaped.endsWith(QLatin1String("more")));
+    escaped.clear();
+}
+
+class DestroyThread : public QThread
+{
+public:
+    QVector<QString> strings;
+    void run() override { strings.clear(); }
+};
+
+class ProduceThread : public QThread
+{
+public:
+    QVector<QString> strings;
+    void run() override
+    {
+        QScopedArena arena;
+        for (int i = 0; i < 10000; ++i)
+            strings.append(QString::number(i));
+    }
+};
+
+void tst_QScopedArena::crossThreadFree()
+{
+    DestroyThread thread;
+    {
+        QScopedArena arena;
+        for (int i = 0; i < 10000; ++i)
+            thread.strings.append(QString::number(i));
+    }
+    thread.start();
+    QVERIFY(thread.wait());
+    QVERIFY(thread.strings.isEmpty());
+
+    // The other direction: strings allocated from another thread's arena
+    // and freed here.
+    ProduceThread producer;
+    producer.start();
+    QVERIFY(producer.wait());
+    QCOMPARE(producer.strings.size(), 10000);
+    QCOMPARE(producer.strings.last(), QString::number(9999));
+    producer.strings.clear();
+}
+
+void tst_QScopedArena::largeAllocation()
+{
+    QScopedArena arena;
+    QByteArray small(16, 'x');
+    const size_t used = arena.bytesUsed();
+    QVERIFY(used > 0);
+    QByteArray large(1024 * 1024, 'y');
+    QCOMPARE(arena.bytesUsed(), used);
+    QCOMPARE(large.count('y'), 1024 * 1024);
+}
+
+QTEST_APPLESS_MAIN(tst_QScopedArena)
+#include "tst_qscopedarena.moc"
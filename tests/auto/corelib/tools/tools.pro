@@ -20,6 +20,7 @@ SUBDIRS=\
     qdatetime \
     qeasingcurve \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
@@ -42,6 +43,7 @@ SUBDIRS=\
     qregexp \
     qregularexpression \
     qringbuffer \
+    qscopedarena \
     qscopedpointer \
     qscopedvaluerollback \
     qset \
@@ -577,7 +577,7 @@ void Http2Server::handleIncomingFrame()
         // TODO: this is not tested for now.
         break;
     case FrameType::PING:
-        // TODO: this is not tested for now.
+        handlePING();
         break;
     case FrameType::GOAWAY:
         // TODO: this is not tested for now.
@@ -727,6 +727,19 @@ void Http2Server::handleWINDOW_UPDATE()
     sendDATA(streamID, delta);
 }
 
+void Http2Server::handlePING()
+{
+    // Only ACK, the client's PING is used to measure the round-trip time.
+    if (inboundFrame.streamID() != connectionStreamID
+        || inboundFrame.flags().testFlag(FrameFlag::ACK)) {
+        return;
+    }
+
+    writer.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
+    writer.append(inboundFrame.dataBegin(), inboundFrame.dataBegin() + 8);
+    writer.write(*socket);
+}
+
 void Http2Server::sendResponse(quint32 streamID, bool emptyBody)
 {
     Q_ASSERT(activeRequests.find(streamID) != activeRequests.end());
@@ -105,6 +105,7 @@ public:
     Q_INVOKABLE void handleSETTINGS();
     Q_INVOKABLE void handleDATA();
     Q_INVOKABLE void handleWINDOW_UPDATE();
+    Q_INVOKABLE void handlePING();
 
     Q_INVOKABLE void sendResponse(quint32 streamID, bool emptyBody);
 
@@ -31,6 +31,7 @@
 #include "http2srv.h"
 
 #include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qhttp2configuration.h>
 #include <QtNetwork/qnetworkrequest.h>
 #include <QtNetwork/qnetworkreply.h>
 #include <QtCore/qglobal.h>
@@ -73,6 +74,7 @@ private slots:
     void pushPromise();
     void goaway_data();
     void goaway();
+    void configuration();
 
 protected slots:
     // Slots to listen to our in-process server:
@@ -452,6 +454,66 @@ void tst_Http2::goaway()
     QVERIFY(!serverGotSettingsACK);
 }
 
+void tst_Http2::configuration()
+{
+    // Non-default HTTP/2 parameters must be advertised in our SETTINGS
+    // (the server verifies them) and respected by the flow control.
+    using namespace Http2;
+
+    clearHTTP2State();
+
+    serverPort = 0;
+    nRequests = 1;
+
+    QHttp2Configuration config;
+    QTest::ignoreMessage(QtWarningMsg, "Maximum frame size to advertise is invalid 1024");
+    QVERIFY(!config.setMaxFrameSize(1024));
+    QCOMPARE(config.maxFrameSize(), unsigned(Http2::maxFrameSize));
+    QVERIFY(config.setMaxFrameSize(Http2::maxFrameSize * 4));
+    QVERIFY(config.setStreamReceiveWindowSize(Http2::maxFrameSize * 8));
+    QTest::ignoreMessage(QtWarningMsg, "Header table size to advertise is invalid 1048576");
+    QVERIFY(!config.setHeaderTableSize(1024 * 1024));
+    QCOMPARE(config.headerTableSize(), unsigned(HPack::FieldLookupTable::DefaultSize));
+    QVERIFY(config.setHeaderTableSize(HPack::FieldLookupTable::DefaultSize * 2));
+    config.setWindowAutoTuningEnabled(true);
+
+    const Http2Settings clientSettings{{Settings::MAX_FRAME_SIZE_ID, quint32(config.maxFrameSize())},
+                                       {Settings::INITIAL_WINDOW_SIZE_ID, quint32(config.streamReceiveWindowSize())},
+                                       {Settings::ENABLE_PUSH_ID, quint32(0)},
+                                       {Settings::HEADER_TABLE_SIZE_ID, quint32(config.headerTableSize())}};
+
+    ServerPtr srv(newServer(defaultServerSettings, clientSettings));
+    const QByteArray respond(int(config.streamReceiveWindowSize() * 4), 'x');
+    srv->setResponseBody(respond);
+
+    QMetaObject::invokeMethod(srv.data(), "startServer", Qt::QueuedConnection);
+    runEventLoop();
+
+    QVERIFY(serverPort != 0);
+
+    auto url = requestUrl();
+    url.setPath("/index.html");
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, QVariant(true));
+    request.setHttp2Configuration(config);
+    QCOMPARE(request.http2Configuration(), config);
+
+    auto reply = manager.get(request);
+    connect(reply, &QNetworkReply::finished, this, &tst_Http2::replyFinished);
+    reply->ignoreSslErrors();
+
+    runEventLoop();
+
+    QVERIFY(nRequests == 0);
+    QVERIFY(prefaceOK);
+    QVERIFY(serverGotSettingsACK);
+
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(reply->isFinished());
+    QCOMPARE(reply->readAll(), respond);
+}
+
 void tst_Http2::serverStarted(quint16 port)
 {
     serverPort = port;
@@ -30,6 +30,9 @@
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QAuthenticator>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
 #ifndef QT_NO_BEARERMANAGEMENT
 #include <QtNetwork/QNetworkConfigurationManager>
 #endif
@@ -40,6 +43,92 @@
 Q_DECLARE_METATYPE(QNetworkAccessManager::NetworkAccessibility)
 #endif
 
+// Keep-alive HTTP server answering GET requests. Paths starting with
+// /secret need Basic authentication; every request's path and
+// Authorization header are recorded.
+class PoolTestServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    int totalConnections;
+    QList<QPair<QByteArray, QByteArray> > requests;
+
+    PoolTestServer() : totalConnections(0)
+    {
+        listen(QHostAddress::LocalHost);
+        connect(this, SIGNAL(newConnection()), this, SLOT(doAccept()));
+    }
+
+    QUrl url(const char *path) const
+    {
+        return QUrl(QStringLiteral("http://127.0.0.1:%1%2").arg(serverPort())
+                    .arg(QLatin1String(path)));
+    }
+
+    QList<QByteArray> authorizationsFor(const QByteArray &path) const
+    {
+        QList<QByteArray> result;
+        for (const auto &request : requests) {
+            if (request.first == path)
+                result << request.second;
+        }
+        return result;
+    }
+
+private slots:
+    void doAccept()
+    {
+        while (QTcpSocket *client = nextPendingConnection()) {
+            client->setParent(this);
+            ++totalConnections;
+            connect(client, SIGNAL(readyRead()), this, SLOT(readyReadSlot()));
+        }
+    }
+
+    void readyReadSlot()
+    {
+        QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
+        QByteArray data = client->property("pending").toByteArray() + client->readAll();
+        int end;
+        while ((end = data.indexOf("\r\n\r\n")) != -1) {
+            const QList<QByteArray> lines = data.left(end).split('\n');
+            data.remove(0, end + 4);
+
+            const QByteArray path = lines.first().split(' ').value(1);
+            QByteArray authorization;
+            for (const QByteArray &line : lines) {
+                if (line.toLower().startsWith("authorization:"))
+                    authorization = line.mid(14).trimmed();
+            }
+            requests << qMakePair(path, authorization);
+
+            QByteArray response;
+            if (path.startsWith("/secret") && authorization.isEmpty()) {
+                response = "HTTP/1.1 401 Unauthorized\r\n"
+                           "WWW-Authenticate: Basic realm=\"pool\"\r\n"
+                           "Content-Length: 0\r\n\r\n";
+            } else {
+                response = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+            }
+            // An idle HTTP/1 channel gets closed if the response arrives
+            // while the request is still being sent, so don't answer at once.
+            QTimer::singleShot(10, client, [client, response]() { client->write(response); });
+        }
+        client->setProperty("pending", data);
+    }
+};
+
+// The reply is deleted with the manager.
+static QNetworkReply::NetworkError fetch(QNetworkAccessManager &manager, const QUrl &url)
+{
+    QNetworkReply *reply = manager.get(QNetworkRequest(url));
+    if (!reply->isFinished()) {
+        QSignalSpy finished(reply, SIGNAL(finished()));
+        finished.wait(10000);
+    }
+    return reply->isFinished() ? reply->error() : QNetworkReply::TimeoutError;
+}
+
 class tst_QNetworkAccessManager : public QObject
 {
     Q_OBJECT
@@ -50,6 +139,8 @@ public:
 private slots:
     void networkAccessible();
     void alwaysCacheRequest();
+    void sharedConnectionPool();
+    void sharedConnectionPoolCredentials();
 };
 
 tst_QNetworkAccessManager::tst_QNetworkAccessManager()
@@ -129,5 +220,87 @@ void tst_QNetworkAccessManager::alwaysCacheRequest()
     delete reply;
 }
 
+void tst_QNetworkAccessManager::sharedConnectionPool()
+{
+    QCOMPARE(QNetworkAccessManager::sharedConnectionPoolMaximumStreams(), 0);
+    QCOMPARE(QNetworkAccessManager::sharedConnectionPoolIdleTimeout(), 120);
+    QNetworkAccessManager::setSharedConnectionPoolMaximumStreams(8);
+    QNetworkAccessManager::setSharedConnectionPoolIdleTimeout(5);
+    QCOMPARE(QNetworkAccessManager::sharedConnectionPoolMaximumStreams(), 8);
+    QCOMPARE(QNetworkAccessManager::sharedConnectionPoolIdleTimeout(), 5);
+
+    QScopedPointer<QNetworkAccessManager> first(new QNetworkAccessManager);
+    QScopedPointer<QNetworkAccessManager> second(new QNetworkAccessManager);
+    QVERIFY(!first->isSharedConnectionPoolEnabled());
+    first->setSharedConnectionPoolEnabled(true);
+    second->setSharedConnectionPoolEnabled(true);
+    QVERIFY(first->isSharedConnectionPoolEnabled());
+
+    // Both managers' requests must go over the same connection.
+    PoolTestServer server;
+    QVERIFY(server.isListening());
+    QCOMPARE(fetch(*first, server.url("/first")), QNetworkReply::NoError);
+    QCOMPARE(fetch(*second, server.url("/second")), QNetworkReply::NoError);
+    QCOMPARE(server.requests.size(), 2);
+    QCOMPARE(server.totalConnections, 1);
+
+    // A manager with its own connections doesn't use the pooled one.
+    {
+        QNetworkAccessManager own;
+        QCOMPARE(fetch(own, server.url("/own")), QNetworkReply::NoError);
+        QCOMPARE(server.totalConnections, 2);
+    }
+
+    // Dropping one user must leave the pool working for the other.
+    first.reset();
+    QCOMPARE(fetch(*second, server.url("/third")), QNetworkReply::NoError);
+    QCOMPARE(server.totalConnections, 2);
+    second.reset();
+
+    QNetworkAccessManager::setSharedConnectionPoolMaximumStreams(0);
+    QNetworkAccessManager::setSharedConnectionPoolIdleTimeout(120);
+}
+
+void tst_QNetworkAccessManager::sharedConnectionPoolCredentials()
+{
+    PoolTestServer server;
+    QVERIFY(server.isListening());
+
+    QNetworkAccessManager first;
+    QNetworkAccessManager second;
+    first.setSharedConnectionPoolEnabled(true);
+    second.setSharedConnectionPoolEnabled(true);
+    connect(&first, &QNetworkAccessManager::authenticationRequired,
+            [](QNetworkReply *, QAuthenticator *authenticator) {
+        authenticator->setUser(QStringLiteral("alice"));
+        authenticator->setPassword(QStringLiteral("secret"));
+    });
+
+    // The first manager authenticates on the connection both have used.
+    QCOMPARE(fetch(first, server.url("/public")), QNetworkReply::NoError);
+    QCOMPARE(fetch(second, server.url("/public")), QNetworkReply::NoError);
+    QCOMPARE(server.totalConnections, 1);
+    QCOMPARE(fetch(first, server.url("/secret/first")), QNetworkReply::NoError);
+    QCOMPARE(server.authorizationsFor("/secret/first").last(),
+             QByteArray("Basic " + QByteArray("alice:secret").toBase64()));
+
+    // Its credentials must not be sent on behalf of the second manager,
+    // which has none.
+    QCOMPARE(fetch(second, server.url("/secret/second")),
+             QNetworkReply::AuthenticationRequiredError);
+    QCOMPARE(fetch(second, server.url("/public/second")), QNetworkReply::NoError);
+    QCOMPARE(server.authorizationsFor("/secret/second"), QList<QByteArray>() << QByteArray());
+    QCOMPARE(server.authorizationsFor("/public/second"), QList<QByteArray>() << QByteArray());
+
+    // The first manager now has cached credentials and so a connection of
+    // its own.
+    const int connections = server.totalConnections;
+    QCOMPARE(fetch(first, server.url("/secret/again")), QNetworkReply::NoError);
+    QCOMPARE(server.totalConnections, connections + 1);
+    QCOMPARE(fetch(second, server.url("/public/third")), QNetworkReply::NoError);
+    QCOMPARE(server.totalConnections, connections + 1);
+    QCOMPARE(server.authorizationsFor("/public/third"), QList<QByteArray>() << QByteArray());
+}
+
 QTEST_MAIN(tst_QNetworkAccessManager)
 #include "tst_qnetworkaccessmanager.moc"
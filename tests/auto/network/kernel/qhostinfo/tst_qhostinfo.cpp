@@ -46,6 +46,8 @@
 #include <QTcpSocket>
 #include <private/qthread_p.h>
 #include <QTcpServer>
+#include <QUdpSocket>
+#include <QNetworkDatagram>
 
 #ifndef QT_NO_BEARERMANAGEMENT
 #include <QtNetwork/qnetworkconfigmanager.h>
@@ -111,6 +113,10 @@ private slots:
     void cache();
 
     void abortHostLookup();
+
+#if defined(QT_BUILD_INTERNAL) && QT_CONFIG(dnsstubresolver)
+    void stubResolver();
+#endif
 protected slots:
     void resultsReady(const QHostInfo &);
 
@@ -664,6 +670,155 @@ void tst_QHostInfo::abortHostLookup()
     QCOMPARE(lookupsDoneCounter, 0);
 }
 
+#if defined(QT_BUILD_INTERNAL) && QT_CONFIG(dnsstubresolver)
+// Answers "found.test" with 192.0.2.1 (TTL of one second) and no IPv6
+// address, "missing.test" with NXDOMAIN and "truncated.test" with a
+// truncated answer of 192.0.2.2. Everything else is refused.
+class FakeDnsServer : public QObject
+{
+    Q_OBJECT
+public:
+    bool bind()
+    {
+        if (!socket.bind(QHostAddress(QHostAddress::LocalHost)))
+            return false;
+        connect(&socket, &QUdpSocket::readyRead, this, &FakeDnsServer::processQueries);
+        return true;
+    }
+    quint16 port() const { return socket.localPort(); }
+
+    QHash<QByteArray, int> queries;
+    QHash<QByteArray, QSet<quint16> > sourcePorts;
+
+private:
+    void processQueries()
+    {
+        while (socket.hasPendingDatagrams()) {
+            const QNetworkDatagram datagram = socket.receiveDatagram();
+            const QByteArray query = datagram.data();
+            if (query.size() < 12)
+                continue;
+
+            // the question: a sequence of labels, type and class
+            QByteArray name;
+            int offset = 12;
+            while (offset < query.size() && query.at(offset)) {
+                const int length = quint8(query.at(offset));
+                if (!name.isEmpty())
+                    name += '.';
+                name += query.mid(offset + 1, length);
+                offset += length + 1;
+            }
+            offset += 5;
+            if (offset > query.size())
+                continue;
+            const quint16 type = qFromBigEndian<quint16>(query.constData() + offset - 4);
+            ++queries[name];
+            sourcePorts[name].insert(datagram.senderPort());
+
+            quint16 flags = 0x8180; // response, recursion desired and available
+            QByteArray records;
+            int answers = 0;
+            int authorities = 0;
+            if (name == "found.test") {
+                if (type == 1) {
+                    // A 192.0.2.1, pointing back at the name in the question
+                    records += QByteArray::fromHex("c00c" "0001" "0001" "00000001" "0004" "c0000201");
+                    answers = 1;
+                }
+            } else if (name == "missing.test") {
+                flags |= 3; // NXDOMAIN
+                // SOA with a TTL of 60 seconds and a minimum of 30
+                records += QByteArray::fromHex("00" "0006" "0001" "0000003c" "0016" "00" "00"
+                                               "00000001" "00000e10" "00000258" "00093a80" "0000001e");
+                authorities = 1;
+            } else if (name == "truncated.test") {
+                flags |= 0x0200; // TC
+                if (type == 1) {
+                    records += QByteArray::fromHex("c00c" "0001" "0001" "0000003c" "0004" "c0000202");
+                    answers = 1;
+                }
+            } else {
+                flags |= 5; // REFUSED
+            }
+
+            QByteArray response = query.left(offset);
+            qToBigEndian<quint16>(flags, response.data() + 2);
+            qToBigEndian<quint16>(1, response.data() + 4);
+            qToBigEndian<quint16>(answers, response.data() + 6);
+            qToBigEndian<quint16>(authorities, response.data() + 8);
+            qToBigEndian<quint16>(0, response.data() + 10);
+            response += records;
+            socket.writeDatagram(datagram.makeReply(response));
+        }
+    }
+
+    QUdpSocket socket;
+};
+
+void tst_QHostInfo::stubResolver()
+{
+    QFETCH_GLOBAL(bool, cache);
+
+    FakeDnsServer server;
+    QVERIFY(server.bind());
+    qt_qhostinfo_set_nameserver(QHostAddress::LocalHost, server.port());
+    struct ResetNameserver {
+        ~ResetNameserver() { qt_qhostinfo_set_nameserver(QHostAddress(), 0); }
+    } resetNameserver;
+
+    // two lookups for the same name share the queries
+    lookupsDoneCounter = 0;
+    QHostInfo::lookupHost("found.test", this, SLOT(resultsReady(QHostInfo)));
+    QHostInfo::lookupHost("found.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 2);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(lookupResults.addresses(), QList<QHostAddress>() << QHostAddress("192.0.2.1"));
+    QCOMPARE(server.queries.value("found.test"), 2); // A and AAAA
+
+    // a name that doesn't exist is remembered as well
+    lookupsDoneCounter = 0;
+    QHostInfo::lookupHost("missing.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 1);
+    QCOMPARE(lookupResults.error(), QHostInfo::HostNotFound);
+    QCOMPARE(server.queries.value("missing.test"), 2);
+
+    QHostInfo::lookupHost("missing.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 2);
+    QCOMPARE(lookupResults.error(), QHostInfo::HostNotFound);
+    QCOMPARE(server.queries.value("missing.test"), cache ? 2 : 4);
+
+    // the positive answer is only cached for its TTL
+    QHostInfo::lookupHost("found.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 3);
+    QCOMPARE(server.queries.value("found.test"), cache ? 2 : 4);
+
+    QTest::qWait(1500);
+    QHostInfo::lookupHost("found.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 4);
+    QCOMPARE(lookupResults.addresses(), QList<QHostAddress>() << QHostAddress("192.0.2.1"));
+    QCOMPARE(server.queries.value("found.test"), cache ? 4 : 6);
+
+    // a truncated answer is not taken for the whole answer, the system
+    // resolver gets asked instead
+    lookupsDoneCounter = 0;
+    QHostInfo::lookupHost("truncated.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE_WITH_TIMEOUT(lookupsDoneCounter, 1, 30000);
+    QVERIFY(server.queries.value("truncated.test") > 0);
+    QVERIFY(!lookupResults.addresses().contains(QHostAddress("192.0.2.2")));
+
+    // concurrent lookups don't share a source port
+    lookupsDoneCounter = 0;
+    QHostInfo::lookupHost("refused1.test", this, SLOT(resultsReady(QHostInfo)));
+    QHostInfo::lookupHost("refused2.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 2);
+    QCOMPARE(lookupResults.error(), QHostInfo::UnknownError);
+    QVERIFY(!server.sourcePorts.value("refused1.test").isEmpty());
+    QVERIFY(!server.sourcePorts.value("refused2.test").isEmpty());
+    QVERIFY(!server.sourcePorts.value("refused1.test").intersects(server.sourcePorts.value("refused2.test")));
+}
+#endif
+
 class LookupAborter : public QObject
 {
     Q_OBJECT
@@ -117,6 +117,8 @@ private slots:
 
     void canAccessPendingConnectionsWhileNotListening();
 
+    void portSharing();
+
 private:
     bool shouldSkipIpv6TestsForBrokenGetsockopt();
 #ifdef SHOULD_CHECK_SYSCALL_SUPPORT
@@ -1052,5 +1054,57 @@ void tst_QTcpServer::canAccessPendingConnectionsWhileNotListening()
     QCOMPARE(&socket, server.nextPendingConnection());
 }
 
+void tst_QTcpServer::portSharing()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        QSKIP("Port sharing is a property of the native socket engine, not of proxies");
+
+    QTcpServer first;
+    QVERIFY(!first.isPortSharingEnabled());
+    first.setPortSharingEnabled(true);
+    QVERIFY(first.isPortSharingEnabled());
+
+#ifdef Q_OS_LINUX
+    QVERIFY2(first.listen(QHostAddress::LocalHost), qPrintable(first.errorString()));
+
+    // a server without port sharing cannot join in
+    QTcpServer intruder;
+    QVERIFY(!intruder.listen(QHostAddress::LocalHost, first.serverPort()));
+    QCOMPARE(intruder.serverError(), QAbstractSocket::AddressInUseError);
+
+    QTcpServer second;
+    second.setPortSharingEnabled(true);
+    QVERIFY2(second.listen(QHostAddress::LocalHost, first.serverPort()),
+             qPrintable(second.errorString()));
+
+    // every connection is accepted by one of the two servers
+    QList<QTcpSocket *> clients;
+    for (int i = 0; i < 20; ++i) {
+        QTcpSocket *client = new QTcpSocket(this);
+        client->connectToHost(QHostAddress::LocalHost, first.serverPort());
+        QVERIFY(client->waitForConnected(5000));
+        clients << client;
+    }
+    int accepted = 0;
+    QElapsedTimer timer;
+    timer.start();
+    while (accepted < clients.size() && timer.elapsed() < 10000) {
+        for (QTcpServer *server : { &first, &second }) {
+            server->waitForNewConnection(10);
+            while (QTcpSocket *socket = server->nextPendingConnection()) {
+                ++accepted;
+                delete socket;
+            }
+        }
+    }
+    QCOMPARE(accepted, clients.size());
+    qDeleteAll(clients);
+#else
+    QVERIFY(!first.listen(QHostAddress::LocalHost));
+    QCOMPARE(first.serverError(), QAbstractSocket::UnsupportedSocketOperationError);
+#endif
+}
+
 QTEST_MAIN(tst_QTcpServer)
 #include "tst_qtcpserver.moc"
@@ -58,6 +58,7 @@
 # include <QProcess>
 #endif
 #include <QStringList>
+#include <QTemporaryFile>
 #include <QTcpServer>
 #include <QTcpSocket>
 #ifndef QT_NO_SSL
@@ -201,6 +202,7 @@ private slots:
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
     void readNotificationsAfterBind();
+    void sendFile();
 
 protected slots:
     void nonBlockingIMAP_hostFound();
@@ -3139,5 +3141,59 @@ void tst_QTcpSocket::readNotificationsAfterBind()
     QCOMPARE(spyReadyRead.count(), 0);
 }
 
+void tst_QTcpSocket::sendFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        QSKIP("sendFile() is tested against a local server; proxies add nothing");
+
+    QByteArray contents;
+    for (int i = 0; i < 100000; ++i)
+        contents += char('a' + i % 26);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+    QVERIFY(file.flush());
+
+    QTcpServer tcpServer;
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY2(tcpServer.waitForNewConnection(5000), "Network timeout");
+    QTcpSocket *newConnection = tcpServer.nextPendingConnection();
+    QVERIFY(newConnection != nullptr);
+
+    // data written around the file must keep its place in the stream
+    QCOMPARE(socket->write("head"), qint64(4));
+    QVERIFY(socket->sendFile(&file, 10, 60000));
+    QCOMPARE(socket->write("middle"), qint64(6));
+    QVERIFY(socket->sendFile(&file, 90000));
+    QCOMPARE(socket->write("tail"), qint64(4));
+    QCOMPARE(socket->bytesToWrite(), qint64(4 + 60000 + 6 + 10000 + 4));
+    QVERIFY(!socket->sendFile(&file, 90000, 10001));
+
+    const QByteArray expected = "head" + contents.mid(10, 60000) + "middle"
+            + contents.mid(90000) + "tail";
+    QSignalSpy bytesWrittenSpy(socket, SIGNAL(bytesWritten(qint64)));
+    QByteArray received;
+    QElapsedTimer timer;
+    timer.start();
+    while (received.size() < expected.size() && timer.elapsed() < 10000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+        received += newConnection->readAll();
+    }
+    QCOMPARE(received, expected);
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+
+    qint64 bytesWritten = 0;
+    for (const QList<QVariant> &arguments : qAsConst(bytesWrittenSpy))
+        bytesWritten += arguments.at(0).toLongLong();
+    QCOMPARE(bytesWritten, qint64(expected.size()));
+
+    delete newConnection;
+    delete socket;
+}
+
 QTEST_MAIN(tst_QTcpSocket)
 #include "tst_qtcpsocket.moc"
@@ -95,6 +95,9 @@ private slots:
     void outOfProcessConnectedClientServerTest();
     void outOfProcessUnconnectedClientServerTest();
     void zeroLengthDatagram();
+    void receiveDatagrams();
+    void receiveDatagramsTruncated();
+    void writeDatagramsPartial();
     void multicastTtlOption_data();
     void multicastTtlOption();
     void multicastLoopbackOption_data();
@@ -1156,6 +1159,140 @@ void tst_QUdpSocket::zeroLengthDatagram()
     QCOMPARE(receiver.readDatagram(&buf, 1), qint64(0));
 }
 
+void tst_QUdpSocket::receiveDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket receiver;
+#ifdef FORCE_SESSION
+    receiver.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+
+    QUdpSocket sender;
+#ifdef FORCE_SESSION
+    sender.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QVERIFY(sender.bind(QHostAddress(QHostAddress::LocalHost), 0));
+
+    // more than fit in one batch, of varying sizes
+    QVector<QNetworkDatagram> datagrams;
+    for (int i = 0; i < 100; ++i) {
+        datagrams << QNetworkDatagram(QByteArray(i * 10, char('a' + i % 26)),
+                                      QHostAddress::LocalHost, receiver.localPort());
+    }
+    QCOMPARE(sender.writeDatagrams(datagrams), datagrams.size());
+    QCOMPARE(sender.writeDatagrams(QVector<QNetworkDatagram>()), 0);
+
+    QVector<QNetworkDatagram> received;
+    while (received.size() < datagrams.size()
+           && (receiver.hasPendingDatagrams() || receiver.waitForReadyRead(5000))) {
+        received += receiver.receiveDatagrams(datagrams.size() - received.size());
+    }
+    QCOMPARE(received.size(), datagrams.size());
+    QVERIFY(!receiver.hasPendingDatagrams());
+
+    for (int i = 0; i < received.size(); ++i) {
+        const QNetworkDatagram &dgram = received.at(i);
+        QVERIFY(dgram.isValid());
+        QCOMPARE(dgram.data(), datagrams.at(i).data());
+        QCOMPARE(dgram.senderAddress(), QHostAddress(QHostAddress::LocalHost));
+        QCOMPARE(dgram.senderPort(), int(sender.localPort()));
+        if (!dgram.destinationAddress().isNull()) {
+            QCOMPARE(dgram.destinationAddress(), QHostAddress(QHostAddress::LocalHost));
+            QCOMPARE(dgram.destinationPort(), int(receiver.localPort()));
+        }
+    }
+}
+
+void tst_QUdpSocket::receiveDatagramsTruncated()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket receiver;
+#ifdef FORCE_SESSION
+    receiver.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+
+    QUdpSocket sender;
+#ifdef FORCE_SESSION
+    sender.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    const QByteArray data = "0123456789abcdefghijklmnopqrstuvwxyz";
+    QVector<QNetworkDatagram> datagrams;
+    for (int i = 0; i < 4; ++i)
+        datagrams << QNetworkDatagram(data, QHostAddress::LocalHost, receiver.localPort());
+    QCOMPARE(sender.writeDatagrams(datagrams), datagrams.size());
+
+    // the rest of each datagram is lost, not returned in the next one
+    QVector<QNetworkDatagram> received;
+    while (received.size() < datagrams.size()
+           && (receiver.hasPendingDatagrams() || receiver.waitForReadyRead(5000))) {
+        received += receiver.receiveDatagrams(datagrams.size() - received.size(), 10);
+    }
+    QCOMPARE(received.size(), datagrams.size());
+    for (const QNetworkDatagram &dgram : qAsConst(received))
+        QCOMPARE(dgram.data(), data.left(10));
+
+    // maxCount is honored
+    QCOMPARE(sender.writeDatagrams(datagrams), datagrams.size());
+    QTRY_VERIFY(receiver.hasPendingDatagrams());
+    received = receiver.receiveDatagrams(1);
+    QCOMPARE(received.size(), 1);
+    QCOMPARE(received.constFirst().data(), data);
+    QVERIFY(receiver.receiveDatagrams(0).isEmpty());
+}
+
+void tst_QUdpSocket::writeDatagramsPartial()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket receiver;
+#ifdef FORCE_SESSION
+    receiver.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+
+    QUdpSocket sender;
+#ifdef FORCE_SESSION
+    sender.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QSignalSpy bytesWrittenSpy(&sender, &QUdpSocket::bytesWritten);
+
+    // the third datagram can't be sent, so only the first two are
+    QVector<QNetworkDatagram> datagrams;
+    datagrams << QNetworkDatagram("first", QHostAddress::LocalHost, receiver.localPort())
+              << QNetworkDatagram("second", QHostAddress::LocalHost, receiver.localPort())
+              << QNetworkDatagram(QByteArray(70000, 'x'), QHostAddress::LocalHost, receiver.localPort())
+              << QNetworkDatagram("fourth", QHostAddress::LocalHost, receiver.localPort());
+    QCOMPARE(sender.writeDatagrams(datagrams), 2);
+    QCOMPARE(sender.error(), QUdpSocket::DatagramTooLargeError);
+    QCOMPARE(bytesWrittenSpy.count(), 1);
+    QCOMPARE(bytesWrittenSpy.at(0).at(0).toLongLong(), qint64(strlen("first") + strlen("second")));
+
+    // the caller can go on with the rest
+    QCOMPARE(sender.writeDatagrams(datagrams.mid(3)), 1);
+    // and nothing at all could be sent
+    QCOMPARE(sender.writeDatagrams(datagrams.mid(2, 1)), -1);
+
+    QVector<QNetworkDatagram> received;
+    while (received.size() < 3
+           && (receiver.hasPendingDatagrams() || receiver.waitForReadyRead(5000))) {
+        received += receiver.receiveDatagrams(10);
+    }
+    QCOMPARE(received.size(), 3);
+    QCOMPARE(received.at(0).data(), QByteArray("first"));
+    QCOMPARE(received.at(1).data(), QByteArray("second"));
+    QCOMPARE(received.at(2).data(), QByteArray("fourth"));
+}
+
 void tst_QUdpSocket::multicastTtlOption_data()
 {
     QTest::addColumn<QHostAddress>("bindAddress");
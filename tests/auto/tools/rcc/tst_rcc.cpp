@@ -39,12 +39,14 @@
 #include <QtCore/QList>
 #include <QtCore/QResource>
 #include <QtCore/QLocale>
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QtGlobal>
 
 #include <algorithm>
 
 typedef QMap<QString, QString> QStringMap;
 Q_DECLARE_METATYPE(QStringMap)
+Q_DECLARE_METATYPE(QResource::Compression)
 
 class tst_rcc : public QObject
 {
@@ -57,6 +59,8 @@ private slots:
     void rcc();
     void binary_data();
     void binary();
+    void compression_data();
+    void compression();
 
     void cleanupTestCase();
 
@@ -353,6 +357,105 @@ void tst_rcc::binary()
     QLocale::setDefault(oldDefaultLocale);
 }
 
+void tst_rcc::compression_data()
+{
+    QTest::addColumn<QStringList>("arguments");
+    QTest::addColumn<QResource::Compression>("algorithm");
+    QTest::addColumn<int>("alignment");
+
+    QTest::newRow("default") << QStringList() << QResource::ZlibCompression << 0;
+    QTest::newRow("zlib") << (QStringList() << "-compress-algo" << "zlib") << QResource::ZlibCompression << 0;
+    QTest::newRow("zstd") << (QStringList() << "-compress-algo" << "zstd") << QResource::ZstdCompression << 0;
+    QTest::newRow("none") << (QStringList() << "-compress-algo" << "none") << QResource::NoCompression << 0;
+    QTest::newRow("aligned") << (QStringList() << "-no-compress" << "-align" << "4096")
+                             << QResource::NoCompression << 4096;
+}
+
+void tst_rcc::compression()
+{
+    QFETCH(QStringList, arguments);
+    QFETCH(QResource::Compression, algorithm);
+    QFETCH(int, alignment);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // large enough to span several zstd frames
+    QByteArray large;
+    for (int i = 0; large.size() < 300 * 1024; ++i)
+        large += "line " + QByteArray::number(i % 1000) + " of a compressible resource\n";
+    const QByteArray small = "too small to be worth compressing";
+    const QString qrcFile = dir.path() + QLatin1String("/compression.qrc");
+    const QString rccFile = dir.path() + QLatin1String("/compression.rcc");
+    {
+        QFile file(dir.path() + QLatin1String("/large.txt"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(large);
+        file.close();
+        file.setFileName(dir.path() + QLatin1String("/small.txt"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(small);
+        file.close();
+        file.setFileName(qrcFile);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("<RCC><qresource><file>large.txt</file><file>small.txt</file></qresource></RCC>");
+    }
+
+    QProcess rccProcess;
+    rccProcess.setWorkingDirectory(dir.path());
+    rccProcess.start(m_rcc, QStringList() << "-binary" << arguments << "-o" << rccFile << qrcFile);
+    QVERIFY2(rccProcess.waitForFinished(), qPrintable(rccProcess.errorString()));
+    if (algorithm == QResource::ZstdCompression
+            && rccProcess.readAllStandardError().contains("not compiled in")) {
+        QSKIP("rcc was built without Zstandard support");
+    }
+    QCOMPARE(rccProcess.exitCode(), 0);
+
+    const QString root = QLatin1String("/compression");
+    if (!QResource::registerResource(rccFile, root)) {
+        if (algorithm == QResource::ZstdCompression)
+            QSKIP("Qt was built without Zstandard support");
+        QFAIL("Could not register the resource");
+    }
+
+    {
+        QResource resource(QLatin1String(":/compression/large.txt"));
+        QVERIFY(resource.isValid());
+        QCOMPARE(resource.compressionAlgorithm(), algorithm);
+        QCOMPARE(resource.isCompressed(), algorithm != QResource::NoCompression);
+        QCOMPARE(resource.uncompressedSize(), qint64(large.size()));
+        QCOMPARE(resource.uncompressedData(), large);
+
+        QFile file(resource.fileName());
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.size(), qint64(large.size()));
+        // read ranges that start and end inside frames and cross frame boundaries
+        for (qint64 pos : { qint64(0), qint64(65530), qint64(100000), qint64(large.size() - 10) }) {
+            QVERIFY(file.seek(pos));
+            QCOMPARE(file.read(100), large.mid(int(pos), 100));
+        }
+        QVERIFY(file.seek(0));
+        QCOMPARE(file.readAll(), large);
+
+        uchar *mapped = file.map(1000, 5000);
+        QVERIFY(mapped);
+        QCOMPARE(QByteArray(reinterpret_cast<const char *>(mapped), 5000), large.mid(1000, 5000));
+        file.close();
+
+        QResource smallResource(QLatin1String(":/compression/small.txt"));
+        QCOMPARE(smallResource.compressionAlgorithm(), QResource::NoCompression);
+        QCOMPARE(smallResource.uncompressedData(), small);
+    }
+    QVERIFY(QResource::unregisterResource(rccFile, root));
+
+    if (alignment) {
+        QFile file(rccFile);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const QByteArray contents = file.readAll();
+        QCOMPARE(contents.indexOf(large) % alignment, 0);
+        QCOMPARE(contents.indexOf(small) % alignment, 0);
+    }
+}
 
 void tst_rcc::cleanupTestCase()
 {
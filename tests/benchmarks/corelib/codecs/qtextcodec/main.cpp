@@ -42,6 +42,10 @@ private slots:
     void fromUnicode() const;
     void toUnicode_data() const;
     void toUnicode() const;
+    void fromUtf8_data() const;
+    void fromUtf8() const;
+    void toUtf8_data() const;
+    void toUtf8() const;
 };
 
 void tst_QTextCodec::codecForName() const
@@ -162,6 +166,73 @@ void tst_QTextCodec::toUnicode() const
 }
 
 
+void tst_QTextCodec::fromUtf8_data() const
+{
+    // sample texts for the different UTF-8 sequence lengths; each is repeated
+    // to build a corpus of roughly 64 kB
+    QTest::addColumn<QString>("text");
+
+    const struct {
+        const char *name;
+        const char *text;
+    } samples[] = {
+        { "ascii", "The quick brown fox jumps over the lazy dog. " },
+        { "latin-1", "Falsches \xc3\x9c" "ben von Xylophonmusik qu\xc3\xa4lt jeden gr\xc3\xb6\xc3\x9f" "eren Zwerg. " },
+        { "greek", "\xce\x9e\xce\xb5\xcf\x83\xce\xba\xce\xb5\xcf\x80\xce\xac\xce\xb6\xcf\x89 \xcf\x84\xce\xb7\xce\xbd "
+                   "\xcf\x88\xcf\x85\xcf\x87\xce\xbf\xcf\x86\xce\xb8\xcf\x8c\xcf\x81\xce\xb1 "
+                   "\xce\xb2\xce\xb4\xce\xb5\xce\xbb\xcf\x85\xce\xb3\xce\xbc\xce\xaf\xce\xb1. " },
+        { "cyrillic", "\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c \xd0\xb6\xd0\xb5 \xd0\xb5\xd1\x89\xd1\x91 "
+                      "\xd1\x8d\xd1\x82\xd0\xb8\xd1\x85 \xd0\xbc\xd1\x8f\xd0\xb3\xd0\xba\xd0\xb8\xd1\x85 "
+                      "\xd1\x84\xd1\x80\xd0\xb0\xd0\xbd\xd1\x86\xd1\x83\xd0\xb7\xd1\x81\xd0\xba\xd0\xb8\xd1\x85 "
+                      "\xd0\xb1\xd1\x83\xd0\xbb\xd0\xbe\xd0\xba, \xd0\xb4\xd0\xb0 \xd0\xb2\xd1\x8b\xd0\xbf\xd0\xb5\xd0\xb9 "
+                      "\xd0\xb6\xd0\xb5 \xd1\x87\xd0\xb0\xd1\x8e. " },
+        { "cjk", "\xe4\xbb\x8a\xe5\xa4\xa9\xe5\xa4\xa9\xe6\xb0\x94\xe5\xbe\x88\xe5\xa5\xbd\xef\xbc\x8c"
+                 "\xe6\x88\x91\xe4\xbb\xac\xe5\x8e\xbb\xe5\x85\xac\xe5\x9b\xad\xe6\x95\xa3\xe6\xad\xa5\xe3\x80\x82"
+                 "\xe3\x81\x84\xe3\x82\x8d\xe3\x81\xaf\xe3\x81\xab\xe3\x81\xbb\xe3\x81\xb8\xe3\x81\xa8"
+                 "\xe3\x81\xa1\xe3\x82\x8a\xe3\x81\xac\xe3\x82\x8b\xe3\x82\x92\xe3\x80\x82" },
+        { "mixed", "Qt 5 \xe2\x80\x94 \xd0\xba\xd1\x80\xd0\xbe\xd1\x81\xd1\x81\xd0\xbf\xd0\xbb\xd0\xb0\xd1\x82"
+                   "\xd1\x84\xd0\xbe\xd1\x80\xd0\xbc\xd0\xb5\xd0\xbd\xd0\xbd\xd1\x8b\xd0\xb9 "
+                   "\xe6\xa1\x86\xe6\x9e\xb6 (\xce\xb5\xcf\x80\xce\xaf\xcf\x80\xce\xb5\xce\xb4\xce\xbf 2) "
+                   "\xf0\x9f\x98\x80 caf\xc3\xa9. " }
+    };
+
+    for (const auto &sample : samples) {
+        const QString text = QString::fromUtf8(sample.text);
+        QString corpus;
+        corpus.reserve(64 * 1024);
+        while (corpus.size() < 32 * 1024)
+            corpus += text;
+        QTest::newRow(sample.name) << corpus;
+    }
+}
+
+void tst_QTextCodec::fromUtf8() const
+{
+    QFETCH(QString, text);
+    const QByteArray utf8 = text.toUtf8();
+
+    QString result;
+    QBENCHMARK {
+        result = QString::fromUtf8(utf8);
+    }
+    QCOMPARE(result, text);
+}
+
+void tst_QTextCodec::toUtf8_data() const
+{
+    fromUtf8_data();
+}
+
+void tst_QTextCodec::toUtf8() const
+{
+    QFETCH(QString, text);
+
+    QByteArray result;
+    QBENCHMARK {
+        result = text.toUtf8();
+    }
+    QCOMPARE(QString::fromUtf8(result), text);
+}
 
 
 QTEST_MAIN(tst_QTextCodec)
@@ -0,0 +1,4 @@
+TEMPLATE = app
+TARGET = tst_bench_qlogging
+QT = core testlib
+SOURCES += tst_qlogging.cpp
@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QtCore>
+#include <QtTest/QtTest>
+
+#ifdef Q_OS_UNIX
+#  include <unistd.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+extern Q_CORE_EXPORT void qt_logging_set_async(bool enable);
+QT_END_NAMESPACE
+
+enum { MessagesPerThread = 10000 };
+
+class LoggingThread : public QThread
+{
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < MessagesPerThread; ++i)
+            qInfo("message %d from a logging thread", i);
+    }
+};
+
+class tst_QLogging : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultHandler_data();
+    void defaultHandler();
+};
+
+void tst_QLogging::defaultHandler_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("async");
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 thread(s), sync").arg(threads))) << threads << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 thread(s), async").arg(threads))) << threads << true;
+    }
+}
+
+// Logs through the default message handler, with stderr redirected to a
+// file. Measures the time until all threads are done logging, not until
+// the messages are written.
+void tst_QLogging::defaultHandler()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("This benchmark redirects stderr with dup2()");
+#else
+    QFETCH(int, threadCount);
+    QFETCH(bool, async);
+
+    QTemporaryFile output;
+    QVERIFY(output.open());
+    fflush(stderr);
+    const int savedStderr = dup(STDERR_FILENO);
+    QVERIFY(savedStderr != -1);
+    QVERIFY(dup2(output.handle(), STDERR_FILENO) != -1);
+
+    QtMessageHandler testHandler = qInstallMessageHandler(0);
+    qt_logging_set_async(async);
+
+    QBENCHMARK {
+        QVector<LoggingThread *> threads;
+        for (int i = 0; i < threadCount; ++i)
+            threads.append(new LoggingThread);
+        for (LoggingThread *thread : qAsConst(threads))
+            thread->start();
+        for (LoggingThread *thread : qAsConst(threads))
+            thread->wait();
+        qDeleteAll(threads);
+    }
+
+    // writes the pending messages
+    qt_logging_set_async(false);
+    qInstallMessageHandler(testHandler);
+
+    fflush(stderr);
+    dup2(savedStderr, STDERR_FILENO);
+    close(savedStderr);
+#endif
+}
+
+QTEST_MAIN(tst_QLogging)
+
+#include "tst_qlogging.moc"
@@ -5,6 +5,8 @@ SUBDIRS = \
         qfile \
         qfileinfo \
         qiodevice \
+        qresourceengine \
+        qsettings \
         qtemporaryfile \
         qtextstream
 
@@ -28,7 +28,11 @@
 #include <QDebug>
 #include <QDirIterator>
 #include <QString>
+#include <QThreadPool>
 #include <qplatformdefs.h>
+#ifdef QT_BUILD_INTERNAL
+#include <private/qfilesystemwalker_p.h>
+#endif
 
 #ifdef Q_OS_WIN
 #   include <qt_windows.h>
@@ -54,11 +58,13 @@ private slots:
     void diriterator_data() { data(); }
     void fsiterator();
     void fsiterator_data() { data(); }
+    void walker();
+    void walker_data();
     void data();
 };
 
 
-void tst_qdiriterator::data()
+static QByteArray qtDir()
 {
 #if defined(Q_OS_WIN)
     const char *qtdir = "C:\\depot\\qt\\main";
@@ -69,9 +75,13 @@ void tst_qdiriterator::data()
         fprintf(stderr, "QTDIR not set\n");
         exit(1);
     }
+    return qtdir;
+}
 
+void tst_qdiriterator::data()
+{
     QTest::addColumn<QByteArray>("dirpath");
-    QByteArray ba = QByteArray(qtdir) + "/src/corelib";
+    QByteArray ba = qtDir() + "/src/corelib";
     QByteArray ba1 = ba + "/io";
     QTest::newRow(ba) << ba;
     //QTest::newRow(ba1) << ba1;
@@ -235,6 +245,49 @@ void tst_qdiriterator::fsiterator()
     qDebug() << count;
 }
 
+void tst_qdiriterator::walker_data()
+{
+    QTest::addColumn<QByteArray>("dirpath");
+    QTest::addColumn<bool>("parallel");
+    QTest::addColumn<bool>("fetchMetaData");
+
+    const QByteArray dirpath = qtDir() + "/src/corelib";
+    QTest::newRow("sequential") << dirpath << false << false;
+    QTest::newRow("parallel") << dirpath << true << false;
+    QTest::newRow("metadata") << dirpath << false << true;
+    QTest::newRow("parallel-metadata") << dirpath << true << true;
+}
+
+void tst_qdiriterator::walker()
+{
+#ifdef QT_BUILD_INTERNAL
+    QFETCH(QByteArray, dirpath);
+    QFETCH(bool, parallel);
+    QFETCH(bool, fetchMetaData);
+
+    QThreadPool pool;
+    int count = 0;
+
+    QBENCHMARK {
+        QFileSystemWalker walker(QString::fromLocal8Bit(dirpath),
+                                 fetchMetaData ? QFileSystemWalker::FetchMetaData
+                                               : QFileSystemWalker::NoWalkerFlags);
+        if (parallel)
+            walker.setThreadPool(&pool);
+
+        int c = 0;
+        walker.walk([&c](const QFileSystemWalker::Batch &batch) {
+            for (const QFileSystemWalker::Entry &entry : batch)
+                c += entry.metaData.isFile();
+        });
+        count = c;
+    }
+    qDebug() << count;
+#else
+    QSKIP("This test requires -developer-build.");
+#endif
+}
+
 QTEST_MAIN(tst_qdiriterator)
 
 #include "main.moc"
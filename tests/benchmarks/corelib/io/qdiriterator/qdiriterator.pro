@@ -1,6 +1,6 @@
 TARGET = tst_bench_qdiriterator
 
-QT = core testlib
+QT = core core-private testlib
 
 CONFIG += release
 
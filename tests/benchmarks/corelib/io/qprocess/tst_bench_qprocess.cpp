@@ -36,6 +36,8 @@ class tst_QProcess : public QObject
 private slots:
 
     void echoTest_performance();
+    void startLatency_data();
+    void startLatency();
 };
 
 void tst_QProcess::echoTest_performance()
@@ -83,5 +85,51 @@ void tst_QProcess::echoTest_performance()
     QVERIFY(process.waitForFinished());
 }
 
+void tst_QProcess::startLatency_data()
+{
+    // The cost of fork() grows with the size of the parent's address space,
+    // so measure how long starting a process takes for various amounts of
+    // resident memory in the parent.
+    QTest::addColumn<int>("residentMB");
+    QTest::addColumn<bool>("vfork");
+
+    static const int sizes[] = { 0, 64, 256, 1024 };
+    for (int residentMB : sizes) {
+        const QByteArray name = "rss-" + QByteArray::number(residentMB) + "MB";
+        QTest::newRow((name + "-fork").constData()) << residentMB << false;
+        QTest::newRow((name + "-vfork").constData()) << residentMB << true;
+    }
+}
+
+void tst_QProcess::startLatency()
+{
+    QFETCH(int, residentMB);
+    QFETCH(bool, vfork);
+
+    if (vfork)
+        qputenv("QT_PROCESS_USE_VFORK", "1");
+    else
+        qunsetenv("QT_PROCESS_USE_VFORK");
+
+    QByteArray ballast;
+    if (residentMB) {
+        QT_TRY {
+            ballast = QByteArray(residentMB * 1024 * 1024, 'x');   // touches every page
+        } QT_CATCH (const std::bad_alloc &) {
+        }
+        if (ballast.isEmpty())
+            QSKIP("Not enough memory to grow the resident set to the requested size");
+    }
+
+    QBENCHMARK {
+        QProcess process;
+        process.start("testProcessLoopback/testProcessLoopback");
+        QVERIFY2(process.waitForStarted(), qPrintable(process.errorString()));
+        process.closeWriteChannel();
+        QVERIFY(process.waitForFinished());
+    }
+    qunsetenv("QT_PROCESS_USE_VFORK");
+}
+
 QTEST_MAIN(tst_QProcess)
 #include "tst_bench_qprocess.moc"
@@ -0,0 +1,131 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QResource>
+#include <QtCore/QTemporaryDir>
+
+class tst_QResourceEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void readRange_data();
+    void readRange();
+    void readAll_data() { readRange_data(); }
+    void readAll();
+
+private:
+    QTemporaryDir dir;
+    QStringList registered;
+    int dataSize;
+};
+
+void tst_QResourceEngine::initTestCase()
+{
+    QVERIFY(dir.isValid());
+
+    QByteArray data;
+    for (int i = 0; data.size() < 4 * 1024 * 1024; ++i)
+        data += "line " + QByteArray::number(i) + " of a large, compressible resource file\n";
+    dataSize = data.size();
+
+    QFile file(dir.filePath(QStringLiteral("data.txt")));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
+    file.setFileName(dir.filePath(QStringLiteral("bench.qrc")));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("<RCC><qresource><file>data.txt</file></qresource></RCC>");
+    file.close();
+
+    // One binary resource per compression algorithm, each registered under its own root
+    const QString rcc = QLibraryInfo::location(QLibraryInfo::BinariesPath) + QLatin1String("/rcc");
+    for (const char *algo : { "none", "zlib", "zstd" }) {
+        const QString name = QString::fromLatin1(algo);
+        const QString rccFile = dir.filePath(name + QLatin1String(".rcc"));
+        QProcess process;
+        process.setWorkingDirectory(dir.path());
+        process.start(rcc, QStringList() << "-binary" << "-compress-algo" << name
+                                         << "-o" << rccFile << QStringLiteral("bench.qrc"));
+        QVERIFY(process.waitForFinished());
+        if (process.exitCode() == 0 && QResource::registerResource(rccFile, QLatin1Char('/') + name))
+            registered << name;
+    }
+}
+
+void tst_QResourceEngine::cleanupTestCase()
+{
+    for (const QString &name : qAsConst(registered))
+        QResource::unregisterResource(dir.filePath(name + QLatin1String(".rcc")), QLatin1Char('/') + name);
+}
+
+void tst_QResourceEngine::readRange_data()
+{
+    QTest::addColumn<QString>("algorithm");
+
+    QTest::newRow("none") << QStringLiteral("none");
+    QTest::newRow("zlib") << QStringLiteral("zlib");
+    QTest::newRow("zstd") << QStringLiteral("zstd");
+}
+
+// Opening a large compressed resource to read a few kilobytes from its middle.
+void tst_QResourceEngine::readRange()
+{
+    QFETCH(QString, algorithm);
+    if (!registered.contains(algorithm))
+        QSKIP("Compression algorithm not supported by this build");
+
+    const QString fileName = QLatin1String(":/") + algorithm + QLatin1String("/data.txt");
+    QBENCHMARK {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QVERIFY(file.seek(dataSize / 2));
+        QCOMPARE(file.read(4096).size(), 4096);
+    }
+}
+
+void tst_QResourceEngine::readAll()
+{
+    QFETCH(QString, algorithm);
+    if (!registered.contains(algorithm))
+        QSKIP("Compression algorithm not supported by this build");
+
+    const QString fileName = QLatin1String(":/") + algorithm + QLatin1String("/data.txt");
+    QBENCHMARK {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll().size(), dataSize);
+    }
+}
+
+QTEST_MAIN(tst_QResourceEngine)
+
+#include "main.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_bench_qresourceengine
+
+QT = core testlib
+CONFIG += release
+
+SOURCES += main.cpp
@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QSettings>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/private/qsettings_p.h>
+
+class tst_QSettings : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void openAndRead_data();
+    void openAndRead();
+    void childGroups();
+    void setValueAndSync_data();
+    void setValueAndSync();
+
+private:
+    QTemporaryDir dir;
+    QByteArray contents;
+};
+
+enum { SectionCount = 200, KeysPerSection = 100 };
+
+void tst_QSettings::initTestCase()
+{
+    QVERIFY(dir.isValid());
+
+    const QString fileName = dir.filePath(QStringLiteral("initial.ini"));
+    {
+        QSettings settings(fileName, QSettings::IniFormat);
+        for (int i = 0; i < SectionCount; ++i) {
+            settings.beginGroup(QLatin1String("section") + QString::number(i));
+            for (int j = 0; j < KeysPerSection; ++j)
+                settings.setValue(QLatin1String("key") + QString::number(j), QStringList() << "some value" << QString::number(i * j));
+            settings.endGroup();
+        }
+    }
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    contents = file.readAll();
+}
+
+static QString writeFile(const QTemporaryDir &dir, const QByteArray &contents)
+{
+    const QString fileName = dir.filePath(QStringLiteral("bench.ini"));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size())
+        return QString();
+    return fileName;
+}
+
+void tst_QSettings::openAndRead_data()
+{
+    QTest::addColumn<int>("sectionStep");
+
+    QTest::newRow("10 keys") << int(SectionCount / 10);
+    QTest::newRow("200 keys") << 1;
+}
+
+// A process start: open a large file and read some keys from it.
+void tst_QSettings::openAndRead()
+{
+    QFETCH(int, sectionStep);
+    const QString fileName = writeFile(dir, contents);
+    QVERIFY(!fileName.isEmpty());
+
+    QBENCHMARK {
+        QConfFile::clearCache();
+        QSettings settings(fileName, QSettings::IniFormat);
+        for (int i = 0; i < SectionCount; i += sectionStep)
+            settings.value(QLatin1String("section") + QString::number(i) + QLatin1String("/key5"));
+    }
+}
+
+void tst_QSettings::childGroups()
+{
+    const QString fileName = writeFile(dir, contents);
+    QVERIFY(!fileName.isEmpty());
+
+    QBENCHMARK {
+        QConfFile::clearCache();
+        QSettings settings(fileName, QSettings::IniFormat);
+        QCOMPARE(settings.childGroups().size(), int(SectionCount));
+    }
+}
+
+void tst_QSettings::setValueAndSync_data()
+{
+    QTest::addColumn<bool>("mapped");
+
+    QTest::newRow("rewrite") << false;
+    QTest::newRow("append") << true;
+}
+
+// Changing a single key of a large file.
+void tst_QSettings::setValueAndSync()
+{
+    QFETCH(bool, mapped);
+    const QString fileName = writeFile(dir, contents);
+    QVERIFY(!fileName.isEmpty());
+    QConfFile::clearCache();
+
+    QSettings settings(fileName, QSettings::IniFormat);
+    settings.setIniMappingEnabled(mapped);
+    int i = 0;
+    QBENCHMARK {
+        settings.setValue(QStringLiteral("section7/key3"), ++i);
+        settings.sync();
+    }
+    QCOMPARE(settings.status(), QSettings::NoError);
+}
+
+QTEST_MAIN(tst_QSettings)
+
+#include "main.moc"
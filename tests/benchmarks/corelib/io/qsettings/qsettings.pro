@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_bench_qsettings
+
+QT = core-private testlib
+CONFIG += release
+
+SOURCES += main.cpp
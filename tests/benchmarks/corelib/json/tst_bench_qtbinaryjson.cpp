@@ -29,6 +29,9 @@
 #include <QtTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonstream.h>
+
+Q_DECLARE_METATYPE(QJsonDocument::ParseMode)
 
 class BenchmarkQtBinaryJson: public QObject
 {
@@ -45,6 +48,16 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseJsonLookup_data();
+    void parseJsonLookup();
+
+    void streamReadJson_data();
+    void streamReadJson();
+    void streamReadJsonValue();
+    void writeJson_data();
+    void writeJson();
+    void streamWriteJson_data();
+    void streamWriteJson();
 
     void toByteArray();
     void fromByteArray();
@@ -120,6 +133,119 @@ void BenchmarkQtBinaryJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtBinaryJson::parseJsonLookup_data()
+{
+    QTest::addColumn<QJsonDocument::ParseMode>("mode");
+
+    QTest::newRow("eager") << QJsonDocument::ParseEagerly;
+    QTest::newRow("lazy") << QJsonDocument::ParseLazily;
+}
+
+void BenchmarkQtBinaryJson::parseJsonLookup()
+{
+    // Parse a document and only read two of its values
+    QFETCH(QJsonDocument::ParseMode, mode);
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(testJson, nullptr, mode);
+        QJsonValue first = doc[0];
+        QJsonValue last = doc[24];
+    }
+}
+
+void BenchmarkQtBinaryJson::streamReadJson_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("numbers.json") << QStringLiteral("numbers.json");
+    QTest::newRow("test.json") << QStringLiteral("test.json");
+}
+
+void BenchmarkQtBinaryJson::streamReadJson()
+{
+    // Compare with parseNumbers() and parseJson(): only tokenize the
+    // document, without building a QJsonDocument
+    QFETCH(QString, fileName);
+    QString testFile = QFINDTESTDATA(fileName);
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    QBENCHMARK {
+        QJsonStreamReader reader(testJson);
+        while (!reader.atEnd())
+            reader.readNext();
+        QVERIFY(!reader.hasError());
+    }
+}
+
+void BenchmarkQtBinaryJson::streamReadJsonValue()
+{
+    // Compare with parseJson(): build the same document through the stream reader
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    QBENCHMARK {
+        QJsonStreamReader reader(testJson);
+        reader.readNext();
+        QJsonValue value = reader.readValue();
+    }
+}
+
+void BenchmarkQtBinaryJson::writeJson_data()
+{
+    QTest::addColumn<bool>("indented");
+
+    QTest::newRow("compact") << false;
+    QTest::newRow("indented") << true;
+}
+
+void BenchmarkQtBinaryJson::writeJson()
+{
+    QFETCH(bool, indented);
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+
+    QBENCHMARK {
+        QByteArray json = doc.toJson(indented ? QJsonDocument::Indented : QJsonDocument::Compact);
+    }
+}
+
+void BenchmarkQtBinaryJson::streamWriteJson_data()
+{
+    writeJson_data();
+}
+
+void BenchmarkQtBinaryJson::streamWriteJson()
+{
+    // Compare with writeJson()
+    QFETCH(bool, indented);
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QJsonValue value = QJsonDocument::fromJson(file.readAll()).array();
+
+    QBENCHMARK {
+        QByteArray json;
+        QJsonStreamWriter writer(&json);
+        writer.setAutoFormatting(indented);
+        writer.writeValue(value);
+    }
+}
+
 void BenchmarkQtBinaryJson::toByteArray()
 {
     // Example: send information over a datastream to another process
@@ -30,6 +30,14 @@
 #include <qtest.h>
 #include <qtesteventloop.h>
 
+#ifdef Q_OS_UNIX
+#include <private/qeventdispatcher_unix_p.h>
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 class PingPong : public QObject
 {
 public:
@@ -83,6 +91,39 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+#ifdef Q_OS_UNIX
+class NotifierReader : public QObject
+{
+public:
+    QSemaphore activated;
+
+    void createNotifiers(const QVector<int> &fds)
+    {
+        for (int fd : fds) {
+            QSocketNotifier *notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+            connect(notifier, &QSocketNotifier::activated, this, &NotifierReader::readyRead);
+            notifiers << notifier;
+        }
+    }
+
+    void deleteNotifiers()
+    {
+        qDeleteAll(notifiers);
+        notifiers.clear();
+    }
+
+    void readyRead(int fd)
+    {
+        char c;
+        if (::read(fd, &c, 1) == 1)
+            activated.release();
+    }
+
+private:
+    QVector<QSocketNotifier *> notifiers;
+};
+#endif
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -96,6 +137,8 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void socketNotifiers_data();
+    void socketNotifiers();
 };
 
 void EventsBench::initTestCase()
@@ -169,6 +212,85 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::socketNotifiers_data()
+{
+    QTest::addColumn<QByteArray>("backend");
+    QTest::addColumn<int>("count");
+
+    for (int count : { 10, 100, 1000, 10000 }) {
+        QTest::newRow(qPrintable(QString::fromLatin1("poll-%1").arg(count))) << QByteArray() << count;
+#ifdef Q_OS_LINUX
+        QTest::newRow(qPrintable(QString::fromLatin1("epoll-%1").arg(count))) << QByteArrayLiteral("1") << count;
+        QTest::newRow(qPrintable(QString::fromLatin1("epoll-edge-%1").arg(count))) << QByteArrayLiteral("edge") << count;
+#endif
+    }
+}
+
+// Measures the wake-up latency of a thread watching many idle sockets
+// when one of them becomes readable.
+void EventsBench::socketNotifiers()
+{
+#ifdef Q_OS_UNIX
+    QFETCH(QByteArray, backend);
+    QFETCH(int, count);
+
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < rlim_t(2 * count + 64)) {
+        limit.rlim_cur = qMin(limit.rlim_max, rlim_t(2 * count + 64));
+        setrlimit(RLIMIT_NOFILE, &limit);
+        if (limit.rlim_cur < rlim_t(2 * count + 64))
+            QSKIP("Not enough file descriptors available");
+    }
+
+    QVector<int> readFds;
+    QVector<int> writeFds;
+    for (int i = 0; i < count; ++i) {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1) {
+            for (int fd : qAsConst(readFds))
+                ::close(fd);
+            for (int fd : qAsConst(writeFds))
+                ::close(fd);
+            QSKIP("Cannot create enough socket pairs");
+        }
+        readFds << fds[0];
+        writeFds << fds[1];
+    }
+
+    // the backend is chosen when the dispatcher is created
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", backend);
+    QThread thread;
+    thread.setEventDispatcher(new QEventDispatcherUNIX);
+    qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+    thread.start();
+
+    NotifierReader reader;
+    reader.moveToThread(&thread);
+    QMetaObject::invokeMethod(&reader, [&]() { reader.createNotifiers(readFds); },
+                              Qt::BlockingQueuedConnection);
+
+    int i = 0;
+    QBENCHMARK {
+        const char c = 'x';
+        QCOMPARE(::write(writeFds.at(i), &c, 1), ssize_t(1));
+        reader.activated.acquire();
+        i = (i + 1) % count;
+    }
+
+    QMetaObject::invokeMethod(&reader, &NotifierReader::deleteNotifiers,
+                              Qt::BlockingQueuedConnection);
+    thread.quit();
+    thread.wait();
+
+    for (int fd : qAsConst(readFds))
+        ::close(fd);
+    for (int fd : qAsConst(writeFds))
+        ::close(fd);
+#else
+    QSKIP("This benchmark requires the UNIX event dispatcher");
+#endif
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         events \
+        qtimer \
         qmetaobject \
         qmetatype \
         qobject \
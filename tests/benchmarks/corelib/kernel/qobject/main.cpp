@@ -43,6 +43,10 @@ Q_OBJECT
 private slots:
     void signal_slot_benchmark();
     void signal_slot_benchmark_data();
+    void signal_slot_threads_benchmark_data();
+    void signal_slot_threads_benchmark();
+    void queued_signal_benchmark_data();
+    void queued_signal_benchmark();
     void qproperty_benchmark_data();
     void qproperty_benchmark();
     void dynamic_property_benchmark();
@@ -55,6 +59,23 @@ struct Functor {
     void operator()(){}
 };
 
+class EmitterThread : public QThread
+{
+public:
+    EmitterThread(Object *sender, int count) : sender(sender), count(count) {}
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i)
+            sender->emitSignal0();
+    }
+
+private:
+    Object *sender;
+    int count;
+};
+
 void QObjectBenchmark::signal_slot_benchmark_data()
 {
     QTest::addColumn<int>("type");
@@ -127,6 +148,68 @@ void QObjectBenchmark::signal_slot_benchmark()
     }
 }
 
+void QObjectBenchmark::signal_slot_threads_benchmark_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("functor");
+    const int maxThreads = qMax(4, QThread::idealThreadCount());
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 thread(s), slot").arg(threads))) << threads << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 thread(s), functor").arg(threads))) << threads << true;
+    }
+}
+
+// Emits the same signal of the same object from several threads at once. Every
+// thread emits the same number of times, so with a scalable emission path the
+// time per iteration stays flat when adding threads (as long as there are cores).
+void QObjectBenchmark::signal_slot_threads_benchmark()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, functor);
+
+    Object sender;
+    Object receiver;
+    if (functor)
+        QObject::connect(&sender, &Object::signal0, &receiver, Functor(), Qt::DirectConnection);
+    else
+        QObject::connect(&sender, &Object::signal0, &receiver, &Object::slot0, Qt::DirectConnection);
+
+    QBENCHMARK {
+        QVector<EmitterThread *> threads;
+        for (int i = 0; i < threadCount; ++i)
+            threads.append(new EmitterThread(&sender, SignalsAndSlotsBenchmarkConstant / 10));
+        for (EmitterThread *thread : qAsConst(threads))
+            thread->start();
+        for (EmitterThread *thread : qAsConst(threads))
+            thread->wait();
+        qDeleteAll(threads);
+    }
+}
+
+void QObjectBenchmark::queued_signal_benchmark_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::newRow("queued") << int(Qt::QueuedConnection);
+    QTest::newRow("batched") << int(Qt::QueuedConnection | Qt::BatchedConnection);
+    QTest::newRow("coalesced") << int(Qt::QueuedConnection | Qt::CoalescedConnection);
+}
+
+// Emits a signal many times through a queued connection, then delivers the calls.
+void QObjectBenchmark::queued_signal_benchmark()
+{
+    QFETCH(int, type);
+
+    Object sender;
+    Object receiver;
+    QObject::connect(&sender, &Object::signal0, &receiver, &Object::slot0, Qt::ConnectionType(type));
+
+    QBENCHMARK {
+        for (int i = 0; i < SignalsAndSlotsBenchmarkConstant / 10; ++i)
+            sender.emitSignal0();
+        QCoreApplication::processEvents();
+    }
+}
+
 void QObjectBenchmark::qproperty_benchmark_data()
 {
     QTest::addColumn<QByteArray>("name");
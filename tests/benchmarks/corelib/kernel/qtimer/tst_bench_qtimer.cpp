@@ -0,0 +1,131 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore>
+#include <QtTest/QtTest>
+
+class TimerReceiver : public QObject
+{
+public:
+    int fired = 0;
+
+protected:
+    void timerEvent(QTimerEvent *) Q_DECL_OVERRIDE { ++fired; }
+};
+
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void registerTimers_data();
+    void registerTimers();
+    void restartTimer_data();
+    void restartTimer();
+    void processEvents_data();
+    void processEvents();
+};
+
+static void addTimerCountRows()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("100000") << 100000;
+}
+
+void tst_QTimer::registerTimers_data()
+{
+    addTimerCountRows();
+}
+
+// Starts and stops as many long-running timers as there are connections
+// in a server with per-connection idle timeouts.
+void tst_QTimer::registerTimers()
+{
+    QFETCH(int, count);
+    TimerReceiver receiver;
+    QVector<QBasicTimer> timers(count);
+
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            timers[i].start(60000 + i % 1000, Qt::CoarseTimer, &receiver);
+        for (int i = 0; i < count; ++i)
+            timers[i].stop();
+    }
+}
+
+void tst_QTimer::restartTimer_data()
+{
+    addTimerCountRows();
+}
+
+// Restarts one timer among many, as happens whenever a connection sees traffic.
+void tst_QTimer::restartTimer()
+{
+    QFETCH(int, count);
+    TimerReceiver receiver;
+    QVector<QBasicTimer> timers(count);
+    for (int i = 0; i < count; ++i)
+        timers[i].start(60000 + i % 1000, Qt::CoarseTimer, &receiver);
+
+    int i = 0;
+    QBENCHMARK {
+        timers[i].start(60000 + i % 1000, Qt::CoarseTimer, &receiver);
+        i = (i + 1) % count;
+    }
+}
+
+void tst_QTimer::processEvents_data()
+{
+    addTimerCountRows();
+}
+
+// Runs event loop iterations while many timers are pending and one of them fires.
+void tst_QTimer::processEvents()
+{
+    QFETCH(int, count);
+    TimerReceiver receiver;
+    QVector<QBasicTimer> timers(count);
+    for (int i = 0; i < count; ++i)
+        timers[i].start(60000 + i % 1000, Qt::CoarseTimer, &receiver);
+
+    QBasicTimer zeroTimer;
+    zeroTimer.start(0, &receiver);
+
+    QBENCHMARK {
+        QCoreApplication::processEvents();
+    }
+    QVERIFY(receiver.fired > 0);
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "tst_bench_qtimer.moc"
@@ -0,0 +1,221 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore>
+
+// Chains of trivial asynchronous stages, each running on a thread pool. The
+// interesting cost is the hand-over between stages, not the stages
+// themselves.
+class tst_QFuture : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void chainWatcher();
+    void chainWatcher_data() { chain_data(); }
+    void chainBlocking();
+    void chainBlocking_data() { chain_data(); }
+    void chainThen();
+    void chainThen_data() { chain_data(); }
+    void fanInWatcher();
+    void fanInWatcher_data() { fanIn_data(); }
+    void fanInWhenAll();
+    void fanInWhenAll_data() { fanIn_data(); }
+
+private:
+    void chain_data();
+    void fanIn_data();
+};
+
+class Stage : public QRunnable, public QFutureInterface<int>
+{
+public:
+    Stage(QThreadPool *pool, const QFuture<int> &previous = QFuture<int>())
+        : previous(previous)
+    {
+        setThreadPool(pool);
+        reportStarted();
+    }
+
+    QFuture<int> start(QThreadPool *pool)
+    {
+        QFuture<int> f = future();
+        pool->start(this);
+        return f;
+    }
+
+    void run() override
+    {
+        // blocks this pool thread until the previous stage is done
+        const int value = previous.isCanceled() ? 0 : previous.result();
+        reportResult(value + 1);
+        reportFinished();
+    }
+
+private:
+    QFuture<int> previous;
+};
+
+static QFuture<int> startStage(QThreadPool *pool)
+{
+    return (new Stage(pool))->start(pool);
+}
+
+void tst_QFuture::chain_data()
+{
+    QTest::addColumn<int>("stages");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+class WatcherChain : public QObject
+{
+    Q_OBJECT
+public:
+    WatcherChain(QThreadPool *pool, int stages)
+        : pool(pool), remaining(stages)
+    {
+        connect(&watcher, &QFutureWatcher<int>::finished, this, &WatcherChain::next);
+    }
+
+    void start(QEventLoop *loop)
+    {
+        this->loop = loop;
+        watcher.setFuture(startStage(pool));
+    }
+
+public Q_SLOTS:
+    void next()
+    {
+        if (--remaining == 0) {
+            loop->quit();
+            return;
+        }
+        watcher.setFuture((new Stage(pool, watcher.future()))->start(pool));
+    }
+
+private:
+    QFutureWatcher<int> watcher;
+    QThreadPool *pool;
+    QEventLoop *loop;
+    int remaining;
+};
+
+void tst_QFuture::chainWatcher()
+{
+    QFETCH(int, stages);
+    QThreadPool pool;
+
+    QBENCHMARK {
+        QEventLoop loop;
+        WatcherChain chain(&pool, stages);
+        chain.start(&loop);
+        loop.exec();
+    }
+}
+
+void tst_QFuture::chainBlocking()
+{
+    QFETCH(int, stages);
+    QThreadPool pool;
+
+    QBENCHMARK {
+        QFuture<int> f = startStage(&pool);
+        for (int i = 1; i < stages; ++i)
+            f = (new Stage(&pool, f))->start(&pool);
+        QCOMPARE(f.result(), stages);
+    }
+}
+
+void tst_QFuture::chainThen()
+{
+    QFETCH(int, stages);
+    QThreadPool pool;
+
+    QBENCHMARK {
+        QFuture<int> f = startStage(&pool);
+        for (int i = 1; i < stages; ++i)
+            f = f.then(&pool, [](int value) { return value + 1; });
+        QCOMPARE(f.result(), stages);
+    }
+}
+
+void tst_QFuture::fanIn_data()
+{
+    QTest::addColumn<int>("tasks");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+void tst_QFuture::fanInWatcher()
+{
+    QFETCH(int, tasks);
+    QThreadPool pool;
+
+    QBENCHMARK {
+        QEventLoop loop;
+        int remaining = tasks;
+        QVector<QFutureWatcher<int> *> watchers;
+        watchers.reserve(tasks);
+        for (int i = 0; i < tasks; ++i) {
+            QFutureWatcher<int> *watcher = new QFutureWatcher<int>;
+            connect(watcher, &QFutureWatcher<int>::finished, [&]() {
+                if (--remaining == 0)
+                    loop.quit();
+            });
+            watcher->setFuture(startStage(&pool));
+            watchers.append(watcher);
+        }
+        loop.exec();
+        qDeleteAll(watchers);
+    }
+}
+
+void tst_QFuture::fanInWhenAll()
+{
+    QFETCH(int, tasks);
+    QThreadPool pool;
+
+    QBENCHMARK {
+        QVector<QFuture<int> > futures;
+        futures.reserve(tasks);
+        for (int i = 0; i < tasks; ++i)
+            futures.append(startStage(&pool));
+        QFuture<QList<QFuture<int> > > all = QtFuture::whenAll(futures.begin(), futures.end());
+        QCOMPARE(all.result().size(), tasks);
+    }
+}
+
+QTEST_MAIN(tst_QFuture)
+
+#include "tst_qfuture.moc"
@@ -40,6 +40,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void fanOut_data();
+    void fanOut();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +77,57 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+// Starts two children until the given depth is reached; the leaves release the semaphore.
+class FanOutRunnable : public QRunnable
+{
+public:
+    FanOutRunnable(QThreadPool *pool, QSemaphore *done, int depth)
+        : pool(pool), done(done), depth(depth) {}
+
+    void run() Q_DECL_OVERRIDE {
+        if (depth == 0) {
+            done->release();
+            return;
+        }
+        pool->start(new FanOutRunnable(pool, done, depth - 1));
+        pool->start(new FanOutRunnable(pool, done, depth - 1));
+    }
+
+private:
+    QThreadPool *pool;
+    QSemaphore *done;
+    int depth;
+};
+
+void tst_QThreadPool::fanOut_data()
+{
+    QTest::addColumn<bool>("workStealing");
+    QTest::addColumn<int>("threadCount");
+
+    for (int threadCount = 1; threadCount <= 64; threadCount *= 2) {
+        QTest::newRow(qPrintable(QString::fromLatin1("shared queue, %1 threads").arg(threadCount)))
+                << false << threadCount;
+        QTest::newRow(qPrintable(QString::fromLatin1("work stealing, %1 threads").arg(threadCount)))
+                << true << threadCount;
+    }
+}
+
+void tst_QThreadPool::fanOut()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(int, threadCount);
+
+    const int depth = 14;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+    QSemaphore done;
+
+    QBENCHMARK {
+        threadPool.start(new FanOutRunnable(&threadPool, &done, depth));
+        done.acquire(1 << depth);
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
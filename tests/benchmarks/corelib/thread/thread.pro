@@ -1,5 +1,6 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        qfuture \
         qmutex \
         qreadwritelock \
         qthreadstorage \
@@ -1,6 +1,6 @@
 TEMPLATE = app
 TARGET = tst_bench_containers-associative
 
-QT = core testlib
+QT = core-private testlib
 
 SOURCES += main.cpp
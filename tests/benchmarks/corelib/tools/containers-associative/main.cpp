@@ -26,9 +26,17 @@
 **
 ****************************************************************************/
 #include <QString>
+#include <private/qflathash_p.h>
 
 #include <qtest.h>
 
+enum Container {
+    Hash,
+    Map,
+    FlatHash
+};
+Q_DECLARE_METATYPE(Container)
+
 class tst_associative_containers : public QObject
 {
     Q_OBJECT
@@ -37,8 +45,28 @@ private slots:
     void insert();
     void lookup_data();
     void lookup();
+    void lookupString_data();
+    void lookupString();
+
+private:
+    static void addRows();
 };
 
+void tst_associative_containers::addRows()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("size");
+
+    for (int size = 10; size < 20000; size += 100) {
+
+        const QByteArray sizeString = QByteArray::number(size);
+
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << Hash << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << Map << size;
+        QTest::newRow(QByteArray("flathash--" + sizeString).constData()) << FlatHash << size;
+    }
+}
+
 template <typename T>
 void testInsert(int size)
 {
@@ -52,30 +80,24 @@ void testInsert(int size)
 
 void tst_associative_containers::insert_data()
 {
-    QTest::addColumn<bool>("useHash");
-    QTest::addColumn<int>("size");
-
-    for (int size = 10; size < 20000; size += 100) {
-
-        const QByteArray sizeString = QByteArray::number(size);
-
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
-    }
+    addRows();
 }
 
 void tst_associative_containers::insert()
 {
-    QFETCH(bool, useHash);
+    QFETCH(Container, container);
     QFETCH(int, size);
 
-    QHash<int, int> testHash;
-    QMap<int, int> testMap;
-
-    if (useHash) {
+    switch (container) {
+    case Hash:
         testInsert<QHash<int, int> >(size);
-    } else {
+        break;
+    case Map:
         testInsert<QMap<int, int> >(size);
+        break;
+    case FlatHash:
+        testInsert<QFlatHash<int, int> >(size);
+        break;
     }
 }
 
@@ -84,16 +106,7 @@ void tst_associative_containers::lookup_data()
 //    setReportType(LineChartReport);
 //    setChartTitle("Time to call value(), with an increasing number of items in the container");
 
-    QTest::addColumn<bool>("useHash");
-    QTest::addColumn<int>("size");
-
-    for (int size = 10; size < 20000; size += 100) {
-
-        const QByteArray sizeString = QByteArray::number(size);
-
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
-    }
+    addRows();
 }
 
 template <typename T>
@@ -115,13 +128,65 @@ void testLookup(int size)
 
 void tst_associative_containers::lookup()
 {
-    QFETCH(bool, useHash);
+    QFETCH(Container, container);
     QFETCH(int, size);
 
-    if (useHash) {
+    switch (container) {
+    case Hash:
         testLookup<QHash<int, int> >(size);
-    } else {
+        break;
+    case Map:
         testLookup<QMap<int, int> >(size);
+        break;
+    case FlatHash:
+        testLookup<QFlatHash<int, int> >(size);
+        break;
+    }
+}
+
+void tst_associative_containers::lookupString_data()
+{
+    addRows();
+}
+
+// half of the lookups miss, like in a symbol table
+template <typename T>
+void testLookupString(int size)
+{
+    T container;
+    QVector<QString> names;
+    names.reserve(2 * size);
+
+    for (int i = 0; i < size; ++i) {
+        const QString name = QStringLiteral("symbol_") + QString::number(i);
+        container.insert(name, i);
+        names.append(name);
+        names.append(QStringLiteral("missing_") + QString::number(i));
+    }
+
+    int found = 0;
+
+    QBENCHMARK {
+        for (const QString &name : qAsConst(names))
+            found += container.contains(name);
+    }
+}
+
+void tst_associative_containers::lookupString()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    switch (container) {
+    case Hash:
+        testLookupString<QHash<QString, int> >(size);
+        break;
+    case Map:
+        testLookupString<QMap<QString, int> >(size);
+        break;
+    case FlatHash:
+        testLookupString<QFlatHash<QString, int> >(size);
+        break;
     }
 }
 
@@ -37,6 +37,10 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+    void toDouble_data();
+    void toDouble();
+    void toLongLong_data();
+    void toLongLong();
 };
 
 static QString data()
@@ -65,6 +69,110 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+enum NumberSource { ByteArray, String, CLocale };
+
+// Numbers as found in CSV and JSON files.
+static QList<QByteArray> doubles()
+{
+    QList<QByteArray> list;
+    quint32 seed = 1;
+    for (int i = 0; i < 1000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const double d = (seed >> 8) / 4096.0 - 1000.0;
+        list << QByteArray::number(d, 'g', 3 + i % 15);
+        if (i % 10 == 0)
+            list << QByteArray::number(d * 1e-9, 'e', 16);
+    }
+    return list;
+}
+
+static QList<QByteArray> integers()
+{
+    QList<QByteArray> list;
+    quint32 seed = 1;
+    for (int i = 0; i < 1000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        list << QByteArray::number(qint64(seed) << (i % 32) >> 8);
+    }
+    return list;
+}
+
+static void addSourceRows()
+{
+    QTest::addColumn<int>("source");
+    QTest::newRow("QByteArray") << int(ByteArray);
+    QTest::newRow("QString") << int(String);
+    QTest::newRow("QLocale::c()") << int(CLocale);
+}
+
+void tst_QLocale::toDouble_data()
+{
+    addSourceRows();
+}
+
+void tst_QLocale::toDouble()
+{
+    QFETCH(int, source);
+    const QList<QByteArray> bytes = doubles();
+    QStringList strings;
+    for (const QByteArray &b : bytes)
+        strings << QString::fromLatin1(b);
+    const QLocale c = QLocale::c();
+
+    double sum = 0;
+    QBENCHMARK {
+        switch (source) {
+        case ByteArray:
+            for (const QByteArray &b : bytes)
+                sum += b.toDouble();
+            break;
+        case String:
+            for (const QString &s : strings)
+                sum += s.toDouble();
+            break;
+        case CLocale:
+            for (const QString &s : strings)
+                sum += c.toDouble(s);
+            break;
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
+void tst_QLocale::toLongLong_data()
+{
+    addSourceRows();
+}
+
+void tst_QLocale::toLongLong()
+{
+    QFETCH(int, source);
+    const QList<QByteArray> bytes = integers();
+    QStringList strings;
+    for (const QByteArray &b : bytes)
+        strings << QString::fromLatin1(b);
+    const QLocale c = QLocale::c();
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        switch (source) {
+        case ByteArray:
+            for (const QByteArray &b : bytes)
+                sum += b.toLongLong();
+            break;
+        case String:
+            for (const QString &s : strings)
+                sum += s.toLongLong();
+            break;
+        case CLocale:
+            for (const QString &s : strings)
+                sum += c.toLongLong(s);
+            break;
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
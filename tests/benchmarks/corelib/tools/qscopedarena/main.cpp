@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/private/qscopedarena_p.h>
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class tst_QScopedArena : public QObject
+{
+    Q_OBJECT
+private slots:
+    void strings_data() { addRows(); }
+    void strings();
+    void vectors_data() { addRows(); }
+    void vectors();
+    void hash_data() { addRows(); }
+    void hash();
+
+private:
+    void addRows();
+};
+
+void tst_QScopedArena::addRows()
+{
+    QTest::addColumn<bool>("arena");
+    QTest::newRow("malloc") << false;
+    QTest::newRow("arena") << true;
+}
+
+template <typename Work>
+static void runScoped(bool arena, Work work)
+{
+    if (arena) {
+        QScopedArena scope;
+        work();
+    } else {
+        work();
+    }
+}
+
+void tst_QScopedArena::strings()
+{
+    QFETCH(bool, arena);
+    QBENCHMARK {
+        runScoped(arena, [] {
+            QVector<QString> lines;
+            lines.reserve(1000);
+            for (int i = 0; i < 1000; ++i) {
+                QString line = QLatin1String("key") + QString::number(i);
+                line += QLatin1String(" = ");
+                line += QString::number(i * 31);
+                lines.append(line);
+            }
+        });
+    }
+}
+
+void tst_QScopedArena::vectors()
+{
+    QFETCH(bool, arena);
+    QBENCHMARK {
+        runScoped(arena, [] {
+            for (int i = 0; i < 1000; ++i) {
+                QVector<int> v;
+                for (int j = 0; j < 16; ++j)
+                    v.append(i + j);
+            }
+        });
+    }
+}
+
+void tst_QScopedArena::hash()
+{
+    QFETCH(bool, arena);
+    QBENCHMARK {
+        runScoped(arena, [] {
+            QHash<int, QString> hash;
+            for (int i = 0; i < 1000; ++i)
+                hash.insert(i, QString::number(i));
+        });
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QScopedArena)
+
+#include "main.moc"
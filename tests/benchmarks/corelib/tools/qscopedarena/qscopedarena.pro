@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_bench_qscopedarena
+
+QT = core-private testlib
+CONFIG += release
+
+SOURCES += main.cpp
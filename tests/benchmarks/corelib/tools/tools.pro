@@ -11,6 +11,7 @@ SUBDIRS = \
         qmap \
         qrect \
         qringbuffer \
+        qscopedarena \
         qstack \
         qstring \
         qstringbuilder \
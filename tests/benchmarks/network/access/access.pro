@@ -1,5 +1,6 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        http2 \
         qfile_vs_qnetworkaccessmanager \
         qnetworkreply \
         qnetworkreply_from_cache \
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "http2srv.h"
+
+#include <QtNetwork/qhttp2configuration.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qurl.h>
+
+Q_DECLARE_METATYPE(QHttp2Configuration)
+
+// Downloads over a cleartext (h2c) loopback connection, to compare how the
+// HTTP/2 flow control parameters affect the throughput of a single stream.
+class tst_bench_Http2 : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_bench_Http2();
+    ~tst_bench_Http2();
+
+private slots:
+    void download_data();
+    void download();
+
+private:
+    QThread workerThread;
+};
+
+namespace {
+
+// The server verifies that the client advertises exactly these settings.
+Http2Settings expectedClientSettings(const QHttp2Configuration &config)
+{
+    using namespace Http2;
+    Http2Settings settings{{Settings::MAX_FRAME_SIZE_ID, quint32(config.maxFrameSize())},
+                           {Settings::INITIAL_WINDOW_SIZE_ID, quint32(config.streamReceiveWindowSize())},
+                           {Settings::ENABLE_PUSH_ID, quint32(0)}};
+    if (config.headerTableSize() != HPack::FieldLookupTable::DefaultSize)
+        settings.push_back({Settings::HEADER_TABLE_SIZE_ID, quint32(config.headerTableSize())});
+    return settings;
+}
+
+bool waitForReply(QNetworkReply *reply)
+{
+    if (!reply->isFinished()) {
+        QEventLoop loop;
+        QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+        QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    return reply->isFinished() && reply->error() == QNetworkReply::NoError;
+}
+
+} // unnamed namespace
+
+tst_bench_Http2::tst_bench_Http2()
+{
+    workerThread.start();
+}
+
+tst_bench_Http2::~tst_bench_Http2()
+{
+    workerThread.quit();
+    workerThread.wait();
+}
+
+void tst_bench_Http2::download_data()
+{
+    QTest::addColumn<QHttp2Configuration>("configuration");
+    QTest::addColumn<int>("size");
+
+    const int size = 16 * 1024 * 1024;
+
+    QTest::newRow("default") << QHttp2Configuration() << size;
+
+    QHttp2Configuration smallWindow;
+    smallWindow.setStreamReceiveWindowSize(Http2::defaultSessionWindowSize);
+    QTest::newRow("stream-window-64K") << smallWindow << size;
+
+    QHttp2Configuration largeWindow;
+    largeWindow.setStreamReceiveWindowSize(size * 2);
+    QTest::newRow("stream-window-32M") << largeWindow << size;
+
+    QHttp2Configuration largeFrames;
+    largeFrames.setMaxFrameSize(Http2::maxFrameSize * 4);
+    QTest::newRow("max-frame-64K") << largeFrames << size;
+
+    QHttp2Configuration autoTuned = smallWindow;
+    autoTuned.setWindowAutoTuningEnabled(true);
+    QTest::newRow("stream-window-64K-autotuned") << autoTuned << size;
+}
+
+void tst_bench_Http2::download()
+{
+    QFETCH(QHttp2Configuration, configuration);
+    QFETCH(int, size);
+
+    const Http2Settings serverSettings{{Http2::Settings::MAX_CONCURRENT_STREAMS_ID, 100}};
+    Http2Server *server = new Http2Server(true, serverSettings, expectedClientSettings(configuration));
+    server->setResponseBody(QByteArray(size, 'x'));
+    server->moveToThread(&workerThread);
+
+    quint16 port = 0;
+    {
+        QEventLoop loop;
+        connect(server, &Http2Server::serverStarted, &loop, [&](quint16 serverPort) {
+            port = serverPort;
+            loop.quit();
+        });
+        QMetaObject::invokeMethod(server, "startServer", Qt::QueuedConnection);
+        QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    QVERIFY(port);
+
+    QUrl url(QStringLiteral("http://127.0.0.1/index.html"));
+    url.setPort(port);
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+    request.setHttp2Configuration(configuration);
+
+    QNetworkAccessManager manager;
+
+    // The first request upgrades the connection from HTTP/1.1, keep it out
+    // of the measurement; the others reuse the established connection.
+    QScopedPointer<QNetworkReply> reply(manager.get(request));
+    QVERIFY(waitForReply(reply.data()));
+    QCOMPARE(reply->bytesAvailable(), qint64(size));
+
+    QBENCHMARK {
+        reply.reset(manager.get(request));
+        QVERIFY(waitForReply(reply.data()));
+        QCOMPARE(reply->bytesAvailable(), qint64(size));
+    }
+
+    reply.reset();
+    QMetaObject::invokeMethod(server, "deleteLater", Qt::QueuedConnection);
+}
+
+QTEST_MAIN(tst_bench_Http2)
+
+#include "tst_bench_http2.moc"
@@ -53,7 +53,7 @@ class tst_qnetworkdiskcache : public QObject
 {
     Q_OBJECT
 private:
-    void injectFakeData();
+    void injectFakeData(quint32 count = NumFakeCacheObjects);
     void insertOneItem();
     bool isUrlCached(quint32 id);
     void cleanRecursive(QString &path);
@@ -77,6 +77,13 @@ private slots:
 
     void timeExpiration_data();
     void timeExpiration();
+
+    void timeLargeCacheOpen_data();
+    void timeLargeCacheOpen();
+    void timeLargeCacheInsertion_data();
+    void timeLargeCacheInsertion();
+    void timeLargeCacheExpiration_data();
+    void timeLargeCacheExpiration();
 };
 
 
@@ -327,7 +334,130 @@ void tst_qnetworkdiskcache::timeExpiration()
 // like a normal user of a cache might encounter is real-life browsing.
 // The point of this is to trigger degradation in file-system and media performance
 // that occur due to the quantity and layout of data.
-void tst_qnetworkdiskcache::injectFakeData()
+static void largeCacheData()
+{
+    QTest::addColumn<QString>("cacheRootDirectory");
+    QTest::addColumn<int>("entries");
+
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QTest::newRow("1000 entries") << cacheLoc << 1000;
+    QTest::newRow("10000 entries") << cacheLoc << 10000;
+    QTest::newRow("50000 entries") << cacheLoc << 50000;
+}
+
+void tst_qnetworkdiskcache::timeLargeCacheOpen_data()
+{
+    largeCacheData();
+}
+
+//Times how long a new cache object takes to learn the size of
+//an existing, well populated cache directory.
+void tst_qnetworkdiskcache::timeLargeCacheOpen()
+{
+    QFETCH(QString, cacheRootDirectory);
+    QFETCH(int, entries);
+
+    cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
+
+    //Housekeeping
+    cleanRecursive(cacheDir); // slow op.
+    initCacheObject();
+    cache->setCacheDirectory(cacheDir);
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->clear();
+    injectFakeData(entries); // SLOW
+    const qint64 expectedSize = cache->cacheSize();
+    cleanupCacheObject();
+
+    QBENCHMARK_ONCE {
+        initCacheObject();
+        cache->setCacheDirectory(cacheDir);
+        QCOMPARE(cache->cacheSize(), expectedSize);
+    }
+
+    //Cleanup (slow)
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::timeLargeCacheInsertion_data()
+{
+    largeCacheData();
+}
+
+//Times insertions into a cache that is full, so that every
+//insertion has to make room for the new entry.
+void tst_qnetworkdiskcache::timeLargeCacheInsertion()
+{
+    QFETCH(QString, cacheRootDirectory);
+    QFETCH(int, entries);
+
+    cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
+
+    //Housekeeping
+    cleanRecursive(cacheDir); // slow op.
+    initCacheObject();
+    cache->setCacheDirectory(cacheDir);
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->clear();
+    injectFakeData(entries); // SLOW
+
+    //The next insertion crosses the limit
+    cache->setMaximumCacheSize(cache->cacheSize() + 1);
+
+    QBENCHMARK_ONCE {
+        for (quint32 i = entries; i < quint32(entries + NumInsertions); i++) {
+            QNetworkCacheMetaData meta;
+            QString fakeURL;
+            QTextStream stream(&fakeURL);
+            stream << fakeURLbase << i;
+            meta.setUrl(QUrl(fakeURL));
+            meta.setSaveToDisk(true);
+
+            QIODevice *device = cache->prepare(meta);
+            device->write(payload);
+            cache->insert(device);
+        }
+    }
+
+    //Cleanup (slow)
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::timeLargeCacheExpiration_data()
+{
+    largeCacheData();
+}
+
+//Times a synchronous expire() that evicts half of a large cache.
+void tst_qnetworkdiskcache::timeLargeCacheExpiration()
+{
+    QFETCH(QString, cacheRootDirectory);
+    QFETCH(int, entries);
+
+    cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
+
+    //Housekeeping
+    cleanRecursive(cacheDir); // slow op.
+    initCacheObject();
+    cache->setCacheDirectory(cacheDir);
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->clear();
+    injectFakeData(entries); // SLOW
+
+    const qint64 size = cache->cacheSize();
+    QBENCHMARK_ONCE {
+        cache->setMaximumCacheSize(size / 2);
+    }
+    QVERIFY(cache->cacheSize() < size / 2);
+
+    //Cleanup (slow)
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::injectFakeData(quint32 count)
 {
 
     QNetworkCacheMetaData::RawHeaderList headers;
@@ -335,7 +465,7 @@ void tst_qnetworkdiskcache::injectFakeData()
 
 
     //Prep cache dir with fake data using QNetworkDiskCache APIs
-    for (quint32 i = 0; i < NumFakeCacheObjects; i++) {
+    for (quint32 i = 0; i < count; i++) {
 
         //prepare metata for url
         QNetworkCacheMetaData meta;
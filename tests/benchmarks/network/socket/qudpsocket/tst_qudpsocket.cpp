@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtNetwork/qudpsocket.h>
+#include <QtNetwork/qnetworkdatagram.h>
+
+class tst_QUdpSocket : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void writeDatagrams_data();
+    void writeDatagrams();
+    void receiveDatagrams_data();
+    void receiveDatagrams();
+
+private:
+    QVector<QNetworkDatagram> makeDatagrams(int datagramSize) const;
+
+    QUdpSocket sender;
+    QUdpSocket receiver;
+};
+
+// datagrams per iteration; small enough for the default receive buffer
+static const int DatagramCount = 64;
+
+void tst_QUdpSocket::initTestCase()
+{
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    QVERIFY(sender.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 4 * 1024 * 1024);
+}
+
+QVector<QNetworkDatagram> tst_QUdpSocket::makeDatagrams(int datagramSize) const
+{
+    QVector<QNetworkDatagram> datagrams;
+    datagrams.reserve(DatagramCount);
+    for (int i = 0; i < DatagramCount; ++i) {
+        datagrams.append(QNetworkDatagram(QByteArray(datagramSize, char('a' + i % 26)),
+                                          receiver.localAddress(), receiver.localPort()));
+    }
+    return datagrams;
+}
+
+void tst_QUdpSocket::writeDatagrams_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("datagramSize");
+
+    for (int size : { 64, 512, 1400 }) {
+        QTest::addRow("single-%d", size) << false << size;
+        QTest::addRow("batched-%d", size) << true << size;
+    }
+}
+
+void tst_QUdpSocket::writeDatagrams()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, datagramSize);
+
+    const QVector<QNetworkDatagram> datagrams = makeDatagrams(datagramSize);
+
+    QBENCHMARK {
+        if (batched) {
+            QCOMPARE(sender.writeDatagrams(datagrams), DatagramCount);
+        } else {
+            for (const QNetworkDatagram &datagram : datagrams)
+                QCOMPARE(sender.writeDatagram(datagram), qint64(datagramSize));
+        }
+
+        // keep the receive queue from overflowing between iterations
+        while (receiver.hasPendingDatagrams())
+            receiver.receiveDatagrams(DatagramCount, datagramSize);
+    }
+}
+
+void tst_QUdpSocket::receiveDatagrams_data()
+{
+    writeDatagrams_data();
+}
+
+void tst_QUdpSocket::receiveDatagrams()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, datagramSize);
+
+    const QVector<QNetworkDatagram> datagrams = makeDatagrams(datagramSize);
+
+    QBENCHMARK {
+        QCOMPARE(sender.writeDatagrams(datagrams), DatagramCount);
+
+        int received = 0;
+        if (batched) {
+            while (received < DatagramCount) {
+                const QVector<QNetworkDatagram> batch =
+                        receiver.receiveDatagrams(DatagramCount - received, datagramSize);
+                if (batch.isEmpty())
+                    break;
+                received += batch.size();
+            }
+        } else {
+            while (received < DatagramCount && receiver.hasPendingDatagrams()) {
+                if (receiver.receiveDatagram(datagramSize).isValid())
+                    ++received;
+            }
+        }
+        QCOMPARE(received, DatagramCount);
+    }
+}
+
+QTEST_MAIN(tst_QUdpSocket)
+
+#include "tst_qudpsocket.moc"
@@ -1,3 +1,5 @@
 TEMPLATE = subdirs
 SUBDIRS = \
-        qtcpserver
+        qtcpserver \
+        qudpsocket \
+        tcpaccept
@@ -0,0 +1,9 @@
+TEMPLATE = app
+TARGET = tst_bench_tcpaccept
+
+QT -= gui
+QT += network testlib
+
+CONFIG += release
+
+SOURCES += tst_tcpaccept.cpp
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qtcpsocket.h>
+
+#include <functional>
+
+// Accepts connections on its own QTcpServer and event loop; every accepted
+// connection gets one byte and is closed again.
+class AcceptorThread : public QThread
+{
+public:
+    AcceptorThread(bool sharePort, quint16 port)
+        : sharePort(sharePort), port(port), listening(false)
+    {}
+
+    void run() override
+    {
+        QTcpServer server;
+        server.setPortSharingEnabled(sharePort);
+        server.setMaxPendingConnections(1000);
+        listening = server.listen(QHostAddress::LocalHost, port);
+        port = server.serverPort();
+        QObject::connect(&server, &QTcpServer::newConnection, [&server]() {
+            while (QTcpSocket *socket = server.nextPendingConnection()) {
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+                socket->write("x", 1);
+                socket->disconnectFromHost();
+            }
+        });
+        ready.release();
+        if (listening)
+            exec();
+    }
+
+    const bool sharePort;
+    quint16 port;
+    bool listening;
+    QSemaphore ready;
+};
+
+class tst_TcpAccept : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void connectionsPerSecond_data();
+    void connectionsPerSecond();
+};
+
+void tst_TcpAccept::connectionsPerSecond_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("sharePort");
+
+    QTest::newRow("single-server") << 1 << false;
+#ifdef Q_OS_LINUX
+    for (int threadCount : { 1, 2, 4, 8 })
+        QTest::addRow("shared-port-%d", threadCount) << threadCount << true;
+#endif
+}
+
+void tst_TcpAccept::connectionsPerSecond()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, sharePort);
+
+    // connections made per iteration, and how many of them are in flight at once
+    const int connectionCount = 500;
+    const int concurrency = 32;
+
+    QVector<AcceptorThread *> acceptors;
+    quint16 port = 0;
+    for (int i = 0; i < threadCount; ++i) {
+        AcceptorThread *acceptor = new AcceptorThread(sharePort, port);
+        acceptor->start();
+        acceptor->ready.acquire();
+        QVERIFY(acceptor->listening);
+        port = acceptor->port;
+        acceptors << acceptor;
+    }
+
+    QBENCHMARK {
+        int started = 0;
+        int finished = 0;
+        int failed = 0;
+        QEventLoop loop;
+        std::function<void()> startConnection;
+        startConnection = [&]() {
+            QTcpSocket *socket = new QTcpSocket;
+            ++started;
+            auto done = [&, socket](bool ok) {
+                socket->disconnect();
+                socket->abort();
+                socket->deleteLater();
+                ++finished;
+                if (!ok)
+                    ++failed;
+                if (started < connectionCount)
+                    startConnection();
+                else if (finished == connectionCount)
+                    loop.quit();
+            };
+            connect(socket, &QTcpSocket::readyRead, [done]() { done(true); });
+            connect(socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error),
+                    [done]() { done(false); });
+            socket->connectToHost(QHostAddress::LocalHost, port);
+        };
+        for (int i = 0; i < concurrency; ++i)
+            startConnection();
+        loop.exec();
+        QCOMPARE(failed, 0);
+    }
+
+    for (AcceptorThread *acceptor : qAsConst(acceptors)) {
+        acceptor->quit();
+        acceptor->wait();
+    }
+    qDeleteAll(acceptors);
+}
+
+QTEST_MAIN(tst_TcpAccept)
+
+#include "tst_tcpaccept.moc"